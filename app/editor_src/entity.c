@@ -2157,29 +2157,374 @@ static const ENTITY ENTITY_MAP[] = {
 };
 
 
-typedef struct ENTITY_KEY_tag ENTITY_KEY;
-struct ENTITY_KEY_tag {
-    const char* name;
-    size_t name_size;
+/* Perfect hash of ENTITY_MAP[] names.
+ * Generated by scripts/build_hash_maps.py. */
+#define ENTITY_HASH_BUCKETS     512
+#define ENTITY_HASH_SLOTS       2560
+
+static const unsigned short ENTITY_HASH_DISP[512] = {
+    12, 0, 2, 1, 56, 1, 7, 5, 2, 8, 23, 4, 11, 12, 6, 27,
+    0, 11, 8, 2, 10, 9, 5, 32, 0, 1, 43, 90, 15, 7, 10, 2,
+    12, 19, 3, 40, 24, 24, 3, 1, 1, 13, 2, 22, 1, 37, 38, 1,
+    0, 6, 62, 19, 11, 58, 2, 11, 18, 5, 3, 35, 27, 0, 3, 0,
+    0, 64, 53, 5, 21, 16, 2, 21, 5, 10, 1, 53, 6, 7, 74, 51,
+    13, 35, 34, 15, 25, 1, 0, 1, 5, 1, 84, 29, 6, 1, 6, 2,
+    31, 4, 1, 0, 30, 2, 4, 30, 2, 16, 1, 0, 34, 0, 13, 2,
+    75, 2, 2, 12, 25, 2, 0, 1, 3, 0, 43, 8, 71, 16, 14, 24,
+    0, 77, 13, 3, 0, 2, 3, 55, 5, 2, 13, 2, 42, 2, 37, 44,
+    8, 0, 2, 3, 10, 16, 4, 55, 0, 23, 2, 0, 1, 13, 7, 1,
+    1, 2, 11, 24, 52, 71, 2, 3, 0, 24, 0, 0, 11, 4, 5, 22,
+    9, 5, 6, 36, 24, 7, 4, 16, 13, 28, 9, 1, 10, 2, 106, 46,
+    4, 1, 3, 0, 98, 64, 78, 5, 0, 52, 44, 116, 15, 9, 3, 0,
+    108, 8, 19, 2, 30, 55, 1, 32, 6, 0, 7, 7, 6, 155, 71, 3,
+    47, 15, 43, 103, 0, 49, 6, 0, 2, 5, 74, 3, 1, 0, 2, 34,
+    0, 66, 2, 3, 22, 3, 26, 90, 5, 41, 143, 1, 0, 7, 9, 4,
+    0, 0, 17, 4, 5, 4, 27, 13, 0, 36, 0, 0, 25, 1, 69, 0,
+    2, 29, 4, 18, 0, 7, 2, 0, 0, 7, 3, 1, 7, 14, 3, 8,
+    10, 0, 18, 5, 3, 12, 10, 2, 6, 1, 6, 57, 52, 34, 8, 0,
+    13, 7, 34, 6, 10, 28, 41, 0, 3, 28, 17, 4, 0, 52, 15, 88,
+    1, 108, 6, 1, 3, 208, 29, 23, 0, 112, 2, 4, 27, 44, 2, 0,
+    71, 1, 85, 30, 20, 9, 9, 34, 22, 3, 134, 5, 73, 44, 10, 19,
+    12, 4, 2, 2, 3, 13, 36, 0, 116, 14, 1, 15, 2, 0, 22, 3,
+    1, 14, 0, 21, 9, 24, 64, 6, 0, 38, 0, 33, 18, 34, 0, 0,
+    12, 76, 122, 38, 18, 0, 127, 11, 19, 21, 5, 4, 40, 22, 14, 73,
+    54, 31, 70, 9, 87, 0, 7, 7, 56, 15, 3, 0, 6, 2, 0, 92,
+    0, 0, 7, 12, 0, 3, 64, 179, 1, 54, 9, 0, 22, 24, 132, 6,
+    55, 80, 33, 64, 13, 3, 17, 10, 39, 24, 0, 245, 10, 20, 58, 0,
+    0, 11, 33, 16, 62, 5, 7, 19, 23, 11, 47, 10, 114, 10, 18, 19,
+    4, 0, 4, 7, 3, 29, 8, 206, 1, 116, 0, 34, 12, 4, 7, 3,
+    10, 93, 4, 31, 32, 132, 0, 0, 107, 9, 23, 1, 2, 29, 1, 4,
+    3, 27, 57, 25, 30, 74, 12, 113, 34, 77, 60, 30, 0, 1, 2, 14
+};
+
+static const unsigned short ENTITY_HASH_INDEX[2560] = {
+    0, 440, 1196, 1353, 1429, 175, 2063, 931, 1694, 0, 0, 466, 158, 736, 662, 1561,
+    1417, 1278, 106, 1488, 321, 719, 1035, 0, 912, 0, 0, 629, 874, 1042, 1592, 482,
+    409, 310, 222, 461, 2037, 1994, 407, 1445, 1711, 949, 1987, 522, 143, 1804, 960, 1195,
+    1806, 1220, 1314, 2105, 1226, 1931, 146, 617, 558, 508, 981, 0, 1340, 1705, 811, 1626,
+    1321, 2125, 1257, 453, 0, 739, 680, 0, 0, 54, 1290, 0, 1184, 0, 0, 1128,
+    0, 1672, 1299, 1607, 897, 540, 47, 2075, 358, 177, 0, 1003, 2042, 0, 1817, 1980,
+    393, 1730, 316, 0, 1801, 68, 431, 0, 1640, 1942, 1893, 669, 167, 0, 548, 800,
+    810, 2078, 0, 1281, 804, 2036, 755, 0, 1460, 1322, 0, 1027, 1818, 0, 634, 515,
+    718, 374, 644, 1307, 1970, 1176, 700, 1292, 1214, 1493, 0, 266, 1181, 0, 627, 0,
+    193, 1111, 353, 1708, 0, 493, 1434, 1283, 0, 112, 0, 366, 2046, 1933, 763, 1131,
+    1930, 1362, 80, 416, 1941, 1950, 299, 1683, 1768, 0, 0, 2003, 0, 1154, 320, 818,
+    0, 2005, 178, 1262, 753, 1099, 524, 348, 0, 1342, 1038, 1140, 566, 1349, 888, 0,
+    0, 1916, 854, 1165, 0, 481, 1240, 2088, 1964, 749, 0, 1886, 2065, 0, 1186, 0,
+    1239, 1920, 1410, 656, 279, 1594, 1919, 280, 1601, 1722, 1523, 0, 1102, 297, 392, 1168,
+    0, 1981, 290, 2108, 587, 1951, 0, 0, 533, 0, 149, 0, 2116, 1706, 300, 856,
+    0, 1780, 1958, 0, 0, 745, 472, 1303, 75, 1770, 1317, 1224, 1539, 1413, 1425, 0,
+    663, 1870, 0, 521, 104, 1789, 1527, 817, 0, 1400, 951, 0, 516, 1685, 1441, 1963,
+    1050, 343, 203, 0, 0, 165, 0, 1335, 15, 1629, 1762, 571, 580, 1581, 1678, 33,
+    1242, 1784, 1432, 1084, 1431, 740, 0, 1418, 2100, 746, 609, 1372, 1562, 1465, 0, 1436,
+    592, 195, 0, 907, 982, 1528, 621, 98, 262, 0, 140, 331, 1379, 0, 541, 281,
+    272, 1880, 0, 990, 101, 0, 0, 448, 1134, 505, 1811, 1511, 0, 1571, 696, 1767,
+    828, 254, 0, 235, 995, 0, 903, 1243, 1745, 1515, 117, 1720, 1275, 2033, 1055, 970,
+    2058, 843, 0, 857, 0, 1495, 128, 767, 2020, 0, 312, 682, 1922, 425, 1230, 619,
+    1319, 1969, 78, 2080, 1006, 2028, 0, 0, 253, 1041, 1225, 0, 0, 690, 41, 97,
+    1270, 2101, 205, 1821, 883, 1219, 1862, 211, 39, 529, 439, 340, 1069, 0, 675, 842,
+    1727, 1836, 742, 704, 2124, 148, 1747, 1106, 838, 2051, 860, 0, 1674, 1194, 1064, 0,
+    686, 1247, 434, 975, 0, 1120, 2082, 677, 694, 1513, 1647, 551, 2076, 727, 1833, 1962,
+    0, 1649, 1723, 789, 1177, 655, 269, 2115, 378, 1654, 1482, 356, 0, 1569, 162, 454,
+    1250, 1512, 1586, 1439, 275, 226, 1399, 1265, 536, 0, 622, 219, 135, 616, 1616, 1570,
+    1613, 517, 705, 1491, 419, 0, 679, 0, 2083, 2109, 0, 1071, 660, 1917, 824, 1253,
+    0, 1462, 1121, 365, 1632, 0, 0, 1718, 160, 1350, 898, 0, 693, 1114, 1952, 1374,
+    794, 405, 0, 1390, 0, 781, 1590, 168, 1060, 1274, 730, 1444, 34, 1197, 1383, 1437,
+    726, 1565, 0, 1127, 974, 2094, 1363, 396, 1227, 52, 1045, 344, 229, 1548, 227, 0,
+    1519, 1999, 449, 1608, 328, 578, 317, 164, 1422, 1638, 1157, 992, 1854, 441, 0, 1295,
+    967, 668, 1971, 1990, 1259, 1863, 535, 1159, 905, 0, 1934, 1644, 1664, 1997, 0, 242,
+    88, 1857, 1153, 0, 1365, 1132, 1291, 0, 692, 1246, 1763, 918, 1403, 1480, 1926, 0,
+    1669, 795, 5, 873, 722, 1595, 289, 837, 118, 185, 123, 778, 0, 0, 370, 398,
+    2054, 0, 595, 1408, 1526, 0, 534, 99, 661, 1750, 1883, 944, 294, 199, 847, 1298,
+    1455, 1279, 910, 545, 0, 2008, 712, 1093, 769, 2123, 1552, 2006, 2059, 921, 463, 2081,
+    884, 1155, 0, 526, 927, 503, 125, 1504, 599, 1415, 520, 1572, 654, 0, 417, 962,
+    737, 1101, 216, 267, 623, 0, 1078, 1166, 1481, 1778, 457, 234, 1502, 848, 1401, 0,
+    458, 191, 922, 2102, 1496, 64, 771, 2064, 711, 1164, 1764, 0, 0, 1530, 1438, 8,
+    1915, 1424, 1651, 1503, 1781, 542, 2001, 853, 0, 1280, 732, 1799, 519, 0, 0, 1650,
+    394, 197, 2068, 1794, 1850, 1288, 1739, 0, 354, 56, 0, 0, 1521, 0, 1170, 2121,
+    1699, 0, 937, 777, 480, 863, 1828, 1420, 114, 1637, 456, 1297, 1973, 244, 0, 807,
+    55, 894, 697, 1844, 44, 284, 323, 291, 839, 0, 2092, 1536, 1223, 1660, 0, 0,
+    50, 278, 0, 86, 0, 653, 1876, 1263, 401, 0, 144, 670, 1077, 1803, 0, 0,
+    2097, 946, 1058, 2067, 1229, 469, 313, 875, 377, 483, 1388, 945, 256, 362, 0, 1000,
+    965, 446, 22, 2023, 202, 1603, 16, 1858, 801, 1816, 630, 1560, 1909, 1252, 1929, 501,
+    998, 1387, 1026, 479, 1666, 0, 1212, 36, 1193, 159, 972, 277, 754, 1921, 1703, 339,
+    2103, 2010, 1448, 0, 1819, 367, 0, 94, 1996, 1094, 556, 659, 1946, 1701, 1749, 1204,
+    716, 1714, 1686, 0, 0, 1855, 1406, 943, 0, 844, 1032, 0, 0, 1141, 773, 442,
+    420, 1777, 1957, 598, 1798, 1557, 969, 751, 1346, 1658, 1391, 1499, 298, 190, 433, 0,
+    1673, 591, 376, 1338, 1199, 0, 638, 1988, 248, 1707, 0, 1464, 322, 1864, 1360, 1661,
+    0, 0, 954, 984, 65, 1484, 1938, 1845, 0, 4, 1878, 0, 968, 0, 0, 1091,
+    26, 1179, 0, 554, 1147, 468, 585, 134, 96, 221, 129, 360, 1486, 689, 357, 562,
+    1231, 1284, 20, 1126, 399, 131, 906, 0, 1544, 1161, 833, 0, 820, 0, 890, 1547,
+    0, 1414, 643, 126, 121, 0, 733, 964, 0, 2019, 0, 0, 1312, 384, 484, 1531,
+    0, 1906, 136, 1313, 1145, 0, 1852, 180, 0, 217, 0, 2053, 0, 2107, 865, 1031,
+    1959, 861, 152, 2114, 793, 1905, 174, 0, 1881, 1485, 0, 2093, 0, 0, 1173, 0,
+    2024, 956, 305, 1525, 6, 1183, 0, 986, 1113, 877, 1326, 1304, 46, 603, 1344, 67,
+    1879, 485, 1668, 476, 1443, 421, 172, 537, 0, 0, 1793, 1684, 835, 1754, 2050, 1271,
+    671, 879, 1725, 0, 1807, 1190, 334, 236, 792, 0, 0, 0, 1358, 0, 327, 869,
+    0, 1709, 0, 512, 1514, 538, 0, 1192, 391, 0, 1367, 1620, 0, 1604, 0, 318,
+    1090, 1306, 1474, 1648, 173, 1500, 855, 350, 783, 1209, 723, 1479, 1080, 2071, 887, 0,
+    747, 1877, 2112, 0, 1330, 1549, 1210, 325, 2039, 2002, 127, 1731, 1440, 233, 1785, 72,
+    0, 1631, 1690, 108, 1734, 1554, 0, 2099, 184, 775, 1254, 750, 0, 1014, 0, 0,
+    0, 1782, 567, 0, 1813, 43, 832, 0, 882, 1960, 864, 166, 1653, 829, 2060, 1092,
+    1992, 57, 2015, 0, 1715, 1943, 933, 1636, 550, 1716, 2086, 607, 1898, 1724, 0, 849,
+    1233, 1354, 774, 652, 936, 588, 0, 1454, 1294, 2041, 2049, 1489, 462, 569, 2057, 0,
+    1054, 891, 764, 1218, 639, 1037, 646, 648, 1717, 1591, 1180, 379, 1018, 450, 509, 1984,
+    1856, 1453, 0, 866, 1805, 443, 952, 1786, 1872, 0, 0, 0, 1133, 273, 1611, 2089,
+    699, 0, 672, 1998, 1282, 198, 876, 1074, 899, 565, 1088, 825, 612, 0, 1268, 768,
+    893, 0, 1869, 1316, 105, 787, 2091, 1687, 735, 2113, 1036, 1116, 531, 904, 1002, 0,
+    0, 0, 92, 1017, 901, 1341, 79, 171, 1577, 169, 0, 2012, 2048, 1966, 582, 347,
+    132, 1546, 264, 1492, 1610, 1382, 1841, 1742, 559, 1979, 1421, 1458, 12, 1787, 0, 1318,
+    1044, 1923, 241, 1315, 0, 748, 681, 1924, 0, 0, 110, 1890, 1619, 0, 1534, 1810,
+    156, 1011, 574, 2026, 647, 729, 0, 400, 1968, 685, 1645, 150, 640, 601, 0, 0,
+    225, 1759, 1865, 826, 1211, 1061, 1765, 0, 0, 1953, 0, 19, 252, 1052, 1008, 93,
+    658, 0, 0, 0, 0, 1617, 2052, 1433, 0, 1097, 0, 0, 369, 1376, 385, 836,
+    48, 1171, 573, 695, 908, 1986, 430, 124, 1738, 0, 0, 1580, 411, 1659, 1912, 920,
+    349, 0, 49, 1264, 1030, 474, 308, 1082, 744, 237, 1820, 665, 260, 437, 1070, 1907,
+    436, 389, 1073, 2014, 867, 1324, 2111, 1897, 2079, 187, 0, 851, 1665, 708, 0, 3,
+    2090, 32, 1995, 1423, 60, 1389, 1823, 1023, 1643, 0, 179, 1428, 192, 137, 923, 0,
+    1846, 1076, 831, 1559, 435, 1013, 288, 62, 0, 246, 0, 973, 642, 618, 1932, 0,
+    1839, 822, 544, 1072, 1558, 1459, 1628, 979, 77, 608, 230, 263, 0, 1783, 701, 0,
+    213, 1733, 61, 1327, 1574, 0, 1470, 678, 803, 1697, 0, 1936, 89, 1535, 1217, 0,
+    492, 796, 1732, 1356, 176, 406, 1447, 814, 1655, 759, 1827, 1726, 71, 0, 212, 724,
+    1396, 917, 196, 1249, 0, 428, 957, 1625, 23, 761, 530, 1466, 988, 1143, 1293, 782,
+    1200, 11, 1364, 1395, 0, 684, 1829, 785, 1473, 0, 2056, 9, 1308, 1320, 0, 258,
+    0, 1993, 1744, 13, 702, 496, 1874, 1696, 1790, 0, 1639, 1837, 58, 1593, 0, 0,
+    1506, 418, 1583, 224, 1068, 1144, 1606, 757, 1575, 107, 1188, 1567, 813, 1860, 1847, 858,
+    709, 1563, 315, 1812, 611, 1568, 0, 471, 1913, 1545, 776, 220, 575, 0, 326, 1167,
+    1124, 589, 1566, 103, 1419, 0, 0, 1910, 1287, 1505, 916, 1947, 0, 1693, 1740, 215,
+    1201, 1215, 295, 426, 1339, 0, 0, 459, 346, 1584, 941, 1169, 0, 717, 338, 363,
+    1065, 0, 341, 0, 204, 983, 371, 0, 938, 0, 402, 2106, 1310, 414, 1057, 2017,
+    335, 1085, 0, 0, 953, 1538, 1207, 1972, 1446, 0, 2070, 0, 0, 408, 303, 151,
+    2013, 0, 0, 1238, 1956, 1634, 1887, 486, 1024, 2074, 444, 2118, 958, 395, 130, 0,
+    597, 0, 0, 560, 1333, 688, 932, 232, 120, 1908, 261, 1808, 980, 375, 228, 1150,
+    69, 1612, 1152, 1822, 1174, 1609, 1516, 2040, 427, 666, 2110, 1059, 382, 1892, 1258, 478,
+    0, 850, 0, 1494, 1598, 1234, 1187, 1743, 605, 257, 1599, 0, 606, 1205, 1641, 0,
+    239, 1402, 959, 0, 0, 989, 2095, 0, 1698, 809, 445, 1656, 1903, 352, 0, 1814,
+    1261, 1336, 1825, 1267, 0, 586, 1266, 1955, 1369, 1185, 0, 0, 563, 292, 0, 1550,
+    859, 494, 527, 0, 1208, 115, 1843, 770, 976, 0, 641, 846, 0, 0, 189, 250,
+    66, 2, 1621, 892, 460, 1842, 924, 1642, 249, 1442, 336, 1160, 1117, 0, 806, 1034,
+    0, 1911, 0, 942, 1020, 1397, 1370, 1522, 489, 1119, 306, 1343, 1139, 1163, 0, 0,
+    0, 1236, 368, 2029, 1605, 1028, 1741, 1357, 1830, 0, 2000, 1948, 1361, 961, 900, 971,
+    1904, 840, 245, 76, 1109, 1452, 218, 455, 594, 581, 1158, 223, 583, 1776, 1019, 1081,
+    1700, 2031, 319, 0, 590, 1542, 1328, 283, 1373, 1386, 2098, 31, 645, 1853, 0, 345,
+    1889, 940, 1329, 0, 1940, 543, 715, 1961, 1108, 286, 1007, 2035, 2016, 1788, 2087, 1087,
+    1713, 1832, 1005, 0, 1977, 947, 2047, 1702, 985, 637, 2066, 707, 758, 0, 841, 0,
+    1156, 1795, 1355, 896, 552, 255, 0, 1430, 1974, 0, 1553, 17, 432, 0, 1015, 1589,
+    752, 18, 913, 1149, 201, 963, 1894, 633, 63, 2034, 977, 1771, 996, 935, 1384, 7,
+    1416, 0, 0, 1891, 1679, 997, 1675, 1507, 939, 0, 1588, 1884, 95, 0, 238, 0,
+    1053, 0, 1757, 1203, 0, 337, 584, 2085, 1834, 766, 788, 139, 1556, 0, 1467, 741,
+    1348, 464, 2025, 142, 0, 0, 27, 506, 45, 532, 909, 1537, 779, 1457, 1021, 0,
+    880, 721, 0, 2032, 1366, 467, 429, 568, 649, 122, 259, 0, 0, 881, 1248, 1688,
+    500, 513, 1022, 2084, 1216, 1213, 386, 2061, 0, 0, 1277, 307, 1409, 1848, 615, 24,
+    0, 1477, 0, 465, 1899, 251, 0, 915, 1001, 207, 74, 2077, 1047, 553, 815, 1404,
+    576, 1451, 1048, 231, 413, 0, 1501, 324, 0, 0, 1851, 999, 1935, 0, 1125, 1896,
+    1983, 510, 1766, 1272, 495, 1039, 1472, 1135, 604, 579, 2018, 1773, 631, 0, 1667, 786,
+    1748, 0, 1939, 1882, 1928, 1925, 0, 1411, 577, 1663, 181, 0, 186, 1900, 415, 1118,
+    0, 1587, 1498, 1483, 0, 1635, 0, 0, 491, 1487, 0, 743, 0, 0, 1381, 270,
+    929, 1873, 0, 1824, 1305, 0, 1046, 42, 0, 1991, 790, 1245, 1285, 1657, 823, 1202,
+    0, 1375, 247, 1123, 287, 1468, 0, 1840, 53, 87, 0, 0, 1435, 330, 1835, 1016,
+    100, 1103, 948, 1769, 1760, 1301, 153, 1450, 1051, 1175, 808, 507, 1775, 564, 1469, 1475,
+    1792, 214, 1682, 911, 674, 404, 81, 361, 1010, 38, 1049, 557, 0, 991, 1012, 502,
+    0, 397, 1585, 109, 0, 1949, 1691, 928, 497, 83, 651, 1148, 25, 0, 0, 1129,
+    0, 725, 1671, 0, 0, 561, 1029, 784, 0, 1009, 1600, 0, 1524, 1710, 1142, 1719,
+    878, 2069, 1004, 0, 547, 1508, 978, 1540, 1276, 0, 1062, 1351, 1985, 2055, 70, 1692,
+    1405, 0, 902, 1345, 1206, 2122, 1096, 311, 1427, 1755, 636, 388, 1861, 84, 0, 926,
+    728, 488, 1244, 0, 380, 570, 1868, 1704, 539, 1945, 0, 499, 797, 0, 1471, 0,
+    1269, 0, 1520, 309, 274, 209, 1867, 1695, 1618, 0, 210, 1311, 683, 1712, 1752, 885,
+    852, 1115, 2045, 35, 514, 2044, 243, 14, 2117, 845, 1543, 1497, 30, 333, 1729, 1602,
+    40, 133, 772, 265, 1758, 1809, 1871, 734, 0, 1393, 0, 85, 528, 0, 342, 0,
+    706, 37, 555, 157, 1815, 1772, 1982, 28, 0, 518, 1875, 301, 0, 188, 0, 0,
+    0, 511, 10, 154, 1615, 760, 1652, 0, 1746, 403, 1385, 1222, 0, 1300, 2021, 1680,
+    862, 504, 1107, 950, 1623, 332, 0, 155, 1490, 1463, 687, 0, 2007, 1241, 373, 1189,
+    1456, 0, 1510, 523, 470, 993, 0, 549, 676, 1359, 271, 1237, 0, 2062, 1251, 821,
+    1622, 1529, 895, 1162, 966, 116, 1902, 1967, 1579, 1756, 0, 141, 1461, 1728, 73, 0,
+    0, 1888, 0, 451, 163, 2120, 1138, 628, 1136, 59, 0, 0, 1533, 1063, 498, 1517,
+    1289, 1086, 0, 1221, 1976, 0, 0, 1172, 703, 1597, 1670, 572, 620, 780, 102, 1476,
+    1838, 2072, 2119, 1368, 1633, 1337, 329, 0, 1256, 1914, 355, 1573, 0, 1033, 240, 2030,
+    805, 1737, 0, 0, 1721, 0, 285, 1676, 930, 1323, 1334, 0, 276, 208, 1826, 1937,
+    490, 0, 304, 410, 1098, 0, 1255, 624, 0, 1182, 138, 816, 383, 868, 762, 1392,
+    1095, 871, 0, 359, 1100, 296, 546, 1228, 819, 487, 1478, 424, 525, 2096, 2011, 1582,
+    925, 1394, 423, 2027, 452, 0, 1662, 1689, 0, 2004, 147, 1079, 673, 0, 1286, 0,
+    602, 1646, 1576, 1198, 650, 834, 412, 0, 2022, 1802, 1352, 113, 2104, 1779, 161, 351,
+    632, 1927, 1797, 691, 635, 1412, 994, 282, 830, 1302, 987, 0, 600, 610, 111, 765,
+    802, 614, 364, 1347, 1541, 473, 593, 955, 870, 0, 1866, 1146, 82, 1614, 714, 1273,
+    1901, 0, 1885, 667, 381, 1332, 1774, 0, 1380, 1398, 0, 0, 1151, 1309, 91, 0,
+    0, 1056, 293, 1518, 182, 1325, 183, 791, 1965, 447, 710, 872, 1751, 1954, 613, 914,
+    1378, 1104, 1426, 0, 625, 0, 1110, 0, 698, 1331, 2073, 1235, 1407, 1112, 0, 1371,
+    713, 0, 0, 0, 1849, 1791, 1944, 1624, 0, 0, 0, 2009, 731, 1681, 0, 1040,
+    720, 1105, 1627, 0, 657, 200, 934, 119, 812, 1578, 475, 51, 1066, 1551, 756, 477,
+    0, 1260, 0, 799, 2043, 1630, 268, 29, 889, 1449, 596, 145, 738, 194, 919, 302,
+    1178, 798, 0, 1, 1067, 2038, 1735, 1232, 1555, 438, 886, 0, 1677, 1796, 0, 626,
+    664, 1532, 0, 827, 0, 1989, 1089, 1075, 1509, 1083, 1859, 1596, 1895, 1736, 1025, 1122,
+    314, 90, 170, 1130, 0, 1918, 1043, 372, 0, 1137, 206, 0, 0, 0, 1978, 1831,
+    1761, 1564, 0, 1975, 390, 0, 1296, 0, 21, 387, 1377, 422, 0, 1800, 1191, 1753
+};
+
+static const unsigned char ENTITY_HASH_NAME_SIZE[2560] = {
+    0, 18, 6, 5, 7, 7, 8, 10, 8, 0, 0, 16, 8, 7, 11, 9, 9, 5, 18, 6, 19, 7, 5, 0,
+    16, 0, 0, 10, 7, 5, 5, 5, 6, 5, 5, 8, 8, 7, 6, 11, 7, 4, 8, 7, 8, 10, 6, 8,
+    5, 9, 6, 5, 6, 8, 5, 5, 5, 11, 7, 0, 6, 8, 6, 10, 4, 6, 12, 5, 0, 6, 9, 0,
+    0, 7, 12, 0, 6, 0, 0, 7, 0, 6, 8, 8, 5, 15, 11, 4, 15, 7, 0, 6, 15, 0, 7, 8,
+    11, 18, 15, 0, 7, 6, 20, 0, 10, 7, 6, 10, 18, 0, 9, 5, 13, 6, 0, 5, 17, 6, 7, 0,
+    9, 6, 0, 7, 7, 0, 7, 6, 6, 9, 8, 7, 10, 8, 19, 15, 7, 9, 0, 16, 6, 0, 10, 0,
+    5, 8, 23, 5, 0, 15, 5, 7, 0, 20, 0, 8, 5, 7, 6, 7, 5, 9, 16, 8, 7, 8, 21, 8,
+    9, 0, 0, 9, 0, 7, 21, 8, 0, 15, 5, 5, 7, 8, 8, 24, 0, 5, 5, 8, 5, 5, 7, 0,
+    0, 7, 8, 7, 0, 6, 19, 6, 8, 7, 0, 13, 8, 0, 6, 0, 17, 8, 7, 6, 16, 10, 9, 17,
+    8, 5, 8, 0, 8, 8, 4, 5, 0, 6, 11, 6, 6, 8, 0, 0, 11, 0, 6, 0, 6, 7, 20, 13,
+    0, 6, 14, 0, 0, 9, 6, 6, 5, 8, 6, 6, 4, 8, 7, 0, 9, 7, 0, 8, 11, 7, 8, 7,
+    0, 8, 5, 0, 8, 9, 12, 17, 6, 21, 16, 0, 0, 14, 0, 11, 7, 4, 8, 7, 6, 6, 7, 6,
+    16, 7, 5, 12, 4, 7, 0, 5, 6, 10, 5, 10, 7, 6, 0, 7, 5, 4, 0, 7, 7, 6, 6, 22,
+    18, 0, 6, 14, 5, 0, 7, 6, 15, 8, 0, 6, 15, 0, 0, 12, 10, 11, 8, 6, 0, 7, 14, 10,
+    8, 18, 0, 5, 5, 0, 8, 5, 7, 18, 11, 8, 8, 8, 7, 7, 6, 7, 0, 13, 0, 6, 8, 10,
+    6, 0, 11, 8, 8, 5, 10, 6, 8, 9, 5, 6, 6, 7, 0, 0, 19, 5, 5, 0, 0, 17, 9, 26,
+    4, 8, 6, 7, 5, 9, 13, 7, 8, 12, 15, 23, 7, 0, 9, 9, 6, 11, 7, 7, 5, 23, 7, 7,
+    6, 8, 8, 0, 8, 8, 5, 0, 10, 5, 20, 13, 0, 5, 5, 8, 10, 17, 6, 8, 8, 6, 8, 15,
+    0, 10, 7, 9, 8, 8, 4, 5, 4, 8, 5, 18, 0, 6, 5, 13, 9, 15, 6, 6, 15, 6, 6, 7,
+    9, 0, 5, 6, 9, 5, 10, 6, 9, 8, 7, 7, 5, 0, 6, 0, 7, 6, 0, 6, 10, 8, 12, 8,
+    0, 9, 6, 7, 7, 0, 0, 6, 5, 7, 8, 0, 8, 8, 6, 5, 11, 6, 0, 7, 0, 6, 6, 16,
+    5, 7, 7, 7, 8, 7, 8, 5, 7, 7, 0, 8, 12, 7, 6, 4, 7, 23, 5, 23, 8, 6, 4, 0,
+    7, 7, 6, 7, 20, 6, 11, 6, 7, 13, 6, 13, 7, 20, 0, 6, 7, 6, 6, 5, 9, 7, 6, 9,
+    6, 0, 10, 6, 9, 8, 0, 19, 8, 8, 6, 0, 8, 7, 16, 0, 10, 10, 8, 8, 10, 7, 8, 0,
+    6, 5, 7, 6, 7, 8, 5, 7, 6, 11, 8, 8, 0, 0, 5, 15, 5, 0, 6, 7, 9, 0, 7, 18,
+    13, 8, 12, 5, 6, 5, 5, 8, 7, 6, 9, 16, 0, 6, 8, 8, 8, 6, 5, 16, 7, 6, 5, 7,
+    7, 8, 0, 8, 7, 5, 5, 7, 8, 7, 7, 7, 9, 0, 8, 6, 7, 8, 8, 11, 6, 0, 8, 6,
+    8, 8, 8, 8, 9, 10, 8, 0, 8, 5, 6, 8, 7, 5, 7, 8, 5, 8, 6, 0, 0, 9, 7, 8,
+    8, 6, 6, 6, 7, 12, 7, 6, 0, 10, 7, 5, 10, 0, 0, 10, 15, 12, 8, 6, 5, 15, 7, 0,
+    18, 11, 0, 0, 8, 0, 7, 9, 8, 0, 6, 10, 6, 7, 6, 5, 20, 8, 6, 9, 7, 19, 0, 10,
+    8, 5, 13, 10, 11, 4, 22, 6, 7, 0, 8, 7, 7, 6, 0, 0, 13, 6, 0, 6, 0, 7, 11, 4,
+    7, 0, 14, 7, 7, 6, 0, 0, 8, 8, 5, 7, 9, 7, 22, 9, 16, 8, 5, 4, 14, 6, 0, 5,
+    6, 13, 8, 6, 16, 9, 6, 8, 6, 6, 10, 7, 10, 6, 8, 8, 7, 6, 8, 13, 9, 0, 6, 22,
+    10, 7, 9, 16, 7, 7, 9, 18, 6, 9, 7, 0, 9, 7, 0, 22, 10, 6, 7, 6, 8, 7, 6, 8,
+    7, 6, 7, 0, 0, 6, 7, 7, 0, 7, 8, 0, 0, 7, 8, 19, 4, 5, 10, 6, 6, 5, 9, 6,
+    10, 5, 7, 11, 5, 7, 17, 0, 6, 8, 22, 6, 5, 0, 7, 7, 9, 6, 0, 9, 16, 5, 8, 8,
+    0, 0, 7, 7, 8, 6, 8, 12, 0, 8, 12, 0, 6, 0, 0, 6, 6, 5, 0, 6, 10, 14, 5, 6,
+    21, 8, 9, 15, 11, 9, 10, 14, 6, 7, 11, 4, 20, 18, 5, 0, 5, 8, 7, 0, 7, 0, 6, 6,
+    0, 8, 5, 6, 5, 0, 7, 6, 0, 8, 0, 0, 6, 9, 13, 8, 0, 7, 7, 5, 8, 0, 8, 6,
+    0, 7, 0, 6, 0, 5, 10, 5, 14, 16, 6, 8, 6, 7, 8, 0, 8, 6, 0, 8, 0, 0, 8, 0,
+    9, 10, 9, 6, 5, 6, 0, 5, 8, 8, 8, 8, 5, 5, 12, 10, 8, 10, 7, 19, 6, 16, 6, 12,
+    0, 0, 6, 7, 6, 10, 7, 7, 5, 4, 8, 0, 7, 5, 19, 18, 9, 0, 0, 0, 8, 0, 17, 6,
+    0, 6, 0, 12, 16, 18, 0, 8, 5, 0, 6, 8, 0, 5, 0, 12, 8, 10, 9, 10, 4, 12, 9, 16,
+    7, 8, 7, 13, 11, 8, 5, 0, 7, 11, 6, 0, 6, 8, 5, 17, 14, 6, 5, 16, 5, 8, 5, 6,
+    0, 6, 8, 21, 18, 8, 0, 7, 14, 5, 12, 7, 0, 8, 0, 0, 0, 8, 6, 0, 7, 9, 8, 0,
+    9, 16, 7, 18, 7, 6, 7, 8, 7, 8, 7, 0, 9, 7, 6, 13, 6, 10, 7, 7, 9, 7, 0, 8,
+    11, 7, 8, 5, 8, 6, 0, 5, 7, 14, 8, 7, 7, 8, 7, 0, 5, 9, 7, 7, 9, 7, 6, 8,
+    7, 7, 8, 6, 8, 14, 7, 7, 8, 6, 0, 7, 15, 18, 5, 6, 9, 0, 0, 0, 7, 20, 5, 6,
+    19, 0, 7, 7, 6, 9, 7, 4, 15, 15, 6, 11, 7, 0, 7, 6, 7, 0, 9, 7, 14, 7, 6, 8,
+    7, 8, 8, 8, 18, 8, 7, 0, 0, 0, 17, 8, 6, 9, 18, 14, 9, 13, 0, 8, 5, 10, 8, 19,
+    22, 8, 13, 7, 11, 13, 8, 8, 8, 6, 6, 9, 7, 7, 0, 7, 10, 5, 19, 7, 0, 7, 5, 6,
+    0, 0, 16, 5, 8, 0, 7, 5, 8, 10, 6, 6, 6, 7, 0, 15, 7, 9, 7, 8, 7, 4, 0, 0,
+    6, 6, 6, 6, 8, 5, 7, 0, 0, 9, 0, 6, 17, 5, 8, 17, 7, 0, 0, 0, 0, 7, 8, 6,
+    0, 6, 0, 0, 8, 6, 11, 6, 13, 6, 6, 8, 10, 7, 14, 7, 14, 0, 0, 8, 7, 6, 12, 6,
+    11, 0, 12, 5, 4, 20, 18, 8, 10, 11, 9, 8, 11, 15, 6, 9, 10, 5, 7, 8, 8, 7, 6, 8,
+    7, 7, 0, 8, 7, 9, 0, 8, 7, 6, 8, 11, 11, 6, 8, 8, 8, 0, 14, 7, 6, 12, 8, 0,
+    7, 7, 6, 7, 12, 8, 11, 7, 0, 16, 0, 7, 4, 8, 11, 0, 8, 6, 13, 7, 6, 9, 7, 9,
+    7, 4, 6, 15, 0, 10, 20, 0, 5, 19, 33, 8, 7, 0, 5, 6, 8, 7, 0, 13, 10, 8, 8, 0,
+    10, 6, 17, 8, 5, 5, 7, 9, 6, 7, 5, 5, 8, 0, 5, 7, 6, 10, 7, 8, 0, 15, 8, 4,
+    5, 6, 14, 11, 6, 8, 16, 7, 7, 5, 6, 10, 0, 8, 7, 8, 7, 0, 7, 7, 8, 8, 0, 12,
+    0, 7, 7, 6, 7, 7, 8, 11, 8, 0, 10, 6, 17, 6, 0, 0, 9, 8, 5, 6, 6, 5, 6, 7,
+    5, 11, 7, 6, 8, 7, 8, 10, 6, 5, 10, 6, 9, 8, 0, 6, 8, 7, 8, 7, 5, 0, 14, 7,
+    5, 6, 9, 19, 5, 0, 0, 11, 7, 7, 18, 6, 0, 7, 7, 6, 6, 7, 8, 19, 6, 0, 0, 4,
+    22, 6, 6, 5, 0, 7, 13, 8, 6, 0, 19, 0, 7, 6, 8, 0, 7, 0, 9, 5, 7, 6, 4, 6,
+    14, 9, 0, 0, 8, 8, 8, 6, 6, 0, 8, 0, 0, 5, 22, 12, 10, 0, 0, 16, 7, 6, 10, 15,
+    8, 4, 15, 6, 8, 6, 7, 0, 6, 0, 0, 6, 10, 10, 7, 6, 5, 8, 16, 8, 10, 6, 8, 6,
+    6, 8, 6, 15, 7, 4, 4, 15, 12, 8, 6, 5, 8, 6, 9, 21, 0, 8, 0, 9, 5, 15, 8, 12,
+    7, 17, 8, 0, 5, 8, 9, 0, 21, 7, 8, 0, 0, 6, 7, 0, 7, 13, 18, 5, 9, 18, 0, 6,
+    8, 6, 6, 8, 0, 6, 7, 8, 6, 7, 0, 0, 19, 6, 0, 7, 12, 8, 7, 0, 9, 9, 8, 6,
+    8, 0, 6, 9, 0, 0, 8, 15, 4, 5, 7, 13, 8, 7, 7, 7, 14, 17, 25, 7, 8, 0, 10, 8,
+    0, 11, 0, 4, 8, 7, 8, 6, 10, 7, 5, 8, 4, 4, 0, 0, 0, 15, 5, 8, 5, 7, 5, 8,
+    8, 0, 5, 6, 8, 5, 8, 8, 9, 7, 11, 5, 16, 6, 6, 8, 16, 6, 7, 5, 7, 7, 8, 8,
+    8, 10, 17, 0, 8, 6, 9, 8, 7, 8, 8, 8, 5, 6, 0, 17, 9, 5, 8, 0, 8, 9, 7, 11,
+    15, 5, 6, 11, 7, 7, 7, 11, 6, 6, 7, 0, 19, 5, 7, 9, 6, 8, 9, 5, 8, 0, 9, 0,
+    6, 8, 5, 7, 6, 17, 0, 7, 8, 0, 6, 8, 20, 0, 8, 10, 7, 8, 11, 9, 14, 7, 6, 10,
+    6, 7, 8, 7, 8, 8, 8, 5, 8, 0, 0, 6, 7, 8, 7, 11, 8, 0, 8, 13, 15, 0, 14, 0,
+    4, 0, 6, 9, 0, 19, 5, 4, 6, 7, 7, 6, 7, 0, 8, 7, 8, 5, 6, 6, 0, 0, 5, 7,
+    5, 7, 10, 9, 8, 10, 8, 0, 9, 7, 0, 12, 8, 17, 21, 6, 10, 8, 15, 0, 0, 7, 7, 8,
+    5, 6, 8, 7, 8, 7, 13, 6, 0, 0, 12, 9, 8, 10, 7, 9, 0, 8, 0, 16, 6, 14, 0, 17,
+    7, 6, 8, 6, 8, 7, 7, 6, 4, 8, 9, 12, 8, 0, 7, 17, 0, 0, 8, 8, 8, 0, 8, 6,
+    8, 12, 7, 10, 7, 6, 6, 10, 7, 6, 7, 5, 10, 0, 6, 8, 7, 0, 7, 6, 6, 8, 0, 9,
+    6, 13, 16, 0, 6, 9, 6, 4, 0, 8, 9, 8, 0, 12, 0, 0, 5, 16, 0, 7, 0, 0, 6, 12,
+    9, 9, 0, 10, 7, 0, 7, 6, 0, 8, 6, 6, 7, 8, 8, 7, 0, 5, 17, 5, 13, 7, 0, 7,
+    17, 5, 0, 0, 6, 9, 8, 8, 16, 5, 8, 4, 7, 9, 6, 7, 8, 7, 12, 12, 8, 15, 9, 7,
+    9, 6, 6, 11, 9, 14, 24, 16, 7, 8, 10, 8, 0, 7, 8, 8, 0, 10, 8, 19, 0, 5, 9, 7,
+    7, 18, 6, 10, 12, 0, 0, 8, 0, 7, 7, 0, 0, 13, 6, 7, 0, 6, 8, 0, 6, 9, 10, 5,
+    5, 7, 7, 0, 6, 12, 7, 8, 8, 0, 6, 15, 5, 7, 6, 8, 5, 0, 8, 12, 8, 6, 7, 14,
+    6, 7, 10, 10, 17, 9, 0, 7, 7, 15, 5, 0, 8, 7, 9, 8, 13, 10, 0, 5, 7, 0, 8, 0,
+    6, 0, 8, 6, 16, 7, 6, 7, 9, 0, 6, 8, 9, 8, 6, 9, 7, 8, 18, 5, 11, 17, 16, 15,
+    8, 8, 7, 7, 6, 13, 16, 6, 7, 7, 7, 10, 5, 8, 7, 8, 0, 7, 0, 15, 10, 0, 18, 0,
+    7, 9, 5, 8, 7, 4, 7, 6, 0, 6, 10, 19, 0, 6, 0, 0, 0, 16, 7, 4, 6, 8, 8, 0,
+    7, 12, 7, 8, 0, 5, 7, 8, 17, 5, 8, 10, 9, 16, 0, 7, 8, 9, 11, 0, 7, 21, 7, 4,
+    8, 0, 8, 5, 13, 14, 0, 7, 7, 7, 8, 16, 0, 8, 10, 8, 8, 6, 9, 7, 8, 14, 9, 9,
+    6, 8, 0, 5, 7, 12, 7, 0, 0, 10, 0, 13, 4, 6, 7, 10, 7, 6, 0, 0, 7, 10, 6, 5,
+    20, 8, 0, 8, 18, 0, 0, 6, 7, 6, 8, 5, 10, 8, 19, 7, 7, 5, 5, 4, 5, 7, 22, 0,
+    11, 8, 13, 4, 0, 7, 13, 12, 18, 6, 0, 0, 8, 0, 5, 10, 6, 7, 9, 0, 20, 8, 7, 10,
+    5, 0, 16, 6, 7, 0, 9, 7, 0, 6, 13, 10, 6, 6, 7, 9, 9, 8, 0, 19, 11, 8, 17, 8,
+    9, 20, 8, 5, 5, 6, 12, 9, 6, 9, 22, 7, 6, 0, 6, 8, 0, 13, 19, 9, 8, 0, 7, 0,
+    5, 8, 7, 8, 7, 7, 5, 0, 7, 8, 5, 17, 7, 7, 6, 13, 10, 5, 7, 15, 9, 7, 15, 5,
+    8, 6, 5, 0, 8, 8, 19, 6, 6, 7, 4, 8, 6, 8, 6, 7, 8, 0, 8, 10, 18, 8, 7, 8,
+    9, 0, 8, 10, 8, 7, 6, 0, 5, 8, 0, 0, 7, 5, 11, 0, 0, 6, 4, 8, 6, 8, 8, 7,
+    6, 16, 6, 6, 9, 6, 7, 16, 17, 10, 5, 0, 8, 0, 6, 0, 15, 7, 6, 17, 4, 6, 0, 4,
+    8, 0, 0, 0, 12, 7, 8, 9, 0, 0, 0, 7, 7, 7, 0, 4, 7, 10, 6, 0, 10, 10, 8, 8,
+    10, 6, 14, 26, 7, 7, 7, 16, 0, 8, 0, 5, 10, 5, 5, 7, 7, 5, 5, 5, 7, 8, 8, 23,
+    5, 11, 0, 7, 7, 10, 17, 4, 5, 16, 8, 0, 6, 10, 0, 10, 11, 9, 0, 9, 0, 8, 6, 6,
+    6, 11, 6, 7, 5, 17, 8, 7, 12, 23, 19, 7, 0, 7, 6, 7, 0, 6, 6, 0, 0, 0, 6, 5,
+    8, 7, 0, 7, 5, 0, 8, 0, 6, 17, 12, 20, 0, 8, 6, 8
 };
 
-static int
-entity_cmp(const void* p_key, const void* p_entity)
+
+static unsigned
+entity_hash(const char* name, size_t name_size)
+{
+    unsigned hash = 2166136261U;
+    size_t i;
+
+    /* FNV-1a */
+    for (i = 0; i < name_size; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static unsigned
+entity_hash_slot(unsigned hash, unsigned disp, unsigned n_slots)
 {
-    ENTITY_KEY* key = (ENTITY_KEY*)p_key;
-    ENTITY* ent = (ENTITY*)p_entity;
+    /* Murmur3 finalizer; then scale to [0, n_slots). */
+    hash ^= disp;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+
+    return (unsigned)(((unsigned long long)hash * n_slots) >> 32);
+}
 
-    return strncmp(key->name, ent->name, key->name_size);
+unsigned
+entity_hex_val(char ch)
+{
+    if ('0' <= ch && ch <= '9')
+        return ch - '0';
+    if ('A' <= ch && ch <= 'Z')
+        return ch - 'A' + 10;
+    else
+        return ch - 'a' + 10;
 }
 
 const ENTITY*
 entity_lookup(const char* name, size_t name_size)
 {
-    ENTITY_KEY key = { name, name_size };
+    unsigned hash = entity_hash(name, name_size);
+    unsigned slot = entity_hash_slot(hash, ENTITY_HASH_DISP[hash & (ENTITY_HASH_BUCKETS - 1)],
+        ENTITY_HASH_SLOTS);
+    const ENTITY* ent;
+
+    if (ENTITY_HASH_INDEX[slot] == 0 || ENTITY_HASH_NAME_SIZE[slot] != name_size)
+        return NULL;
+
+    ent = &ENTITY_MAP[ENTITY_HASH_INDEX[slot] - 1];
+    if (memcmp(ent->name, name, name_size) != 0)
+        return NULL;
 
-    return bsearch(&key,
-        ENTITY_MAP,
-        sizeof(ENTITY_MAP) / sizeof(ENTITY_MAP[0]),
-        sizeof(ENTITY),
-        entity_cmp);
+    return ent;
 }
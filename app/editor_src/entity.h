@@ -40,5 +40,9 @@ struct ENTITY_tag {
 
 const ENTITY* entity_lookup(const char* name, size_t name_size);
 
+/* Value of a hexadecimal digit of a numeric character reference ("&#x...;").
+ * Shared by the HTML and the plain text renderers. */
+unsigned entity_hex_val(char ch);
+
 
 #endif  /* MD4C_ENTITY_H */
@@ -4,6 +4,7 @@
 #include <d3d10_1.h>
 #include <d3d10.h>
 #include <tchar.h>
+#include <string.h>
 #include <string>
 #include <vector>
 #include <map>
@@ -43,10 +44,31 @@ void CleanupRenderTarget();
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 std::string OpenFileDialog();
 void SaveTextToFile(const std::string& text, const std::string& filename);
-void RenderFormattedText(const std::string& html);
+void RenderFormattedText(const char* html, size_t html_size);
 HTMLTag ParseHTMLTag(const std::string& tag);
 bool InitializeFonts();
 
+// Editor text storage: a zero-terminated std::vector<char> edited in place by InputTextMultiline(),
+// so the editor never copies the document when it gains or loses focus.
+static int TextStorageGetLength(ImGuiInputTextStorage* storage) {
+    return (int)((std::vector<char>*)storage->UserData)->size() - 1;
+}
+
+static const char* TextStorageGetSpan(ImGuiInputTextStorage* storage, int pos, int len) {
+    (void)len;
+    return ((std::vector<char>*)storage->UserData)->data() + pos;
+}
+
+static void TextStorageInsertChars(ImGuiInputTextStorage* storage, int pos, const char* text, int text_len) {
+    std::vector<char>* text_buffer = (std::vector<char>*)storage->UserData;
+    text_buffer->insert(text_buffer->begin() + pos, text, text + text_len);
+}
+
+static void TextStorageDeleteChars(ImGuiInputTextStorage* storage, int pos, int len) {
+    std::vector<char>* text_buffer = (std::vector<char>*)storage->UserData;
+    text_buffer->erase(text_buffer->begin() + pos, text_buffer->begin() + pos + len);
+}
+
 // font initialization with more elegant fonts
 bool InitializeFonts() {
     ImGuiIO& io = ImGui::GetIO();
@@ -130,7 +152,20 @@ int main(int, char**)
     bool show_demo_window = false;
     bool show_another_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
-    std::vector<char> text_buffer(2048);
+    std::vector<char> text_buffer(1, '\0');
+    ImU32 text_generation = 0; // Changed when the text is replaced outside of the editor
+    ImGuiInputTextStorage text_storage;
+    text_storage.UserData = &text_buffer;
+    text_storage.GetLengthFn = TextStorageGetLength;
+    text_storage.GetSpanFn = TextStorageGetSpan;
+    text_storage.InsertCharsFn = TextStorageInsertChars;
+    text_storage.DeleteCharsFn = TextStorageDeleteChars;
+    MD_HTML_BUFFER html_buffer = {};
+    MD_PARSE_LIMITS preview_limits = {};   // Keep the frame responsive on huge or hostile documents
+    preview_limits.max_marks = 100000;
+    preview_limits.max_block_bytes = 64 * 1024 * 1024;
+    preview_limits.max_nesting = 64;
+    preview_limits.max_time_ms = 50;
 
     // Main loop
     bool done = false;
@@ -183,6 +218,7 @@ int main(int, char**)
                     {
                         text_buffer.assign(file_content.begin(), file_content.end());
                         text_buffer.push_back('\0');
+                        text_generation++;
                     }
                 }
                 if (ImGui::MenuItem("Save"))
@@ -206,25 +242,28 @@ int main(int, char**)
             ImGui::Columns(2, nullptr, true);
 
             // Editor pane
-            ImGui::InputTextMultiline("##source", text_buffer.data(), text_buffer.size(),
+            ImGui::SetNextItemTextGeneration(text_generation);
+            ImGui::InputTextMultiline("##source", &text_storage,
                 ImVec2(available_size.x * 0.5f, available_size.y),
-                ImGuiInputTextFlags_AllowTabInput | ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_NoHorizontalScroll);
+                ImGuiInputTextFlags_AllowTabInput | ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_WordWrap);
 
             // Preview pane
             ImGui::NextColumn();
             ImGui::BeginChild("Preview", ImVec2(0, 0), true);
 
             // Convert markdown to HTML and render
-            std::string markdown_text = text_buffer.data();
-            std::string html_output;
-            md_html(markdown_text.c_str(), markdown_text.size(),
-                [](const MD_CHAR* text, MD_SIZE size, void* userdata) {
-                    std::string* output = static_cast<std::string*>(userdata);
-                    output->append(text, size);
-                },
-                &html_output, MD_DIALECT_GITHUB, MD_HTML_FLAG_DEBUG);
-
-            RenderFormattedText(html_output);
+            // text_buffer is zero-terminated: parse it and render the HTML in place, without copying either.
+            html_buffer.size = 0;
+            int md_ret = md_html_buffer(text_buffer.data(), (MD_SIZE)(text_buffer.size() - 1),
+                &html_buffer, MD_DIALECT_GITHUB, MD_HTML_FLAG_DEBUG, &preview_limits);
+
+            // On MD_PARSE_LIMIT_EXCEEDED the buffer still holds the part rendered so far: show it as a partial preview.
+            if (md_ret == MD_PARSE_LIMIT_EXCEEDED)
+                ImGui::TextDisabled("(Preview truncated: the document is too large or too complex.)");
+            else if (md_ret != 0)
+                ImGui::TextDisabled("(Preview failed.)");
+            if (md_ret == 0 || md_ret == MD_PARSE_LIMIT_EXCEEDED)
+                RenderFormattedText(html_buffer.data ? html_buffer.data : "", html_buffer.size);
 
             ImGui::EndChild();
             ImGui::End();
@@ -241,6 +280,7 @@ int main(int, char**)
     }
 
     // Cleanup
+    free(html_buffer.data);
     ImGui_ImplDX10_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
@@ -339,7 +379,7 @@ void SaveTextToFile(const std::string& text, const std::string& filename)
 }
 
 
-void RenderFormattedText(const std::string& html) {
+void RenderFormattedText(const char* html, size_t html_size) {
     // Set up preview styling with dark background and white text
     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.1f, 0.1f, 0.12f, 1.0f));
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.9f, 0.9f, 0.9f, 1.0f));
@@ -349,8 +389,9 @@ void RenderFormattedText(const std::string& html) {
     ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8.0f, 4.0f));
     ImGui::PushStyleVar(ImGuiStyleVar_ItemInnerSpacing, ImVec2(6.0f, 6.0f));
 
-    std::string::size_type pos = 0;
-    std::string::size_type last_pos = 0;
+    const char* html_end = html + html_size;
+    const char* pos = NULL;
+    const char* last_pos = html;
     std::vector<HTMLTag> tag_stack;
     bool in_ordered_list = false;
     bool in_code_block = false;
@@ -366,10 +407,12 @@ void RenderFormattedText(const std::string& html) {
         16.0f   // h6
     };
 
-    while ((pos = html.find('<', last_pos)) != std::string::npos) {
+    while ((pos = (const char*)memchr(last_pos, '<', (size_t)(html_end - last_pos))) != NULL) {
         if (pos > last_pos) {
-            std::string text = html.substr(last_pos, pos - last_pos);
-            if (!text.empty() && text != "\n") {
+            // Text runs are rendered straight out of the HTML buffer
+            const char* text = last_pos;
+            const char* text_end = pos;
+            if (!(text_end - text == 1 && text[0] == '\n')) {
                 ImVec4 text_color = ImVec4(0.9f, 0.9f, 0.9f, 1.0f);
                 bool is_bold = false;
                 bool is_italic = false;
@@ -400,7 +443,7 @@ void RenderFormattedText(const std::string& html) {
                 if (in_code_block) {
                     ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
                     ImGui::BeginChild("CodeBlock", ImVec2(0, 0), true, ImGuiWindowFlags_NoScrollbar);
-                    ImGui::TextUnformatted(text.c_str());
+                    ImGui::TextUnformatted(text, text_end);
                     ImGui::EndChild();
                     ImGui::PopStyleColor();
                 }
@@ -415,7 +458,7 @@ void RenderFormattedText(const std::string& html) {
 
                     ImGui::PushStyleColor(ImGuiCol_Text, text_color);
                     ImGui::PushTextWrapPos(ImGui::GetContentRegionAvail().x);
-                    ImGui::TextUnformatted(text.c_str());
+                    ImGui::TextUnformatted(text, text_end);
                     ImGui::PopTextWrapPos();
                     ImGui::PopStyleColor();
 
@@ -434,7 +477,7 @@ void RenderFormattedText(const std::string& html) {
                     }
 
                     ImGui::PushTextWrapPos(ImGui::GetContentRegionAvail().x);
-                    ImGui::TextUnformatted(text.c_str());
+                    ImGui::TextUnformatted(text, text_end);
                     ImGui::PopTextWrapPos();
 
                     if (in_ordered_list) {
@@ -447,10 +490,10 @@ void RenderFormattedText(const std::string& html) {
         }
 
         // Process tags
-        std::string::size_type end_pos = html.find('>', pos);
-        if (end_pos == std::string::npos) break;
+        const char* end_pos = (const char*)memchr(pos, '>', (size_t)(html_end - pos));
+        if (end_pos == NULL) break;
 
-        HTMLTag tag = ParseHTMLTag(html.substr(pos + 1, end_pos - pos - 1));
+        HTMLTag tag = ParseHTMLTag(std::string(pos + 1, end_pos));
 
         // Handle ordered lists
         if (tag.tag == "ol") {
@@ -24,6 +24,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "md4c-html.h"
@@ -45,6 +46,27 @@
 #define snprintf _snprintf
 #endif
 
+/* SIMD scanning of the text to escape. SSE2 is the baseline on x86-64 (and
+ * on 32-bit x86 when the compiler is told so); AVX2 is used when the CPU
+ * reports it at runtime. Define MD4C_HTML_NO_SIMD to use only the scalar
+ * loops. */
+#if !defined MD4C_HTML_NO_SIMD && !defined MD4C_USE_UTF16
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define MD_HTML_USE_SSE2
+#include <emmintrin.h>
+#if defined _MSC_VER
+#define MD_HTML_USE_AVX2
+#define MD_HTML_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#elif (defined __GNUC__ && __GNUC__ >= 5) || (defined __clang__ && __clang_major__ >= 4)
+#define MD_HTML_USE_AVX2
+#define MD_HTML_TARGET_AVX2     __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+#endif
+
 
 
 typedef struct MD_HTML_tag MD_HTML;
@@ -53,12 +75,49 @@ struct MD_HTML_tag {
     void* userdata;
     unsigned flags;
     int image_nesting_level;
-    char escape_map[256];
+
+#ifdef MD_HTML_USE_SSE2
+    /* Vectorized skipping over characters which need no escaping. */
+    MD_OFFSET (*skip_html_safe)(const MD_CHAR*, MD_OFFSET, MD_SIZE);
+    MD_OFFSET (*skip_url_safe)(const MD_CHAR*, MD_OFFSET, MD_SIZE);
+#endif
+
+    /* Output staging area. For plain md_html() it stays empty so every
+     * fragment goes straight to process_output(). */
+    MD_CHAR* out;
+    MD_SIZE out_size;
+    MD_SIZE out_capacity;
+    MD_HTML_BUFFER* out_buffer; /* Set if 'out' is the caller's growable buffer. */
+    int error;
 };
 
 #define NEED_HTML_ESC_FLAG   0x1
 #define NEED_URL_ESC_FLAG    0x2
 
+/* Map of characters which need escaping (bitmask of NEED_xxx_ESC_FLAG):
+ *
+ *  -- HTML: '"', '&', '<', '>' and '\0'.
+ *  -- URL: Anything but '\0', alphanumerics and "~-_.+!*(),%#@?=;:/$".
+ */
+static const char escape_map[256] = {
+    /* 0x00 */ 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0x10 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0x20 */ 2, 0, 3, 0, 0, 0, 3, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x30 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 3, 0,
+    /* 0x40 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x50 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 0,
+    /* 0x60 */ 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x70 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 0, 2,
+    /* 0x80 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0x90 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xa0 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xb0 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xc0 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xd0 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xe0 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    /* 0xf0 */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
+};
+
 
 /*****************************************
  ***  HTML rendering helper functions  ***
@@ -70,10 +129,57 @@ struct MD_HTML_tag {
 #define ISALNUM(ch)     (ISLOWER(ch) || ISUPPER(ch) || ISDIGIT(ch))
 
 
+static void
+render_verbatim_slow(MD_HTML* r, const MD_CHAR* text, MD_SIZE size)
+{
+    if (r->out_buffer != NULL) {
+        /* Grow the caller's buffer geometrically. */
+        MD_SIZE new_capacity = r->out_capacity + r->out_capacity / 2;
+        MD_CHAR* new_out;
+
+        if (new_capacity < r->out_size + size)
+            new_capacity = r->out_size + size;
+        if (new_capacity < 256)
+            new_capacity = 256;
+        new_out = (MD_CHAR*)realloc(r->out, new_capacity * sizeof(MD_CHAR));
+        if (new_out == NULL) {
+            r->error = -1;
+            return;
+        }
+        r->out = new_out;
+        r->out_capacity = new_capacity;
+        r->out_buffer->data = new_out;
+        r->out_buffer->capacity = new_capacity;
+    }
+    else {
+        /* Flush the staged chunk. Fragments which would not fit into an empty
+         * chunk anyway are passed through without copying. */
+        if (r->out_size > 0) {
+            r->process_output(r->out, r->out_size, r->userdata);
+            r->out_size = 0;
+        }
+        if (size >= r->out_capacity) {
+            r->process_output(text, size, r->userdata);
+            return;
+        }
+    }
+
+    memcpy(r->out + r->out_size, text, size * sizeof(MD_CHAR));
+    r->out_size += size;
+}
+
 static inline void
 render_verbatim(MD_HTML* r, const MD_CHAR* text, MD_SIZE size)
 {
-    r->process_output(text, size, r->userdata);
+    /* With plain md_html(), there is no staging area so we always take the
+     * slow path which calls process_output() directly. */
+    if (r->out != NULL && r->out_size + size <= r->out_capacity) {
+        memcpy(r->out + r->out_size, text, size * sizeof(MD_CHAR));
+        r->out_size += size;
+        return;
+    }
+
+    render_verbatim_slow(r, text, size);
 }
 
 /* Keep this as a macro. Most compiler should then be smart enough to replace
@@ -82,6 +188,202 @@ render_verbatim(MD_HTML* r, const MD_CHAR* text, MD_SIZE size)
         render_verbatim((r), (verbatim), (MD_SIZE) (strlen(verbatim)))
 
 
+#ifdef MD_HTML_USE_SSE2
+
+/* The vector predicates below must mirror escape_map[] exactly:
+ *
+ *  -- HTML: '"', '&', '<', '>' and '\0'.
+ *  -- URL: Anything but '\0', alphanumerics and "~-_.+!*(),%#@?=;:/$"; i.e.
+ *     other control chars, space, non-ASCII bytes and the 13 remaining ASCII
+ *     punctuation chars.
+ *
+ * The skip functions return the offset of the first char which needs
+ * escaping, or the offset where fewer than a full vector of chars remains.
+ * Callers finish the tail with the scalar loop.
+ */
+
+/* Unsigned range check: lo <= ch <= hi. */
+#define SSE2_IN_RANGE(v, lo, hi)                                            \
+        _mm_cmpeq_epi8(_mm_min_epu8(_mm_sub_epi8((v), _mm_set1_epi8((char)(lo))), \
+                                    _mm_set1_epi8((char)((hi) - (lo)))),    \
+                       _mm_sub_epi8((v), _mm_set1_epi8((char)(lo))))
+
+static inline __m128i
+sse2_need_html_esc(__m128i v)
+{
+    __m128i m;
+
+    m = _mm_cmpeq_epi8(v, _mm_setzero_si128());
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('&')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('<')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+    return m;
+}
+
+static inline __m128i
+sse2_need_url_esc(__m128i v)
+{
+    __m128i m;
+
+    m = SSE2_IN_RANGE(v, 0x01, ' ');
+    m = _mm_or_si128(m, SSE2_IN_RANGE(v, 0x7f, 0xff));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+    m = _mm_or_si128(m, SSE2_IN_RANGE(v, '&', '\''));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('<')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+    m = _mm_or_si128(m, SSE2_IN_RANGE(v, '[', '^'));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('`')));
+    m = _mm_or_si128(m, SSE2_IN_RANGE(v, '{', '}'));
+    return m;
+}
+
+static inline unsigned
+md_html_ctz(unsigned mask)
+{
+#if defined _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+static MD_OFFSET
+skip_html_safe_sse2(const MD_CHAR* data, MD_OFFSET off, MD_SIZE size)
+{
+    while (off + 16 <= size) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(sse2_need_html_esc(v));
+        if (mask != 0)
+            return off + md_html_ctz(mask);
+        off += 16;
+    }
+    return off;
+}
+
+static MD_OFFSET
+skip_url_safe_sse2(const MD_CHAR* data, MD_OFFSET off, MD_SIZE size)
+{
+    while (off + 16 <= size) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(sse2_need_url_esc(v));
+        if (mask != 0)
+            return off + md_html_ctz(mask);
+        off += 16;
+    }
+    return off;
+}
+
+#ifdef MD_HTML_USE_AVX2
+
+#define AVX2_IN_RANGE(v, lo, hi)                                            \
+        _mm256_cmpeq_epi8(_mm256_min_epu8(_mm256_sub_epi8((v), _mm256_set1_epi8((char)(lo))), \
+                                          _mm256_set1_epi8((char)((hi) - (lo)))), \
+                          _mm256_sub_epi8((v), _mm256_set1_epi8((char)(lo))))
+
+MD_HTML_TARGET_AVX2 static MD_OFFSET
+skip_html_safe_avx2(const MD_CHAR* data, MD_OFFSET off, MD_SIZE size)
+{
+    while (off + 32 <= size) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + off));
+        __m256i m;
+        unsigned mask;
+
+        m = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('&')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')));
+        mask = (unsigned)_mm256_movemask_epi8(m);
+        if (mask != 0)
+            return off + md_html_ctz(mask);
+        off += 32;
+    }
+
+    /* Finish with one 16-byte step here rather than calling the SSE2 variant:
+     * Mixing legacy SSE code with dirty upper YMM halves is very slow on some
+     * CPUs. */
+    if (off + 16 <= size) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(sse2_need_html_esc(v));
+        if (mask != 0)
+            return off + md_html_ctz(mask);
+        off += 16;
+    }
+    return off;
+}
+
+MD_HTML_TARGET_AVX2 static MD_OFFSET
+skip_url_safe_avx2(const MD_CHAR* data, MD_OFFSET off, MD_SIZE size)
+{
+    while (off + 32 <= size) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + off));
+        __m256i m;
+        unsigned mask;
+
+        m = AVX2_IN_RANGE(v, 0x01, ' ');
+        m = _mm256_or_si256(m, AVX2_IN_RANGE(v, 0x7f, 0xff));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+        m = _mm256_or_si256(m, AVX2_IN_RANGE(v, '&', '\''));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')));
+        m = _mm256_or_si256(m, AVX2_IN_RANGE(v, '[', '^'));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('`')));
+        m = _mm256_or_si256(m, AVX2_IN_RANGE(v, '{', '}'));
+        mask = (unsigned)_mm256_movemask_epi8(m);
+        if (mask != 0)
+            return off + md_html_ctz(mask);
+        off += 32;
+    }
+
+    /* Finish with one 16-byte step here rather than calling the SSE2 variant:
+     * Mixing legacy SSE code with dirty upper YMM halves is very slow on some
+     * CPUs. */
+    if (off + 16 <= size) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(sse2_need_url_esc(v));
+        if (mask != 0)
+            return off + md_html_ctz(mask);
+        off += 16;
+    }
+    return off;
+}
+
+static int
+md_html_cpu_has_avx2(void)
+{
+    static int has_avx2 = -1;
+
+    if (has_avx2 < 0) {
+#if defined _MSC_VER
+        int info[4];
+
+        has_avx2 = 0;
+        __cpuid(info, 0);
+        if (info[0] >= 7) {
+            __cpuid(info, 1);
+            /* Check OSXSAVE + AVX, and that the OS saves the YMM state. */
+            if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                has_avx2 = ((info[1] & (1 << 5)) != 0);
+            }
+        }
+#else
+        __builtin_cpu_init();
+        has_avx2 = (__builtin_cpu_supports("avx2") != 0);
+#endif
+    }
+
+    return has_avx2;
+}
+
+#endif  /* MD_HTML_USE_AVX2 */
+
+#endif  /* MD_HTML_USE_SSE2 */
+
+
 static void
 render_html_escaped(MD_HTML* r, const MD_CHAR* data, MD_SIZE size)
 {
@@ -89,9 +391,12 @@ render_html_escaped(MD_HTML* r, const MD_CHAR* data, MD_SIZE size)
     MD_OFFSET off = 0;
 
     /* Some characters need to be escaped in normal HTML text. */
-#define NEED_HTML_ESC(ch)   (r->escape_map[(unsigned char)(ch)] & NEED_HTML_ESC_FLAG)
+#define NEED_HTML_ESC(ch)   (escape_map[(unsigned char)(ch)] & NEED_HTML_ESC_FLAG)
 
     while (1) {
+#ifdef MD_HTML_USE_SSE2
+        off = r->skip_html_safe(data, off, size);
+#endif
         /* Optimization: Use some loop unrolling. */
         while (off + 3 < size && !NEED_HTML_ESC(data[off + 0]) && !NEED_HTML_ESC(data[off + 1])
             && !NEED_HTML_ESC(data[off + 2]) && !NEED_HTML_ESC(data[off + 3]))
@@ -126,9 +431,12 @@ render_url_escaped(MD_HTML* r, const MD_CHAR* data, MD_SIZE size)
     MD_OFFSET off = 0;
 
     /* Some characters need to be escaped in URL attributes. */
-#define NEED_URL_ESC(ch)    (r->escape_map[(unsigned char)(ch)] & NEED_URL_ESC_FLAG)
+#define NEED_URL_ESC(ch)    (escape_map[(unsigned char)(ch)] & NEED_URL_ESC_FLAG)
 
     while (1) {
+#ifdef MD_HTML_USE_SSE2
+        off = r->skip_url_safe(data, off, size);
+#endif
         while (off < size && !NEED_URL_ESC(data[off]))
             off++;
         if (off > beg)
@@ -156,17 +464,6 @@ render_url_escaped(MD_HTML* r, const MD_CHAR* data, MD_SIZE size)
     }
 }
 
-static unsigned
-hex_val(char ch)
-{
-    if ('0' <= ch && ch <= '9')
-        return ch - '0';
-    if ('A' <= ch && ch <= 'Z')
-        return ch - 'A' + 10;
-    else
-        return ch - 'a' + 10;
-}
-
 static void
 render_utf8_codepoint(MD_HTML* r, unsigned codepoint,
     void (*fn_append)(MD_HTML*, const MD_CHAR*, MD_SIZE))
@@ -224,7 +521,7 @@ render_entity(MD_HTML* r, const MD_CHAR* text, MD_SIZE size,
             /* Hexadecimal entity (e.g. "&#x1234abcd;")). */
             MD_SIZE i;
             for (i = 3; i < size - 1; i++)
-                codepoint = 16 * codepoint + hex_val(text[i]);
+                codepoint = 16 * codepoint + entity_hex_val(text[i]);
         }
         else {
             /* Decimal entity (e.g. "&1234;") */
@@ -530,45 +827,233 @@ debug_log_callback(const char* msg, void* userdata)
         fprintf(stderr, "MD4C: %s\n", msg);
 }
 
+static const MD_PARSER md_html_parser = {
+    MD_PARSER_ABI_VERSION,
+    0,
+    enter_block_callback,
+    leave_block_callback,
+    enter_span_callback,
+    leave_span_callback,
+    text_callback,
+    debug_log_callback,
+    NULL,
+    NULL
+};
+
+static void
+md_html_init_parser(MD_PARSER* parser, unsigned parser_flags, const MD_PARSE_LIMITS* limits)
+{
+    *parser = md_html_parser;
+    parser->flags = parser_flags;
+    parser->limits = limits;
+}
+
+static void
+md_html_init(MD_HTML* r)
+{
+#ifdef MD_HTML_USE_SSE2
+    r->skip_html_safe = skip_html_safe_sse2;
+    r->skip_url_safe = skip_url_safe_sse2;
+#ifdef MD_HTML_USE_AVX2
+    if (md_html_cpu_has_avx2()) {
+        r->skip_html_safe = skip_html_safe_avx2;
+        r->skip_url_safe = skip_url_safe_avx2;
+    }
+#endif
+#endif
+}
+
+static int
+md_html_render(MD_HTML* r, MD_PARSE_CONTEXT* context, const MD_PARSER* parser,
+    const MD_CHAR* input, MD_SIZE input_size)
+{
+    /* Consider skipping UTF-8 byte order mark (BOM). */
+    if (r->flags & MD_HTML_FLAG_SKIP_UTF8_BOM && sizeof(MD_CHAR) == 1) {
+        static const MD_CHAR bom[3] = { (char)0xef, (char)0xbb, (char)0xbf };
+        if (input_size >= sizeof(bom) && memcmp(input, bom, sizeof(bom)) == 0) {
+            input += sizeof(bom);
+            input_size -= sizeof(bom);
+        }
+    }
+
+    if (context != NULL)
+        return md_parse_with_context(context, input, input_size, parser, (void*)r);
+    else
+        return md_parse(input, input_size, parser, (void*)r);
+}
+
 int
 md_html(const MD_CHAR* input, MD_SIZE input_size,
     void (*process_output)(const MD_CHAR*, MD_SIZE, void*),
     void* userdata, unsigned parser_flags, unsigned renderer_flags)
 {
-    MD_HTML render = { process_output, userdata, renderer_flags, 0, { 0 } };
-    int i;
+    return md_html_ex(input, input_size, process_output, userdata,
+                      parser_flags, renderer_flags, NULL);
+}
+
+int
+md_html_ex(const MD_CHAR* input, MD_SIZE input_size,
+    void (*process_output)(const MD_CHAR*, MD_SIZE, void*),
+    void* userdata, unsigned parser_flags, unsigned renderer_flags,
+    const MD_PARSE_LIMITS* limits)
+{
+    MD_HTML render;
+    MD_PARSER parser;
+
+    memset(&render, 0, sizeof(MD_HTML));
+    render.process_output = process_output;
+    render.userdata = userdata;
+    render.flags = renderer_flags;
+    md_html_init(&render);
+    md_html_init_parser(&parser, parser_flags, limits);
+    return md_html_render(&render, NULL, &parser, input, input_size);
+}
 
-    MD_PARSER parser = {
-        0,
-        parser_flags,
-        enter_block_callback,
-        leave_block_callback,
-        enter_span_callback,
-        leave_span_callback,
-        text_callback,
-        debug_log_callback,
-        NULL
-    };
+int
+md_html_chunked(const MD_CHAR* input, MD_SIZE input_size,
+    void (*process_output)(const MD_CHAR*, MD_SIZE, void*),
+    void* userdata, unsigned parser_flags, unsigned renderer_flags,
+    const MD_PARSE_LIMITS* limits)
+{
+    MD_HTML render;
+    MD_PARSER parser;
+    MD_CHAR chunk[MD_HTML_CHUNK_SIZE];
+    int ret;
+
+    memset(&render, 0, sizeof(MD_HTML));
+    render.process_output = process_output;
+    render.userdata = userdata;
+    render.flags = renderer_flags;
+    render.out = chunk;
+    render.out_capacity = MD_HTML_CHUNK_SIZE;
+
+    md_html_init(&render);
+    md_html_init_parser(&parser, parser_flags, limits);
+    ret = md_html_render(&render, NULL, &parser, input, input_size);
+
+    /* Flush the tail, even if the parsing has been aborted. */
+    if (render.out_size > 0)
+        process_output(render.out, render.out_size, userdata);
+    return ret;
+}
+
+int
+md_html_buffer(const MD_CHAR* input, MD_SIZE input_size, MD_HTML_BUFFER* buffer,
+    unsigned parser_flags, unsigned renderer_flags, const MD_PARSE_LIMITS* limits)
+{
+    MD_HTML render;
+    MD_PARSER parser;
+    int ret;
+
+    memset(&render, 0, sizeof(MD_HTML));
+    render.flags = renderer_flags;
+    render.out = buffer->data;
+    render.out_size = buffer->size;
+    render.out_capacity = buffer->capacity;
+    render.out_buffer = buffer;
+
+    md_html_init(&render);
+    md_html_init_parser(&parser, parser_flags, limits);
+    ret = md_html_render(&render, NULL, &parser, input, input_size);
+
+    buffer->size = render.out_size;
+    if (ret == 0 && render.error != 0)
+        ret = render.error;
+    return ret;
+}
+
+
+/*********************************
+ ***  Reusable renderer object  ***
+ *********************************/
 
-    /* Build map of characters which need escaping. */
-    for (i = 0; i < 256; i++) {
-        unsigned char ch = (unsigned char)i;
+struct MD_HTML_RENDERER_tag {
+    MD_HTML html;               /* Template; copied for each rendering. */
+    MD_PARSER parser;
+    MD_PARSE_LIMITS limits;     /* Copy of the caller's limits, if any. */
+    MD_PARSE_CONTEXT* context;
+    MD_CHAR chunk[MD_HTML_CHUNK_SIZE];
+};
+
+MD_HTML_RENDERER*
+md_html_renderer_create(unsigned parser_flags, unsigned renderer_flags,
+    const MD_PARSE_LIMITS* limits)
+{
+    MD_HTML_RENDERER* renderer;
 
-        if (strchr("\"&<>", ch) != NULL)
-            render.escape_map[i] |= NEED_HTML_ESC_FLAG;
+    renderer = (MD_HTML_RENDERER*)malloc(sizeof(MD_HTML_RENDERER));
+    if (renderer == NULL)
+        return NULL;
 
-        if (!ISALNUM(ch) && strchr("~-_.+!*(),%#@?=;:/,+$", ch) == NULL)
-            render.escape_map[i] |= NEED_URL_ESC_FLAG;
+    renderer->context = md_parse_context_create();
+    if (renderer->context == NULL) {
+        free(renderer);
+        return NULL;
     }
 
-    /* Consider skipping UTF-8 byte order mark (BOM). */
-    if (renderer_flags & MD_HTML_FLAG_SKIP_UTF8_BOM && sizeof(MD_CHAR) == 1) {
-        static const MD_CHAR bom[3] = { (char)0xef, (char)0xbb, (char)0xbf };
-        if (input_size >= sizeof(bom) && memcmp(input, bom, sizeof(bom)) == 0) {
-            input += sizeof(bom);
-            input_size -= sizeof(bom);
-        }
+    memset(&renderer->html, 0, sizeof(MD_HTML));
+    renderer->html.flags = renderer_flags;
+    md_html_init(&renderer->html);
+    if (limits != NULL) {
+        renderer->limits = *limits;
+        md_html_init_parser(&renderer->parser, parser_flags, &renderer->limits);
+    } else {
+        md_html_init_parser(&renderer->parser, parser_flags, NULL);
     }
+    return renderer;
+}
 
-    return md_parse(input, input_size, &parser, (void*)&render);
+int
+md_html_renderer_render(MD_HTML_RENDERER* renderer, const MD_CHAR* input, MD_SIZE input_size,
+    void (*process_output)(const MD_CHAR*, MD_SIZE, void*), void* userdata)
+{
+    MD_HTML render = renderer->html;
+    int ret;
+
+    render.process_output = process_output;
+    render.userdata = userdata;
+    render.out = renderer->chunk;
+    render.out_capacity = MD_HTML_CHUNK_SIZE;
+
+    ret = md_html_render(&render, renderer->context, &renderer->parser, input, input_size);
+
+    /* Flush the tail, even if the parsing has been aborted. */
+    if (render.out_size > 0)
+        process_output(render.out, render.out_size, userdata);
+    return ret;
+}
+
+int
+md_html_renderer_render_buffer(MD_HTML_RENDERER* renderer, const MD_CHAR* input, MD_SIZE input_size,
+    MD_HTML_BUFFER* buffer)
+{
+    MD_HTML render = renderer->html;
+    int ret;
+
+    render.out = buffer->data;
+    render.out_size = buffer->size;
+    render.out_capacity = buffer->capacity;
+    render.out_buffer = buffer;
+
+    ret = md_html_render(&render, renderer->context, &renderer->parser, input, input_size);
+
+    buffer->size = render.out_size;
+    if (ret == 0 && render.error != 0)
+        ret = render.error;
+    return ret;
+}
+
+MD_PARSE_CONTEXT*
+md_html_renderer_context(MD_HTML_RENDERER* renderer)
+{
+    return renderer->context;
+}
+
+void
+md_html_renderer_destroy(MD_HTML_RENDERER* renderer)
+{
+    if (renderer == NULL)
+        return;
+    md_parse_context_destroy(renderer->context);
+    free(renderer);
 }
@@ -61,6 +61,102 @@ extern "C" {
         void (*process_output)(const MD_CHAR*, MD_SIZE, void*),
         void* userdata, unsigned parser_flags, unsigned renderer_flags);
 
+/* Same as md_html(), with resource limits.
+ *
+ * Param limits are propagated to md_parse() (see MD_PARSE_LIMITS). May be
+ * NULL for no limits.
+ *
+ * Returns -1 on error (if md_parse() fails.)
+ * Returns MD_PARSE_LIMIT_EXCEEDED (-2) if the parsing has been cut short by
+ * the limits. The output then holds the part of the document rendered so
+ * far (with all its open tags closed), so it is still usable as a preview.
+ * Returns 0 on success.
+ */
+    int md_html_ex(const MD_CHAR* input, MD_SIZE input_size,
+        void (*process_output)(const MD_CHAR*, MD_SIZE, void*),
+        void* userdata, unsigned parser_flags, unsigned renderer_flags,
+        const MD_PARSE_LIMITS* limits);
+
+
+/* Size (in MD_CHAR units) of the chunks md_html_chunked() stages the output in. */
+#define MD_HTML_CHUNK_SIZE                  4096
+
+/* Same as md_html_ex(), but the small fragments the renderer produces (tags,
+ * escape sequences, text runs) are first collected in an internal buffer
+ * and process_output() only gets called with chunks of up to
+ * MD_HTML_CHUNK_SIZE characters.
+ */
+    int md_html_chunked(const MD_CHAR* input, MD_SIZE input_size,
+        void (*process_output)(const MD_CHAR*, MD_SIZE, void*),
+        void* userdata, unsigned parser_flags, unsigned renderer_flags,
+        const MD_PARSE_LIMITS* limits);
+
+
+/* Growable output buffer for md_html_buffer().
+ *
+ * The buffer is owned by the caller: It may start zero-initialized or
+ * preallocated, and md_html_buffer() enlarges it with realloc() as needed.
+ * Release it with free(data) when no longer needed.
+ *
+ * Reusing the same buffer for subsequent calls (after resetting size to zero)
+ * avoids any reallocation once it has grown large enough.
+ */
+    typedef struct MD_HTML_BUFFER {
+        MD_CHAR* data;          /* Output, not zero-terminated. */
+        MD_SIZE size;           /* Count of used MD_CHARs in data. */
+        MD_SIZE capacity;       /* Count of allocated MD_CHARs in data. */
+    } MD_HTML_BUFFER;
+
+/* Render Markdown into HTML, appending the output to the given buffer.
+ *
+ * The output is appended after the first buffer->size characters already
+ * present in the buffer.
+ *
+ * Returns -1 on error (if md_parse() fails or the buffer cannot grow).
+ * Returns MD_PARSE_LIMIT_EXCEEDED (-2) if the parsing has been cut short by
+ * the limits; buffer->size then covers the part rendered so far.
+ * Returns 0 on success.
+ */
+    int md_html_buffer(const MD_CHAR* input, MD_SIZE input_size, MD_HTML_BUFFER* buffer,
+        unsigned parser_flags, unsigned renderer_flags, const MD_PARSE_LIMITS* limits);
+
+
+/* Reusable renderer.
+ *
+ * The functions above set up the renderer and the parser anew on each call,
+ * which is a noticeable part of the time spent on small documents. The
+ * renderer object keeps the setup (for the given flags) together with its
+ * own persistent parse context (see md_parse_context_create()), so callers
+ * converting many documents can reuse it for all of them.
+ *
+ * The renderer must not be used by more threads at the same time.
+ */
+    typedef struct MD_HTML_RENDERER_tag MD_HTML_RENDERER;
+
+/* Create the renderer. Returns NULL if the memory allocation fails.
+ * Param parser_flags are flags from md4c.h propagated to md_parse().
+ * Param render_flags is bitmask of MD_HTML_FLAG_xxxx.
+ * Param limits are copied into the renderer and apply to every rendering.
+ * May be NULL for no limits.
+ */
+    MD_HTML_RENDERER* md_html_renderer_create(unsigned parser_flags, unsigned renderer_flags,
+        const MD_PARSE_LIMITS* limits);
+
+/* Same as md_html_chunked() but with the renderer's flags and limits. */
+    int md_html_renderer_render(MD_HTML_RENDERER* renderer, const MD_CHAR* input, MD_SIZE input_size,
+        void (*process_output)(const MD_CHAR*, MD_SIZE, void*), void* userdata);
+
+/* Same as md_html_buffer() but with the renderer's flags and limits. */
+    int md_html_renderer_render_buffer(MD_HTML_RENDERER* renderer, const MD_CHAR* input, MD_SIZE input_size,
+        MD_HTML_BUFFER* buffer);
+
+/* Parse context used by the renderer, e.g. for md_parse_context_set_threads().
+ * It is owned by the renderer. */
+    MD_PARSE_CONTEXT* md_html_renderer_context(MD_HTML_RENDERER* renderer);
+
+/* Release all resources of the renderer. */
+    void md_html_renderer_destroy(MD_HTML_RENDERER* renderer);
+
 
 #ifdef __cplusplus
 }  /* extern "C" { */
@@ -0,0 +1,859 @@
+/*
+ * MD4C: Markdown parser for C
+ * (http://github.com/mity/md4c)
+ *
+ * Copyright (c) 2016-2024 Martin Mit
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "md4c-stream.h"
+
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 199409L
+ /* C89/90 or old compilers in general may not understand "inline". */
+#if defined __GNUC__
+#define inline __inline__
+#elif defined _MSC_VER
+#define inline __inline
+#else
+#define inline
+#endif
+#endif
+
+
+/* Stream layout (all items are 32-bit words):
+ *
+ * Header:
+ *  [0] MD_STREAM_MAGIC
+ *  [1] MD_STREAM_VERSION | (sizeof(MD_CHAR) << 16)
+ *  [2] parser flags
+ *  [3] size of the source text
+ *  [4] md_stream_hash() of the source text
+ *  [5] reserved (zero)
+ *
+ * Records start with a record header word: Event type in bits 0-3, the
+ * block/span/text type in bits 8-15 and the REC_xxx flags. Then:
+ *  -- block/span without detail: nothing more.
+ *  -- block/span with REC_DETAIL: The detail (see md_stream_put_detail()).
+ *  -- block/span with REC_BACKREF: Position of an earlier record whose
+ *     detail is the same (leave events usually repeat the enter's detail).
+ *  -- text: Size and offset of the text in the source.
+ *  -- text with REC_INLINE: Size and the text itself, padded to whole words.
+ */
+#define MD_STREAM_MAGIC         0x5334444d      /* "MD4S" */
+#define MD_STREAM_HEADER_SIZE   6
+
+#define REC_EVENT_MASK          0x0000000f
+#define REC_INLINE              0x00000010
+#define REC_DETAIL              0x00000020
+#define REC_BACKREF             0x00000040
+#define REC_TYPE_SHIFT          8
+#define REC_TYPE_MASK           0x0000ff00
+
+/* Attribute flags. */
+#define ATTR_INLINE             0x00000001
+#define ATTR_NULL               0x00000002
+
+#define WORDS_FOR_CHARS(n)      (((n) * sizeof(MD_CHAR) + sizeof(unsigned) - 1) / sizeof(unsigned))
+
+/* MD_ATTRIBUTE::substr_types points directly into the stream. */
+typedef char MD_STREAM_TEXTTYPE_CHECK[sizeof(MD_TEXTTYPE) == sizeof(unsigned) ? 1 : -1];
+
+
+unsigned
+md_stream_hash(const MD_CHAR* text, MD_SIZE size)
+{
+    const unsigned char* bytes = (const unsigned char*)text;
+    size_t n = (size_t)size * sizeof(MD_CHAR);
+    unsigned hash = 2166136261U;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+
+/*****************
+ ***  Writing  ***
+ *****************/
+
+typedef struct MD_STREAM_RECORDER_tag MD_STREAM_RECORDER;
+struct MD_STREAM_RECORDER_tag {
+    MD_STREAM* stream;
+    const MD_CHAR* text;
+    MD_SIZE size;
+
+    /* Stack of open blocks and spans: Record position and detail size of
+     * the enter records (or -1 if the enter has no detail). */
+    MD_SIZE* stack;
+    int n_stack;
+    int alloc_stack;
+
+    int error;
+};
+
+static int
+md_stream_reserve(MD_STREAM_RECORDER* r, MD_SIZE n)
+{
+    MD_STREAM* stream = r->stream;
+
+    if (stream->size + n > stream->capacity) {
+        MD_SIZE capacity = stream->capacity + stream->capacity / 2;
+        unsigned* data;
+
+        if (capacity < stream->size + n)
+            capacity = stream->size + n;
+        if (capacity < 256)
+            capacity = 256;
+        data = (unsigned*)realloc(stream->data, capacity * sizeof(unsigned));
+        if (data == NULL) {
+            r->error = -1;
+            return -1;
+        }
+        stream->data = data;
+        stream->capacity = capacity;
+    }
+    return 0;
+}
+
+static inline void
+md_stream_put(MD_STREAM_RECORDER* r, unsigned word)
+{
+    if (md_stream_reserve(r, 1) == 0)
+        r->stream->data[r->stream->size++] = word;
+}
+
+static void
+md_stream_put_chars(MD_STREAM_RECORDER* r, const MD_CHAR* text, MD_SIZE size)
+{
+    MD_SIZE n = WORDS_FOR_CHARS(size);
+
+    if (md_stream_reserve(r, n) != 0)
+        return;
+    r->stream->data[r->stream->size + n - 1] = 0;   /* Zero the padding. */
+    memcpy(r->stream->data + r->stream->size, text, size * sizeof(MD_CHAR));
+    r->stream->size += n;
+}
+
+static inline int
+md_stream_in_source(MD_STREAM_RECORDER* r, const MD_CHAR* text, MD_SIZE size)
+{
+    return (text >= r->text && text + size <= r->text + r->size);
+}
+
+static void
+md_stream_put_attribute(MD_STREAM_RECORDER* r, const MD_ATTRIBUTE* attr)
+{
+    MD_SIZE n_substrs = 0;
+    MD_SIZE i;
+
+    if (attr->substr_offsets != NULL) {
+        while (attr->substr_offsets[n_substrs] < attr->size)
+            n_substrs++;
+    }
+
+    if (attr->text == NULL) {
+        md_stream_put(r, ATTR_NULL);
+        md_stream_put(r, attr->size);
+    } else if (md_stream_in_source(r, attr->text, attr->size)) {
+        md_stream_put(r, 0);
+        md_stream_put(r, attr->size);
+        md_stream_put(r, (unsigned)(attr->text - r->text));
+    } else {
+        md_stream_put(r, ATTR_INLINE);
+        md_stream_put(r, attr->size);
+        md_stream_put_chars(r, attr->text, attr->size);
+    }
+
+    md_stream_put(r, n_substrs);
+    for (i = 0; i < n_substrs; i++)
+        md_stream_put(r, (unsigned)attr->substr_types[i]);
+    for (i = 0; i <= n_substrs; i++)
+        md_stream_put(r, (attr->substr_offsets != NULL ? attr->substr_offsets[i] : 0));
+}
+
+static int
+md_stream_has_detail(MD_STREAM_EVENTTYPE event_type, int type)
+{
+    if (event_type == MD_STREAM_ENTER_BLOCK || event_type == MD_STREAM_LEAVE_BLOCK) {
+        switch (type) {
+            case MD_BLOCK_UL:
+            case MD_BLOCK_OL:
+            case MD_BLOCK_LI:
+            case MD_BLOCK_H:
+            case MD_BLOCK_CODE:
+            case MD_BLOCK_TABLE:
+            case MD_BLOCK_TH:
+            case MD_BLOCK_TD:
+                return 1;
+            default:
+                return 0;
+        }
+    } else {
+        switch (type) {
+            case MD_SPAN_A:
+            case MD_SPAN_IMG:
+            case MD_SPAN_WIKILINK:
+                return 1;
+            default:
+                return 0;
+        }
+    }
+}
+
+static void
+md_stream_put_detail(MD_STREAM_RECORDER* r, MD_STREAM_EVENTTYPE event_type, int type, const void* detail)
+{
+    if (event_type == MD_STREAM_ENTER_BLOCK || event_type == MD_STREAM_LEAVE_BLOCK) {
+        switch (type) {
+            case MD_BLOCK_UL:
+            {
+                const MD_BLOCK_UL_DETAIL* det = (const MD_BLOCK_UL_DETAIL*)detail;
+                md_stream_put(r, (unsigned)det->is_tight);
+                md_stream_put(r, (unsigned)det->mark);
+                break;
+            }
+            case MD_BLOCK_OL:
+            {
+                const MD_BLOCK_OL_DETAIL* det = (const MD_BLOCK_OL_DETAIL*)detail;
+                md_stream_put(r, det->start);
+                md_stream_put(r, (unsigned)det->is_tight);
+                md_stream_put(r, (unsigned)det->mark_delimiter);
+                break;
+            }
+            case MD_BLOCK_LI:
+            {
+                const MD_BLOCK_LI_DETAIL* det = (const MD_BLOCK_LI_DETAIL*)detail;
+                md_stream_put(r, (unsigned)det->is_task);
+                md_stream_put(r, (unsigned)det->task_mark);
+                md_stream_put(r, det->task_mark_offset);
+                break;
+            }
+            case MD_BLOCK_H:
+                md_stream_put(r, ((const MD_BLOCK_H_DETAIL*)detail)->level);
+                break;
+            case MD_BLOCK_CODE:
+            {
+                const MD_BLOCK_CODE_DETAIL* det = (const MD_BLOCK_CODE_DETAIL*)detail;
+                md_stream_put_attribute(r, &det->info);
+                md_stream_put_attribute(r, &det->lang);
+                md_stream_put(r, (unsigned)det->fence_char);
+                break;
+            }
+            case MD_BLOCK_TABLE:
+            {
+                const MD_BLOCK_TABLE_DETAIL* det = (const MD_BLOCK_TABLE_DETAIL*)detail;
+                md_stream_put(r, det->col_count);
+                md_stream_put(r, det->head_row_count);
+                md_stream_put(r, det->body_row_count);
+                break;
+            }
+            case MD_BLOCK_TH:
+            case MD_BLOCK_TD:
+                md_stream_put(r, (unsigned)((const MD_BLOCK_TD_DETAIL*)detail)->align);
+                break;
+        }
+    } else {
+        switch (type) {
+            case MD_SPAN_A:
+            {
+                const MD_SPAN_A_DETAIL* det = (const MD_SPAN_A_DETAIL*)detail;
+                md_stream_put_attribute(r, &det->href);
+                md_stream_put_attribute(r, &det->title);
+                md_stream_put(r, (unsigned)det->is_autolink);
+                break;
+            }
+            case MD_SPAN_IMG:
+            {
+                const MD_SPAN_IMG_DETAIL* det = (const MD_SPAN_IMG_DETAIL*)detail;
+                md_stream_put_attribute(r, &det->src);
+                md_stream_put_attribute(r, &det->title);
+                break;
+            }
+            case MD_SPAN_WIKILINK:
+                md_stream_put_attribute(r, &((const MD_SPAN_WIKILINK_DETAIL*)detail)->target);
+                break;
+        }
+    }
+}
+
+static int
+md_stream_record_event(MD_STREAM_RECORDER* r, MD_STREAM_EVENTTYPE event_type, int type, const void* detail)
+{
+    int is_enter = (event_type == MD_STREAM_ENTER_BLOCK || event_type == MD_STREAM_ENTER_SPAN);
+    MD_SIZE rec_pos = r->stream->size;
+    unsigned rec = (unsigned)event_type | ((unsigned)type << REC_TYPE_SHIFT);
+
+    if (detail != NULL && md_stream_has_detail(event_type, type)) {
+        md_stream_put(r, rec | REC_DETAIL);
+        md_stream_put_detail(r, event_type, type, detail);
+    } else {
+        md_stream_put(r, rec);
+    }
+    if (r->error)
+        return r->error;
+
+    if (is_enter) {
+        if (r->n_stack + 2 > r->alloc_stack) {
+            int alloc_stack = (r->alloc_stack > 0 ? r->alloc_stack * 2 : 64);
+            MD_SIZE* stack = (MD_SIZE*)realloc(r->stack, alloc_stack * sizeof(MD_SIZE));
+            if (stack == NULL) {
+                r->error = -1;
+                return -1;
+            }
+            r->stack = stack;
+            r->alloc_stack = alloc_stack;
+        }
+        r->stack[r->n_stack++] = rec_pos;
+        r->stack[r->n_stack++] = r->stream->size - rec_pos;
+    } else if (r->n_stack >= 2) {
+        MD_SIZE enter_pos = r->stack[r->n_stack - 2];
+        MD_SIZE enter_len = r->stack[r->n_stack - 1];
+        MD_SIZE len = r->stream->size - rec_pos;
+        unsigned* data = r->stream->data;
+
+        r->n_stack -= 2;
+
+        /* Replace a repeated detail with a reference to the enter record. */
+        if ((data[rec_pos] & REC_DETAIL) && len == enter_len && len > 2  &&
+           (data[enter_pos] & REC_DETAIL) &&
+           memcmp(data + rec_pos + 1, data + enter_pos + 1, (len - 1) * sizeof(unsigned)) == 0) {
+            data[rec_pos] = rec | REC_BACKREF;
+            data[rec_pos + 1] = enter_pos;
+            r->stream->size = rec_pos + 2;
+        }
+    }
+
+    return 0;
+}
+
+static int
+md_stream_enter_block_callback(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    return md_stream_record_event((MD_STREAM_RECORDER*)userdata, MD_STREAM_ENTER_BLOCK, (int)type, detail);
+}
+
+static int
+md_stream_leave_block_callback(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    return md_stream_record_event((MD_STREAM_RECORDER*)userdata, MD_STREAM_LEAVE_BLOCK, (int)type, detail);
+}
+
+static int
+md_stream_enter_span_callback(MD_SPANTYPE type, void* detail, void* userdata)
+{
+    return md_stream_record_event((MD_STREAM_RECORDER*)userdata, MD_STREAM_ENTER_SPAN, (int)type, detail);
+}
+
+static int
+md_stream_leave_span_callback(MD_SPANTYPE type, void* detail, void* userdata)
+{
+    return md_stream_record_event((MD_STREAM_RECORDER*)userdata, MD_STREAM_LEAVE_SPAN, (int)type, detail);
+}
+
+static int
+md_stream_text_callback(MD_TEXTTYPE type, const MD_CHAR* text, MD_SIZE size, void* userdata)
+{
+    MD_STREAM_RECORDER* r = (MD_STREAM_RECORDER*)userdata;
+    unsigned rec = (unsigned)MD_STREAM_TEXT | ((unsigned)type << REC_TYPE_SHIFT);
+
+    if (md_stream_in_source(r, text, size)) {
+        md_stream_put(r, rec);
+        md_stream_put(r, size);
+        md_stream_put(r, (unsigned)(text - r->text));
+    } else {
+        /* Text produced by the parser itself (line breaks, indentation of
+         * code blocks, the replacement of NULL chars...). */
+        md_stream_put(r, rec | REC_INLINE);
+        md_stream_put(r, size);
+        md_stream_put_chars(r, text, size);
+    }
+    return r->error;
+}
+
+int
+md_stream_record(MD_PARSE_CONTEXT* context, const MD_CHAR* text, MD_SIZE size,
+    unsigned parser_flags, MD_STREAM* stream)
+{
+    MD_STREAM_RECORDER r;
+    MD_PARSER parser = {
+        0,
+        parser_flags,
+        md_stream_enter_block_callback,
+        md_stream_leave_block_callback,
+        md_stream_enter_span_callback,
+        md_stream_leave_span_callback,
+        md_stream_text_callback,
+        NULL,
+        NULL,
+        NULL
+    };
+    int ret;
+
+    memset(&r, 0, sizeof(MD_STREAM_RECORDER));
+    r.stream = stream;
+    r.text = text;
+    r.size = size;
+
+    stream->size = 0;
+    md_stream_put(&r, MD_STREAM_MAGIC);
+    md_stream_put(&r, MD_STREAM_VERSION | ((unsigned)sizeof(MD_CHAR) << 16));
+    md_stream_put(&r, parser_flags);
+    md_stream_put(&r, size);
+    md_stream_put(&r, md_stream_hash(text, size));
+    md_stream_put(&r, 0);
+    if (r.error)
+        return -1;
+
+    if (context != NULL)
+        ret = md_parse_with_context(context, text, size, &parser, (void*)&r);
+    else
+        ret = md_parse(text, size, &parser, (void*)&r);
+
+    free(r.stack);
+    if (ret != 0 || r.error) {
+        stream->size = 0;
+        return -1;
+    }
+    return 0;
+}
+
+
+/*****************
+ ***  Reading  ***
+ *****************/
+
+static int
+md_stream_check_header(const MD_STREAM* stream)
+{
+    return (stream->data != NULL && stream->size >= MD_STREAM_HEADER_SIZE  &&
+            stream->data[0] == MD_STREAM_MAGIC  &&
+            stream->data[1] == (MD_STREAM_VERSION | ((unsigned)sizeof(MD_CHAR) << 16)));
+}
+
+unsigned
+md_stream_parser_flags(const MD_STREAM* stream)
+{
+    return (md_stream_check_header(stream) ? stream->data[2] : 0);
+}
+
+/* Reader state: The words of the stream, the current position and the end. */
+typedef struct MD_STREAM_READER_tag MD_STREAM_READER;
+struct MD_STREAM_READER_tag {
+    const unsigned* data;
+    MD_SIZE pos;
+    MD_SIZE end;
+    const MD_CHAR* text;
+    MD_SIZE text_size;
+    int error;
+};
+
+static inline unsigned
+md_stream_get(MD_STREAM_READER* rd)
+{
+    if (rd->pos >= rd->end) {
+        rd->error = 1;
+        return 0;
+    }
+    return rd->data[rd->pos++];
+}
+
+static const MD_CHAR*
+md_stream_get_text(MD_STREAM_READER* rd, int is_inline, MD_SIZE size)
+{
+    if (is_inline) {
+        const MD_CHAR* text = (const MD_CHAR*)(rd->data + rd->pos);
+        MD_SIZE n = WORDS_FOR_CHARS(size);
+
+        if (n > rd->end - rd->pos) {
+            rd->error = 1;
+            return NULL;
+        }
+        rd->pos += n;
+        return text;
+    } else {
+        MD_SIZE off = md_stream_get(rd);
+
+        if (off > rd->text_size || size > rd->text_size - off) {
+            rd->error = 1;
+            return NULL;
+        }
+        return rd->text + off;
+    }
+}
+
+static void
+md_stream_get_attribute(MD_STREAM_READER* rd, MD_ATTRIBUTE* attr)
+{
+    unsigned flags = md_stream_get(rd);
+    MD_SIZE n_substrs;
+    MD_SIZE i;
+
+    attr->size = md_stream_get(rd);
+    if (flags & ATTR_NULL) {
+        attr->text = NULL;
+        if (attr->size != 0)
+            rd->error = 1;
+    } else
+        attr->text = md_stream_get_text(rd, (flags & ATTR_INLINE), attr->size);
+
+    n_substrs = md_stream_get(rd);
+    if (rd->error || n_substrs > attr->size || 2 * n_substrs + 1 > rd->end - rd->pos) {
+        rd->error = 1;
+        return;
+    }
+    attr->substr_types = (const MD_TEXTTYPE*)(rd->data + rd->pos);
+    attr->substr_offsets = (const MD_OFFSET*)(rd->data + rd->pos + n_substrs);
+    rd->pos += 2 * n_substrs + 1;
+
+    /* Only these types are used in attributes (see MD_ATTRIBUTE). */
+    for (i = 0; i < n_substrs; i++) {
+        if (attr->substr_types[i] != MD_TEXT_NORMAL  &&  attr->substr_types[i] != MD_TEXT_ENTITY  &&
+            attr->substr_types[i] != MD_TEXT_NULLCHAR) {
+            rd->error = 1;
+            return;
+        }
+    }
+
+    /* Renderers walk the substrings by their offsets, so they must be
+     * increasing and end exactly at the attribute size. */
+    if (attr->substr_offsets[0] != 0 || attr->substr_offsets[n_substrs] != attr->size) {
+        rd->error = 1;
+        return;
+    }
+    for (i = 0; i < n_substrs; i++) {
+        if (attr->substr_offsets[i] >= attr->substr_offsets[i+1]) {
+            rd->error = 1;
+            return;
+        }
+    }
+}
+
+static void
+md_stream_get_detail(MD_STREAM_READER* rd, MD_STREAM_EVENT* event)
+{
+    if (event->event_type == MD_STREAM_ENTER_BLOCK || event->event_type == MD_STREAM_LEAVE_BLOCK) {
+        switch (event->type) {
+            case MD_BLOCK_UL:
+                event->u.ul.is_tight = (int)md_stream_get(rd);
+                event->u.ul.mark = (MD_CHAR)md_stream_get(rd);
+                if ((unsigned)event->u.ul.is_tight > 1)
+                    rd->error = 1;
+                break;
+            case MD_BLOCK_OL:
+                event->u.ol.start = md_stream_get(rd);
+                event->u.ol.is_tight = (int)md_stream_get(rd);
+                event->u.ol.mark_delimiter = (MD_CHAR)md_stream_get(rd);
+                if ((unsigned)event->u.ol.is_tight > 1)
+                    rd->error = 1;
+                break;
+            case MD_BLOCK_LI:
+                event->u.li.is_task = (int)md_stream_get(rd);
+                event->u.li.task_mark = (MD_CHAR)md_stream_get(rd);
+                event->u.li.task_mark_offset = md_stream_get(rd);
+                if ((unsigned)event->u.li.is_task > 1  ||
+                    (event->u.li.is_task  &&  event->u.li.task_mark != 'x'  &&
+                     event->u.li.task_mark != 'X'  &&  event->u.li.task_mark != ' '))
+                    rd->error = 1;
+                break;
+            case MD_BLOCK_H:
+                event->u.h.level = md_stream_get(rd);
+                if (event->u.h.level < 1  ||  event->u.h.level > 6)
+                    rd->error = 1;
+                break;
+            case MD_BLOCK_CODE:
+                md_stream_get_attribute(rd, &event->u.code.info);
+                md_stream_get_attribute(rd, &event->u.code.lang);
+                event->u.code.fence_char = (MD_CHAR)md_stream_get(rd);
+                break;
+            case MD_BLOCK_TABLE:
+                event->u.table.col_count = md_stream_get(rd);
+                event->u.table.head_row_count = md_stream_get(rd);
+                event->u.table.body_row_count = md_stream_get(rd);
+                break;
+            case MD_BLOCK_TH:
+            case MD_BLOCK_TD:
+                event->u.td.align = (MD_ALIGN)md_stream_get(rd);
+                if ((unsigned)event->u.td.align > MD_ALIGN_RIGHT)
+                    rd->error = 1;
+                break;
+            default:
+                rd->error = 1;
+                return;
+        }
+    } else {
+        switch (event->type) {
+            case MD_SPAN_A:
+                md_stream_get_attribute(rd, &event->u.a.href);
+                md_stream_get_attribute(rd, &event->u.a.title);
+                event->u.a.is_autolink = (int)md_stream_get(rd);
+                break;
+            case MD_SPAN_IMG:
+                md_stream_get_attribute(rd, &event->u.img.src);
+                md_stream_get_attribute(rd, &event->u.img.title);
+                break;
+            case MD_SPAN_WIKILINK:
+                md_stream_get_attribute(rd, &event->u.wikilink.target);
+                break;
+            default:
+                rd->error = 1;
+                return;
+        }
+    }
+
+    event->detail = (void*)&event->u;
+}
+
+int
+md_stream_next(const MD_STREAM* stream, const MD_CHAR* text, MD_SIZE* pos,
+    MD_STREAM_EVENT* event)
+{
+    MD_STREAM_READER rd;
+    MD_SIZE rec_pos;
+    unsigned rec;
+
+    if (!md_stream_check_header(stream))
+        return -1;
+
+    rd.data = stream->data;
+    rd.pos = (*pos < MD_STREAM_HEADER_SIZE ? MD_STREAM_HEADER_SIZE : *pos);
+    rd.end = stream->size;
+    rd.text = text;
+    rd.text_size = stream->data[3];
+    rd.error = 0;
+
+    if (rd.pos >= rd.end)
+        return 0;
+
+    rec_pos = rd.pos;
+    rec = md_stream_get(&rd);
+    event->event_type = (MD_STREAM_EVENTTYPE)(rec & REC_EVENT_MASK);
+    event->type = (int)((rec & REC_TYPE_MASK) >> REC_TYPE_SHIFT);
+    event->detail = NULL;
+    event->text = NULL;
+    event->size = 0;
+
+    switch (event->event_type) {
+        case MD_STREAM_ENTER_BLOCK:
+        case MD_STREAM_LEAVE_BLOCK:
+            if (event->type > MD_BLOCK_TD)
+                return -1;
+            break;
+        case MD_STREAM_ENTER_SPAN:
+        case MD_STREAM_LEAVE_SPAN:
+            if (event->type > MD_SPAN_U)
+                return -1;
+            break;
+        case MD_STREAM_TEXT:
+            if (event->type > MD_TEXT_LATEXMATH)
+                return -1;
+            break;
+        default:
+            return -1;
+    }
+
+    switch (event->event_type) {
+        case MD_STREAM_ENTER_BLOCK:
+        case MD_STREAM_LEAVE_BLOCK:
+        case MD_STREAM_ENTER_SPAN:
+        case MD_STREAM_LEAVE_SPAN:
+            if (rec & REC_BACKREF) {
+                MD_STREAM_READER ref = rd;
+                unsigned ref_rec;
+
+                /* Only leave records refer back, always to an earlier enter of
+                 * the same kind which has its own detail. */
+                if (event->event_type != MD_STREAM_LEAVE_BLOCK && event->event_type != MD_STREAM_LEAVE_SPAN)
+                    return -1;
+                ref.pos = md_stream_get(&rd);
+                if (ref.pos < MD_STREAM_HEADER_SIZE || ref.pos >= rec_pos)
+                    return -1;
+                ref_rec = md_stream_get(&ref);
+                if ((ref_rec & REC_TYPE_MASK) != (rec & REC_TYPE_MASK) || !(ref_rec & REC_DETAIL)  ||
+                   (ref_rec & REC_EVENT_MASK) != (unsigned)event->event_type - 1)
+                    return -1;
+                md_stream_get_detail(&ref, event);
+                if (ref.error)
+                    return -1;
+            } else if (rec & REC_DETAIL) {
+                md_stream_get_detail(&rd, event);
+            }
+
+            /* Renderers dereference the detail of these types unchecked. */
+            if (event->detail == NULL  &&  md_stream_has_detail(event->event_type, event->type))
+                return -1;
+            break;
+
+        case MD_STREAM_TEXT:
+            event->size = md_stream_get(&rd);
+            event->text = md_stream_get_text(&rd, (rec & REC_INLINE), event->size);
+            break;
+
+        default:
+            return -1;
+    }
+
+    if (rd.error)
+        return -1;
+
+    *pos = rd.pos;
+    return 1;
+}
+
+/* Nesting of the events read so far: The stack holds the blocks and spans
+ * entered and not left yet (as the event type of the enter in the high byte
+ * and the block/span type in the low one). The stream must be a single
+ * MD_BLOCK_DOC, as md_parse() produces it; spans and text may only appear
+ * inside a block and blocks may not appear inside a span. */
+typedef struct MD_STREAM_NESTING_tag MD_STREAM_NESTING;
+struct MD_STREAM_NESTING_tag {
+    unsigned short* stack;
+    int n_stack;
+    int alloc_stack;
+    int is_done;    /* MD_BLOCK_DOC has been left. */
+};
+
+/* Returns 0 if the event may follow the events seen so far, -1 otherwise. */
+static int
+md_stream_nest(MD_STREAM_NESTING* nest, const MD_STREAM_EVENT* event)
+{
+    unsigned short top = (nest->n_stack > 0 ? nest->stack[nest->n_stack - 1] : 0);
+    unsigned short item;
+
+    if (nest->is_done)
+        return -1;
+
+    switch (event->event_type) {
+        case MD_STREAM_ENTER_BLOCK:
+            if (nest->n_stack == 0 ? (event->type != MD_BLOCK_DOC)
+                    : (event->type == MD_BLOCK_DOC  ||  (top >> 8) != MD_STREAM_ENTER_BLOCK))
+                return -1;
+            break;
+        case MD_STREAM_ENTER_SPAN:
+        case MD_STREAM_TEXT:
+            if (nest->n_stack == 0)
+                return -1;
+            break;
+        default:
+            item = (unsigned short)(((event->event_type - 1) << 8) | event->type);
+            if (nest->n_stack == 0  ||  top != item)
+                return -1;
+            nest->n_stack--;
+            if (nest->n_stack == 0)
+                nest->is_done = 1;
+            return 0;
+    }
+
+    if (event->event_type == MD_STREAM_TEXT)
+        return 0;
+
+    if (nest->n_stack >= nest->alloc_stack) {
+        int alloc_stack = (nest->alloc_stack > 0 ? nest->alloc_stack * 2 : 64);
+        unsigned short* stack = (unsigned short*)realloc(nest->stack, alloc_stack * sizeof(unsigned short));
+        if (stack == NULL)
+            return -1;
+        nest->stack = stack;
+        nest->alloc_stack = alloc_stack;
+    }
+    nest->stack[nest->n_stack++] = (unsigned short)((event->event_type << 8) | event->type);
+    return 0;
+}
+
+int
+md_stream_check(const MD_STREAM* stream, const MD_CHAR* text, MD_SIZE size)
+{
+    MD_STREAM_EVENT event;
+    MD_STREAM_NESTING nest;
+    MD_SIZE pos = 0;
+    int ret;
+
+    if (!md_stream_check_header(stream) || stream->data[3] != size  ||
+       stream->data[4] != md_stream_hash(text, size))
+        return -1;
+
+    memset(&nest, 0, sizeof(MD_STREAM_NESTING));
+    while ((ret = md_stream_next(stream, text, &pos, &event)) > 0) {
+        if (md_stream_nest(&nest, &event) != 0) {
+            ret = -1;
+            break;
+        }
+    }
+    if (ret == 0  &&  !nest.is_done)
+        ret = -1;
+    free(nest.stack);
+    return (ret == 0 ? 0 : -1);
+}
+
+int
+md_stream_replay(const MD_STREAM* stream, const MD_CHAR* text,
+    const MD_PARSER* parser, void* userdata)
+{
+    MD_STREAM_EVENT event;
+    MD_STREAM_NESTING nest;
+    MD_SIZE pos = 0;
+    int ret;
+
+    memset(&nest, 0, sizeof(MD_STREAM_NESTING));
+    while ((ret = md_stream_next(stream, text, &pos, &event)) > 0) {
+        /* Stop before any callback gets an event out of order. */
+        if (md_stream_nest(&nest, &event) != 0) {
+            ret = -1;
+            break;
+        }
+
+        switch (event.event_type) {
+            case MD_STREAM_ENTER_BLOCK:
+                ret = parser->enter_block((MD_BLOCKTYPE)event.type, event.detail, userdata);
+                break;
+            case MD_STREAM_LEAVE_BLOCK:
+                ret = parser->leave_block((MD_BLOCKTYPE)event.type, event.detail, userdata);
+                break;
+            case MD_STREAM_ENTER_SPAN:
+                ret = parser->enter_span((MD_SPANTYPE)event.type, event.detail, userdata);
+                break;
+            case MD_STREAM_LEAVE_SPAN:
+                ret = parser->leave_span((MD_SPANTYPE)event.type, event.detail, userdata);
+                break;
+            case MD_STREAM_TEXT:
+                ret = parser->text((MD_TEXTTYPE)event.type, event.text, event.size, userdata);
+                break;
+        }
+        if (ret != 0) {
+            free(nest.stack);
+            return ret;
+        }
+    }
+    if (ret == 0  &&  !nest.is_done)
+        ret = -1;
+    free(nest.stack);
+
+    if (ret < 0) {
+        if (parser->debug_log != NULL)
+            parser->debug_log("Malformed event stream.", userdata);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+#pragma once
+/*
+ * MD4C: Markdown parser for C
+ * (http://github.com/mity/md4c)
+ *
+ * Copyright (c) 2016-2024 Martin Mit
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MD4C_STREAM_H
+#define MD4C_STREAM_H
+
+#include "md4c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* Event stream: A recorded parse of a document.
+ *
+ * md_stream_record() runs md_parse() and stores every callback it gets into
+ * a flat array of 32-bit words: Block and span enter/leave records with their
+ * detail structures serialized inline, and text records. Text which lies in
+ * the source document is stored only as an offset and size, so the stream
+ * is much smaller than the rendered output, but the same source text has to
+ * be provided when the stream is read back.
+ *
+ * The stream does not contain any pointers, so it can be copied, or written
+ * to a file as it is and loaded later (e.g. to cache parses of documents
+ * keyed by md_stream_hash() of their contents). The words are stored in the
+ * native byte order.
+ */
+#define MD_STREAM_VERSION                   1
+
+/* Stream buffer. Same ownership rules as MD_HTML_BUFFER: Owned by the caller,
+ * may start zero-initialized, grown with realloc() and released with
+ * free(data). */
+    typedef struct MD_STREAM {
+        unsigned* data;         /* Header words followed by the records. */
+        MD_SIZE size;           /* Count of used words in data. */
+        MD_SIZE capacity;       /* Count of allocated words in data. */
+    } MD_STREAM;
+
+    typedef enum MD_STREAM_EVENTTYPE {
+        MD_STREAM_ENTER_BLOCK = 1,
+        MD_STREAM_LEAVE_BLOCK,
+        MD_STREAM_ENTER_SPAN,
+        MD_STREAM_LEAVE_SPAN,
+        MD_STREAM_TEXT
+    } MD_STREAM_EVENTTYPE;
+
+/* Single event as produced by md_stream_next(). */
+    typedef struct MD_STREAM_EVENT {
+        MD_STREAM_EVENTTYPE event_type;
+
+        /* MD_BLOCKTYPE, MD_SPANTYPE or MD_TEXTTYPE, depending on event_type. */
+        int type;
+
+        /* For block and span events: Pointer to the detail structure (the
+         * same one md_parse() would pass to the callback), or NULL. It points
+         * into this structure, i.e. it is valid as long as the event is. */
+        void* detail;
+
+        /* For MD_STREAM_TEXT: The text. It points either into the source
+         * document or into the stream. */
+        const MD_CHAR* text;
+        MD_SIZE size;
+
+        /* Storage for *detail. */
+        union {
+            MD_BLOCK_UL_DETAIL ul;
+            MD_BLOCK_OL_DETAIL ol;
+            MD_BLOCK_LI_DETAIL li;
+            MD_BLOCK_H_DETAIL h;
+            MD_BLOCK_CODE_DETAIL code;
+            MD_BLOCK_TABLE_DETAIL table;
+            MD_BLOCK_TD_DETAIL td;
+            MD_SPAN_A_DETAIL a;
+            MD_SPAN_IMG_DETAIL img;
+            MD_SPAN_WIKILINK_DETAIL wikilink;
+        } u;
+    } MD_STREAM_EVENT;
+
+
+/* Hash of the document contents as stored in the stream header. */
+    unsigned md_stream_hash(const MD_CHAR* text, MD_SIZE size);
+
+/* Parse the document and record it into the stream. Any previous contents
+ * of the stream is replaced.
+ *
+ * Param context may be NULL; otherwise md_parse_with_context() is used.
+ *
+ * Returns -1 on error (if md_parse() fails or the stream cannot grow).
+ * Returns 0 on success.
+ */
+    int md_stream_record(MD_PARSE_CONTEXT* context, const MD_CHAR* text, MD_SIZE size,
+        unsigned parser_flags, MD_STREAM* stream);
+
+/* Check the stream is a valid recording of the given document: The header
+ * must match (including md_stream_hash() of the text) and the records must be
+ * well-formed. That is, every block and span type which has a detail structure
+ * must carry one, the types and the detail fields must be in their ranges
+ * (e.g. MD_BLOCK_H_DETAIL::level in 1..6), and the enter and leave records must
+ * be balanced and properly nested in a single MD_BLOCK_DOC, with no block
+ * inside a span. (Which blocks may contain which is not checked.) Streams
+ * loaded from untrusted storage should be checked with this before reading
+ * them.
+ *
+ * Returns 0 if the stream may be used with the text, -1 otherwise.
+ */
+    int md_stream_check(const MD_STREAM* stream, const MD_CHAR* text, MD_SIZE size);
+
+/* Parser flags the stream was recorded with. */
+    unsigned md_stream_parser_flags(const MD_STREAM* stream);
+
+/* Iterate over the stream. Start with *pos set to zero.
+ *
+ * Each record is checked on its own (see md_stream_check()), but not how the
+ * records nest; callers which need that should check the stream first.
+ *
+ * Returns 1 and fills the event on success, 0 at the end of the stream and
+ * -1 if the record is malformed.
+ */
+    int md_stream_next(const MD_STREAM* stream, const MD_CHAR* text, MD_SIZE* pos,
+        MD_STREAM_EVENT* event);
+
+/* Replay the stream through the parser callbacks as if md_parse() was called
+ * on the text. parser->flags are ignored. Every record, including its nesting,
+ * is checked before it is passed to a callback, so the callbacks never get an
+ * event md_parse() would not produce; but a malformed stream may be detected
+ * only after some events have been replayed.
+ *
+ * Returns -1 if the stream is malformed; or the non-zero value a callback
+ * returned to abort the replay; or 0 on success.
+ */
+    int md_stream_replay(const MD_STREAM* stream, const MD_CHAR* text,
+        const MD_PARSER* parser, void* userdata);
+
+
+#ifdef __cplusplus
+}  /* extern "C" { */
+#endif
+
+#endif  /* MD4C_STREAM_H */
@@ -0,0 +1,477 @@
+/*
+ * MD4C: Markdown parser for C
+ * (http://github.com/mity/md4c)
+ *
+ * Copyright (c) 2016-2024 Martin Mit
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "md4c-text.h"
+#include "entity.h"
+
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 199409L
+ /* C89/90 or old compilers in general may not understand "inline". */
+#if defined __GNUC__
+#define inline __inline__
+#elif defined _MSC_VER
+#define inline __inline
+#else
+#define inline
+#endif
+#endif
+
+#define MD_UNUSED(x)                ((void)x)
+
+
+/* Separators between blocks. They are not output right away but only before
+ * the next text, so empty blocks (or blocks whose contents is dropped, like
+ * raw HTML) do not produce runs of empty lines, and the output does not start
+ * with a separator. When more separators meet, the strongest one wins. */
+#define SEP_NONE        0
+#define SEP_LINE        1       /* "\n" */
+#define SEP_PARA        2       /* "\n\n" */
+
+
+typedef struct MD_TEXT_tag MD_TEXT;
+struct MD_TEXT_tag {
+    MD_TEXT_BUFFER* buffer;
+    MD_TEXT_BLOCKS* blocks;
+    const MD_CHAR* input;
+    MD_SIZE input_size;
+    unsigned flags;
+
+    MD_SIZE out_start;          /* buffer->size when md_text() was called. */
+    int separator;              /* Pending SEP_xxx. */
+    int cell_index;             /* Index of the current cell in a table row. */
+    int list_level;             /* Count of the open lists. */
+
+    /* Block records (only maintained if blocks != NULL): Stack of the open
+     * blocks, and whether the last record still collects text of the
+     * innermost one. */
+    MD_BLOCKTYPE* stack;
+    int n_stack;
+    int alloc_stack;
+    int record_open;
+    int record_has_src;
+
+    int error;
+};
+
+
+/****************************
+ ***  Output and records  ***
+ ****************************/
+
+static int
+md_text_reserve(MD_TEXT* r, MD_SIZE n)
+{
+    MD_TEXT_BUFFER* buffer = r->buffer;
+    MD_SIZE capacity = buffer->capacity + buffer->capacity / 2;
+    MD_CHAR* data;
+
+    if (capacity < buffer->size + n)
+        capacity = buffer->size + n;
+    if (capacity < 256)
+        capacity = 256;
+    data = (MD_CHAR*)realloc(buffer->data, capacity * sizeof(MD_CHAR));
+    if (data == NULL) {
+        r->error = -1;
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static inline void
+md_text_append(MD_TEXT* r, const MD_CHAR* text, MD_SIZE size)
+{
+    MD_TEXT_BUFFER* buffer = r->buffer;
+
+    if (buffer->size + size > buffer->capacity  &&  md_text_reserve(r, size) != 0)
+        return;
+    memcpy(buffer->data + buffer->size, text, size * sizeof(MD_CHAR));
+    buffer->size += size;
+}
+
+static inline void
+md_text_separate(MD_TEXT* r, int separator)
+{
+    if (r->separator < separator)
+        r->separator = separator;
+}
+
+static void
+md_text_flush_separator(MD_TEXT* r)
+{
+    if (r->buffer->size > r->out_start) {
+        switch (r->separator) {
+        case SEP_LINE:  md_text_append(r, "\n", 1); break;
+        case SEP_PARA:  md_text_append(r, "\n\n", 2); break;
+        }
+    }
+    r->separator = SEP_NONE;
+}
+
+static MD_TEXT_BLOCK*
+md_text_new_record(MD_TEXT* r)
+{
+    MD_TEXT_BLOCKS* blocks = r->blocks;
+    MD_TEXT_BLOCK* rec;
+
+    if (blocks->size >= blocks->capacity) {
+        MD_SIZE capacity = (blocks->capacity > 0 ? blocks->capacity * 2 : 64);
+        MD_TEXT_BLOCK* data;
+
+        data = (MD_TEXT_BLOCK*)realloc(blocks->data, capacity * sizeof(MD_TEXT_BLOCK));
+        if (data == NULL) {
+            r->error = -1;
+            return NULL;
+        }
+        blocks->data = data;
+        blocks->capacity = capacity;
+    }
+
+    rec = &blocks->data[blocks->size++];
+    rec->type = (r->n_stack > 0 ? r->stack[r->n_stack - 1] : MD_BLOCK_DOC);
+    rec->beg = r->buffer->size;
+    rec->end = r->buffer->size;
+    /* Until some text from the input comes, keep an empty source range where
+     * the previous record has ended. */
+    rec->src_beg = (blocks->size > 1 ? rec[-1].src_end : 0);
+    rec->src_end = rec->src_beg;
+    r->record_open = 1;
+    r->record_has_src = 0;
+    return rec;
+}
+
+/* Output the text. Param src is the text in the input it has been produced
+ * from (the same as out for normal text), to be recorded in the block
+ * records. */
+static void
+md_text_output(MD_TEXT* r, const MD_CHAR* out, MD_SIZE out_size,
+    const MD_CHAR* src, MD_SIZE src_size)
+{
+    MD_TEXT_BLOCK* rec;
+
+    if (r->separator != SEP_NONE)
+        md_text_flush_separator(r);
+
+    if (r->blocks == NULL) {
+        md_text_append(r, out, out_size);
+        return;
+    }
+
+    if (r->record_open)
+        rec = &r->blocks->data[r->blocks->size - 1];
+    else if ((rec = md_text_new_record(r)) == NULL)
+        return;
+
+    md_text_append(r, out, out_size);
+    rec->end = r->buffer->size;
+
+    /* Text made up by the parser (line breaks, indentation of code blocks...)
+     * has no place in the input. */
+    if (src >= r->input  &&  src + src_size <= r->input + r->input_size) {
+        if (!r->record_has_src) {
+            rec->src_beg = (MD_OFFSET)(src - r->input);
+            r->record_has_src = 1;
+        }
+        rec->src_end = (MD_OFFSET)(src - r->input) + src_size;
+    }
+}
+
+static void
+md_text_output_codepoint(MD_TEXT* r, unsigned codepoint,
+    const MD_CHAR* src, MD_SIZE src_size)
+{
+    static const MD_CHAR utf8_replacement_char[] = { (char)0xef, (char)0xbf, (char)0xbd };
+
+    unsigned char utf8[4];
+    size_t n;
+
+    if (codepoint <= 0x7f) {
+        n = 1;
+        utf8[0] = codepoint;
+    }
+    else if (codepoint <= 0x7ff) {
+        n = 2;
+        utf8[0] = 0xc0 | ((codepoint >> 6) & 0x1f);
+        utf8[1] = 0x80 + ((codepoint >> 0) & 0x3f);
+    }
+    else if (codepoint <= 0xffff) {
+        n = 3;
+        utf8[0] = 0xe0 | ((codepoint >> 12) & 0xf);
+        utf8[1] = 0x80 + ((codepoint >> 6) & 0x3f);
+        utf8[2] = 0x80 + ((codepoint >> 0) & 0x3f);
+    }
+    else {
+        n = 4;
+        utf8[0] = 0xf0 | ((codepoint >> 18) & 0x7);
+        utf8[1] = 0x80 + ((codepoint >> 12) & 0x3f);
+        utf8[2] = 0x80 + ((codepoint >> 6) & 0x3f);
+        utf8[3] = 0x80 + ((codepoint >> 0) & 0x3f);
+    }
+
+    if (0 < codepoint && codepoint <= 0x10ffff)
+        md_text_output(r, (char*)utf8, (MD_SIZE)n, src, src_size);
+    else
+        md_text_output(r, utf8_replacement_char, 3, src, src_size);
+}
+
+/* Translate entity to its UTF-8 equivalent, or output the verbatim one
+ * if such entity is unknown (or if the translation is disabled). */
+static void
+md_text_output_entity(MD_TEXT* r, const MD_CHAR* text, MD_SIZE size)
+{
+    if (!(r->flags & MD_TEXT_FLAG_VERBATIM_ENTITIES)) {
+        if (size > 3 && text[1] == '#') {
+            unsigned codepoint = 0;
+            MD_SIZE i;
+
+            if (text[2] == 'x' || text[2] == 'X') {
+                for (i = 3; i < size - 1; i++)
+                    codepoint = 16 * codepoint + entity_hex_val(text[i]);
+            }
+            else {
+                for (i = 2; i < size - 1; i++)
+                    codepoint = 10 * codepoint + (text[i] - '0');
+            }
+
+            md_text_output_codepoint(r, codepoint, text, size);
+            return;
+        }
+        else {
+            const ENTITY* ent;
+
+            ent = entity_lookup(text, size);
+            if (ent != NULL) {
+                md_text_output_codepoint(r, ent->codepoints[0], text, size);
+                if (ent->codepoints[1])
+                    md_text_output_codepoint(r, ent->codepoints[1], text, size);
+                return;
+            }
+        }
+    }
+
+    md_text_output(r, text, size, text, size);
+}
+
+
+/**************************************
+ ***  Text renderer implementation  ***
+ **************************************/
+
+static int
+md_text_enter_block_callback(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    MD_TEXT* r = (MD_TEXT*)userdata;
+
+    MD_UNUSED(detail);
+
+    switch (type) {
+    case MD_BLOCK_DOC:      /* noop */ break;
+    case MD_BLOCK_THEAD:    /* noop */ break;
+    case MD_BLOCK_TBODY:    /* noop */ break;
+    case MD_BLOCK_TR:       md_text_separate(r, SEP_LINE); r->cell_index = 0; break;
+    case MD_BLOCK_TH:       /* fall through */
+    case MD_BLOCK_TD:
+        /* Output the tab right away so that empty cells keep the columns. */
+        if (r->cell_index++ > 0) {
+            md_text_flush_separator(r);
+            md_text_append(r, "\t", 1);
+        }
+        break;
+    case MD_BLOCK_UL:       /* fall through */
+    case MD_BLOCK_OL:       md_text_separate(r, SEP_LINE); r->list_level++; break;
+    default:                md_text_separate(r, SEP_LINE); break;
+    }
+
+    if (r->blocks != NULL) {
+        if (r->n_stack >= r->alloc_stack) {
+            int alloc_stack = (r->alloc_stack > 0 ? r->alloc_stack * 2 : 16);
+            MD_BLOCKTYPE* stack;
+
+            stack = (MD_BLOCKTYPE*)realloc(r->stack, alloc_stack * sizeof(MD_BLOCKTYPE));
+            if (stack == NULL) {
+                r->error = -1;
+                return r->error;
+            }
+            r->stack = stack;
+            r->alloc_stack = alloc_stack;
+        }
+        r->stack[r->n_stack++] = type;
+        r->record_open = 0;
+    }
+
+    return r->error;
+}
+
+static int
+md_text_leave_block_callback(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    MD_TEXT* r = (MD_TEXT*)userdata;
+
+    MD_UNUSED(detail);
+
+    switch (type) {
+    case MD_BLOCK_DOC:
+        /* Terminate the last line. */
+        r->separator = SEP_LINE;
+        md_text_flush_separator(r);
+        break;
+    case MD_BLOCK_UL:       /* fall through */
+    case MD_BLOCK_OL:
+        /* Nested list is just more items of the parent one. */
+        r->list_level--;
+        md_text_separate(r, (r->list_level > 0 ? SEP_LINE : SEP_PARA));
+        break;
+    case MD_BLOCK_CODE:
+        /* Code block text comes with the line ends; drop the last one so the
+         * block is separated as any other one. */
+        if (r->buffer->size > r->out_start  &&  r->buffer->data[r->buffer->size - 1] == '\n') {
+            r->buffer->size--;
+            if (r->record_open  &&  r->blocks->data[r->blocks->size - 1].end > r->buffer->size)
+                r->blocks->data[r->blocks->size - 1].end = r->buffer->size;
+        }
+        md_text_separate(r, SEP_PARA);
+        break;
+    case MD_BLOCK_LI:       /* fall through */
+    case MD_BLOCK_TR:       md_text_separate(r, SEP_LINE); break;
+    case MD_BLOCK_THEAD:    /* noop */ break;
+    case MD_BLOCK_TBODY:    /* noop */ break;
+    case MD_BLOCK_TH:       /* noop */ break;
+    case MD_BLOCK_TD:       /* noop */ break;
+    default:                md_text_separate(r, SEP_PARA); break;
+    }
+
+    if (r->blocks != NULL) {
+        r->n_stack--;
+        r->record_open = 0;
+    }
+
+    return r->error;
+}
+
+static int
+md_text_enter_span_callback(MD_SPANTYPE type, void* detail, void* userdata)
+{
+    /* Spans have no representation in plain text. Even images only
+     * contribute their alternative text which comes as normal text. */
+    MD_UNUSED(type);
+    MD_UNUSED(detail);
+    MD_UNUSED(userdata);
+    return 0;
+}
+
+static int
+md_text_leave_span_callback(MD_SPANTYPE type, void* detail, void* userdata)
+{
+    MD_UNUSED(type);
+    MD_UNUSED(detail);
+    MD_UNUSED(userdata);
+    return 0;
+}
+
+static int
+md_text_text_callback(MD_TEXTTYPE type, const MD_CHAR* text, MD_SIZE size, void* userdata)
+{
+    MD_TEXT* r = (MD_TEXT*)userdata;
+
+    switch (type) {
+    case MD_TEXT_NULLCHAR:  md_text_output_codepoint(r, 0x0000, text, size); break;
+    case MD_TEXT_BR:        md_text_output(r, "\n", 1, text, size); break;
+    case MD_TEXT_SOFTBR:    md_text_output(r, " ", 1, text, size); break;
+    case MD_TEXT_HTML:
+        if (r->flags & MD_TEXT_FLAG_KEEP_HTML)
+            md_text_output(r, text, size, text, size);
+        break;
+    case MD_TEXT_ENTITY:    md_text_output_entity(r, text, size); break;
+    default:                md_text_output(r, text, size, text, size); break;
+    }
+
+    return r->error;
+}
+
+static void
+md_text_debug_log_callback(const char* msg, void* userdata)
+{
+    MD_TEXT* r = (MD_TEXT*)userdata;
+    if (r->flags & MD_TEXT_FLAG_DEBUG)
+        fprintf(stderr, "MD4C: %s\n", msg);
+}
+
+int
+md_text(MD_PARSE_CONTEXT* context, const MD_CHAR* input, MD_SIZE input_size,
+    MD_TEXT_BUFFER* buffer, MD_TEXT_BLOCKS* blocks,
+    unsigned parser_flags, unsigned renderer_flags)
+{
+    MD_TEXT r;
+    MD_PARSER parser = {
+        0,
+        parser_flags,
+        md_text_enter_block_callback,
+        md_text_leave_block_callback,
+        md_text_enter_span_callback,
+        md_text_leave_span_callback,
+        md_text_text_callback,
+        md_text_debug_log_callback,
+        NULL,
+        NULL
+    };
+    const MD_CHAR* text = input;
+    MD_SIZE size = input_size;
+    int ret;
+
+    memset(&r, 0, sizeof(MD_TEXT));
+    r.buffer = buffer;
+    r.blocks = blocks;
+    r.input = input;
+    r.input_size = input_size;
+    r.flags = renderer_flags;
+    r.out_start = buffer->size;
+
+    if (blocks != NULL)
+        blocks->size = 0;
+
+    /* Consider skipping UTF-8 byte order mark (BOM). */
+    if (r.flags & MD_TEXT_FLAG_SKIP_UTF8_BOM && sizeof(MD_CHAR) == 1) {
+        static const MD_CHAR bom[3] = { (char)0xef, (char)0xbb, (char)0xbf };
+        if (size >= sizeof(bom) && memcmp(text, bom, sizeof(bom)) == 0) {
+            text += sizeof(bom);
+            size -= sizeof(bom);
+        }
+    }
+
+    if (context != NULL)
+        ret = md_parse_with_context(context, text, size, &parser, (void*)&r);
+    else
+        ret = md_parse(text, size, &parser, (void*)&r);
+
+    free(r.stack);
+    if (ret != 0 || r.error)
+        return -1;
+    return 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+/*
+ * MD4C: Markdown parser for C
+ * (http://github.com/mity/md4c)
+ *
+ * Copyright (c) 2016-2024 Martin Mit
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MD4C_TEXT_H
+#define MD4C_TEXT_H
+
+#include "md4c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+    /* If set, debug output from md_parse() is sent to stderr. */
+#define MD_TEXT_FLAG_DEBUG                  0x0001
+#define MD_TEXT_FLAG_VERBATIM_ENTITIES      0x0002
+#define MD_TEXT_FLAG_SKIP_UTF8_BOM          0x0004
+    /* If set, raw HTML (blocks and inline tags) is kept in the output.
+     * By default it is dropped. */
+#define MD_TEXT_FLAG_KEEP_HTML              0x0008
+
+
+/* Output buffer for md_text(). Same ownership rules as MD_HTML_BUFFER: Owned
+ * by the caller, may start zero-initialized, grown with realloc() and
+ * released with free(data). */
+    typedef struct MD_TEXT_BUFFER {
+        MD_CHAR* data;          /* Output, not zero-terminated. */
+        MD_SIZE size;           /* Count of used MD_CHARs in data. */
+        MD_SIZE capacity;       /* Count of allocated MD_CHARs in data. */
+    } MD_TEXT_BUFFER;
+
+/* Text of a single block, as recorded by md_text().
+ *
+ * A record is made for every run of text belonging directly to one block,
+ * i.e. typically for each paragraph, heading, code block, table cell or
+ * item of a tight list. Block separators are not part of the records.
+ */
+    typedef struct MD_TEXT_BLOCK {
+        MD_BLOCKTYPE type;      /* The innermost block containing the text. */
+        MD_OFFSET beg;          /* Range of the text in the output buffer. */
+        MD_OFFSET end;
+        MD_OFFSET src_beg;      /* Range of the input the text comes from. */
+        MD_OFFSET src_end;
+    } MD_TEXT_BLOCK;
+
+    typedef struct MD_TEXT_BLOCKS {
+        MD_TEXT_BLOCK* data;
+        MD_SIZE size;           /* Count of used records in data. */
+        MD_SIZE capacity;       /* Count of allocated records in data. */
+    } MD_TEXT_BLOCKS;
+
+/* Render Markdown into plain text, appending the output to the given buffer.
+ *
+ * Blocks are separated with a blank line, list items and table rows with a
+ * new line and table cells with a tab. Entities are translated to UTF-8
+ * (unless MD_TEXT_FLAG_VERBATIM_ENTITIES), hard line breaks become new lines
+ * and soft line breaks spaces. Link destinations, image URLs and titles are
+ * not part of the output; the image alternative text is.
+ *
+ * Param context may be NULL; otherwise md_parse_with_context() is used.
+ * Param blocks may be NULL; otherwise its contents is replaced with a record
+ * for each block (see MD_TEXT_BLOCK). Offsets in the records are relative to
+ * the start of the buffer and of the input respectively.
+ * Param parser_flags are flags from md4c.h propagated to md_parse().
+ * Param renderer_flags is bitmask of MD_TEXT_FLAG_xxxx.
+ *
+ * Returns -1 on error (if md_parse() fails or the buffers cannot grow).
+ * Returns 0 on success.
+ */
+    int md_text(MD_PARSE_CONTEXT* context, const MD_CHAR* input, MD_SIZE input_size,
+        MD_TEXT_BUFFER* buffer, MD_TEXT_BLOCKS* blocks,
+        unsigned parser_flags, unsigned renderer_flags);
+
+
+#ifdef __cplusplus
+}  /* extern "C" { */
+#endif
+
+#endif  /* MD4C_TEXT_H */
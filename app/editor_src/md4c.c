@@ -25,6 +25,7 @@
 
 #include "md4c.h"
 #include <limits.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -117,6 +118,91 @@
 /* Suppress "unused parameter" warnings. */
 #define MD_UNUSED(x)                ((void)x)
 
+/* SIMD acceleration of some hot scanning loops (x86 only, 8-bit encodings
+ * only). SSE2 is the baseline; SSSE3 and AVX2 code paths are compiled in
+ * where the compiler allows it and selected at runtime. Define MD4C_NO_SIMD
+ * to use only the plain C loops. */
+#if !defined MD4C_NO_SIMD && !defined MD4C_USE_UTF16
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define MD_USE_SSE2
+#include <emmintrin.h>
+#if defined _MSC_VER
+#define MD_USE_AVX2
+#define MD_TARGET_SSSE3
+#define MD_TARGET_AVX2
+#include <immintrin.h>
+#include <intrin.h>
+#elif (defined __GNUC__ && __GNUC__ >= 5) || (defined __clang__ && __clang_major__ >= 4)
+#define MD_USE_AVX2
+#define MD_TARGET_SSSE3         __attribute__((target("ssse3")))
+#define MD_TARGET_AVX2          __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#endif
+#endif
+
+/* Threads for the optional parallel analysis of inlines (see
+ * md_parse_context_set_threads()). Define MD4C_NO_THREADS to build without
+ * them. */
+#if !defined MD4C_NO_THREADS
+#if defined _WIN32
+#define MD_USE_THREADS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+typedef HANDLE MD_THREAD;
+typedef CRITICAL_SECTION MD_MUTEX;
+typedef CONDITION_VARIABLE MD_COND;
+#define md_mutex_init(m)        InitializeCriticalSection(m)
+#define md_mutex_destroy(m)     DeleteCriticalSection(m)
+#define md_mutex_lock(m)        EnterCriticalSection(m)
+#define md_mutex_unlock(m)      LeaveCriticalSection(m)
+#define md_cond_init(c)         InitializeConditionVariable(c)
+#define md_cond_destroy(c)      ((void)(c))
+#define md_cond_wait(c, m)      SleepConditionVariableCS((c), (m), INFINITE)
+#define md_cond_broadcast(c)    WakeAllConditionVariable(c)
+#elif defined __unix__ || defined __APPLE__
+#define MD_USE_THREADS
+#include <pthread.h>
+typedef pthread_t MD_THREAD;
+typedef pthread_mutex_t MD_MUTEX;
+typedef pthread_cond_t MD_COND;
+#define md_mutex_init(m)        pthread_mutex_init((m), NULL)
+#define md_mutex_destroy(m)     pthread_mutex_destroy(m)
+#define md_mutex_lock(m)        pthread_mutex_lock(m)
+#define md_mutex_unlock(m)      pthread_mutex_unlock(m)
+#define md_cond_init(c)         pthread_cond_init((c), NULL)
+#define md_cond_destroy(c)      pthread_cond_destroy(c)
+#define md_cond_wait(c, m)      pthread_cond_wait((c), (m))
+#define md_cond_broadcast(c)    pthread_cond_broadcast(c)
+#endif
+#endif
+
+/* Millisecond clock for MD_PARSE_LIMITS::max_time_ms. Only differences of
+ * its values are meaningful. */
+#if defined _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#define md_clock_ms()           ((unsigned long) GetTickCount())
+#else
+#include <time.h>
+static unsigned long
+md_clock_ms(void)
+{
+#if defined CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return (unsigned long) ts.tv_sec * 1000 + (unsigned long) (ts.tv_nsec / 1000000);
+#endif
+    /* Processor time; good enough as a fallback. */
+    return (unsigned long) (clock() / (CLOCKS_PER_SEC / 1000));
+}
+#endif
+
 
 /******************************
  ***  Some internal limits  ***
@@ -150,6 +236,34 @@ typedef struct MD_MARK_tag MD_MARK;
 typedef struct MD_BLOCK_tag MD_BLOCK;
 typedef struct MD_CONTAINER_tag MD_CONTAINER;
 typedef struct MD_REF_DEF_tag MD_REF_DEF;
+typedef struct MD_REF_DEF_INDEX_tag MD_REF_DEF_INDEX;
+typedef struct MD_WORKER_POOL_tag MD_WORKER_POOL;
+
+
+/* Arena for small temporary allocations (ref. def. hashtable, table cell
+ * boundaries etc.). Memory is carved from a chain of blocks and it is never
+ * freed individually: md_arena_release() rewinds the arena to a position
+ * previously returned by md_arena_mark() (i.e. users have to nest properly),
+ * md_arena_reset() rewinds it completely. The blocks themselves are kept for
+ * reuse until md_arena_free(). */
+typedef struct MD_ARENA_BLOCK_tag MD_ARENA_BLOCK;
+struct MD_ARENA_BLOCK_tag {
+    MD_ARENA_BLOCK* next;
+    size_t size;        /* Usable bytes following this header. */
+    size_t used;
+};
+
+typedef struct MD_ARENA_tag MD_ARENA;
+struct MD_ARENA_tag {
+    MD_ARENA_BLOCK* head;
+    MD_ARENA_BLOCK* current;    /* Blocks after this one are unused. */
+};
+
+typedef struct MD_ARENA_MARK_tag MD_ARENA_MARK;
+struct MD_ARENA_MARK_tag {
+    MD_ARENA_BLOCK* block;
+    size_t used;
+};
 
 
 /* During analyzes of inline marks, we need to manage stacks of unresolved
@@ -173,16 +287,22 @@ struct MD_CTX_tag {
     /* When this is true, it allows some optimizations. */
     int doc_ends_with_newline;
 
+#ifdef MD_USE_AVX2
+    int simd_level;     /* MD_SIMD_xxxx supported by the CPU. */
+#endif
+
     /* Helper temporary growing buffer. */
     CHAR* buffer;
     unsigned alloc_buffer;
 
+    /* Small temporary allocations. */
+    MD_ARENA arena;
+
     /* Reference definitions. */
     MD_REF_DEF* ref_defs;
     int n_ref_defs;
     int alloc_ref_defs;
-    void** ref_def_hashtable;
-    int ref_def_hashtable_size;
+    MD_REF_DEF_INDEX* ref_def_index;
     SZ max_ref_def_output;
 
     /* Stack of inline/span markers.
@@ -199,6 +319,16 @@ struct MD_CTX_tag {
     char mark_char_map[256];
 #endif
 
+#ifdef MD_USE_AVX2
+    /* mark_char_map[] in the form of two nibble lookup tables for pshufb:
+     * ch is a mark char iff (mark_nibble_lo[ch & 0xf] & mark_nibble_hi[ch >> 4]).
+     * mark_simd_level is zero if the map cannot be expressed this way or the
+     * CPU lacks SSSE3. */
+    unsigned char mark_nibble_lo[16];
+    unsigned char mark_nibble_hi[16];
+    int mark_simd_level;
+#endif
+
     /* For resolving of inline spans. */
     MD_MARKSTACK opener_stacks[16];
 #define ASTERISK_OPENERS_oo_mod3_0      (ctx->opener_stacks[0])     /* Opener-only */
@@ -263,6 +393,18 @@ struct MD_CTX_tag {
     int html_block_type;    /* For checking closing raw HTML condition. */
     int last_line_has_list_loosening_effect;
     int last_list_item_starts_with_two_blank_lines;
+
+    /* Resource limits (copy of *MD_PARSER::limits, or all zero). */
+    MD_PARSE_LIMITS limits;
+    unsigned long start_time;   /* md_clock_ms() when the parsing started. */
+    int limit_exceeded;     /* The document is not rendered completely. */
+    int time_is_up;         /* No more blocks are rendered. */
+    int too_many_marks;     /* md_collect_marks() hit limits.max_marks. */
+
+#ifdef MD_USE_THREADS
+    /* Workers analyzing inlines ahead of md_process_all_blocks(), or NULL. */
+    MD_WORKER_POOL* pool;
+#endif
 };
 
 enum MD_LINETYPE_tag {
@@ -380,6 +522,155 @@ md_ascii_eq(const CHAR* s1, const CHAR* s2, SZ n)
     return memcmp(s1, s2, n * sizeof(CHAR)) == 0;
 }
 
+#ifdef MD_USE_SSE2
+
+static inline unsigned
+md_ctz(unsigned mask)
+{
+#if defined _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+#ifdef MD_USE_AVX2
+
+#define MD_SIMD_NONE        0
+#define MD_SIMD_SSSE3       1
+#define MD_SIMD_AVX2        2
+
+static int
+md_cpu_simd_level(void)
+{
+    static int level = -1;
+
+    if (level < 0) {
+#if defined _MSC_VER
+        int info[4];
+        int max_leaf;
+        int l = MD_SIMD_NONE;
+
+        __cpuid(info, 0);
+        max_leaf = info[0];
+        if (max_leaf >= 1) {
+            __cpuid(info, 1);
+            if (info[2] & (1 << 9))
+                l = MD_SIMD_SSSE3;
+            /* AVX2 also needs OSXSAVE + AVX, and the OS saving the YMM state. */
+            if (max_leaf >= 7 && (info[2] & (1 << 27)) && (info[2] & (1 << 28))
+                && (_xgetbv(0) & 6) == 6) {
+                __cpuidex(info, 7, 0);
+                if (info[1] & (1 << 5))
+                    l = MD_SIMD_AVX2;
+            }
+        }
+        level = l;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            level = MD_SIMD_AVX2;
+        else if (__builtin_cpu_supports("ssse3"))
+            level = MD_SIMD_SSSE3;
+        else
+            level = MD_SIMD_NONE;
+#endif
+    }
+
+    return level;
+}
+
+#endif  /* MD_USE_AVX2 */
+
+/* Skip to the next '\r' or '\n'. Returns its offset, or an offset where
+ * fewer than a full vector of chars remains before 'end'; the caller has to
+ * check the rest. */
+static OFF
+md_skip_non_newline_chars_sse2(MD_CTX* ctx, OFF off, OFF end)
+{
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    while (off + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)STR(off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(
+                            _mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 16;
+    }
+
+    return off;
+}
+
+#ifdef MD_USE_AVX2
+MD_TARGET_AVX2 static OFF
+md_skip_non_newline_chars_avx2(MD_CTX* ctx, OFF off, OFF end)
+{
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    while (off + 32 <= end) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)STR(off));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(
+                            _mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, lf)));
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 32;
+    }
+
+    /* Not calling the SSE2 variant for the rest: Mixing legacy SSE code with
+     * dirty upper YMM halves is very slow on some CPUs. */
+    if (off + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)STR(off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(
+                            _mm_cmpeq_epi8(v, _mm256_castsi256_si128(cr)),
+                            _mm_cmpeq_epi8(v, _mm256_castsi256_si128(lf))));
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 16;
+    }
+
+    return off;
+}
+#endif
+
+static inline OFF
+md_skip_non_newline_chars(MD_CTX* ctx, OFF off, OFF end)
+{
+#ifdef MD_USE_AVX2
+    if (ctx->simd_level == MD_SIMD_AVX2)
+        return md_skip_non_newline_chars_avx2(ctx, off, end);
+#endif
+    return md_skip_non_newline_chars_sse2(ctx, off, end);
+}
+
+/* Skip a run of spaces. Same contract as md_skip_non_newline_chars(). */
+static OFF
+md_skip_spaces_sse2(MD_CTX* ctx, OFF off, OFF end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+
+    while (off + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)STR(off));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, space)) ^ 0xffff;
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 16;
+    }
+
+    return off;
+}
+
+#endif  /* MD_USE_SSE2 */
+
+
 static int
 md_text_with_null_replacement(MD_CTX* ctx, MD_TEXTTYPE type, const CHAR* str, SZ size)
 {
@@ -387,8 +678,17 @@ md_text_with_null_replacement(MD_CTX* ctx, MD_TEXTTYPE type, const CHAR* str, SZ
     int ret = 0;
 
     while (1) {
+#if !defined MD4C_USE_UTF16
+        /* memchr() is vectorized by any decent C library. This matters for
+         * long verbatim lines (e.g. minified JSON in code blocks). */
+        if (off < size) {
+            const CHAR* nul = (const CHAR*)memchr(str + off, _T('\0'), size - off);
+            off = (nul != NULL ? (OFF)(nul - str) : size);
+        }
+#else
         while (off < size && str[off] != _T('\0'))
             off++;
+#endif
 
         if (off > 0) {
             ret = ctx->parser.text(type, str, off, ctx->userdata);
@@ -438,6 +738,127 @@ md_text_with_null_replacement(MD_CTX* ctx, MD_TEXTTYPE type, const CHAR* str, SZ
     } while(0)
 
 
+#define MD_ARENA_ALIGN          8
+#define MD_ARENA_BLOCK_SIZE     4096
+
+static void*
+md_arena_alloc(MD_ARENA* arena, size_t size)
+{
+    MD_ARENA_BLOCK* block = arena->current;
+    void* ptr;
+
+    size = (size + MD_ARENA_ALIGN - 1) & ~(size_t)(MD_ARENA_ALIGN - 1);
+
+    /* Blocks following the current one are free; move on until we find one
+     * large enough. */
+    while (block != NULL && block->size - block->used < size) {
+        block = block->next;
+        if (block != NULL)
+            block->used = 0;
+    }
+
+    if (block == NULL) {
+        MD_ARENA_BLOCK* tail;
+        size_t block_size = MD_ARENA_BLOCK_SIZE;
+
+        while (block_size < size)
+            block_size *= 2;
+        block = (MD_ARENA_BLOCK*)malloc(sizeof(MD_ARENA_BLOCK) + block_size);
+        if (block == NULL)
+            return NULL;
+        block->next = NULL;
+        block->size = block_size;
+        block->used = 0;
+
+        if (arena->head == NULL) {
+            arena->head = block;
+        } else {
+            tail = (arena->current != NULL ? arena->current : arena->head);
+            while (tail->next != NULL)
+                tail = tail->next;
+            tail->next = block;
+        }
+    }
+
+    arena->current = block;
+    ptr = (char*)(block + 1) + block->used;
+    block->used += size;
+    return ptr;
+}
+
+static inline MD_ARENA_MARK
+md_arena_mark(MD_ARENA* arena)
+{
+    MD_ARENA_MARK mark;
+
+    mark.block = arena->current;
+    mark.used = (arena->current != NULL ? arena->current->used : 0);
+    return mark;
+}
+
+static void
+md_arena_release(MD_ARENA* arena, MD_ARENA_MARK mark)
+{
+    if (mark.block != NULL) {
+        arena->current = mark.block;
+        arena->current->used = mark.used;
+    } else {
+        arena->current = arena->head;
+        if (arena->current != NULL)
+            arena->current->used = 0;
+    }
+}
+
+static void
+md_arena_reset(MD_ARENA* arena)
+{
+    MD_ARENA_MARK mark = { NULL, 0 };
+    md_arena_release(arena, mark);
+}
+
+static void
+md_arena_free(MD_ARENA* arena)
+{
+    MD_ARENA_BLOCK* block = arena->head;
+
+    while (block != NULL) {
+        MD_ARENA_BLOCK* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+/* If the arena had to grow into multiple blocks, replace them with a single
+ * block of the total size so the next parse is served without any malloc(). */
+static void
+md_arena_compact(MD_ARENA* arena)
+{
+    MD_ARENA_BLOCK* block;
+    size_t total = 0;
+
+    if (arena->head == NULL || arena->head->next == NULL) {
+        md_arena_reset(arena);
+        return;
+    }
+
+    for (block = arena->head; block != NULL; block = block->next)
+        total += block->size;
+    md_arena_free(arena);
+
+    block = (MD_ARENA_BLOCK*)malloc(sizeof(MD_ARENA_BLOCK) + total);
+    if (block != NULL) {
+        block->next = NULL;
+        block->size = total;
+        block->used = 0;
+        arena->head = block;
+        arena->current = block;
+    }
+}
+
+
 #define MD_ENTER_BLOCK(type, arg)                                           \
     do {                                                                    \
         ret = ctx->parser.enter_block((type), (arg), ctx->userdata);        \
@@ -546,242 +967,600 @@ struct MD_UNICODE_FOLD_INFO_tag {
 
 
 #if defined MD4C_USE_UTF16 || defined MD4C_USE_UTF8
-/* Binary search over sorted "map" of codepoints. Consecutive sequences
- * of codepoints may be encoded in the map by just using the
- * (MIN_CODEPOINT | 0x40000000) and (MAX_CODEPOINT | 0x80000000).
+/* Two-stage lookup tables: (codepoint >> *_PAGE_SHIFT) selects a page in
+ * *_PAGE_INDEX[], the page then holds the property of every codepoint in it.
+ * Identical pages (most of them are all-zero) are stored only once, so any
+ * lookup is just two or three dependent loads. Codepoints at or above
+ * UNICODE_TABLE_LIMIT have no property.
  *
- * Returns index of the found record in the map (in the case of ranges,
- * the minimal value is used); or -1 on failure. */
-static int
-md_unicode_bsearch__(unsigned codepoint, const unsigned* map, size_t map_size)
-{
-    int beg, end;
-    int pivot_beg, pivot_end;
-
-    beg = 0;
-    end = (int)map_size - 1;
-    while (beg <= end) {
-        /* Pivot may be a range, not just a single value. */
-        pivot_beg = pivot_end = (beg + end) / 2;
-        if (map[pivot_end] & 0x40000000)
-            pivot_end++;
-        if (map[pivot_beg] & 0x80000000)
-            pivot_beg--;
-
-        if (codepoint < (map[pivot_beg] & 0x00ffffff))
-            end = pivot_beg - 1;
-        else if (codepoint > (map[pivot_end] & 0x00ffffff))
-            beg = pivot_end + 1;
-        else
-            return pivot_beg;
-    }
+ *  - WHITESPACE_*: Bitmap of Unicode "Zs" category.
+ *  - PUNCT_*: Bitmap of Unicode "P*" and "S*" categories.
+ *  - FOLD_*: Per-codepoint index into FOLD_RECORDS[], i.e. the full case
+ *    folding ("C" and "F" statuses). Each record is { n_codepoints,
+ *    delta of the 1st folded codepoint, 2nd codepoint, 3rd codepoint }.
+ *
+ * (generated by scripts/build_unicode_tables.py) */
+#define UNICODE_TABLE_LIMIT     0x1fc00
+
+#define WHITESPACE_PAGE_SHIFT   9
+#define WHITESPACE_PAGE_BYTES   64
+static const unsigned char WHITESPACE_PAGE_INDEX[254] = {
+      0,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  1,  1,  1,  1,  3,  1,  1,  1,  1,  1,  1,  1,  4,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1
+};
+static const unsigned char WHITESPACE_PAGES[320] = {
+     0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0xff, 0x07, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
 
-    return -1;
-}
+#define PUNCT_PAGE_SHIFT        6
+#define PUNCT_PAGE_BYTES        8
+static const unsigned char PUNCT_PAGE_INDEX[2032] = {
+      0,  1,  2,  3,  4,  4,  4,  4,  4,  4,  4,  5,  4,  6,  7,  8,  4,  4,  9,  4,  4, 10, 11, 12, 13, 14,  4, 15, 16,  4,  4, 17,
+     18, 19, 20,  4,  4, 21,  4, 22,  4,  8,  4, 23,  4, 24,  4, 25,  4, 26, 27,  4,  4, 28,  4, 29, 30, 31,  4,  4, 32,  4, 33, 34,
+      4, 35, 36, 37,  4,  4,  4,  4,  4,  4,  4,  4,  4, 38, 39,  4, 40,  4,  4,  4,  4,  4,  4,  4,  4, 41, 42, 43, 44,  4,  4, 45,
+     46,  4,  4,  4,  4, 47,  4, 48, 36,  4, 49,  4,  4, 50,  4, 51, 52, 53,  4, 54,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4, 55, 56,
+     57, 58, 59, 40, 60, 61, 62, 63, 63, 63, 63, 63, 63, 63, 63, 63, 64, 46, 65, 66, 63, 63, 63, 63, 63, 63, 63, 63, 63, 67, 68, 63,
+     63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 69, 70, 63,  4,  4,  4, 71,  4, 24,  4,  4, 72, 73, 74, 75, 63, 63, 63, 76,
+     77,  4, 78, 37,  4,  4, 79, 80, 81, 82, 83, 63, 63, 63, 63, 63,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4, 63,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4, 84, 85,  4,  4,  4,  4, 86, 87,  4, 88, 89,  4, 90,  4,
+     91, 92,  4, 93, 94, 95,  4, 96,  4, 97,  4, 98,  4, 99,  4,100,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,101,  4,102,103,  4,  4,  4,  4, 53,104,  4,105,106,107,  4,  4,108,109,  4,110,
+      4,  4,  4,  4,111,112,113,114,  4,  4,  4,  4,  4,  4, 95,115,  4,  4,  4,  4,  4,116,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,117,  4,  4,118,  4,  4,  4,  4,119,  4,120,112,  4,121,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,122,  4,  4,123,124,  4,
+      4,125,126,127,  4,128,  4,129,130,  4,101,  4,  4,  4,  4,  4,  4,131,  4,132,  4,  4,  4,133,  4,134,135,  4, 51,  4,  4,  4,
+     37,  4,  4,  4,  4,136,  4,137, 30,138,139,  4,140,  4,  4,  4,  4,141,  4,  4,  4,  4,  4,  4,  4,  4,  4,142,  4,143,  4,144,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,145,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,146,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4, 94,  4,147,148,149,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,150,  4,  4,  4,  4,137,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,151,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4, 84, 63,152,
+     63, 63, 63, 67,153,154,155,156, 63,157,  4,  4, 63,158,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,159,160,161,162,163,
+     63, 63, 63, 63, 63, 63, 63, 63,164,165,166,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4,167,  4,  4,  4,  4,  4, 30,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,
+      4,  4,  4,  4,  4, 36,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,168,  4,169,  4,  4,  4,  4,  4,  4, 23,  4,  4,  4,  4,
+    170, 63,171,172,173, 63,174,175,176,177,  4,  4, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63,178, 63,179, 63,180,
+    181,182,183,  4, 63, 63, 63, 63, 63,184,185,186, 63, 63,187, 46
+};
+static const unsigned char PUNCT_PAGES[1504] = {
+     0x00, 0x00, 0x00, 0x00, 0xfe, 0xff, 0x00, 0xfc, 0x01, 0x00, 0x00, 0xf8, 0x01, 0x00, 0x00, 0x78,
+     0x00, 0x00, 0x00, 0x00, 0xfe, 0xdb, 0xd3, 0x89, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x00, 0xfc, 0xff, 0xe0, 0xaf, 0xff, 0xff,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x40, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,
+     0x49, 0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0xc0, 0xff, 0x00, 0xe8, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x00, 0x10, 0x40, 0x00, 0x02, 0x00, 0x60,
+     0xff, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0xc3,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x01, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x2c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x07,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x80, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00,
+     0xfe, 0xff, 0xff, 0xfc, 0x00, 0x00, 0x50, 0x3d, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0,
+     0xbf, 0xdf, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+     0x00, 0x00, 0x00, 0x00, 0xff, 0x01, 0x00, 0x00, 0x00, 0x00, 0xff, 0x03, 0x00, 0x00, 0x00, 0x00,
+     0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00, 0x70, 0x0f, 0x00, 0x00, 0x00, 0x00,
+     0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x7f, 0x3f, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0xfc, 0xff, 0x07, 0xf0, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0,
+     0xff, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa0,
+     0x03, 0xe0, 0x00, 0xe0, 0x00, 0xe0, 0x00, 0x60, 0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x7c, 0x00, 0x7c, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+     0x7b, 0x03, 0xd0, 0xc1, 0xaf, 0x42, 0x00, 0x0c, 0x1f, 0xbc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x0c, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0x03, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3f, 0x00,
+     0x00, 0x00, 0xf0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xcf, 0xff,
+     0xff, 0xff, 0xbf, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x07, 0x00, 0xde,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3f, 0x00, 0x00, 0x00, 0x00,
+     0xff, 0xff, 0xff, 0xfb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0f, 0x00,
+     0xff, 0xff, 0x3f, 0x00, 0x00, 0x00, 0xff, 0xff, 0x1e, 0xff, 0xff, 0xff, 0x01, 0x00, 0xc1, 0xe0,
+     0x00, 0x00, 0x00, 0x18, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc3, 0xff, 0x00, 0x00, 0x00, 0x00,
+     0xff, 0xff, 0xff, 0xff, 0x0f, 0x80, 0x00, 0x00, 0xff, 0xff, 0xff, 0x7f, 0x00, 0xfc, 0xff, 0xff,
+     0xff, 0x00, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0xfc, 0xff, 0xff, 0xff, 0xff, 0x01, 0x00,
+     0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0,
+     0x00, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x40,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0x00, 0xff, 0xff, 0x7f, 0x00, 0x03, 0x00, 0x00, 0x00,
+     0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xc0, 0x03,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x17,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00,
+     0xfe, 0x3f, 0x00, 0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x80, 0x03,
+     0x00, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x0c, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfc, 0xff, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0,
+     0x00, 0x00, 0xff, 0x03, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xf7, 0xff, 0x7f, 0x0f, 0x00, 0x00,
+     0xfe, 0xff, 0x00, 0xfc, 0x01, 0x00, 0x00, 0xf8, 0x01, 0x00, 0x00, 0xf8, 0x3f, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x7f, 0x7f, 0x00, 0x30, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xff,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xff, 0x73, 0xff, 0x1f, 0x01, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x1f, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80, 0x01,
+     0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0xff, 0x01, 0x00, 0x00, 0x00, 0x80,
+     0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0xe0, 0x03, 0x00, 0x00, 0x00, 0x00,
+     0xc0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xd8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0xe0, 0x21, 0x00, 0xe8, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x00, 0xf8, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00,
+     0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x0e, 0x00, 0x00, 0x00, 0xff, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+     0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00,
+     0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdc, 0x07, 0x00, 0x00, 0x00,
+     0xff, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0xf8, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0xe0, 0xff, 0xff, 0xff, 0x03, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xff, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x00,
+     0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x7f, 0xfe, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0x1f, 0x1c, 0x00, 0x00, 0x18, 0xf0, 0xff, 0xff, 0xff, 0xc3, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0x07, 0x00, 0x00, 0x23, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0xff, 0xff, 0x7f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08,
+     0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00,
+     0x00, 0x02, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe0, 0xdf, 0xff,
+     0xef, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0x0f, 0xff, 0xff, 0xff, 0xff, 0x0f, 0x00, 0xff, 0x7f, 0xfe, 0xff,
+     0xfe, 0xff, 0xfe, 0xff, 0xff, 0xff, 0x3f, 0x00, 0x00, 0xe0, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0, 0xff, 0xff, 0xff,
+     0x07, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0f, 0xff, 0x01, 0x03, 0x00, 0x3f, 0x00, 0x00, 0x00,
+     0xff, 0xff, 0xff, 0xf0, 0xff, 0x1f, 0xff, 0x1f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0xf8,
+     0xff, 0xff, 0xff, 0x03, 0xff, 0x0f, 0x01, 0x00, 0xff, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0x00, 0xff, 0x03, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0xff, 0xff, 0xff, 0x3f, 0x03, 0x00,
+     0xff, 0xff, 0x0f, 0x00, 0xff, 0x3f, 0xff, 0x1f, 0xff, 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xbf,
+     0x3f, 0xc0, 0xff, 0x0f, 0xff, 0x01, 0xff, 0x01, 0xff, 0xff, 0xf7, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+#define FOLD_PAGE_SHIFT         6
+static const unsigned char FOLD_PAGE_INDEX[2032] = {
+      0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  0,  0,  0, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0, 20, 21,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 22,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 23,  0,  0,  0,  0,  0, 24, 24, 25, 24, 26, 27, 28, 29,
+      0,  0,  0,  0, 30, 31, 32,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 33, 34,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 35, 36, 24, 37,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 38, 39,  0, 40, 41, 42, 43,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 44, 45,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 46,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 47,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 48,  0, 49, 50,  0, 51, 52,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 53,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0, 54,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 55,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0, 56,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+static const unsigned char FOLD_PAGES[3648] = {
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  0,  1,  1,  1,  1,  1,  1,  1,  3,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  5,  0,  4,  0,  4,  0,  4,  0,  0,  4,  0,  4,  0,  4,  0,  4,
+      0,  4,  0,  4,  0,  4,  0,  4,  0,  6,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  7,  4,  0,  4,  0,  4,  0,  8,
+      0,  9,  4,  0,  4,  0, 10,  4,  0, 11, 11,  4,  0,  0, 12, 13, 14,  4,  0, 11, 15,  0, 16, 17,  4,  0,  0,  0, 16, 18,  0, 19,
+      4,  0,  4,  0,  4,  0, 20,  4,  0, 20,  0,  0,  4,  0, 20,  4,  0, 21, 21,  4,  0,  4,  0, 22,  4,  0,  0,  0,  4,  0,  0,  0,
+      0,  0,  0,  0, 23,  4,  0, 23,  4,  0, 23,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0, 24, 23,  4,  0,  4,  0, 25, 26,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+     27,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  0,  0,  0,  0, 28,  4,  0, 29, 30,  0,
+      0,  4,  0, 31, 32, 33,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0, 34,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,  4,  0,  0,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0, 34,
+      0,  0,  0,  0,  0,  0, 35,  0, 36, 36, 36,  0, 37,  0, 38, 38, 39,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  0,  1,  1,  1,  1,  1,  1,  1,  1,  1,  0,  0,  0,  0, 40,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 41, 42, 43,  0,  0,  0, 44, 45,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0, 46, 47,  0,  0, 48, 49,  0,  4,  0, 50,  4,  0,  0, 27, 27, 27,
+     51, 51, 51, 51, 51, 51, 51, 51, 51, 51, 51, 51, 51, 51, 51, 51,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+     52,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53,
+     53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0, 54,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55, 55,
+     55, 55, 55, 55, 55, 55,  0, 55,  0,  0,  0,  0,  0, 55,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56,  0,  0,
+     57, 58, 59, 60, 60, 61, 62, 63, 64,  0,  0,  0,  0,  0,  0,  0, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,
+     65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65, 65,  0,  0, 65, 65, 65,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0, 66, 67, 68, 69, 70, 71,  0,  0, 72,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56, 56, 56,  0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56, 56, 56,  0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56, 56, 56,
+      0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56,  0,  0, 73,  0, 74,  0, 75,  0, 76,  0,  0, 56,  0, 56,  0, 56,  0, 56,
+      0,  0,  0,  0,  0,  0,  0,  0, 56, 56, 56, 56, 56, 56, 56, 56,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     77, 77, 77, 77, 77, 77, 77, 77, 78, 78, 78, 78, 78, 78, 78, 78, 79, 79, 79, 79, 79, 79, 79, 79, 80, 80, 80, 80, 80, 80, 80, 80,
+     81, 81, 81, 81, 81, 81, 81, 81, 82, 82, 82, 82, 82, 82, 82, 82,  0,  0, 83, 84, 85,  0, 86, 87, 56, 56, 88, 88, 89,  0, 90,  0,
+      0,  0, 91, 92, 93,  0, 94, 95, 96, 96, 96, 96, 97,  0,  0,  0,  0,  0, 98, 99,  0,  0,100,101, 56, 56,102,102,  0,  0,  0,  0,
+      0,  0,103,104,105,  0,106,107, 56, 56,108,108, 50,  0,  0,  0,  0,  0,109,110,111,  0,112,113,114,114,115,115,116,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,117,  0,  0,  0,118,119,  0,  0,  0,  0,  0,  0,120,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,121,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,122,122,122,122,122,122,122,122,122,122,
+    122,122,122,122,122,122,122,122,122,122,122,122,122,122,122,122,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53,
+     53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      4,  0,123,124,125,  0,  0,  4,  0,  4,  0,  4,  0,126,127,128,129,  0,  4,  0,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,130,130,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,  4,  0,  0,  0,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,  4,  0,131,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  0,  0,  0,  4,  0,132,  0,  0,  4,  0,  4,  0,  0,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0,  4,  0,  4,  0,  4,  0,133,134,135,136,133,  0,137,138,139,140,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,  4,  0,
+      4,  0,  4,  0, 47,141,142,  4,  0,  4,  0,  0,  0,  0,  0,  0,  4,  0,  0,  0,  0,  0,  4,  0,  4,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  4,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,
+    143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,
+    143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,143,
+    144,145,146,147,148,149,150,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,151,152,153,154,155,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  0,  0,  0,  0,  0,
+    156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,
+    156,156,156,156,156,156,156,156,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,
+    156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,156,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,157,157,157,157,157,157,157,157,157,157,157,  0,157,157,157,157,
+    157,157,157,157,157,157,157,157,157,157,157,  0,157,157,157,157,157,157,157,  0,157,157,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37,
+     37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+      0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,158,
+    158,158,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+static const int FOLD_RECORDS[159][4] = {
+    { 1, 0, 0x0000, 0x0000 },
+    { 1, 32, 0x0000, 0x0000 },
+    { 1, 775, 0x0000, 0x0000 },
+    { 2, -108, 0x0073, 0x0000 },
+    { 1, 1, 0x0000, 0x0000 },
+    { 2, -199, 0x0307, 0x0000 },
+    { 2, 371, 0x006e, 0x0000 },
+    { 1, -121, 0x0000, 0x0000 },
+    { 1, -268, 0x0000, 0x0000 },
+    { 1, 210, 0x0000, 0x0000 },
+    { 1, 206, 0x0000, 0x0000 },
+    { 1, 205, 0x0000, 0x0000 },
+    { 1, 79, 0x0000, 0x0000 },
+    { 1, 202, 0x0000, 0x0000 },
+    { 1, 203, 0x0000, 0x0000 },
+    { 1, 207, 0x0000, 0x0000 },
+    { 1, 211, 0x0000, 0x0000 },
+    { 1, 209, 0x0000, 0x0000 },
+    { 1, 213, 0x0000, 0x0000 },
+    { 1, 214, 0x0000, 0x0000 },
+    { 1, 218, 0x0000, 0x0000 },
+    { 1, 217, 0x0000, 0x0000 },
+    { 1, 219, 0x0000, 0x0000 },
+    { 1, 2, 0x0000, 0x0000 },
+    { 2, -390, 0x030c, 0x0000 },
+    { 1, -97, 0x0000, 0x0000 },
+    { 1, -56, 0x0000, 0x0000 },
+    { 1, -130, 0x0000, 0x0000 },
+    { 1, 10795, 0x0000, 0x0000 },
+    { 1, -163, 0x0000, 0x0000 },
+    { 1, 10792, 0x0000, 0x0000 },
+    { 1, -195, 0x0000, 0x0000 },
+    { 1, 69, 0x0000, 0x0000 },
+    { 1, 71, 0x0000, 0x0000 },
+    { 1, 116, 0x0000, 0x0000 },
+    { 1, 38, 0x0000, 0x0000 },
+    { 1, 37, 0x0000, 0x0000 },
+    { 1, 64, 0x0000, 0x0000 },
+    { 1, 63, 0x0000, 0x0000 },
+    { 3, 41, 0x0308, 0x0301 },
+    { 3, 21, 0x0308, 0x0301 },
+    { 1, 8, 0x0000, 0x0000 },
+    { 1, -30, 0x0000, 0x0000 },
+    { 1, -25, 0x0000, 0x0000 },
+    { 1, -15, 0x0000, 0x0000 },
+    { 1, -22, 0x0000, 0x0000 },
+    { 1, -54, 0x0000, 0x0000 },
+    { 1, -48, 0x0000, 0x0000 },
+    { 1, -60, 0x0000, 0x0000 },
+    { 1, -64, 0x0000, 0x0000 },
+    { 1, -7, 0x0000, 0x0000 },
+    { 1, 80, 0x0000, 0x0000 },
+    { 1, 15, 0x0000, 0x0000 },
+    { 1, 48, 0x0000, 0x0000 },
+    { 2, -34, 0x0582, 0x0000 },
+    { 1, 7264, 0x0000, 0x0000 },
+    { 1, -8, 0x0000, 0x0000 },
+    { 1, -6222, 0x0000, 0x0000 },
+    { 1, -6221, 0x0000, 0x0000 },
+    { 1, -6212, 0x0000, 0x0000 },
+    { 1, -6210, 0x0000, 0x0000 },
+    { 1, -6211, 0x0000, 0x0000 },
+    { 1, -6204, 0x0000, 0x0000 },
+    { 1, -6180, 0x0000, 0x0000 },
+    { 1, 35267, 0x0000, 0x0000 },
+    { 1, -3008, 0x0000, 0x0000 },
+    { 2, -7726, 0x0331, 0x0000 },
+    { 2, -7715, 0x0308, 0x0000 },
+    { 2, -7713, 0x030a, 0x0000 },
+    { 2, -7712, 0x030a, 0x0000 },
+    { 2, -7737, 0x02be, 0x0000 },
+    { 1, -58, 0x0000, 0x0000 },
+    { 2, -7723, 0x0073, 0x0000 },
+    { 2, -7051, 0x0313, 0x0000 },
+    { 3, -7053, 0x0313, 0x0300 },
+    { 3, -7055, 0x0313, 0x0301 },
+    { 3, -7057, 0x0313, 0x0342 },
+    { 2, -128, 0x03b9, 0x0000 },
+    { 2, -136, 0x03b9, 0x0000 },
+    { 2, -112, 0x03b9, 0x0000 },
+    { 2, -120, 0x03b9, 0x0000 },
+    { 2, -64, 0x03b9, 0x0000 },
+    { 2, -72, 0x03b9, 0x0000 },
+    { 2, -66, 0x03b9, 0x0000 },
+    { 2, -7170, 0x03b9, 0x0000 },
+    { 2, -7176, 0x03b9, 0x0000 },
+    { 2, -7173, 0x0342, 0x0000 },
+    { 3, -7174, 0x0342, 0x03b9 },
+    { 1, -74, 0x0000, 0x0000 },
+    { 2, -7179, 0x03b9, 0x0000 },
+    { 1, -7173, 0x0000, 0x0000 },
+    { 2, -78, 0x03b9, 0x0000 },
+    { 2, -7180, 0x03b9, 0x0000 },
+    { 2, -7190, 0x03b9, 0x0000 },
+    { 2, -7183, 0x0342, 0x0000 },
+    { 3, -7184, 0x0342, 0x03b9 },
+    { 1, -86, 0x0000, 0x0000 },
+    { 2, -7189, 0x03b9, 0x0000 },
+    { 3, -7193, 0x0308, 0x0300 },
+    { 3, -7194, 0x0308, 0x0301 },
+    { 2, -7197, 0x0342, 0x0000 },
+    { 3, -7198, 0x0308, 0x0342 },
+    { 1, -100, 0x0000, 0x0000 },
+    { 3, -7197, 0x0308, 0x0300 },
+    { 3, -7198, 0x0308, 0x0301 },
+    { 2, -7203, 0x0313, 0x0000 },
+    { 2, -7201, 0x0342, 0x0000 },
+    { 3, -7202, 0x0308, 0x0342 },
+    { 1, -112, 0x0000, 0x0000 },
+    { 2, -118, 0x03b9, 0x0000 },
+    { 2, -7210, 0x03b9, 0x0000 },
+    { 2, -7206, 0x03b9, 0x0000 },
+    { 2, -7213, 0x0342, 0x0000 },
+    { 3, -7214, 0x0342, 0x03b9 },
+    { 1, -128, 0x0000, 0x0000 },
+    { 1, -126, 0x0000, 0x0000 },
+    { 2, -7219, 0x03b9, 0x0000 },
+    { 1, -7517, 0x0000, 0x0000 },
+    { 1, -8383, 0x0000, 0x0000 },
+    { 1, -8262, 0x0000, 0x0000 },
+    { 1, 28, 0x0000, 0x0000 },
+    { 1, 16, 0x0000, 0x0000 },
+    { 1, 26, 0x0000, 0x0000 },
+    { 1, -10743, 0x0000, 0x0000 },
+    { 1, -3814, 0x0000, 0x0000 },
+    { 1, -10727, 0x0000, 0x0000 },
+    { 1, -10780, 0x0000, 0x0000 },
+    { 1, -10749, 0x0000, 0x0000 },
+    { 1, -10783, 0x0000, 0x0000 },
+    { 1, -10782, 0x0000, 0x0000 },
+    { 1, -10815, 0x0000, 0x0000 },
+    { 1, -35332, 0x0000, 0x0000 },
+    { 1, -42280, 0x0000, 0x0000 },
+    { 1, -42308, 0x0000, 0x0000 },
+    { 1, -42319, 0x0000, 0x0000 },
+    { 1, -42315, 0x0000, 0x0000 },
+    { 1, -42305, 0x0000, 0x0000 },
+    { 1, -42258, 0x0000, 0x0000 },
+    { 1, -42282, 0x0000, 0x0000 },
+    { 1, -42261, 0x0000, 0x0000 },
+    { 1, 928, 0x0000, 0x0000 },
+    { 1, -42307, 0x0000, 0x0000 },
+    { 1, -35384, 0x0000, 0x0000 },
+    { 1, -38864, 0x0000, 0x0000 },
+    { 2, -64154, 0x0066, 0x0000 },
+    { 2, -64155, 0x0069, 0x0000 },
+    { 2, -64156, 0x006c, 0x0000 },
+    { 3, -64157, 0x0066, 0x0069 },
+    { 3, -64158, 0x0066, 0x006c },
+    { 2, -64146, 0x0074, 0x0000 },
+    { 2, -64147, 0x0074, 0x0000 },
+    { 2, -62879, 0x0576, 0x0000 },
+    { 2, -62880, 0x0565, 0x0000 },
+    { 2, -62881, 0x056b, 0x0000 },
+    { 2, -62872, 0x0576, 0x0000 },
+    { 2, -62883, 0x056d, 0x0000 },
+    { 1, 40, 0x0000, 0x0000 },
+    { 1, 39, 0x0000, 0x0000 },
+    { 1, 34, 0x0000, 0x0000 }
+};
+
+#define MD_UNICODE_BIT(prefix, codepoint)                                   \
+        ((prefix##_PAGES[prefix##_PAGE_INDEX[(codepoint) >> prefix##_PAGE_SHIFT] * prefix##_PAGE_BYTES \
+                         + (((codepoint) & ((1 << prefix##_PAGE_SHIFT) - 1)) >> 3)] >> ((codepoint) & 0x7)) & 0x1)
 
 static int
 md_is_unicode_whitespace__(unsigned codepoint)
 {
-#define R(cp_min, cp_max)   ((cp_min) | 0x40000000), ((cp_max) | 0x80000000)
-#define S(cp)               (cp)
-    /* Unicode "Zs" category.
-     * (generated by scripts/build_whitespace_map.py) */
-    static const unsigned WHITESPACE_MAP[] = {
-        S(0x0020), S(0x00a0), S(0x1680), R(0x2000,0x200a), S(0x202f), S(0x205f), S(0x3000)
-    };
-#undef R
-#undef S
-
     /* The ASCII ones are the most frequently used ones, also CommonMark
      * specification requests few more in this range. */
     if (codepoint <= 0x7f)
         return ISWHITESPACE_(codepoint);
 
-    return (md_unicode_bsearch__(codepoint, WHITESPACE_MAP, SIZEOF_ARRAY(WHITESPACE_MAP)) >= 0);
+    if (codepoint >= UNICODE_TABLE_LIMIT)
+        return FALSE;
+    return MD_UNICODE_BIT(WHITESPACE, codepoint);
 }
 
 static int
 md_is_unicode_punct__(unsigned codepoint)
 {
-#define R(cp_min, cp_max)   ((cp_min) | 0x40000000), ((cp_max) | 0x80000000)
-#define S(cp)               (cp)
-    /* Unicode general "P" and "S" categories.
-     * (generated by scripts/build_punct_map.py) */
-    static const unsigned PUNCT_MAP[] = {
-        R(0x0021,0x002f), R(0x003a,0x0040), R(0x005b,0x0060), R(0x007b,0x007e), R(0x00a1,0x00a9),
-        R(0x00ab,0x00ac), R(0x00ae,0x00b1), S(0x00b4), R(0x00b6,0x00b8), S(0x00bb), S(0x00bf), S(0x00d7),
-        S(0x00f7), R(0x02c2,0x02c5), R(0x02d2,0x02df), R(0x02e5,0x02eb), S(0x02ed), R(0x02ef,0x02ff), S(0x0375),
-        S(0x037e), R(0x0384,0x0385), S(0x0387), S(0x03f6), S(0x0482), R(0x055a,0x055f), R(0x0589,0x058a),
-        R(0x058d,0x058f), S(0x05be), S(0x05c0), S(0x05c3), S(0x05c6), R(0x05f3,0x05f4), R(0x0606,0x060f),
-        S(0x061b), R(0x061d,0x061f), R(0x066a,0x066d), S(0x06d4), S(0x06de), S(0x06e9), R(0x06fd,0x06fe),
-        R(0x0700,0x070d), R(0x07f6,0x07f9), R(0x07fe,0x07ff), R(0x0830,0x083e), S(0x085e), S(0x0888),
-        R(0x0964,0x0965), S(0x0970), R(0x09f2,0x09f3), R(0x09fa,0x09fb), S(0x09fd), S(0x0a76), R(0x0af0,0x0af1),
-        S(0x0b70), R(0x0bf3,0x0bfa), S(0x0c77), S(0x0c7f), S(0x0c84), S(0x0d4f), S(0x0d79), S(0x0df4), S(0x0e3f),
-        S(0x0e4f), R(0x0e5a,0x0e5b), R(0x0f01,0x0f17), R(0x0f1a,0x0f1f), S(0x0f34), S(0x0f36), S(0x0f38),
-        R(0x0f3a,0x0f3d), S(0x0f85), R(0x0fbe,0x0fc5), R(0x0fc7,0x0fcc), R(0x0fce,0x0fda), R(0x104a,0x104f),
-        R(0x109e,0x109f), S(0x10fb), R(0x1360,0x1368), R(0x1390,0x1399), S(0x1400), R(0x166d,0x166e),
-        R(0x169b,0x169c), R(0x16eb,0x16ed), R(0x1735,0x1736), R(0x17d4,0x17d6), R(0x17d8,0x17db),
-        R(0x1800,0x180a), S(0x1940), R(0x1944,0x1945), R(0x19de,0x19ff), R(0x1a1e,0x1a1f), R(0x1aa0,0x1aa6),
-        R(0x1aa8,0x1aad), R(0x1b5a,0x1b6a), R(0x1b74,0x1b7e), R(0x1bfc,0x1bff), R(0x1c3b,0x1c3f),
-        R(0x1c7e,0x1c7f), R(0x1cc0,0x1cc7), S(0x1cd3), S(0x1fbd), R(0x1fbf,0x1fc1), R(0x1fcd,0x1fcf),
-        R(0x1fdd,0x1fdf), R(0x1fed,0x1fef), R(0x1ffd,0x1ffe), R(0x2010,0x2027), R(0x2030,0x205e),
-        R(0x207a,0x207e), R(0x208a,0x208e), R(0x20a0,0x20c0), R(0x2100,0x2101), R(0x2103,0x2106),
-        R(0x2108,0x2109), S(0x2114), R(0x2116,0x2118), R(0x211e,0x2123), S(0x2125), S(0x2127), S(0x2129),
-        S(0x212e), R(0x213a,0x213b), R(0x2140,0x2144), R(0x214a,0x214d), S(0x214f), R(0x218a,0x218b),
-        R(0x2190,0x2426), R(0x2440,0x244a), R(0x249c,0x24e9), R(0x2500,0x2775), R(0x2794,0x2b73),
-        R(0x2b76,0x2b95), R(0x2b97,0x2bff), R(0x2ce5,0x2cea), R(0x2cf9,0x2cfc), R(0x2cfe,0x2cff), S(0x2d70),
-        R(0x2e00,0x2e2e), R(0x2e30,0x2e5d), R(0x2e80,0x2e99), R(0x2e9b,0x2ef3), R(0x2f00,0x2fd5),
-        R(0x2ff0,0x2fff), R(0x3001,0x3004), R(0x3008,0x3020), S(0x3030), R(0x3036,0x3037), R(0x303d,0x303f),
-        R(0x309b,0x309c), S(0x30a0), S(0x30fb), R(0x3190,0x3191), R(0x3196,0x319f), R(0x31c0,0x31e3), S(0x31ef),
-        R(0x3200,0x321e), R(0x322a,0x3247), S(0x3250), R(0x3260,0x327f), R(0x328a,0x32b0), R(0x32c0,0x33ff),
-        R(0x4dc0,0x4dff), R(0xa490,0xa4c6), R(0xa4fe,0xa4ff), R(0xa60d,0xa60f), S(0xa673), S(0xa67e),
-        R(0xa6f2,0xa6f7), R(0xa700,0xa716), R(0xa720,0xa721), R(0xa789,0xa78a), R(0xa828,0xa82b),
-        R(0xa836,0xa839), R(0xa874,0xa877), R(0xa8ce,0xa8cf), R(0xa8f8,0xa8fa), S(0xa8fc), R(0xa92e,0xa92f),
-        S(0xa95f), R(0xa9c1,0xa9cd), R(0xa9de,0xa9df), R(0xaa5c,0xaa5f), R(0xaa77,0xaa79), R(0xaade,0xaadf),
-        R(0xaaf0,0xaaf1), S(0xab5b), R(0xab6a,0xab6b), S(0xabeb), S(0xfb29), R(0xfbb2,0xfbc2), R(0xfd3e,0xfd4f),
-        S(0xfdcf), R(0xfdfc,0xfdff), R(0xfe10,0xfe19), R(0xfe30,0xfe52), R(0xfe54,0xfe66), R(0xfe68,0xfe6b),
-        R(0xff01,0xff0f), R(0xff1a,0xff20), R(0xff3b,0xff40), R(0xff5b,0xff65), R(0xffe0,0xffe6),
-        R(0xffe8,0xffee), R(0xfffc,0xfffd), R(0x10100,0x10102), R(0x10137,0x1013f), R(0x10179,0x10189),
-        R(0x1018c,0x1018e), R(0x10190,0x1019c), S(0x101a0), R(0x101d0,0x101fc), S(0x1039f), S(0x103d0),
-        S(0x1056f), S(0x10857), R(0x10877,0x10878), S(0x1091f), S(0x1093f), R(0x10a50,0x10a58), S(0x10a7f),
-        S(0x10ac8), R(0x10af0,0x10af6), R(0x10b39,0x10b3f), R(0x10b99,0x10b9c), S(0x10ead), R(0x10f55,0x10f59),
-        R(0x10f86,0x10f89), R(0x11047,0x1104d), R(0x110bb,0x110bc), R(0x110be,0x110c1), R(0x11140,0x11143),
-        R(0x11174,0x11175), R(0x111c5,0x111c8), S(0x111cd), S(0x111db), R(0x111dd,0x111df), R(0x11238,0x1123d),
-        S(0x112a9), R(0x1144b,0x1144f), R(0x1145a,0x1145b), S(0x1145d), S(0x114c6), R(0x115c1,0x115d7),
-        R(0x11641,0x11643), R(0x11660,0x1166c), S(0x116b9), R(0x1173c,0x1173f), S(0x1183b), R(0x11944,0x11946),
-        S(0x119e2), R(0x11a3f,0x11a46), R(0x11a9a,0x11a9c), R(0x11a9e,0x11aa2), R(0x11b00,0x11b09),
-        R(0x11c41,0x11c45), R(0x11c70,0x11c71), R(0x11ef7,0x11ef8), R(0x11f43,0x11f4f), R(0x11fd5,0x11ff1),
-        S(0x11fff), R(0x12470,0x12474), R(0x12ff1,0x12ff2), R(0x16a6e,0x16a6f), S(0x16af5), R(0x16b37,0x16b3f),
-        R(0x16b44,0x16b45), R(0x16e97,0x16e9a), S(0x16fe2), S(0x1bc9c), S(0x1bc9f), R(0x1cf50,0x1cfc3),
-        R(0x1d000,0x1d0f5), R(0x1d100,0x1d126), R(0x1d129,0x1d164), R(0x1d16a,0x1d16c), R(0x1d183,0x1d184),
-        R(0x1d18c,0x1d1a9), R(0x1d1ae,0x1d1ea), R(0x1d200,0x1d241), S(0x1d245), R(0x1d300,0x1d356), S(0x1d6c1),
-        S(0x1d6db), S(0x1d6fb), S(0x1d715), S(0x1d735), S(0x1d74f), S(0x1d76f), S(0x1d789), S(0x1d7a9),
-        S(0x1d7c3), R(0x1d800,0x1d9ff), R(0x1da37,0x1da3a), R(0x1da6d,0x1da74), R(0x1da76,0x1da83),
-        R(0x1da85,0x1da8b), S(0x1e14f), S(0x1e2ff), R(0x1e95e,0x1e95f), S(0x1ecac), S(0x1ecb0), S(0x1ed2e),
-        R(0x1eef0,0x1eef1), R(0x1f000,0x1f02b), R(0x1f030,0x1f093), R(0x1f0a0,0x1f0ae), R(0x1f0b1,0x1f0bf),
-        R(0x1f0c1,0x1f0cf), R(0x1f0d1,0x1f0f5), R(0x1f10d,0x1f1ad), R(0x1f1e6,0x1f202), R(0x1f210,0x1f23b),
-        R(0x1f240,0x1f248), R(0x1f250,0x1f251), R(0x1f260,0x1f265), R(0x1f300,0x1f6d7), R(0x1f6dc,0x1f6ec),
-        R(0x1f6f0,0x1f6fc), R(0x1f700,0x1f776), R(0x1f77b,0x1f7d9), R(0x1f7e0,0x1f7eb), S(0x1f7f0),
-        R(0x1f800,0x1f80b), R(0x1f810,0x1f847), R(0x1f850,0x1f859), R(0x1f860,0x1f887), R(0x1f890,0x1f8ad),
-        R(0x1f8b0,0x1f8b1), R(0x1f900,0x1fa53), R(0x1fa60,0x1fa6d), R(0x1fa70,0x1fa7c), R(0x1fa80,0x1fa88),
-        R(0x1fa90,0x1fabd), R(0x1fabf,0x1fac5), R(0x1face,0x1fadb), R(0x1fae0,0x1fae8), R(0x1faf0,0x1faf8),
-        R(0x1fb00,0x1fb92), R(0x1fb94,0x1fbca)
-    };
-#undef R
-#undef S
-
     /* The ASCII ones are the most frequently used ones, also CommonMark
      * specification requests few more in this range. */
     if (codepoint <= 0x7f)
         return ISPUNCT_(codepoint);
 
-    return (md_unicode_bsearch__(codepoint, PUNCT_MAP, SIZEOF_ARRAY(PUNCT_MAP)) >= 0);
+    if (codepoint >= UNICODE_TABLE_LIMIT)
+        return FALSE;
+    return MD_UNICODE_BIT(PUNCT, codepoint);
 }
 
 static void
 md_get_unicode_fold_info(unsigned codepoint, MD_UNICODE_FOLD_INFO* info)
 {
-#define R(cp_min, cp_max)   ((cp_min) | 0x40000000), ((cp_max) | 0x80000000)
-#define S(cp)               (cp)
-    /* Unicode "Pc", "Pd", "Pe", "Pf", "Pi", "Po", "Ps" categories.
-     * (generated by scripts/build_folding_map.py) */
-    static const unsigned FOLD_MAP_1[] = {
-        R(0x0041,0x005a), S(0x00b5), R(0x00c0,0x00d6), R(0x00d8,0x00de), R(0x0100,0x012e), R(0x0132,0x0136),
-        R(0x0139,0x0147), R(0x014a,0x0176), S(0x0178), R(0x0179,0x017d), S(0x017f), S(0x0181), S(0x0182),
-        S(0x0184), S(0x0186), S(0x0187), S(0x0189), S(0x018a), S(0x018b), S(0x018e), S(0x018f), S(0x0190),
-        S(0x0191), S(0x0193), S(0x0194), S(0x0196), S(0x0197), S(0x0198), S(0x019c), S(0x019d), S(0x019f),
-        R(0x01a0,0x01a4), S(0x01a6), S(0x01a7), S(0x01a9), S(0x01ac), S(0x01ae), S(0x01af), S(0x01b1), S(0x01b2),
-        S(0x01b3), S(0x01b5), S(0x01b7), S(0x01b8), S(0x01bc), S(0x01c4), S(0x01c5), S(0x01c7), S(0x01c8),
-        S(0x01ca), R(0x01cb,0x01db), R(0x01de,0x01ee), S(0x01f1), S(0x01f2), S(0x01f4), S(0x01f6), S(0x01f7),
-        R(0x01f8,0x021e), S(0x0220), R(0x0222,0x0232), S(0x023a), S(0x023b), S(0x023d), S(0x023e), S(0x0241),
-        S(0x0243), S(0x0244), S(0x0245), R(0x0246,0x024e), S(0x0345), S(0x0370), S(0x0372), S(0x0376), S(0x037f),
-        S(0x0386), R(0x0388,0x038a), S(0x038c), S(0x038e), S(0x038f), R(0x0391,0x03a1), R(0x03a3,0x03ab),
-        S(0x03c2), S(0x03cf), S(0x03d0), S(0x03d1), S(0x03d5), S(0x03d6), R(0x03d8,0x03ee), S(0x03f0), S(0x03f1),
-        S(0x03f4), S(0x03f5), S(0x03f7), S(0x03f9), S(0x03fa), R(0x03fd,0x03ff), R(0x0400,0x040f),
-        R(0x0410,0x042f), R(0x0460,0x0480), R(0x048a,0x04be), S(0x04c0), R(0x04c1,0x04cd), R(0x04d0,0x052e),
-        R(0x0531,0x0556), R(0x10a0,0x10c5), S(0x10c7), S(0x10cd), R(0x13f8,0x13fd), S(0x1c80), S(0x1c81),
-        S(0x1c82), S(0x1c83), S(0x1c84), S(0x1c85), S(0x1c86), S(0x1c87), S(0x1c88), R(0x1c90,0x1cba),
-        R(0x1cbd,0x1cbf), R(0x1e00,0x1e94), S(0x1e9b), R(0x1ea0,0x1efe), R(0x1f08,0x1f0f), R(0x1f18,0x1f1d),
-        R(0x1f28,0x1f2f), R(0x1f38,0x1f3f), R(0x1f48,0x1f4d), S(0x1f59), S(0x1f5b), S(0x1f5d), S(0x1f5f),
-        R(0x1f68,0x1f6f), S(0x1fb8), S(0x1fb9), S(0x1fba), S(0x1fbb), S(0x1fbe), R(0x1fc8,0x1fcb), S(0x1fd8),
-        S(0x1fd9), S(0x1fda), S(0x1fdb), S(0x1fe8), S(0x1fe9), S(0x1fea), S(0x1feb), S(0x1fec), S(0x1ff8),
-        S(0x1ff9), S(0x1ffa), S(0x1ffb), S(0x2126), S(0x212a), S(0x212b), S(0x2132), R(0x2160,0x216f), S(0x2183),
-        R(0x24b6,0x24cf), R(0x2c00,0x2c2f), S(0x2c60), S(0x2c62), S(0x2c63), S(0x2c64), R(0x2c67,0x2c6b),
-        S(0x2c6d), S(0x2c6e), S(0x2c6f), S(0x2c70), S(0x2c72), S(0x2c75), S(0x2c7e), S(0x2c7f), R(0x2c80,0x2ce2),
-        S(0x2ceb), S(0x2ced), S(0x2cf2), R(0xa640,0xa66c), R(0xa680,0xa69a), R(0xa722,0xa72e), R(0xa732,0xa76e),
-        S(0xa779), S(0xa77b), S(0xa77d), R(0xa77e,0xa786), S(0xa78b), S(0xa78d), S(0xa790), S(0xa792),
-        R(0xa796,0xa7a8), S(0xa7aa), S(0xa7ab), S(0xa7ac), S(0xa7ad), S(0xa7ae), S(0xa7b0), S(0xa7b1), S(0xa7b2),
-        S(0xa7b3), R(0xa7b4,0xa7c2), S(0xa7c4), S(0xa7c5), S(0xa7c6), S(0xa7c7), S(0xa7c9), S(0xa7d0), S(0xa7d6),
-        S(0xa7d8), S(0xa7f5), R(0xab70,0xabbf), R(0xff21,0xff3a), R(0x10400,0x10427), R(0x104b0,0x104d3),
-        R(0x10570,0x1057a), R(0x1057c,0x1058a), R(0x1058c,0x10592), S(0x10594), S(0x10595), R(0x10c80,0x10cb2),
-        R(0x118a0,0x118bf), R(0x16e40,0x16e5f), R(0x1e900,0x1e921)
-    };
-    static const unsigned FOLD_MAP_1_DATA[] = {
-        0x0061, 0x007a, 0x03bc, 0x00e0, 0x00f6, 0x00f8, 0x00fe, 0x0101, 0x012f, 0x0133, 0x0137, 0x013a, 0x0148,
-        0x014b, 0x0177, 0x00ff, 0x017a, 0x017e, 0x0073, 0x0253, 0x0183, 0x0185, 0x0254, 0x0188, 0x0256, 0x0257,
-        0x018c, 0x01dd, 0x0259, 0x025b, 0x0192, 0x0260, 0x0263, 0x0269, 0x0268, 0x0199, 0x026f, 0x0272, 0x0275,
-        0x01a1, 0x01a5, 0x0280, 0x01a8, 0x0283, 0x01ad, 0x0288, 0x01b0, 0x028a, 0x028b, 0x01b4, 0x01b6, 0x0292,
-        0x01b9, 0x01bd, 0x01c6, 0x01c6, 0x01c9, 0x01c9, 0x01cc, 0x01cc, 0x01dc, 0x01df, 0x01ef, 0x01f3, 0x01f3,
-        0x01f5, 0x0195, 0x01bf, 0x01f9, 0x021f, 0x019e, 0x0223, 0x0233, 0x2c65, 0x023c, 0x019a, 0x2c66, 0x0242,
-        0x0180, 0x0289, 0x028c, 0x0247, 0x024f, 0x03b9, 0x0371, 0x0373, 0x0377, 0x03f3, 0x03ac, 0x03ad, 0x03af,
-        0x03cc, 0x03cd, 0x03ce, 0x03b1, 0x03c1, 0x03c3, 0x03cb, 0x03c3, 0x03d7, 0x03b2, 0x03b8, 0x03c6, 0x03c0,
-        0x03d9, 0x03ef, 0x03ba, 0x03c1, 0x03b8, 0x03b5, 0x03f8, 0x03f2, 0x03fb, 0x037b, 0x037d, 0x0450, 0x045f,
-        0x0430, 0x044f, 0x0461, 0x0481, 0x048b, 0x04bf, 0x04cf, 0x04c2, 0x04ce, 0x04d1, 0x052f, 0x0561, 0x0586,
-        0x2d00, 0x2d25, 0x2d27, 0x2d2d, 0x13f0, 0x13f5, 0x0432, 0x0434, 0x043e, 0x0441, 0x0442, 0x0442, 0x044a,
-        0x0463, 0xa64b, 0x10d0, 0x10fa, 0x10fd, 0x10ff, 0x1e01, 0x1e95, 0x1e61, 0x1ea1, 0x1eff, 0x1f00, 0x1f07,
-        0x1f10, 0x1f15, 0x1f20, 0x1f27, 0x1f30, 0x1f37, 0x1f40, 0x1f45, 0x1f51, 0x1f53, 0x1f55, 0x1f57, 0x1f60,
-        0x1f67, 0x1fb0, 0x1fb1, 0x1f70, 0x1f71, 0x03b9, 0x1f72, 0x1f75, 0x1fd0, 0x1fd1, 0x1f76, 0x1f77, 0x1fe0,
-        0x1fe1, 0x1f7a, 0x1f7b, 0x1fe5, 0x1f78, 0x1f79, 0x1f7c, 0x1f7d, 0x03c9, 0x006b, 0x00e5, 0x214e, 0x2170,
-        0x217f, 0x2184, 0x24d0, 0x24e9, 0x2c30, 0x2c5f, 0x2c61, 0x026b, 0x1d7d, 0x027d, 0x2c68, 0x2c6c, 0x0251,
-        0x0271, 0x0250, 0x0252, 0x2c73, 0x2c76, 0x023f, 0x0240, 0x2c81, 0x2ce3, 0x2cec, 0x2cee, 0x2cf3, 0xa641,
-        0xa66d, 0xa681, 0xa69b, 0xa723, 0xa72f, 0xa733, 0xa76f, 0xa77a, 0xa77c, 0x1d79, 0xa77f, 0xa787, 0xa78c,
-        0x0265, 0xa791, 0xa793, 0xa797, 0xa7a9, 0x0266, 0x025c, 0x0261, 0x026c, 0x026a, 0x029e, 0x0287, 0x029d,
-        0xab53, 0xa7b5, 0xa7c3, 0xa794, 0x0282, 0x1d8e, 0xa7c8, 0xa7ca, 0xa7d1, 0xa7d7, 0xa7d9, 0xa7f6, 0x13a0,
-        0x13ef, 0xff41, 0xff5a, 0x10428, 0x1044f, 0x104d8, 0x104fb, 0x10597, 0x105a1, 0x105a3, 0x105b1, 0x105b3,
-        0x105b9, 0x105bb, 0x105bc, 0x10cc0, 0x10cf2, 0x118c0, 0x118df, 0x16e60, 0x16e7f, 0x1e922, 0x1e943
-    };
-    static const unsigned FOLD_MAP_2[] = {
-        S(0x00df), S(0x0130), S(0x0149), S(0x01f0), S(0x0587), S(0x1e96), S(0x1e97), S(0x1e98), S(0x1e99),
-        S(0x1e9a), S(0x1e9e), S(0x1f50), R(0x1f80,0x1f87), R(0x1f88,0x1f8f), R(0x1f90,0x1f97), R(0x1f98,0x1f9f),
-        R(0x1fa0,0x1fa7), R(0x1fa8,0x1faf), S(0x1fb2), S(0x1fb3), S(0x1fb4), S(0x1fb6), S(0x1fbc), S(0x1fc2),
-        S(0x1fc3), S(0x1fc4), S(0x1fc6), S(0x1fcc), S(0x1fd6), S(0x1fe4), S(0x1fe6), S(0x1ff2), S(0x1ff3),
-        S(0x1ff4), S(0x1ff6), S(0x1ffc), S(0xfb00), S(0xfb01), S(0xfb02), S(0xfb05), S(0xfb06), S(0xfb13),
-        S(0xfb14), S(0xfb15), S(0xfb16), S(0xfb17)
-    };
-    static const unsigned FOLD_MAP_2_DATA[] = {
-        0x0073,0x0073, 0x0069,0x0307, 0x02bc,0x006e, 0x006a,0x030c, 0x0565,0x0582, 0x0068,0x0331, 0x0074,0x0308,
-        0x0077,0x030a, 0x0079,0x030a, 0x0061,0x02be, 0x0073,0x0073, 0x03c5,0x0313, 0x1f00,0x03b9, 0x1f07,0x03b9,
-        0x1f00,0x03b9, 0x1f07,0x03b9, 0x1f20,0x03b9, 0x1f27,0x03b9, 0x1f20,0x03b9, 0x1f27,0x03b9, 0x1f60,0x03b9,
-        0x1f67,0x03b9, 0x1f60,0x03b9, 0x1f67,0x03b9, 0x1f70,0x03b9, 0x03b1,0x03b9, 0x03ac,0x03b9, 0x03b1,0x0342,
-        0x03b1,0x03b9, 0x1f74,0x03b9, 0x03b7,0x03b9, 0x03ae,0x03b9, 0x03b7,0x0342, 0x03b7,0x03b9, 0x03b9,0x0342,
-        0x03c1,0x0313, 0x03c5,0x0342, 0x1f7c,0x03b9, 0x03c9,0x03b9, 0x03ce,0x03b9, 0x03c9,0x0342, 0x03c9,0x03b9,
-        0x0066,0x0066, 0x0066,0x0069, 0x0066,0x006c, 0x0073,0x0074, 0x0073,0x0074, 0x0574,0x0576, 0x0574,0x0565,
-        0x0574,0x056b, 0x057e,0x0576, 0x0574,0x056d
-    };
-    static const unsigned FOLD_MAP_3[] = {
-        S(0x0390), S(0x03b0), S(0x1f52), S(0x1f54), S(0x1f56), S(0x1fb7), S(0x1fc7), S(0x1fd2), S(0x1fd3),
-        S(0x1fd7), S(0x1fe2), S(0x1fe3), S(0x1fe7), S(0x1ff7), S(0xfb03), S(0xfb04)
-    };
-    static const unsigned FOLD_MAP_3_DATA[] = {
-        0x03b9,0x0308,0x0301, 0x03c5,0x0308,0x0301, 0x03c5,0x0313,0x0300, 0x03c5,0x0313,0x0301,
-        0x03c5,0x0313,0x0342, 0x03b1,0x0342,0x03b9, 0x03b7,0x0342,0x03b9, 0x03b9,0x0308,0x0300,
-        0x03b9,0x0308,0x0301, 0x03b9,0x0308,0x0342, 0x03c5,0x0308,0x0300, 0x03c5,0x0308,0x0301,
-        0x03c5,0x0308,0x0342, 0x03c9,0x0342,0x03b9, 0x0066,0x0066,0x0069, 0x0066,0x0066,0x006c
-    };
-#undef R
-#undef S
-    static const struct {
-        const unsigned* map;
-        const unsigned* data;
-        size_t map_size;
-        unsigned n_codepoints;
-    } FOLD_MAP_LIST[] = {
-        { FOLD_MAP_1, FOLD_MAP_1_DATA, SIZEOF_ARRAY(FOLD_MAP_1), 1 },
-        { FOLD_MAP_2, FOLD_MAP_2_DATA, SIZEOF_ARRAY(FOLD_MAP_2), 2 },
-        { FOLD_MAP_3, FOLD_MAP_3_DATA, SIZEOF_ARRAY(FOLD_MAP_3), 3 }
-    };
-
-    int i;
+    const int* record;
 
     /* Fast path for ASCII characters. */
     if (codepoint <= 0x7f) {
@@ -792,41 +1571,24 @@ md_get_unicode_fold_info(unsigned codepoint, MD_UNICODE_FOLD_INFO* info)
         return;
     }
 
-    /* Try to locate the codepoint in any of the maps. */
-    for (i = 0; i < (int)SIZEOF_ARRAY(FOLD_MAP_LIST); i++) {
-        int index;
-
-        index = md_unicode_bsearch__(codepoint, FOLD_MAP_LIST[i].map, FOLD_MAP_LIST[i].map_size);
-        if (index >= 0) {
-            /* Found the mapping. */
-            unsigned n_codepoints = FOLD_MAP_LIST[i].n_codepoints;
-            const unsigned* map = FOLD_MAP_LIST[i].map;
-            const unsigned* codepoints = FOLD_MAP_LIST[i].data + (index * n_codepoints);
-
-            memcpy(info->codepoints, codepoints, sizeof(unsigned) * n_codepoints);
-            info->n_codepoints = n_codepoints;
-
-            if (FOLD_MAP_LIST[i].map[index] != codepoint) {
-                /* The found mapping maps whole range of codepoints,
-                 * i.e. we have to offset info->codepoints[0] accordingly. */
-                if ((map[index] & 0x00ffffff) + 1 == codepoints[0]) {
-                    /* Alternating type of the range. */
-                    info->codepoints[0] = codepoint + ((codepoint & 0x1) == (map[index] & 0x1) ? 1 : 0);
-                }
-                else {
-                    /* Range to range kind of mapping. */
-                    info->codepoints[0] += (codepoint - (map[index] & 0x00ffffff));
-                }
-            }
-
-            return;
-        }
+    if (codepoint >= UNICODE_TABLE_LIMIT) {
+        /* No mapping. Map the codepoint to itself. */
+        info->codepoints[0] = codepoint;
+        info->n_codepoints = 1;
+        return;
     }
 
-    /* No mapping found. Map the codepoint to itself. */
-    info->codepoints[0] = codepoint;
-    info->n_codepoints = 1;
+    /* Record 0 maps the codepoint to itself, so no special case is needed
+     * for codepoints without any folding. */
+    record = FOLD_RECORDS[FOLD_PAGES[(FOLD_PAGE_INDEX[codepoint >> FOLD_PAGE_SHIFT] << FOLD_PAGE_SHIFT)
+                                     + (codepoint & ((1 << FOLD_PAGE_SHIFT) - 1))]];
+    info->n_codepoints = (unsigned) record[0];
+    info->codepoints[0] = codepoint + (unsigned) record[1];
+    info->codepoints[1] = (unsigned) record[2];
+    info->codepoints[2] = (unsigned) record[3];
 }
+
+#undef MD_UNICODE_BIT
 #endif
 
 
@@ -1049,6 +1811,27 @@ md_merge_lines_alloc(MD_CTX* ctx, OFF beg, OFF end, const MD_LINE* lines, MD_SIZ
     return 0;
 }
 
+/* Same as md_merge_lines_alloc() but the string is allocated from ctx->arena.
+ */
+static int
+md_merge_lines_arena(MD_CTX* ctx, OFF beg, OFF end, const MD_LINE* lines, MD_SIZE n_lines,
+    CHAR line_break_replacement_char, CHAR** p_str, SZ* p_size)
+{
+    CHAR* buffer;
+
+    buffer = (CHAR*)md_arena_alloc(&ctx->arena, sizeof(CHAR) * (end - beg));
+    if (buffer == NULL) {
+        MD_LOG("md_arena_alloc() failed.");
+        return -1;
+    }
+
+    md_merge_lines(ctx, beg, end, lines, n_lines,
+        line_break_replacement_char, buffer, p_size);
+
+    *p_str = buffer;
+    return 0;
+}
+
 static OFF
 md_skip_unicode_whitespace(const CHAR* label, OFF off, SZ size)
 {
@@ -1435,6 +2218,8 @@ struct MD_ATTRIBUTE_BUILD_tag {
     int substr_alloc;
     MD_TEXTTYPE trivial_types[1];
     OFF trivial_offsets[2];
+    int uses_arena;             /* Non-trivial attribute lives in ctx->arena. */
+    MD_ARENA_MARK arena_mark;
 };
 
 
@@ -1451,20 +2236,20 @@ md_build_attr_append_substr(MD_CTX* ctx, MD_ATTRIBUTE_BUILD* build,
         build->substr_alloc = (build->substr_alloc > 0
             ? build->substr_alloc + build->substr_alloc / 2
             : 8);
-        new_substr_types = (MD_TEXTTYPE*)realloc(build->substr_types,
+        /* Note +1 to reserve space for final offset (== raw_size). The old
+         * arrays stay in the arena until md_free_attribute(). */
+        new_substr_types = (MD_TEXTTYPE*)md_arena_alloc(&ctx->arena,
             build->substr_alloc * sizeof(MD_TEXTTYPE));
-        if (new_substr_types == NULL) {
-            MD_LOG("realloc() failed.");
-            return -1;
-        }
-        /* Note +1 to reserve space for final offset (== raw_size). */
-        new_substr_offsets = (OFF*)realloc(build->substr_offsets,
+        new_substr_offsets = (OFF*)md_arena_alloc(&ctx->arena,
             (build->substr_alloc + 1) * sizeof(OFF));
-        if (new_substr_offsets == NULL) {
-            MD_LOG("realloc() failed.");
-            free(new_substr_types);
+        if (new_substr_types == NULL || new_substr_offsets == NULL) {
+            MD_LOG("md_arena_alloc() failed.");
             return -1;
         }
+        if (build->substr_count > 0) {
+            memcpy(new_substr_types, build->substr_types, build->substr_count * sizeof(MD_TEXTTYPE));
+            memcpy(new_substr_offsets, build->substr_offsets, build->substr_count * sizeof(OFF));
+        }
 
         build->substr_types = new_substr_types;
         build->substr_offsets = new_substr_offsets;
@@ -1476,15 +2261,14 @@ md_build_attr_append_substr(MD_CTX* ctx, MD_ATTRIBUTE_BUILD* build,
     return 0;
 }
 
+/* Attributes built from the arena must be freed in the reverse order of
+ * building. */
 static void
 md_free_attribute(MD_CTX* ctx, MD_ATTRIBUTE_BUILD* build)
 {
-    MD_UNUSED(ctx);
-
-    if (build->substr_alloc > 0) {
-        free(build->text);
-        free(build->substr_types);
-        free(build->substr_offsets);
+    if (build->uses_arena) {
+        md_arena_release(&ctx->arena, build->arena_mark);
+        build->uses_arena = FALSE;
     }
 }
 
@@ -1499,7 +2283,7 @@ md_build_attribute(MD_CTX* ctx, const CHAR* raw_text, SZ raw_size,
     memset(build, 0, sizeof(MD_ATTRIBUTE_BUILD));
 
     /* If there is no backslash and no ampersand, build trivial attribute
-     * without any malloc(). */
+     * without any allocation. */
     is_trivial = TRUE;
     for (raw_off = 0; raw_off < raw_size; raw_off++) {
         if (ISANYOF3_(raw_text[raw_off], _T('\\'), _T('&'), _T('\0'))) {
@@ -1520,9 +2304,11 @@ md_build_attribute(MD_CTX* ctx, const CHAR* raw_text, SZ raw_size,
         off = raw_size;
     }
     else {
-        build->text = (CHAR*)malloc(raw_size * sizeof(CHAR));
+        build->arena_mark = md_arena_mark(&ctx->arena);
+        build->uses_arena = TRUE;
+        build->text = (CHAR*)md_arena_alloc(&ctx->arena, raw_size * sizeof(CHAR));
         if (build->text == NULL) {
-            MD_LOG("malloc() failed.");
+            MD_LOG("md_arena_alloc() failed.");
             goto abort;
         }
 
@@ -1597,338 +2383,412 @@ md_fnv1a(unsigned base, const void* data, size_t n)
     return hash;
 }
 
+/* Slot of a perfect hash table built by scripts/build_hash_maps.py. */
+static inline unsigned
+md_hash_slot(unsigned hash, unsigned disp, unsigned n_slots)
+{
+    /* Murmur3 finalizer; then scale to [0, n_slots). */
+    hash ^= disp;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+
+    return (unsigned)(((uint64_t)hash * n_slots) >> 32);
+}
+
 
 struct MD_REF_DEF_tag {
     CHAR* label;
     CHAR* title;
-    unsigned hash;
+    const unsigned char* key;   /* Normalized label (see md_link_label_key()). */
+    SZ key_size;
+    unsigned hash;              /* Hash of the key. */
     SZ label_size;
     SZ title_size;
     OFF dest_beg;
     OFF dest_end;
-    unsigned char label_needs_free : 1;
-    unsigned char title_needs_free : 1;
 };
 
 /* Label equivalence is quite complicated with regards to whitespace and case
- * folding. This complicates computing a hash of it as well as direct comparison
- * of two labels. */
+ * folding. Therefore we turn every label into a normalized key: The label
+ * case-folded (and encoded in UTF-8), with the leading and trailing whitespace
+ * removed and any other whitespace run replaced with a single space. Two
+ * labels are equivalent if and only if their keys are equal byte for byte. */
+
+/* Max. size of a key for a label of 'size' CHARs: Any character may fold into
+ * up to 3 codepoints, each taking up to 4 bytes. */
+#define MD_LINK_LABEL_KEY_MAX(size)     (12 * (size_t)(size) + 1)
 
 static unsigned
-md_link_label_hash(const CHAR* label, SZ size)
+md_encode_utf8(unsigned codepoint, unsigned char* buf)
 {
-    unsigned hash = MD_FNV1A_BASE;
+    if (codepoint <= 0x7f) {
+        buf[0] = (unsigned char) codepoint;
+        return 1;
+    }
+    if (codepoint <= 0x7ff) {
+        buf[0] = (unsigned char) (0xc0 | (codepoint >> 6));
+        buf[1] = (unsigned char) (0x80 | (codepoint & 0x3f));
+        return 2;
+    }
+    if (codepoint <= 0xffff) {
+        buf[0] = (unsigned char) (0xe0 | (codepoint >> 12));
+        buf[1] = (unsigned char) (0x80 | ((codepoint >> 6) & 0x3f));
+        buf[2] = (unsigned char) (0x80 | (codepoint & 0x3f));
+        return 3;
+    }
+    buf[0] = (unsigned char) (0xf0 | (codepoint >> 18));
+    buf[1] = (unsigned char) (0x80 | ((codepoint >> 12) & 0x3f));
+    buf[2] = (unsigned char) (0x80 | ((codepoint >> 6) & 0x3f));
+    buf[3] = (unsigned char) (0x80 | (codepoint & 0x3f));
+    return 4;
+}
+
+/* Writes the key of the label into 'key' (of MD_LINK_LABEL_KEY_MAX(size)
+ * bytes) and returns its size. */
+static SZ
+md_link_label_key(const CHAR* label, SZ size, unsigned char* key)
+{
+    SZ key_size = 0;
     OFF off;
-    unsigned codepoint;
-    int is_whitespace = FALSE;
 
     off = md_skip_unicode_whitespace(label, 0, size);
     while (off < size) {
+        MD_UNICODE_FOLD_INFO fold_info;
+        unsigned codepoint;
         SZ char_size;
+        unsigned i;
 
-        codepoint = md_decode_unicode(label, off, size, &char_size);
-        is_whitespace = ISUNICODEWHITESPACE_(codepoint) || ISNEWLINE_(label[off]);
+        /* Fast path for ASCII. */
+        if ((unsigned) label[off] < 0x80  &&  !ISWHITESPACE_(label[off])  &&  !ISNEWLINE_(label[off])) {
+            key[key_size++] = (unsigned char) (ISUPPER_(label[off]) ? label[off] + ('a' - 'A') : label[off]);
+            off++;
+            continue;
+        }
 
-        if (is_whitespace) {
-            codepoint = ' ';
-            hash = md_fnv1a(hash, &codepoint, sizeof(unsigned));
+        codepoint = md_decode_unicode(label, off, size, &char_size);
+        if (ISUNICODEWHITESPACE_(codepoint)  ||  ISNEWLINE_(label[off])) {
             off = md_skip_unicode_whitespace(label, off, size);
+            if (off < size)
+                key[key_size++] = ' ';
+            continue;
         }
-        else {
-            MD_UNICODE_FOLD_INFO fold_info;
 
-            md_get_unicode_fold_info(codepoint, &fold_info);
-            hash = md_fnv1a(hash, fold_info.codepoints, fold_info.n_codepoints * sizeof(unsigned));
-            off += char_size;
-        }
+        md_get_unicode_fold_info(codepoint, &fold_info);
+        for (i = 0; i < fold_info.n_codepoints; i++)
+            key_size += md_encode_utf8(fold_info.codepoints[i], key + key_size);
+        off += char_size;
     }
 
-    return hash;
+    return key_size;
 }
 
-static OFF
-md_link_label_cmp_load_fold_info(const CHAR* label, OFF off, SZ size,
-    MD_UNICODE_FOLD_INFO* fold_info)
-{
-    unsigned codepoint;
-    SZ char_size;
-
-    if (off >= size) {
-        /* Treat end of a link label as a whitespace. */
-        goto whitespace;
-    }
+/* The index of the reference definitions lives in the MD_PARSE_CONTEXT, so
+ * it survives between md_parse_with_context() calls. When an edited document
+ * is parsed again, most of its ref. defs are the same and in the same order as
+ * the last time. md_build_ref_def_hashtable() therefore walks the keys of the
+ * previous parse alongside the current ref. defs and reuses the key of each
+ * unchanged label; only new or changed labels are folded again. When the walk
+ * loses track (e.g. after a block of removed ref. defs), it resyncs by the
+ * source offsets of the ref. defs, which an edit shifts uniformly. */
+typedef struct MD_REF_DEF_KEY_tag MD_REF_DEF_KEY;
+struct MD_REF_DEF_KEY_tag {
+    size_t off;         /* The raw label, then the key in MD_REF_DEF_INDEX::pool[]. */
+    SZ label_size;
+    SZ key_size;
+    unsigned hash;
+    OFF src_off;        /* MD_REF_DEF::dest_beg; grows with the key index. */
+};
 
-    codepoint = md_decode_unicode(label, off, size, &char_size);
-    off += char_size;
-    if (ISUNICODEWHITESPACE_(codepoint)) {
-        /* Treat all whitespace as equivalent */
-        goto whitespace;
-    }
+struct MD_REF_DEF_INDEX_tag {
+    /* Keys of the current ([cur]) and the previous ([cur ^ 1]) parse. */
+    MD_REF_DEF_KEY* keys[2];
+    int n_keys[2];
+    int alloc_keys[2];
+    unsigned char* pool[2];
+    size_t pool_size[2];
+    size_t alloc_pool[2];
+    int cur;
+    OFF doc_size;       /* Size of the document of the last parse. */
+
+    /* Hash table with open addressing: Zero marks an empty slot, otherwise
+     * the slot holds (index into ctx->ref_defs[] + 1). The size is a power
+     * of two, and at most a half of the slots is used. */
+    int* slots;
+    unsigned n_slots;
+    unsigned alloc_slots;
+};
 
-    /* Get real folding info. */
-    md_get_unicode_fold_info(codepoint, fold_info);
-    return off;
+static void
+md_ref_def_index_free(MD_REF_DEF_INDEX* index)
+{
+    int i;
 
-whitespace:
-    fold_info->codepoints[0] = _T(' ');
-    fold_info->n_codepoints = 1;
-    return md_skip_unicode_whitespace(label, off, size);
+    for (i = 0; i < 2; i++) {
+        free(index->keys[i]);
+        free(index->pool[i]);
+    }
+    free(index->slots);
+    memset(index, 0, sizeof(MD_REF_DEF_INDEX));
 }
 
+/* Makes sure the current pool can take 'size' more bytes. */
 static int
-md_link_label_cmp(const CHAR* a_label, SZ a_size, const CHAR* b_label, SZ b_size)
-{
-    OFF a_off;
-    OFF b_off;
-    MD_UNICODE_FOLD_INFO a_fi = { { 0 }, 0 };
-    MD_UNICODE_FOLD_INFO b_fi = { { 0 }, 0 };
-    OFF a_fi_off = 0;
-    OFF b_fi_off = 0;
-    int cmp;
-
-    a_off = md_skip_unicode_whitespace(a_label, 0, a_size);
-    b_off = md_skip_unicode_whitespace(b_label, 0, b_size);
-    while (a_off < a_size || a_fi_off < a_fi.n_codepoints ||
-        b_off < b_size || b_fi_off < b_fi.n_codepoints)
-    {
-        /* If needed, load fold info for next char. */
-        if (a_fi_off >= a_fi.n_codepoints) {
-            a_fi_off = 0;
-            a_off = md_link_label_cmp_load_fold_info(a_label, a_off, a_size, &a_fi);
-        }
-        if (b_fi_off >= b_fi.n_codepoints) {
-            b_fi_off = 0;
-            b_off = md_link_label_cmp_load_fold_info(b_label, b_off, b_size, &b_fi);
-        }
+md_ref_def_index_reserve(MD_REF_DEF_INDEX* index, size_t size)
+{
+    int cur = index->cur;
 
-        cmp = b_fi.codepoints[b_fi_off] - a_fi.codepoints[a_fi_off];
-        if (cmp != 0)
-            return cmp;
+    if (index->pool_size[cur] + size > index->alloc_pool[cur]) {
+        size_t alloc_pool = index->alloc_pool[cur] + index->alloc_pool[cur] / 2;
+        unsigned char* new_pool;
 
-        a_fi_off++;
-        b_fi_off++;
+        if (alloc_pool < index->pool_size[cur] + size)
+            alloc_pool = index->pool_size[cur] + size + 1024;
+        new_pool = (unsigned char*) realloc(index->pool[cur], alloc_pool);
+        if (new_pool == NULL)
+            return -1;
+
+        index->pool[cur] = new_pool;
+        index->alloc_pool[cur] = alloc_pool;
     }
 
     return 0;
 }
 
-typedef struct MD_REF_DEF_LIST_tag MD_REF_DEF_LIST;
-struct MD_REF_DEF_LIST_tag {
-    int n_ref_defs;
-    int alloc_ref_defs;
-    MD_REF_DEF* ref_defs[];  /* Valid items always  point into ctx->ref_defs[] */
-};
-
-static int
-md_ref_def_cmp(const void* a, const void* b)
+static inline int
+md_ref_def_key_matches(const MD_REF_DEF_INDEX* index, int prev, int k, const MD_REF_DEF* def)
 {
-    const MD_REF_DEF* a_ref = *(const MD_REF_DEF**)a;
-    const MD_REF_DEF* b_ref = *(const MD_REF_DEF**)b;
+    const MD_REF_DEF_KEY* key = &index->keys[prev][k];
 
-    if (a_ref->hash < b_ref->hash)
-        return -1;
-    else if (a_ref->hash > b_ref->hash)
-        return +1;
-    else
-        return md_link_label_cmp(a_ref->label, a_ref->label_size, b_ref->label, b_ref->label_size);
+    return (key->label_size == def->label_size  &&
+            memcmp(index->pool[prev] + key->off, def->label, def->label_size * sizeof(CHAR)) == 0);
 }
 
+/* Finds the key with the source offset 'src_off' among the keys [from, n) of
+ * the previous parse. The offsets grow, so gallop forward from 'from' (the
+ * lost ref. defs are usually close) and bisect the last step. Returns the
+ * index of the key, or -1. */
 static int
-md_ref_def_cmp_for_sort(const void* a, const void* b)
+md_ref_def_index_find_src_off(const MD_REF_DEF_INDEX* index, int prev, int from, OFF src_off)
 {
-    int cmp;
+    const MD_REF_DEF_KEY* keys = index->keys[prev];
+    int n = index->n_keys[prev];
+    int lo = from;
+    int hi = from;
+    int step = 1;
 
-    cmp = md_ref_def_cmp(a, b);
+    if (from >= n  ||  keys[n-1].src_off < src_off)
+        return -1;
 
-    /* Ensure stability of the sorting. */
-    if (cmp == 0) {
-        const MD_REF_DEF* a_ref = *(const MD_REF_DEF**)a;
-        const MD_REF_DEF* b_ref = *(const MD_REF_DEF**)b;
+    while (keys[hi].src_off < src_off) {
+        lo = hi + 1;
+        hi = (step < n - hi) ? hi + step : n - 1;
+        step *= 2;
+    }
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
 
-        if (a_ref < b_ref)
-            cmp = -1;
-        else if (a_ref > b_ref)
-            cmp = +1;
+        if (keys[mid].src_off < src_off)
+            lo = mid + 1;
         else
-            cmp = 0;
+            hi = mid;
     }
+    return (keys[lo].src_off == src_off ? lo : -1);
+}
 
-    return cmp;
+static inline unsigned
+md_ref_def_slot(unsigned hash, unsigned n_slots)
+{
+    return (hash ^ (hash >> 16)) & (n_slots - 1);
 }
 
 static int
 md_build_ref_def_hashtable(MD_CTX* ctx)
 {
-    int i, j;
+    MD_REF_DEF_INDEX* index = ctx->ref_def_index;
+    int prev = index->cur;
+    int cur = prev ^ 1;
+    /* Shifts of the source offsets from the previous parse (modulo the range
+     * of OFF): At the last reused key, and past an edit in front of the end. */
+    OFF shift = 0;
+    OFF tail_shift = ctx->size - index->doc_size;
+    unsigned n_slots;
+    int i, j, k;
+
+    index->cur = cur;
+    index->n_keys[cur] = 0;
+    index->pool_size[cur] = 0;
+    index->doc_size = ctx->size;
 
     if (ctx->n_ref_defs == 0)
         return 0;
 
-    ctx->ref_def_hashtable_size = (ctx->n_ref_defs * 5) / 4;
-    ctx->ref_def_hashtable = malloc(ctx->ref_def_hashtable_size * sizeof(void*));
-    if (ctx->ref_def_hashtable == NULL) {
-        MD_LOG("malloc() failed.");
-        goto abort;
-    }
-    memset(ctx->ref_def_hashtable, 0, ctx->ref_def_hashtable_size * sizeof(void*));
+    if (ctx->n_ref_defs > index->alloc_keys[cur]) {
+        MD_REF_DEF_KEY* new_keys;
 
-    /* Each member of ctx->ref_def_hashtable[] can be:
-     *  -- NULL,
-     *  -- pointer to the MD_REF_DEF in ctx->ref_defs[], or
-     *  -- pointer to a MD_REF_DEF_LIST, which holds multiple pointers to
-     *     such MD_REF_DEFs.
-     */
-    for (i = 0; i < ctx->n_ref_defs; i++) {
-        MD_REF_DEF* def = &ctx->ref_defs[i];
-        void* bucket;
-        MD_REF_DEF_LIST* list;
-
-        def->hash = md_link_label_hash(def->label, def->label_size);
-        bucket = ctx->ref_def_hashtable[def->hash % ctx->ref_def_hashtable_size];
-
-        if (bucket == NULL) {
-            /* The bucket is empty. Make it just point to the def. */
-            ctx->ref_def_hashtable[def->hash % ctx->ref_def_hashtable_size] = def;
-            continue;
+        new_keys = (MD_REF_DEF_KEY*) realloc(index->keys[cur], ctx->n_ref_defs * sizeof(MD_REF_DEF_KEY));
+        if (new_keys == NULL) {
+            MD_LOG("realloc() failed.");
+            goto abort;
         }
-
-        if (ctx->ref_defs <= (MD_REF_DEF*)bucket && (MD_REF_DEF*)bucket < ctx->ref_defs + ctx->n_ref_defs) {
-            /* The bucket already contains one ref. def. Lets see whether it
-             * is the same label (ref. def. duplicate) or different one
-             * (hash conflict). */
-            MD_REF_DEF* old_def = (MD_REF_DEF*)bucket;
-
-            if (md_link_label_cmp(def->label, def->label_size, old_def->label, old_def->label_size) == 0) {
-                /* Duplicate label: Ignore this ref. def. */
-                continue;
+        index->keys[cur] = new_keys;
+        index->alloc_keys[cur] = ctx->n_ref_defs;
+    }
+
+    /* Get the keys. */
+    for (i = 0, j = 0; i < ctx->n_ref_defs; i++) {
+        const MD_REF_DEF* def = &ctx->ref_defs[i];
+        MD_REF_DEF_KEY* key = &index->keys[cur][i];
+        const MD_REF_DEF_KEY* old_key = NULL;
+        size_t label_bytes = def->label_size * sizeof(CHAR);
+        unsigned char* ptr;
+
+        /* Look for the same label in the previous parse: Right after the
+         * previous match, or one further (if a ref. def. has been removed). */
+        for (k = j; k < j + 2  &&  k < index->n_keys[prev]; k++) {
+            if (md_ref_def_key_matches(index, prev, k, def)) {
+                old_key = &index->keys[prev][k];
+                break;
             }
+        }
 
-            /* Make the bucket complex, i.e. able to hold more ref. defs. */
-            list = (MD_REF_DEF_LIST*)malloc(sizeof(MD_REF_DEF_LIST) + 2 * sizeof(MD_REF_DEF*));
-            if (list == NULL) {
-                MD_LOG("malloc() failed.");
-                goto abort;
+        /* More of them removed, or the ref. def. moved by an edit: Look for
+         * it by its previous source offset. */
+        if (old_key == NULL  &&  j + 2 < index->n_keys[prev]) {
+            k = md_ref_def_index_find_src_off(index, prev, j + 2, def->dest_beg - shift);
+            if (k < 0  ||  !md_ref_def_key_matches(index, prev, k, def)) {
+                k = (tail_shift != shift)
+                        ? md_ref_def_index_find_src_off(index, prev, j + 2, def->dest_beg - tail_shift)
+                        : -1;
             }
-            list->ref_defs[0] = old_def;
-            list->ref_defs[1] = def;
-            list->n_ref_defs = 2;
-            list->alloc_ref_defs = 2;
-            ctx->ref_def_hashtable[def->hash % ctx->ref_def_hashtable_size] = list;
-            continue;
+            if (k >= 0  &&  md_ref_def_key_matches(index, prev, k, def))
+                old_key = &index->keys[prev][k];
         }
 
-        /* Append the def to the complex bucket list.
-         *
-         * Note in this case we ignore potential duplicates to avoid expensive
-         * iterating over the complex bucket. Below, we revisit all the complex
-         * buckets and handle it more cheaply after the complex bucket contents
-         * is sorted. */
-        list = (MD_REF_DEF_LIST*)bucket;
-        if (list->n_ref_defs >= list->alloc_ref_defs) {
-            int alloc_ref_defs = list->alloc_ref_defs + list->alloc_ref_defs / 2;
-            MD_REF_DEF_LIST* list_tmp = (MD_REF_DEF_LIST*)realloc(list,
-                sizeof(MD_REF_DEF_LIST) + alloc_ref_defs * sizeof(MD_REF_DEF*));
-            if (list_tmp == NULL) {
-                MD_LOG("realloc() failed.");
-                goto abort;
-            }
-            list = list_tmp;
-            list->alloc_ref_defs = alloc_ref_defs;
-            ctx->ref_def_hashtable[def->hash % ctx->ref_def_hashtable_size] = list;
+        if (old_key != NULL) {
+            j = k + 1;
+            shift = def->dest_beg - old_key->src_off;
         }
 
-        list->ref_defs[list->n_ref_defs] = def;
-        list->n_ref_defs++;
+        if (md_ref_def_index_reserve(index, label_bytes +
+                (old_key != NULL ? old_key->key_size : MD_LINK_LABEL_KEY_MAX(def->label_size))) != 0)
+        {
+            MD_LOG("realloc() failed.");
+            goto abort;
+        }
+
+        key->off = index->pool_size[cur];
+        key->label_size = def->label_size;
+        key->src_off = def->dest_beg;
+        ptr = index->pool[cur] + key->off;
+        memcpy(ptr, def->label, label_bytes);
+        if (old_key != NULL) {
+            key->key_size = old_key->key_size;
+            key->hash = old_key->hash;
+            memcpy(ptr + label_bytes, index->pool[prev] + old_key->off + label_bytes, key->key_size);
+        } else {
+            key->key_size = md_link_label_key(def->label, def->label_size, ptr + label_bytes);
+            key->hash = md_fnv1a(MD_FNV1A_BASE, ptr + label_bytes, key->key_size);
+        }
+        index->pool_size[cur] += label_bytes + key->key_size;
     }
+    index->n_keys[cur] = ctx->n_ref_defs;
 
-    /* Sort the complex buckets so we can use bsearch() with them. */
-    for (i = 0; i < ctx->ref_def_hashtable_size; i++) {
-        void* bucket = ctx->ref_def_hashtable[i];
-        MD_REF_DEF_LIST* list;
+    /* The pool does not move anymore. */
+    for (i = 0; i < ctx->n_ref_defs; i++) {
+        MD_REF_DEF* def = &ctx->ref_defs[i];
+        const MD_REF_DEF_KEY* key = &index->keys[cur][i];
 
-        if (bucket == NULL)
-            continue;
-        if (ctx->ref_defs <= (MD_REF_DEF*)bucket && (MD_REF_DEF*)bucket < ctx->ref_defs + ctx->n_ref_defs)
-            continue;
+        def->key = index->pool[cur] + key->off + def->label_size * sizeof(CHAR);
+        def->key_size = key->key_size;
+        def->hash = key->hash;
+    }
 
-        list = (MD_REF_DEF_LIST*)bucket;
-        qsort(list->ref_defs, list->n_ref_defs, sizeof(MD_REF_DEF*), md_ref_def_cmp_for_sort);
+    /* Fill the hash table. */
+    n_slots = 16;
+    while (n_slots < 2 * (unsigned) ctx->n_ref_defs)
+        n_slots *= 2;
+    if (n_slots > index->alloc_slots) {
+        int* new_slots;
 
-        /* Disable all duplicates in the complex bucket by forcing all such
-         * records to point to the 1st such ref. def. I.e. no matter which
-         * record is found during the lookup, it will always point to the right
-         * ref. def. in ctx->ref_defs[]. */
-        for (j = 1; j < list->n_ref_defs; j++) {
-            if (md_ref_def_cmp(&list->ref_defs[j - 1], &list->ref_defs[j]) == 0)
-                list->ref_defs[j] = list->ref_defs[j - 1];
+        new_slots = (int*) realloc(index->slots, n_slots * sizeof(int));
+        if (new_slots == NULL) {
+            MD_LOG("realloc() failed.");
+            goto abort;
         }
+        index->slots = new_slots;
+        index->alloc_slots = n_slots;
     }
+    index->n_slots = n_slots;
+    memset(index->slots, 0, n_slots * sizeof(int));
 
-    return 0;
-
-abort:
-    return -1;
-}
+    for (i = 0; i < ctx->n_ref_defs; i++) {
+        const MD_REF_DEF* def = &ctx->ref_defs[i];
+        unsigned slot = md_ref_def_slot(def->hash, n_slots);
 
-static void
-md_free_ref_def_hashtable(MD_CTX* ctx)
-{
-    if (ctx->ref_def_hashtable != NULL) {
-        int i;
+        while (index->slots[slot] != 0) {
+            const MD_REF_DEF* other = &ctx->ref_defs[index->slots[slot] - 1];
 
-        for (i = 0; i < ctx->ref_def_hashtable_size; i++) {
-            void* bucket = ctx->ref_def_hashtable[i];
-            if (bucket == NULL)
-                continue;
-            if (ctx->ref_defs <= (MD_REF_DEF*)bucket && (MD_REF_DEF*)bucket < ctx->ref_defs + ctx->n_ref_defs)
-                continue;
-            free(bucket);
+            if (other->hash == def->hash  &&  other->key_size == def->key_size  &&
+                memcmp(other->key, def->key, def->key_size) == 0)
+                break;  /* Duplicate label: The 1st ref. def. wins. */
+            slot = (slot + 1) & (n_slots - 1);
         }
-
-        free(ctx->ref_def_hashtable);
+        if (index->slots[slot] == 0)
+            index->slots[slot] = i + 1;
     }
+
+    return 0;
+
+abort:
+    index->n_keys[cur] = 0;
+    return -1;
 }
 
 static const MD_REF_DEF*
 md_lookup_ref_def(MD_CTX* ctx, const CHAR* label, SZ label_size)
 {
+    const MD_REF_DEF_INDEX* index = ctx->ref_def_index;
+    MD_ARENA_MARK arena_mark;
+    unsigned char key_buf[256];
+    unsigned char* key = key_buf;
+    const MD_REF_DEF* def = NULL;
+    SZ key_size;
     unsigned hash;
-    void* bucket;
-
-    if (ctx->ref_def_hashtable_size == 0)
-        return NULL;
-
-    hash = md_link_label_hash(label, label_size);
-    bucket = ctx->ref_def_hashtable[hash % ctx->ref_def_hashtable_size];
+    unsigned slot;
 
-    if (bucket == NULL) {
+    if (ctx->n_ref_defs == 0)
         return NULL;
-    }
-    else if (ctx->ref_defs <= (MD_REF_DEF*)bucket && (MD_REF_DEF*)bucket < ctx->ref_defs + ctx->n_ref_defs) {
-        const MD_REF_DEF* def = (MD_REF_DEF*)bucket;
 
-        if (md_link_label_cmp(def->label, def->label_size, label, label_size) == 0)
-            return def;
-        else
+    arena_mark = md_arena_mark(&ctx->arena);
+    if (MD_LINK_LABEL_KEY_MAX(label_size) > sizeof(key_buf)) {
+        key = (unsigned char*) md_arena_alloc(&ctx->arena, MD_LINK_LABEL_KEY_MAX(label_size));
+        if (key == NULL) {
+            MD_LOG("md_arena_alloc() failed.");
             return NULL;
+        }
     }
-    else {
-        MD_REF_DEF_LIST* list = (MD_REF_DEF_LIST*)bucket;
-        MD_REF_DEF key_buf;
-        const MD_REF_DEF* key = &key_buf;
-        const MD_REF_DEF** ret;
-
-        key_buf.label = (CHAR*)label;
-        key_buf.label_size = label_size;
-        key_buf.hash = md_link_label_hash(key_buf.label, key_buf.label_size);
-
-        ret = (const MD_REF_DEF**)bsearch(&key, list->ref_defs,
-            list->n_ref_defs, sizeof(MD_REF_DEF*), md_ref_def_cmp);
-        if (ret != NULL)
-            return *ret;
-        else
-            return NULL;
+
+    key_size = md_link_label_key(label, label_size, key);
+    hash = md_fnv1a(MD_FNV1A_BASE, key, key_size);
+
+    for (slot = md_ref_def_slot(hash, index->n_slots); index->slots[slot] != 0;
+         slot = (slot + 1) & (index->n_slots - 1))
+    {
+        const MD_REF_DEF* tmp = &ctx->ref_defs[index->slots[slot] - 1];
+
+        if (tmp->hash == hash  &&  tmp->key_size == key_size  &&
+            memcmp(tmp->key, key, key_size) == 0)
+        {
+            def = tmp;
+            break;
+        }
     }
+
+    md_arena_release(&ctx->arena, arena_mark);
+    return def;
 }
 
 
@@ -2272,11 +3132,12 @@ md_is_link_reference_definition(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lin
     def = &ctx->ref_defs[ctx->n_ref_defs];
     memset(def, 0, sizeof(MD_REF_DEF));
 
+    /* Multi-line label and title have to be merged into a new string. It is
+     * allocated from ctx->arena so it lives until the end of md_parse(). */
     if (label_is_multiline) {
-        MD_CHECK(md_merge_lines_alloc(ctx, label_contents_beg, label_contents_end,
+        MD_CHECK(md_merge_lines_arena(ctx, label_contents_beg, label_contents_end,
             lines + label_contents_line_index, n_lines - label_contents_line_index,
             _T(' '), &def->label, &def->label_size));
-        def->label_needs_free = TRUE;
     }
     else {
         def->label = (CHAR*)STR(label_contents_beg);
@@ -2284,10 +3145,9 @@ md_is_link_reference_definition(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lin
     }
 
     if (title_is_multiline) {
-        MD_CHECK(md_merge_lines_alloc(ctx, title_contents_beg, title_contents_end,
+        MD_CHECK(md_merge_lines_arena(ctx, title_contents_beg, title_contents_end,
             lines + title_contents_line_index, n_lines - title_contents_line_index,
             _T('\n'), &def->title, &def->title_size));
-        def->title_needs_free = TRUE;
     }
     else {
         def->title = (CHAR*)STR(title_contents_beg);
@@ -2303,10 +3163,6 @@ md_is_link_reference_definition(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lin
 
 abort:
     /* Failure. */
-    if (def != NULL && def->label_needs_free)
-        free(def->label);
-    if (def != NULL && def->title_needs_free)
-        free(def->title);
     return ret;
 }
 
@@ -2316,6 +3172,7 @@ md_is_link_reference(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines,
 {
     const MD_REF_DEF* def;
     const MD_LINE* beg_line;
+    MD_ARENA_MARK arena_mark = md_arena_mark(&ctx->arena);
     int is_multiline;
     CHAR* label;
     SZ label_size;
@@ -2335,7 +3192,7 @@ md_is_link_reference(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines,
     is_multiline = (end > beg_line->end);
 
     if (is_multiline) {
-        MD_CHECK(md_merge_lines_alloc(ctx, beg, end, beg_line,
+        MD_CHECK(md_merge_lines_arena(ctx, beg, end, beg_line,
             (int)(n_lines - (beg_line - lines)), _T(' '), &label, &label_size));
     }
     else {
@@ -2353,7 +3210,7 @@ md_is_link_reference(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines,
     }
 
     if (is_multiline)
-        free(label);
+        md_arena_release(&ctx->arena, arena_mark);
 
     if (def != NULL) {
         /* See https://github.com/mity/md4c/issues/238 */
@@ -2461,31 +3318,14 @@ md_is_inline_link_spec(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines,
         MD_CHECK(md_merge_lines_alloc(ctx, title_contents_beg, title_contents_end,
             lines + title_contents_line_index, n_lines - title_contents_line_index,
             _T('\n'), &attr->title, &attr->title_size));
-        attr->title_needs_free = TRUE;
-    }
-
-    *p_end = off;
-    ret = TRUE;
-
-abort:
-    return ret;
-}
-
-static void
-md_free_ref_defs(MD_CTX* ctx)
-{
-    int i;
-
-    for (i = 0; i < ctx->n_ref_defs; i++) {
-        MD_REF_DEF* def = &ctx->ref_defs[i];
-
-        if (def->label_needs_free)
-            free(def->label);
-        if (def->title_needs_free)
-            free(def->title);
+        attr->title_needs_free = TRUE;
     }
 
-    free(ctx->ref_defs);
+    *p_end = off;
+    ret = TRUE;
+
+abort:
+    return ret;
 }
 
 
@@ -2634,6 +3474,12 @@ md_opener_stack(MD_CTX* ctx, int mark_index)
 static MD_MARK*
 md_add_mark(MD_CTX* ctx)
 {
+    if (ctx->limits.max_marks != 0  &&  ctx->n_marks >= (int) ctx->limits.max_marks) {
+        /* The caller renders the block as a plain text. */
+        ctx->too_many_marks = TRUE;
+        return NULL;
+    }
+
     if (ctx->n_marks >= ctx->alloc_marks) {
         MD_MARK* new_marks;
 
@@ -2763,6 +3609,107 @@ md_rollback(MD_CTX* ctx, int opener_index, int closer_index, int how)
     }
 }
 
+#ifdef MD_USE_AVX2
+
+/* Express mark_char_map[] as a pair of nibble tables (see MD_CTX). This is
+ * exact as long as the mark chars span at most 8 distinct high nibbles; each
+ * of those gets its own bit. */
+static void
+md_build_mark_nibble_tables(MD_CTX* ctx)
+{
+    int n_groups = 0;
+    int hi, lo;
+
+    memset(ctx->mark_nibble_lo, 0, sizeof(ctx->mark_nibble_lo));
+    memset(ctx->mark_nibble_hi, 0, sizeof(ctx->mark_nibble_hi));
+    ctx->mark_simd_level = MD_SIMD_NONE;
+
+    for (hi = 0; hi < 16; hi++) {
+        unsigned char bit;
+
+        for (lo = 0; lo < 16; lo++) {
+            if (ctx->mark_char_map[(hi << 4) | lo])
+                break;
+        }
+        if (lo == 16)
+            continue;
+
+        if (n_groups == 8)
+            return;
+        bit = (unsigned char)(1 << n_groups++);
+        ctx->mark_nibble_hi[hi] = bit;
+        for (lo = 0; lo < 16; lo++) {
+            if (ctx->mark_char_map[(hi << 4) | lo])
+                ctx->mark_nibble_lo[lo] |= bit;
+        }
+    }
+
+    ctx->mark_simd_level = ctx->simd_level;
+}
+
+/* Skip chars which are not in mark_char_map[]. Returns offset of the first
+ * mark char, or an offset where fewer than a full vector of chars remains
+ * before 'end'; the caller has to check the rest. */
+MD_TARGET_SSSE3 static OFF
+md_skip_non_mark_chars_ssse3(MD_CTX* ctx, OFF off, OFF end)
+{
+    const __m128i lo_table = _mm_loadu_si128((const __m128i*)ctx->mark_nibble_lo);
+    const __m128i hi_table = _mm_loadu_si128((const __m128i*)ctx->mark_nibble_hi);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+
+    while (off + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)STR(off));
+        __m128i lo = _mm_shuffle_epi8(lo_table, _mm_and_si128(v, nibble_mask));
+        __m128i hi = _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask));
+        __m128i is_mark = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+        unsigned mask = (unsigned)_mm_movemask_epi8(is_mark) ^ 0xffff;
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 16;
+    }
+
+    return off;
+}
+
+MD_TARGET_AVX2 static OFF
+md_skip_non_mark_chars_avx2(MD_CTX* ctx, OFF off, OFF end)
+{
+    const __m256i lo_table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctx->mark_nibble_lo));
+    const __m256i hi_table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)ctx->mark_nibble_hi));
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+
+    while (off + 32 <= end) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)STR(off));
+        __m256i lo = _mm256_shuffle_epi8(lo_table, _mm256_and_si256(v, nibble_mask));
+        __m256i hi = _mm256_shuffle_epi8(hi_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask));
+        __m256i is_mark = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+        unsigned mask = ~(unsigned)_mm256_movemask_epi8(is_mark);
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 32;
+    }
+
+    /* One more 16-byte step. (Do not call the SSSE3 variant for this: Mixing
+     * legacy SSE code with dirty upper YMM halves is very slow on some CPUs.) */
+    if (off + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)STR(off));
+        __m128i lo = _mm_shuffle_epi8(_mm256_castsi256_si128(lo_table), _mm_and_si128(v, _mm_set1_epi8(0x0f)));
+        __m128i hi = _mm_shuffle_epi8(_mm256_castsi256_si128(hi_table), _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0f)));
+        __m128i is_mark = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+        unsigned mask = (unsigned)_mm_movemask_epi8(is_mark) ^ 0xffff;
+
+        if (mask != 0)
+            return off + md_ctz(mask);
+        off += 16;
+    }
+
+    return off;
+}
+
+#endif  /* MD_USE_AVX2 */
+
 static void
 md_build_mark_char_map(MD_CTX* ctx)
 {
@@ -2807,6 +3754,10 @@ md_build_mark_char_map(MD_CTX* ctx)
                 ctx->mark_char_map[i] = 1;
         }
     }
+
+#ifdef MD_USE_AVX2
+    md_build_mark_nibble_tables(ctx);
+#endif
 }
 
 static int
@@ -3062,6 +4013,13 @@ md_collect_marks(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines, int table_m
 #define IS_MARK_CHAR(off)   (ctx->mark_char_map[(unsigned char) CH(off)])
 #endif
 
+#ifdef MD_USE_AVX2
+            if (ctx->mark_simd_level == MD_SIMD_AVX2)
+                off = md_skip_non_mark_chars_avx2(ctx, off, line->end);
+            else if (ctx->mark_simd_level == MD_SIMD_SSSE3)
+                off = md_skip_non_mark_chars_ssse3(ctx, off, line->end);
+#endif
+
             /* Optimization: Use some loop unrolling. */
             while (off + 3 < line->end && !IS_MARK_CHAR(off + 0) && !IS_MARK_CHAR(off + 1)
                 && !IS_MARK_CHAR(off + 2) && !IS_MARK_CHAR(off + 3))
@@ -4228,8 +5186,8 @@ md_enter_leave_span_a(MD_CTX* ctx, int enter, MD_SPANTYPE type,
         MD_LEAVE_SPAN(type, &det);
 
 abort:
-    md_free_attribute(ctx, &href_build);
     md_free_attribute(ctx, &title_build);
+    md_free_attribute(ctx, &href_build);
     return ret;
 }
 
@@ -4614,7 +5572,8 @@ md_process_table_row(MD_CTX* ctx, MD_BLOCKTYPE cell_type, OFF beg, OFF end,
     const MD_ALIGN* align, int col_count)
 {
     MD_LINE line;
-    OFF* pipe_offs = NULL;
+    MD_ARENA_MARK arena_mark = md_arena_mark(&ctx->arena);
+    OFF* pipe_offs;
     int i, j, k, n;
     int ret = 0;
 
@@ -4623,14 +5582,22 @@ md_process_table_row(MD_CTX* ctx, MD_BLOCKTYPE cell_type, OFF beg, OFF end,
 
     /* Break the line into table cells by identifying pipe characters who
      * form the cell boundary. */
-    MD_CHECK(md_analyze_inlines(ctx, &line, 1, TRUE));
+    ret = md_analyze_inlines(ctx, &line, 1, TRUE);
+    if (ret < 0  &&  ctx->too_many_marks) {
+        /* Too complicated row: Put all of it into the 1st cell. */
+        ctx->too_many_marks = FALSE;
+        ctx->n_marks = 0;
+        ctx->n_table_cell_boundaries = 0;
+        ret = 0;
+    }
+    MD_CHECK(ret);
 
     /* We have to remember the cell boundaries in local buffer because
      * ctx->marks[] shall be reused during cell contents processing. */
     n = ctx->n_table_cell_boundaries + 2;
-    pipe_offs = (OFF*)malloc(n * sizeof(OFF));
+    pipe_offs = (OFF*)md_arena_alloc(&ctx->arena, n * sizeof(OFF));
     if (pipe_offs == NULL) {
-        MD_LOG("malloc() failed.");
+        MD_LOG("md_arena_alloc() failed.");
         ret = -1;
         goto abort;
     }
@@ -4656,7 +5623,7 @@ md_process_table_row(MD_CTX* ctx, MD_BLOCKTYPE cell_type, OFF beg, OFF end,
     MD_LEAVE_BLOCK(MD_BLOCK_TR, NULL);
 
 abort:
-    free(pipe_offs);
+    md_arena_release(&ctx->arena, arena_mark);
 
     ctx->table_cell_boundaries_head = -1;
     ctx->table_cell_boundaries_tail = -1;
@@ -4667,6 +5634,7 @@ abort:
 static int
 md_process_table_block_contents(MD_CTX* ctx, int col_count, const MD_LINE* lines, MD_SIZE n_lines)
 {
+    MD_ARENA_MARK arena_mark = md_arena_mark(&ctx->arena);
     MD_ALIGN* align;
     MD_SIZE line_index;
     int ret = 0;
@@ -4675,9 +5643,9 @@ md_process_table_block_contents(MD_CTX* ctx, int col_count, const MD_LINE* lines
      * with the underlines. */
     MD_ASSERT(n_lines >= 2);
 
-    align = malloc(col_count * sizeof(MD_ALIGN));
+    align = (MD_ALIGN*)md_arena_alloc(&ctx->arena, col_count * sizeof(MD_ALIGN));
     if (align == NULL) {
-        MD_LOG("malloc() failed.");
+        MD_LOG("md_arena_alloc() failed.");
         ret = -1;
         goto abort;
     }
@@ -4699,7 +5667,7 @@ md_process_table_block_contents(MD_CTX* ctx, int col_count, const MD_LINE* lines
     }
 
 abort:
-    free(align);
+    md_arena_release(&ctx->arena, arena_mark);
     return ret;
 }
 
@@ -4744,13 +5712,40 @@ struct MD_CONTAINER_tag {
 };
 
 
+/* Fallback for blocks exceeding MD_PARSE_LIMITS::max_marks: The lines are
+ * output as they are, without looking for any inlines. */
+static int
+md_process_plain_block_contents(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines)
+{
+    MD_SIZE line_index;
+    int ret = 0;
+
+    for (line_index = 0; line_index < n_lines; line_index++) {
+        const MD_LINE* line = &lines[line_index];
+
+        if (line_index > 0)
+            MD_TEXT(MD_TEXT_SOFTBR, _T("\n"), 1);
+        MD_TEXT_INSECURE(MD_TEXT_NORMAL, STR(line->beg), line->end - line->beg);
+    }
+
+abort:
+    return ret;
+}
+
 static int
 md_process_normal_block_contents(MD_CTX* ctx, const MD_LINE* lines, MD_SIZE n_lines)
 {
     int i;
     int ret;
 
-    MD_CHECK(md_analyze_inlines(ctx, lines, n_lines, FALSE));
+    ret = md_analyze_inlines(ctx, lines, n_lines, FALSE);
+    if (ret < 0  &&  ctx->too_many_marks) {
+        ctx->too_many_marks = FALSE;
+        ctx->n_marks = 0;
+        ret = md_process_plain_block_contents(ctx, lines, n_lines);
+        goto abort;
+    }
+    MD_CHECK(ret);
     MD_CHECK(md_process_inlines(ctx, lines, n_lines));
 
 abort:
@@ -4759,106 +5754,647 @@ abort:
         free(md_mark_get_ptr(ctx, i));
     ctx->ptr_stack.top = -1;
 
-    return ret;
+    return ret;
+}
+
+static int
+md_process_verbatim_block_contents(MD_CTX* ctx, MD_TEXTTYPE text_type, const MD_VERBATIMLINE* lines, MD_SIZE n_lines)
+{
+    static const CHAR indent_chunk_str[] = _T("                ");
+    static const SZ indent_chunk_size = SIZEOF_ARRAY(indent_chunk_str) - 1;
+
+    MD_SIZE line_index;
+    int ret = 0;
+
+    for (line_index = 0; line_index < n_lines; line_index++) {
+        const MD_VERBATIMLINE* line = &lines[line_index];
+        int indent = line->indent;
+
+        MD_ASSERT(indent >= 0);
+
+        /* Output code indentation. */
+        while (indent > (int) indent_chunk_size) {
+            MD_TEXT(text_type, indent_chunk_str, indent_chunk_size);
+            indent -= indent_chunk_size;
+        }
+        if (indent > 0)
+            MD_TEXT(text_type, indent_chunk_str, indent);
+
+        /* Output the code line itself. */
+        MD_TEXT_INSECURE(text_type, STR(line->beg), line->end - line->beg);
+
+        /* Enforce end-of-line. */
+        MD_TEXT(text_type, _T("\n"), 1);
+    }
+
+abort:
+    return ret;
+}
+
+static int
+md_process_code_block_contents(MD_CTX* ctx, int is_fenced, const MD_VERBATIMLINE* lines, MD_SIZE n_lines)
+{
+    if (is_fenced) {
+        /* Skip the first line in case of fenced code: It is the fence.
+         * (Only the starting fence is present due to logic in md_analyze_line().) */
+        lines++;
+        n_lines--;
+    }
+    else {
+        /* Ignore blank lines at start/end of indented code block. */
+        while (n_lines > 0 && lines[0].beg == lines[0].end) {
+            lines++;
+            n_lines--;
+        }
+        while (n_lines > 0 && lines[n_lines - 1].beg == lines[n_lines - 1].end) {
+            n_lines--;
+        }
+    }
+
+    if (n_lines == 0)
+        return 0;
+
+    return md_process_verbatim_block_contents(ctx, MD_TEXT_CODE, lines, n_lines);
+}
+
+static int
+md_setup_fenced_code_detail(MD_CTX* ctx, const MD_BLOCK* block, MD_BLOCK_CODE_DETAIL* det,
+    MD_ATTRIBUTE_BUILD* info_build, MD_ATTRIBUTE_BUILD* lang_build)
+{
+    const MD_VERBATIMLINE* fence_line = (const MD_VERBATIMLINE*)(block + 1);
+    OFF beg = fence_line->beg;
+    OFF end = fence_line->end;
+    OFF lang_end;
+    CHAR fence_ch = CH(fence_line->beg);
+    int ret = 0;
+
+    /* Skip the fence itself. */
+    while (beg < ctx->size && CH(beg) == fence_ch)
+        beg++;
+    /* Trim initial spaces. */
+    while (beg < ctx->size && CH(beg) == _T(' '))
+        beg++;
+
+    /* Trim trailing spaces. */
+    while (end > beg && CH(end - 1) == _T(' '))
+        end--;
+
+    /* Build info string attribute. */
+    MD_CHECK(md_build_attribute(ctx, STR(beg), end - beg, 0, &det->info, info_build));
+
+    /* Build info string attribute. */
+    lang_end = beg;
+    while (lang_end < end && !ISWHITESPACE(lang_end))
+        lang_end++;
+    MD_CHECK(md_build_attribute(ctx, STR(beg), lang_end - beg, 0, &det->lang, lang_build));
+
+    det->fence_char = fence_ch;
+
+abort:
+    return ret;
+}
+
+#ifdef MD_USE_THREADS
+
+/***************************************
+ ***  Parallel Analysis of Inlines  ***
+ ***************************************/
+
+/* With md_parse_context_set_threads(), md_process_all_blocks() splits the
+ * leaf blocks into batches and worker threads run md_analyze_inlines() on
+ * them while the calling thread walks the blocks and calls the callbacks.
+ *
+ * When the calling thread reaches a block, it borrows the block's marks
+ * from the batch and calls md_process_inlines() on them. The inline
+ * analysis of a block depends only on the block itself and on the
+ * reference definitions (which are complete and read-only at this point),
+ * so the output is the same as from the single-threaded parsing.
+ *
+ * The only exception is ctx->max_ref_def_output: It is a budget shared by
+ * all the blocks in the document order. Every worker spends its own copy of
+ * the budget and if the calling thread then finds the real budget would not
+ * suffice, it throws the batch away and analyzes it itself.
+ */
+
+/* Size of the inline contents in a batch, and minimal count of batches to
+ * bother with the workers at all. */
+#define MD_INLINE_BATCH_SIZE        (64 * 1024)
+#define MD_INLINE_BATCH_MIN_COUNT   2
+
+/* Batches being analyzed or waiting for the calling thread, per worker. */
+#define MD_INLINE_SLOTS_PER_WORKER  4
+
+#define MD_BATCH_PENDING    0       /* Not analyzed (yet). */
+#define MD_BATCH_DONE       1
+#define MD_BATCH_FAILED     2       /* The calling thread has to analyze it. */
+
+/* Analyzed inlines of one leaf block. */
+typedef struct MD_INLINE_RESULT_tag MD_INLINE_RESULT;
+struct MD_INLINE_RESULT_tag {
+    int mark_off;           /* Index of the 1st mark in MD_INLINE_BATCH::marks. */
+    int n_marks;
+    int ptr_stack_top;      /* MD_CTX::ptr_stack, relative to mark_off. */
+};
+
+typedef struct MD_INLINE_BATCH_tag MD_INLINE_BATCH;
+struct MD_INLINE_BATCH_tag {
+    int state;
+    SZ ref_def_output;      /* How much of the budget the worker has spent. */
+    MD_INLINE_RESULT* results;
+    int n_results;
+    int alloc_results;
+    MD_MARK* marks;
+    int n_marks;
+    int alloc_marks;
+};
+
+typedef struct MD_WORKER_tag MD_WORKER;
+struct MD_WORKER_tag {
+    MD_WORKER_POOL* pool;
+
+    /* Buffers for md_analyze_inlines(), kept between batches and parses. */
+    MD_MARK* marks;
+    int alloc_marks;
+    MD_ARENA arena;
+};
+
+struct MD_WORKER_POOL_tag {
+    MD_MUTEX mutex;
+    MD_COND work_cond;      /* For workers: New batch to analyze, or quit. */
+    MD_COND done_cond;      /* For the calling thread: A batch is finished. */
+    MD_THREAD* threads;
+    MD_WORKER* workers;
+    int n_threads;
+    int quit;
+
+    /* The current job. Batch i covers the range of ctx->block_bytes from
+     * batch_offs[i] to batch_offs[i+1] and it lives in slots[i % n_slots].
+     * Workers may only take batches which fit into the free slots. */
+    int has_job;
+    MD_CTX tmpl;            /* Copy of MD_CTX for the workers. */
+    SZ ref_def_budget;      /* Initial ctx->max_ref_def_output. */
+    int* batch_offs;
+    int alloc_batch_offs;
+    int n_batches;
+    int next_batch;         /* Next batch for a worker to take. */
+    int n_released;         /* Batches consumed by the calling thread. */
+    int n_busy;             /* Workers analyzing a batch right now. */
+    MD_INLINE_BATCH* slots;
+    int n_slots;
+
+    /* Only for the calling thread. */
+    int cur_batch;
+    int cur_result;         /* -1 if the cur_batch has not been waited for. */
+};
+
+/* Leaf blocks which md_process_leaf_block() passes to
+ * md_process_normal_block_contents(). */
+static inline int
+md_block_has_normal_inlines(const MD_BLOCK* block)
+{
+    return (!(block->flags & MD_BLOCK_CONTAINER)  &&  block->n_lines > 0  &&
+            block->type != MD_BLOCK_HR  &&  block->type != MD_BLOCK_CODE  &&
+            block->type != MD_BLOCK_HTML  &&  block->type != MD_BLOCK_TABLE);
+}
+
+static inline int
+md_next_block_off(const MD_BLOCK* block, int byte_off)
+{
+    byte_off += sizeof(MD_BLOCK);
+    if (!(block->flags & MD_BLOCK_CONTAINER)) {
+        if (block->type == MD_BLOCK_CODE || block->type == MD_BLOCK_HTML)
+            byte_off += block->n_lines * sizeof(MD_VERBATIMLINE);
+        else
+            byte_off += block->n_lines * sizeof(MD_LINE);
+    }
+    return byte_off;
+}
+
+/* Free memory blocks stored in dummy marks of results which the calling
+ * thread has not processed. (See md_mark_get_ptr().) */
+static void
+md_free_inline_results(MD_INLINE_BATCH* batch, int from)
+{
+    int r, i;
+
+    for (r = from; r < batch->n_results; r++) {
+        MD_MARK* marks = batch->marks + batch->results[r].mark_off;
+
+        for (i = batch->results[r].ptr_stack_top; i >= 0; i = marks[i].next) {
+            void* ptr;
+            memcpy(&ptr, &marks[i], sizeof(void*));
+            free(ptr);
+        }
+    }
+}
+
+static int
+md_add_inline_result(MD_CTX* wctx, MD_INLINE_BATCH* batch)
+{
+    MD_INLINE_RESULT* res;
+
+    if (batch->n_results >= batch->alloc_results) {
+        int alloc_results = (batch->alloc_results > 0 ? batch->alloc_results * 2 : 64);
+        MD_INLINE_RESULT* results;
+
+        results = (MD_INLINE_RESULT*)realloc(batch->results, alloc_results * sizeof(MD_INLINE_RESULT));
+        if (results == NULL)
+            return -1;
+        batch->results = results;
+        batch->alloc_results = alloc_results;
+    }
+
+    if (batch->n_marks + wctx->n_marks > batch->alloc_marks) {
+        int alloc_marks = batch->alloc_marks + batch->alloc_marks / 2;
+        MD_MARK* marks;
+
+        if (alloc_marks < batch->n_marks + wctx->n_marks)
+            alloc_marks = batch->n_marks + wctx->n_marks + 256;
+        marks = (MD_MARK*)realloc(batch->marks, alloc_marks * sizeof(MD_MARK));
+        if (marks == NULL)
+            return -1;
+        batch->marks = marks;
+        batch->alloc_marks = alloc_marks;
+    }
+
+    res = &batch->results[batch->n_results++];
+    res->mark_off = batch->n_marks;
+    res->n_marks = wctx->n_marks;
+    res->ptr_stack_top = wctx->ptr_stack.top;
+    memcpy(batch->marks + batch->n_marks, wctx->marks, wctx->n_marks * sizeof(MD_MARK));
+    batch->n_marks += wctx->n_marks;
+
+    /* The batch owns the memory stored in the dummy marks now. */
+    wctx->ptr_stack.top = -1;
+    return 0;
+}
+
+/* Called in a worker thread (without the pool->mutex locked). */
+static int
+md_analyze_inline_batch(MD_WORKER* worker, int byte_beg, int byte_end, MD_INLINE_BATCH* batch)
+{
+    MD_WORKER_POOL* pool = worker->pool;
+    MD_CTX wctx;
+    MD_CTX* ctx = &wctx;
+    int byte_off = byte_beg;
+    int state = MD_BATCH_DONE;
+    int i;
+
+    memcpy(&wctx, &pool->tmpl, sizeof(MD_CTX));
+    wctx.pool = NULL;
+    wctx.parser.debug_log = NULL;   /* The callbacks belong to the calling thread. */
+    wctx.buffer = NULL;
+    wctx.alloc_buffer = 0;
+    wctx.arena = worker->arena;
+    wctx.marks = worker->marks;
+    wctx.alloc_marks = worker->alloc_marks;
+    wctx.n_marks = 0;
+    wctx.max_ref_def_output = pool->ref_def_budget;
+    for (i = 0; i < (int)SIZEOF_ARRAY(wctx.opener_stacks); i++)
+        wctx.opener_stacks[i].top = -1;
+    wctx.ptr_stack.top = -1;
+    wctx.unresolved_link_head = -1;
+    wctx.unresolved_link_tail = -1;
+    wctx.table_cell_boundaries_head = -1;
+    wctx.table_cell_boundaries_tail = -1;
+
+    while (byte_off < byte_end) {
+        const MD_BLOCK* block = (const MD_BLOCK*)((const char*)wctx.block_bytes + byte_off);
+
+        if (md_block_has_normal_inlines(block)) {
+            if (md_analyze_inlines(ctx, (const MD_LINE*)(block + 1), block->n_lines, FALSE) < 0  ||
+                md_add_inline_result(ctx, batch) < 0)
+            {
+                for (i = ctx->ptr_stack.top; i >= 0; i = ctx->marks[i].next)
+                    free(md_mark_get_ptr(ctx, i));
+                ctx->ptr_stack.top = -1;
+                md_free_inline_results(batch, 0);
+                batch->n_results = 0;
+                batch->n_marks = 0;
+                state = MD_BATCH_FAILED;
+                break;
+            }
+        }
+
+        byte_off = md_next_block_off(block, byte_off);
+    }
+
+    batch->ref_def_output = pool->ref_def_budget - wctx.max_ref_def_output;
+
+    worker->marks = wctx.marks;
+    worker->alloc_marks = wctx.alloc_marks;
+    worker->arena = wctx.arena;
+    md_arena_reset(&worker->arena);
+    return state;
+}
+
+static void
+md_worker_main(MD_WORKER* worker)
+{
+    MD_WORKER_POOL* pool = worker->pool;
+
+    md_mutex_lock(&pool->mutex);
+    while (TRUE) {
+        MD_INLINE_BATCH* batch;
+        int batch_index;
+        int state;
+
+        while (!pool->quit  &&  !(pool->has_job  &&  pool->next_batch < pool->n_batches  &&
+                                  pool->next_batch < pool->n_released + pool->n_slots))
+            md_cond_wait(&pool->work_cond, &pool->mutex);
+        if (pool->quit)
+            break;
+
+        batch_index = pool->next_batch++;
+        batch = &pool->slots[batch_index % pool->n_slots];
+        pool->n_busy++;
+        md_mutex_unlock(&pool->mutex);
+
+        state = md_analyze_inline_batch(worker, pool->batch_offs[batch_index],
+                    pool->batch_offs[batch_index + 1], batch);
+
+        md_mutex_lock(&pool->mutex);
+        batch->state = state;
+        pool->n_busy--;
+        md_cond_broadcast(&pool->done_cond);
+    }
+    md_mutex_unlock(&pool->mutex);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI
+md_worker_thread_proc(LPVOID arg)
+{
+    md_worker_main((MD_WORKER*)arg);
+    return 0;
+}
+
+static int
+md_thread_create(MD_THREAD* thread, MD_WORKER* worker)
+{
+    *thread = CreateThread(NULL, 0, md_worker_thread_proc, (LPVOID)worker, 0, NULL);
+    return (*thread != NULL ? 0 : -1);
+}
+
+static void
+md_thread_join(MD_THREAD thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+#else
+static void*
+md_worker_thread_proc(void* arg)
+{
+    md_worker_main((MD_WORKER*)arg);
+    return NULL;
 }
 
 static int
-md_process_verbatim_block_contents(MD_CTX* ctx, MD_TEXTTYPE text_type, const MD_VERBATIMLINE* lines, MD_SIZE n_lines)
+md_thread_create(MD_THREAD* thread, MD_WORKER* worker)
 {
-    static const CHAR indent_chunk_str[] = _T("                ");
-    static const SZ indent_chunk_size = SIZEOF_ARRAY(indent_chunk_str) - 1;
+    return (pthread_create(thread, NULL, md_worker_thread_proc, (void*)worker) == 0 ? 0 : -1);
+}
 
-    MD_SIZE line_index;
-    int ret = 0;
+static void
+md_thread_join(MD_THREAD thread)
+{
+    pthread_join(thread, NULL);
+}
+#endif
 
-    for (line_index = 0; line_index < n_lines; line_index++) {
-        const MD_VERBATIMLINE* line = &lines[line_index];
-        int indent = line->indent;
+static void
+md_worker_pool_destroy(MD_WORKER_POOL* pool)
+{
+    int i;
 
-        MD_ASSERT(indent >= 0);
+    md_mutex_lock(&pool->mutex);
+    pool->quit = TRUE;
+    md_cond_broadcast(&pool->work_cond);
+    md_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->n_threads; i++) {
+        md_thread_join(pool->threads[i]);
+        free(pool->workers[i].marks);
+        md_arena_free(&pool->workers[i].arena);
+    }
+    for (i = 0; i < pool->n_slots; i++) {
+        free(pool->slots[i].results);
+        free(pool->slots[i].marks);
+    }
+
+    md_cond_destroy(&pool->done_cond);
+    md_cond_destroy(&pool->work_cond);
+    md_mutex_destroy(&pool->mutex);
+    free(pool->batch_offs);
+    free(pool->slots);
+    free(pool->workers);
+    free(pool->threads);
+    free(pool);
+}
 
-        /* Output code indentation. */
-        while (indent > (int) indent_chunk_size) {
-            MD_TEXT(text_type, indent_chunk_str, indent_chunk_size);
-            indent -= indent_chunk_size;
-        }
-        if (indent > 0)
-            MD_TEXT(text_type, indent_chunk_str, indent);
+static MD_WORKER_POOL*
+md_worker_pool_create(int n_threads)
+{
+    MD_WORKER_POOL* pool;
+    int i;
 
-        /* Output the code line itself. */
-        MD_TEXT_INSECURE(text_type, STR(line->beg), line->end - line->beg);
+    pool = (MD_WORKER_POOL*)malloc(sizeof(MD_WORKER_POOL));
+    if (pool == NULL)
+        return NULL;
+    memset(pool, 0, sizeof(MD_WORKER_POOL));
+    md_mutex_init(&pool->mutex);
+    md_cond_init(&pool->work_cond);
+    md_cond_init(&pool->done_cond);
+
+    pool->threads = (MD_THREAD*)malloc(n_threads * sizeof(MD_THREAD));
+    pool->workers = (MD_WORKER*)calloc(n_threads, sizeof(MD_WORKER));
+    pool->slots = (MD_INLINE_BATCH*)calloc(n_threads * MD_INLINE_SLOTS_PER_WORKER, sizeof(MD_INLINE_BATCH));
+    if (pool->threads == NULL || pool->workers == NULL || pool->slots == NULL) {
+        md_worker_pool_destroy(pool);
+        return NULL;
+    }
+    pool->n_slots = n_threads * MD_INLINE_SLOTS_PER_WORKER;
 
-        /* Enforce end-of-line. */
-        MD_TEXT(text_type, _T("\n"), 1);
+    for (i = 0; i < n_threads; i++) {
+        pool->workers[i].pool = pool;
+        if (md_thread_create(&pool->threads[i], &pool->workers[i]) != 0)
+            break;
+        pool->n_threads++;
     }
 
-abort:
-    return ret;
+    if (pool->n_threads == 0) {
+        md_worker_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
 }
 
-static int
-md_process_code_block_contents(MD_CTX* ctx, int is_fenced, const MD_VERBATIMLINE* lines, MD_SIZE n_lines)
+/* Split the leaf blocks into batches and let the workers start. If it is
+ * not worth it (or on error), ctx->pool is reset to NULL and the document
+ * is processed the usual way. */
+static void
+md_worker_pool_start(MD_CTX* ctx)
 {
-    if (is_fenced) {
-        /* Skip the first line in case of fenced code: It is the fence.
-         * (Only the starting fence is present due to logic in md_analyze_line().) */
-        lines++;
-        n_lines--;
-    }
-    else {
-        /* Ignore blank lines at start/end of indented code block. */
-        while (n_lines > 0 && lines[0].beg == lines[0].end) {
-            lines++;
-            n_lines--;
+    MD_WORKER_POOL* pool = ctx->pool;
+    int byte_off = 0;
+    int n_batches = 0;
+    SZ batch_size = 0;
+
+    while (byte_off < ctx->n_block_bytes) {
+        const MD_BLOCK* block = (const MD_BLOCK*)((const char*)ctx->block_bytes + byte_off);
+
+        if (md_block_has_normal_inlines(block)) {
+            const MD_LINE* lines = (const MD_LINE*)(block + 1);
+            batch_size += lines[block->n_lines - 1].end - lines[0].beg + 1;
         }
-        while (n_lines > 0 && lines[n_lines - 1].beg == lines[n_lines - 1].end) {
-            n_lines--;
+        byte_off = md_next_block_off(block, byte_off);
+
+        if (batch_size >= MD_INLINE_BATCH_SIZE  ||  (byte_off >= ctx->n_block_bytes  &&  batch_size > 0)) {
+            if (n_batches + 2 > pool->alloc_batch_offs) {
+                int alloc_batch_offs = (pool->alloc_batch_offs > 0 ? pool->alloc_batch_offs * 2 : 256);
+                int* batch_offs;
+
+                batch_offs = (int*)realloc(pool->batch_offs, alloc_batch_offs * sizeof(int));
+                if (batch_offs == NULL) {
+                    MD_LOG("realloc() failed.");
+                    ctx->pool = NULL;
+                    return;
+                }
+                pool->batch_offs = batch_offs;
+                pool->alloc_batch_offs = alloc_batch_offs;
+            }
+            pool->batch_offs[n_batches++] = byte_off;
+            batch_size = 0;
         }
     }
 
-    if (n_lines == 0)
-        return 0;
+    if (n_batches < MD_INLINE_BATCH_MIN_COUNT) {
+        ctx->pool = NULL;
+        return;
+    }
 
-    return md_process_verbatim_block_contents(ctx, MD_TEXT_CODE, lines, n_lines);
+    /* batch_offs[] has been filled with the ends; shift it to get the
+     * beginnings too. */
+    memmove(pool->batch_offs + 1, pool->batch_offs, n_batches * sizeof(int));
+    pool->batch_offs[0] = 0;
+
+    memcpy(&pool->tmpl, ctx, sizeof(MD_CTX));
+    pool->ref_def_budget = ctx->max_ref_def_output;
+    pool->cur_batch = 0;
+    pool->cur_result = -1;
+
+    md_mutex_lock(&pool->mutex);
+    pool->n_batches = n_batches;
+    pool->next_batch = 0;
+    pool->n_released = 0;
+    pool->has_job = TRUE;
+    md_cond_broadcast(&pool->work_cond);
+    md_mutex_unlock(&pool->mutex);
+}
+
+static void
+md_worker_pool_release_batch(MD_WORKER_POOL* pool)
+{
+    MD_INLINE_BATCH* batch = &pool->slots[pool->cur_batch % pool->n_slots];
+
+    /* Free what the calling thread has not processed (if anything). */
+    if (batch->state == MD_BATCH_DONE)
+        md_free_inline_results(batch, (pool->cur_result >= 0 ? pool->cur_result : 0));
+    batch->state = MD_BATCH_PENDING;
+    batch->n_results = 0;
+    batch->n_marks = 0;
+
+    md_mutex_lock(&pool->mutex);
+    pool->n_released++;
+    md_cond_broadcast(&pool->work_cond);
+    md_mutex_unlock(&pool->mutex);
+
+    pool->cur_batch++;
+    pool->cur_result = -1;
+}
+
+/* Stop the job. Batches nobody has taken are dropped; we wait for those
+ * the workers are analyzing right now. */
+static void
+md_worker_pool_finish(MD_CTX* ctx)
+{
+    MD_WORKER_POOL* pool = ctx->pool;
+    int n_taken;
+
+    md_mutex_lock(&pool->mutex);
+    pool->n_batches = pool->next_batch;
+    while (pool->n_busy > 0)
+        md_cond_wait(&pool->done_cond, &pool->mutex);
+    pool->has_job = FALSE;
+    n_taken = pool->next_batch;
+    md_mutex_unlock(&pool->mutex);
+
+    while (pool->cur_batch < n_taken)
+        md_worker_pool_release_batch(pool);
 }
 
 static int
-md_setup_fenced_code_detail(MD_CTX* ctx, const MD_BLOCK* block, MD_BLOCK_CODE_DETAIL* det,
-    MD_ATTRIBUTE_BUILD* info_build, MD_ATTRIBUTE_BUILD* lang_build)
+md_process_pooled_block_contents(MD_CTX* ctx, const MD_BLOCK* block)
 {
-    const MD_VERBATIMLINE* fence_line = (const MD_VERBATIMLINE*)(block + 1);
-    OFF beg = fence_line->beg;
-    OFF end = fence_line->end;
-    OFF lang_end;
-    CHAR fence_ch = CH(fence_line->beg);
+    MD_WORKER_POOL* pool = ctx->pool;
+    const MD_LINE* lines = (const MD_LINE*)(block + 1);
+    int byte_off = (int)((const char*)block - (const char*)ctx->block_bytes);
+    MD_INLINE_BATCH* batch;
+    MD_INLINE_RESULT* res;
+    MD_MARK* marks;
+    int i;
     int ret = 0;
 
-    /* Skip the fence itself. */
-    while (beg < ctx->size && CH(beg) == fence_ch)
-        beg++;
-    /* Trim initial spaces. */
-    while (beg < ctx->size && CH(beg) == _T(' '))
-        beg++;
+    while (byte_off >= pool->batch_offs[pool->cur_batch + 1])
+        md_worker_pool_release_batch(pool);
+
+    batch = &pool->slots[pool->cur_batch % pool->n_slots];
+    if (pool->cur_result < 0) {
+        md_mutex_lock(&pool->mutex);
+        while (batch->state == MD_BATCH_PENDING)
+            md_cond_wait(&pool->done_cond, &pool->mutex);
+        md_mutex_unlock(&pool->mutex);
+
+        if (batch->state == MD_BATCH_DONE) {
+            if (batch->ref_def_output < ctx->max_ref_def_output) {
+                ctx->max_ref_def_output -= batch->ref_def_output;
+            } else {
+                /* The worker instantiated reference links the real budget
+                 * would not allow. */
+                md_free_inline_results(batch, 0);
+                batch->state = MD_BATCH_FAILED;
+            }
+        }
+        pool->cur_result = 0;
+    }
 
-    /* Trim trailing spaces. */
-    while (end > beg && CH(end - 1) == _T(' '))
-        end--;
+    if (batch->state == MD_BATCH_FAILED)
+        return md_process_normal_block_contents(ctx, lines, block->n_lines);
 
-    /* Build info string attribute. */
-    MD_CHECK(md_build_attribute(ctx, STR(beg), end - beg, 0, &det->info, info_build));
+    MD_ASSERT(pool->cur_result < batch->n_results);
+    res = &batch->results[pool->cur_result++];
 
-    /* Build info string attribute. */
-    lang_end = beg;
-    while (lang_end < end && !ISWHITESPACE(lang_end))
-        lang_end++;
-    MD_CHECK(md_build_attribute(ctx, STR(beg), lang_end - beg, 0, &det->lang, lang_build));
+    /* Lend the marks to md_process_inlines(). It does not add any. */
+    marks = ctx->marks;
+    ctx->marks = batch->marks + res->mark_off;
+    ctx->n_marks = res->n_marks;
+    ctx->ptr_stack.top = res->ptr_stack_top;
 
-    det->fence_char = fence_ch;
+    MD_CHECK(md_process_inlines(ctx, lines, block->n_lines));
 
 abort:
+    for (i = ctx->ptr_stack.top; i >= 0; i = ctx->marks[i].next)
+        free(md_mark_get_ptr(ctx, i));
+    ctx->ptr_stack.top = -1;
+    ctx->marks = marks;
+    ctx->n_marks = 0;
+
     return ret;
 }
 
+#endif  /* MD_USE_THREADS */
+
 static int
 md_process_leaf_block(MD_CTX* ctx, const MD_BLOCK* block)
 {
@@ -4930,6 +6466,12 @@ md_process_leaf_block(MD_CTX* ctx, const MD_BLOCK* block)
         break;
 
     default:
+#ifdef MD_USE_THREADS
+        if (ctx->pool != NULL) {
+            MD_CHECK(md_process_pooled_block_contents(ctx, block));
+            break;
+        }
+#endif
         MD_CHECK(md_process_normal_block_contents(ctx,
             (const MD_LINE*)(block + 1), block->n_lines));
         break;
@@ -4940,16 +6482,31 @@ md_process_leaf_block(MD_CTX* ctx, const MD_BLOCK* block)
 
 abort:
     if (clean_fence_code_detail) {
-        md_free_attribute(ctx, &info_build);
         md_free_attribute(ctx, &lang_build);
+        md_free_attribute(ctx, &info_build);
     }
     return ret;
 }
 
+/* Checks MD_PARSE_LIMITS::max_time_ms. */
+static int
+md_is_time_up(MD_CTX* ctx)
+{
+    if (!ctx->time_is_up  &&  ctx->limits.max_time_ms != 0  &&
+        md_clock_ms() - ctx->start_time >= ctx->limits.max_time_ms)
+    {
+        ctx->time_is_up = TRUE;
+        ctx->limit_exceeded = TRUE;
+    }
+
+    return ctx->time_is_up;
+}
+
 static int
 md_process_all_blocks(MD_CTX* ctx)
 {
     int byte_off = 0;
+    int n_skipped_containers = 0;
     int ret = 0;
 
     /* ctx->containers now is not needed for detection of lists and list items
@@ -4958,6 +6515,11 @@ md_process_all_blocks(MD_CTX* ctx)
      * level of lists. */
     ctx->n_containers = 0;
 
+#ifdef MD_USE_THREADS
+    if (ctx->pool != NULL)
+        md_worker_pool_start(ctx);
+#endif
+
     while (byte_off < ctx->n_block_bytes) {
         MD_BLOCK* block = (MD_BLOCK*)((char*)ctx->block_bytes + byte_off);
         union {
@@ -4990,14 +6552,22 @@ md_process_all_blocks(MD_CTX* ctx)
         }
 
         if (block->flags & MD_BLOCK_CONTAINER) {
-            if (block->flags & MD_BLOCK_CONTAINER_CLOSER) {
+            /* When the time is up, we only close the containers which are
+             * already open. */
+            if ((block->flags & MD_BLOCK_CONTAINER_CLOSER)  &&  n_skipped_containers > 0) {
+                n_skipped_containers--;
+            }
+            else if (block->flags & MD_BLOCK_CONTAINER_CLOSER) {
                 MD_LEAVE_BLOCK(block->type, &det);
 
                 if (block->type == MD_BLOCK_UL || block->type == MD_BLOCK_OL || block->type == MD_BLOCK_QUOTE)
                     ctx->n_containers--;
             }
 
-            if (block->flags & MD_BLOCK_CONTAINER_OPENER) {
+            if ((block->flags & MD_BLOCK_CONTAINER_OPENER)  &&  ctx->time_is_up) {
+                n_skipped_containers++;
+            }
+            else if (block->flags & MD_BLOCK_CONTAINER_OPENER) {
                 MD_ENTER_BLOCK(block->type, &det);
 
                 if (block->type == MD_BLOCK_UL || block->type == MD_BLOCK_OL) {
@@ -5014,7 +6584,8 @@ md_process_all_blocks(MD_CTX* ctx)
             }
         }
         else {
-            MD_CHECK(md_process_leaf_block(ctx, block));
+            if (!md_is_time_up(ctx))
+                MD_CHECK(md_process_leaf_block(ctx, block));
 
             if (block->type == MD_BLOCK_CODE || block->type == MD_BLOCK_HTML)
                 byte_off += block->n_lines * sizeof(MD_VERBATIMLINE);
@@ -5028,6 +6599,10 @@ md_process_all_blocks(MD_CTX* ctx)
     ctx->n_block_bytes = 0;
 
 abort:
+#ifdef MD_USE_THREADS
+    if (ctx->pool != NULL)
+        md_worker_pool_finish(ctx);
+#endif
     return ret;
 }
 
@@ -5074,6 +6649,10 @@ md_start_new_block(MD_CTX* ctx, const MD_LINE_ANALYSIS* line)
 
     MD_ASSERT(ctx->current_block == NULL);
 
+    /* Block boundary is where we check the time. When it is up,
+     * md_process_doc() stops after the current line. */
+    md_is_time_up(ctx);
+
     block = (MD_BLOCK*)md_push_block_bytes(ctx, sizeof(MD_BLOCK));
     if (block == NULL)
         return -1;
@@ -5483,26 +7062,35 @@ struct TAG_tag {
 
 static const TAG t1[] = { X("pre"), X("script"), X("style"), X("textarea"), Xend };
 
-static const TAG a6[] = { X("address"), X("article"), X("aside"), Xend };
-static const TAG b6[] = { X("base"), X("basefont"), X("blockquote"), X("body"), Xend };
-static const TAG c6[] = { X("caption"), X("center"), X("col"), X("colgroup"), Xend };
-static const TAG d6[] = { X("dd"), X("details"), X("dialog"), X("dir"),
-                          X("div"), X("dl"), X("dt"), Xend };
-static const TAG f6[] = { X("fieldset"), X("figcaption"), X("figure"), X("footer"),
-                          X("form"), X("frame"), X("frameset"), Xend };
-static const TAG h6[] = { X("h1"), X("h2"), X("h3"), X("h4"), X("h5"), X("h6"),
-                          X("head"), X("header"), X("hr"), X("html"), Xend };
-static const TAG i6[] = { X("iframe"), Xend };
-static const TAG l6[] = { X("legend"), X("li"), X("link"), Xend };
-static const TAG m6[] = { X("main"), X("menu"), X("menuitem"), Xend };
-static const TAG n6[] = { X("nav"), X("noframes"), Xend };
-static const TAG o6[] = { X("ol"), X("optgroup"), X("option"), Xend };
-static const TAG p6[] = { X("p"), X("param"), Xend };
-static const TAG s6[] = { X("search"), X("section"), X("summary"), Xend };
-static const TAG t6[] = { X("table"), X("tbody"), X("td"), X("tfoot"), X("th"),
-                          X("thead"), X("title"), X("tr"), X("track"), Xend };
-static const TAG u6[] = { X("ul"), Xend };
-static const TAG xx[] = { Xend };
+#define TAG6_NAME_MAXLEN        10
+
+/* Perfect hash of the tag names which start HTML block of type 6.
+ * Generated by scripts/build_hash_maps.py. */
+#define TAG6_HASH_BUCKETS       16
+#define TAG6_HASH_SLOTS         96
+
+static const unsigned short TAG6_HASH_DISP[16] = {
+    2, 4, 1, 2, 3, 0, 13, 3, 4, 2, 0, 13, 7, 3, 1, 49
+};
+
+static const TAG TAG6_HASH_MAP[96] = {
+    Xend, X("search"), X("menuitem"), X("col"), X("li"), Xend,
+    X("tfoot"), Xend, Xend, X("section"), X("param"), Xend,
+    X("fieldset"), Xend, X("h4"), Xend, X("iframe"), Xend,
+    X("dd"), X("legend"), X("dialog"), Xend, X("frameset"), X("link"),
+    Xend, X("dt"), X("address"), X("h5"), X("center"), Xend,
+    Xend, X("track"), X("main"), Xend, Xend, X("menu"),
+    Xend, Xend, X("ol"), X("summary"), Xend, X("base"),
+    X("title"), X("colgroup"), X("blockquote"), X("caption"), Xend, Xend,
+    Xend, X("h2"), X("article"), X("table"), Xend, Xend,
+    Xend, X("h3"), X("header"), Xend, X("thead"), X("p"),
+    X("aside"), X("div"), Xend, X("basefont"), X("th"), X("form"),
+    Xend, X("td"), Xend, Xend, X("option"), X("html"),
+    Xend, Xend, X("figcaption"), Xend, Xend, X("hr"),
+    X("optgroup"), X("ul"), X("frame"), X("head"), X("tbody"), X("h1"),
+    X("figure"), X("footer"), Xend, X("body"), X("tr"), X("dir"),
+    X("dl"), X("noframes"), Xend, X("h6"), X("nav"), X("details")
+};
 
 #undef X
 #undef Xend
@@ -5513,12 +7101,6 @@ static const TAG xx[] = { Xend };
 static int
 md_is_html_block_start_condition(MD_CTX* ctx, OFF beg)
 {
-    /* Type 6 is started by a long list of allowed tags. We use two-level
-     * tree to speed-up the search. */
-    static const TAG* map6[26] = {
-        a6, b6, c6, d6, xx, f6, xx, h6, i6, xx, xx, l6, m6,
-        n6, o6, p6, xx, xx, s6, t6, u6, xx, xx, xx, xx, xx
-    };
     OFF off = beg + 1;
     int i;
 
@@ -5553,27 +7135,32 @@ md_is_html_block_start_condition(MD_CTX* ctx, OFF beg)
 
     /* Check for type 6: Many possible starting tags listed above. */
     if (off + 1 < ctx->size && (ISALPHA(off) || (CH(off) == _T('/') && ISALPHA(off + 1)))) {
-        int slot;
-        const TAG* tags;
+        char name[TAG6_NAME_MAXLEN];
+        SZ len = 0;
 
         if (CH(off) == _T('/'))
             off++;
 
-        slot = (ISUPPER(off) ? CH(off) - 'A' : CH(off) - 'a');
-        tags = map6[slot];
-
-        for (i = 0; tags[i].name != NULL; i++) {
-            if (off + tags[i].len <= ctx->size) {
-                if (md_ascii_case_eq(STR(off), tags[i].name, tags[i].len)) {
-                    OFF tmp = off + tags[i].len;
-                    if (tmp >= ctx->size)
-                        return 6;
-                    if (ISBLANK(tmp) || ISNEWLINE(tmp) || CH(tmp) == _T('>'))
-                        return 6;
-                    if (tmp + 1 < ctx->size && CH(tmp) == _T('/') && CH(tmp + 1) == _T('>'))
-                        return 6;
-                    break;
-                }
+        /* Fold the tag name to lower case for hashing. */
+        while (len < TAG6_NAME_MAXLEN && off + len < ctx->size && ISALNUM(off + len)) {
+            name[len] = (char)(ISUPPER(off + len) ? CH(off + len) - 'A' + 'a' : CH(off + len));
+            len++;
+        }
+
+        /* (Anything longer than the longest known tag cannot match.) */
+        if (off + len >= ctx->size || !ISALNUM(off + len)) {
+            unsigned hash = md_fnv1a(MD_FNV1A_BASE, name, len);
+            const TAG* tag = &TAG6_HASH_MAP[md_hash_slot(hash,
+                TAG6_HASH_DISP[hash & (TAG6_HASH_BUCKETS - 1)], TAG6_HASH_SLOTS)];
+
+            if (len > 0 && tag->len == len && md_ascii_case_eq(STR(off), tag->name, len)) {
+                OFF tmp = off + len;
+                if (tmp >= ctx->size)
+                    return 6;
+                if (ISBLANK(tmp) || ISNEWLINE(tmp) || CH(tmp) == _T('>'))
+                    return 6;
+                if (tmp + 1 < ctx->size && CH(tmp) == _T('/') && CH(tmp + 1) == _T('>'))
+                    return 6;
             }
         }
     }
@@ -5865,6 +7452,15 @@ md_line_indentation(MD_CTX* ctx, unsigned total_indent, OFF beg, OFF* p_end)
     OFF off = beg;
     unsigned indent = total_indent;
 
+#ifdef MD_USE_SSE2
+    /* Fast forward over a long run of leading spaces (e.g. deeply indented
+     * code). Tabs (and the short tail) are handled below. */
+    if (off + 16 <= ctx->size && CH(off) == _T(' ')) {
+        off = md_skip_spaces_sse2(ctx, off, ctx->size);
+        indent += off - beg;
+    }
+#endif
+
     while (off < ctx->size && ISBLANK(off)) {
         if (CH(off) == _T('\t'))
             indent = (indent + 4) & ~3;
@@ -6139,8 +7735,11 @@ md_analyze_line(MD_CTX* ctx, OFF beg, OFF* p_end,
             break;
         }
 
-        /* Check for start of a new container block. */
+        /* Check for start of a new container block (unless it would nest
+         * too deep). */
         if (line->indent < ctx->code_indent_offset &&
+            (ctx->limits.max_nesting == 0  ||
+             n_parents + n_brothers + n_children < (int) ctx->limits.max_nesting) &&
             md_is_container_mark(ctx, line->indent, off, &off, &container))
         {
             if (pivot_line->type == MD_LINE_TEXT && n_parents == ctx->n_containers &&
@@ -6293,7 +7892,9 @@ md_analyze_line(MD_CTX* ctx, OFF beg, OFF* p_end,
      * Note this is quite a bottleneck of the parsing as we here iterate almost
      * over compete document.
      */
-#if defined __linux__ && !defined MD4C_USE_UTF16
+#if defined MD_USE_SSE2
+    off = md_skip_non_newline_chars(ctx, off, ctx->size);
+#elif defined __linux__ && !defined MD4C_USE_UTF16
      /* Recent glibc versions have superbly optimized strcspn(), even using
       * vectorization if available. */
     if (ctx->doc_ends_with_newline && off < ctx->size) {
@@ -6476,6 +8077,12 @@ md_process_doc(MD_CTX* ctx)
 
         MD_CHECK(md_analyze_line(ctx, off, &off, pivot_line, line));
         MD_CHECK(md_process_line(ctx, &pivot_line, line));
+
+        if (ctx->limits.max_block_bytes != 0  &&
+            (unsigned) ctx->n_block_bytes > ctx->limits.max_block_bytes)
+            ctx->limit_exceeded = TRUE;
+        if (ctx->limit_exceeded)
+            break;
     }
 
     md_end_current_block(ctx);
@@ -6488,6 +8095,9 @@ md_process_doc(MD_CTX* ctx)
 
     MD_LEAVE_BLOCK(MD_BLOCK_DOC, NULL);
 
+    if (ctx->limit_exceeded)
+        ret = MD_PARSE_LIMIT_EXCEEDED;
+
 abort:
 
 #if 0
@@ -6520,14 +8130,56 @@ abort:
  ***  Public API  ***
  ********************/
 
-int
-md_parse(const MD_CHAR* text, MD_SIZE size, const MD_PARSER* parser, void* userdata)
+/* Buffers kept between md_parse_with_context() calls. */
+struct MD_PARSE_CONTEXT_tag {
+    CHAR* buffer;
+    unsigned alloc_buffer;
+    MD_ARENA arena;
+    MD_REF_DEF* ref_defs;
+    int alloc_ref_defs;
+    MD_REF_DEF_INDEX ref_def_index;
+    MD_MARK* marks;
+    int alloc_marks;
+    void* block_bytes;
+    int alloc_block_bytes;
+    MD_CONTAINER* containers;
+    int alloc_containers;
+    CHAR* input;            /* Gathered pieces for md_parse_chunks(). */
+    SZ alloc_input;
+    int n_threads;
+
+    /* MD_CTX::mark_char_map[] (and its nibble tables) of the previous parse.
+     * Valid if has_mark_char_map and the parser flags are the same. */
+    int has_mark_char_map;
+    unsigned mark_char_map_flags;
+#if defined MD4C_USE_UTF16
+    char mark_char_map[128];
+#else
+    char mark_char_map[256];
+#endif
+#ifdef MD_USE_AVX2
+    unsigned char mark_nibble_lo[16];
+    unsigned char mark_nibble_hi[16];
+    int mark_simd_level;
+#endif
+#ifdef MD_USE_THREADS
+    MD_WORKER_POOL* pool;   /* Created lazily. */
+#endif
+};
+
+/* Documents smaller than this are not worth waking up the workers. */
+#define MD_PARALLEL_MIN_SIZE    (256 * 1024)
+
+static int
+md_parse_impl(MD_PARSE_CONTEXT* context, const MD_CHAR* text, MD_SIZE size,
+    const MD_PARSER* parser, void* userdata)
 {
     MD_CTX ctx;
+    MD_REF_DEF_INDEX ref_def_index;
     int i;
     int ret;
 
-    if (parser->abi_version != 0) {
+    if (parser->abi_version > MD_PARSER_ABI_VERSION) {
         if (parser->debug_log != NULL)
             parser->debug_log("Unsupported abi_version.", userdata);
         return -1;
@@ -6537,12 +8189,70 @@ md_parse(const MD_CHAR* text, MD_SIZE size, const MD_PARSER* parser, void* userd
     memset(&ctx, 0, sizeof(MD_CTX));
     ctx.text = text;
     ctx.size = size;
-    memcpy(&ctx.parser, parser, sizeof(MD_PARSER));
+    /* Callers with abi_version 0 may pass a shorter MD_PARSER without the
+     * member 'limits', so do not touch it at all for them. */
+    memcpy(&ctx.parser, parser, (parser->abi_version >= 1)
+            ? sizeof(MD_PARSER) : offsetof(MD_PARSER, limits));
     ctx.userdata = userdata;
     ctx.code_indent_offset = (ctx.parser.flags & MD_FLAG_NOINDENTEDCODEBLOCKS) ? (OFF)(-1) : 4;
-    md_build_mark_char_map(&ctx);
+#ifdef MD_USE_AVX2
+    ctx.simd_level = md_cpu_simd_level();
+#endif
     ctx.doc_ends_with_newline = (size > 0 && ISNEWLINE_(text[size - 1]));
     ctx.max_ref_def_output = MIN(MIN(16 * (uint64_t)size, (uint64_t)(1024 * 1024)), (uint64_t)SZ_MAX);
+    if (ctx.parser.limits != NULL)
+        memcpy(&ctx.limits, ctx.parser.limits, sizeof(MD_PARSE_LIMITS));
+    if (ctx.limits.max_time_ms != 0)
+        ctx.start_time = md_clock_ms();
+
+    /* Reuse buffers from the previous parse, if any. */
+    if (context != NULL) {
+        ctx.buffer = context->buffer;
+        ctx.alloc_buffer = context->alloc_buffer;
+        ctx.arena = context->arena;
+        ctx.ref_defs = context->ref_defs;
+        ctx.alloc_ref_defs = context->alloc_ref_defs;
+        ctx.ref_def_index = &context->ref_def_index;
+        ctx.marks = context->marks;
+        ctx.alloc_marks = context->alloc_marks;
+        ctx.block_bytes = context->block_bytes;
+        ctx.alloc_block_bytes = context->alloc_block_bytes;
+        ctx.containers = context->containers;
+        ctx.alloc_containers = context->alloc_containers;
+
+        /* Callers converting many small documents pay for building the map
+         * on every call otherwise. */
+        if (context->has_mark_char_map  &&  context->mark_char_map_flags == ctx.parser.flags) {
+            memcpy(ctx.mark_char_map, context->mark_char_map, sizeof(ctx.mark_char_map));
+#ifdef MD_USE_AVX2
+            memcpy(ctx.mark_nibble_lo, context->mark_nibble_lo, sizeof(ctx.mark_nibble_lo));
+            memcpy(ctx.mark_nibble_hi, context->mark_nibble_hi, sizeof(ctx.mark_nibble_hi));
+            ctx.mark_simd_level = context->mark_simd_level;
+#endif
+        } else {
+            md_build_mark_char_map(&ctx);
+            memcpy(context->mark_char_map, ctx.mark_char_map, sizeof(ctx.mark_char_map));
+#ifdef MD_USE_AVX2
+            memcpy(context->mark_nibble_lo, ctx.mark_nibble_lo, sizeof(ctx.mark_nibble_lo));
+            memcpy(context->mark_nibble_hi, ctx.mark_nibble_hi, sizeof(ctx.mark_nibble_hi));
+            context->mark_simd_level = ctx.mark_simd_level;
+#endif
+            context->mark_char_map_flags = ctx.parser.flags;
+            context->has_mark_char_map = TRUE;
+        }
+
+#ifdef MD_USE_THREADS
+        if (context->n_threads > 1  &&  size >= MD_PARALLEL_MIN_SIZE) {
+            if (context->pool == NULL)
+                context->pool = md_worker_pool_create(context->n_threads);
+            ctx.pool = context->pool;
+        }
+#endif
+    } else {
+        md_build_mark_char_map(&ctx);
+        memset(&ref_def_index, 0, sizeof(MD_REF_DEF_INDEX));
+        ctx.ref_def_index = &ref_def_index;
+    }
 
     /* Reset all mark stacks and lists. */
     for (i = 0; i < (int)SIZEOF_ARRAY(ctx.opener_stacks); i++)
@@ -6557,12 +8267,182 @@ md_parse(const MD_CHAR* text, MD_SIZE size, const MD_PARSER* parser, void* userd
     ret = md_process_doc(&ctx);
 
     /* Clean-up. */
-    md_free_ref_defs(&ctx);
-    md_free_ref_def_hashtable(&ctx);
-    free(ctx.buffer);
-    free(ctx.marks);
-    free(ctx.block_bytes);
-    free(ctx.containers);
+    if (context != NULL) {
+        md_arena_compact(&ctx.arena);
+        context->buffer = ctx.buffer;
+        context->alloc_buffer = ctx.alloc_buffer;
+        context->arena = ctx.arena;
+        context->ref_defs = ctx.ref_defs;
+        context->alloc_ref_defs = ctx.alloc_ref_defs;
+        context->marks = ctx.marks;
+        context->alloc_marks = ctx.alloc_marks;
+        context->block_bytes = ctx.block_bytes;
+        context->alloc_block_bytes = ctx.alloc_block_bytes;
+        context->containers = ctx.containers;
+        context->alloc_containers = ctx.alloc_containers;
+    } else {
+        free(ctx.buffer);
+        md_arena_free(&ctx.arena);
+        free(ctx.ref_defs);
+        md_ref_def_index_free(&ref_def_index);
+        free(ctx.marks);
+        free(ctx.block_bytes);
+        free(ctx.containers);
+    }
+
+    return ret;
+}
+
+int
+md_parse(const MD_CHAR* text, MD_SIZE size, const MD_PARSER* parser, void* userdata)
+{
+    return md_parse_impl(NULL, text, size, parser, userdata);
+}
+
+MD_PARSE_CONTEXT*
+md_parse_context_create(void)
+{
+    MD_PARSE_CONTEXT* context;
+
+    context = (MD_PARSE_CONTEXT*)malloc(sizeof(MD_PARSE_CONTEXT));
+    if (context != NULL)
+        memset(context, 0, sizeof(MD_PARSE_CONTEXT));
+    return context;
+}
+
+int
+md_parse_with_context(MD_PARSE_CONTEXT* context, const MD_CHAR* text, MD_SIZE size,
+    const MD_PARSER* parser, void* userdata)
+{
+    return md_parse_impl(context, text, size, parser, userdata);
+}
+
+static int
+md_append_input(MD_PARSE_CONTEXT* context, SZ* p_size, const CHAR* text, SZ size)
+{
+    if (size > SZ_MAX / sizeof(CHAR) - *p_size)
+        return -1;
+
+    if (*p_size + size > context->alloc_input) {
+        SZ alloc_input;
+        CHAR* new_input;
+
+        alloc_input = (context->alloc_input < (SZ_MAX / sizeof(CHAR)) / 2
+            ? context->alloc_input + context->alloc_input / 2 : SZ_MAX / sizeof(CHAR));
+        if (alloc_input < *p_size + size)
+            alloc_input = *p_size + size;
+        new_input = (CHAR*) realloc(context->input, alloc_input * sizeof(CHAR));
+        if (new_input == NULL)
+            return -1;
+
+        context->input = new_input;
+        context->alloc_input = alloc_input;
+    }
+
+    memcpy(context->input + *p_size, text, size * sizeof(CHAR));
+    *p_size += size;
+    return 0;
+}
+
+int
+md_parse_chunks(MD_PARSE_CONTEXT* context, const MD_CHUNK_ITERATOR* iter,
+    const MD_PARSER* parser, void* userdata)
+{
+    MD_PARSE_CONTEXT tmp_context;
+    const CHAR* piece = _T("");     /* Adjacent pieces not gathered (yet). */
+    SZ piece_size = 0;
+    SZ size = 0;                    /* Gathered into context->input. */
+    int is_gathering = FALSE;
+    const CHAR* text;
+    SZ text_size;
+    int ret;
 
+    if (context == NULL) {
+        memset(&tmp_context, 0, sizeof(MD_PARSE_CONTEXT));
+        context = &tmp_context;
+    }
+
+    while (iter->next_chunk(&text, &text_size, iter->iter_data)) {
+        if (text_size == 0)
+            continue;
+
+        if (text == piece + piece_size  &&  text_size <= SZ_MAX - piece_size) {
+            piece_size += text_size;
+            continue;
+        }
+
+        if (piece_size > 0) {
+            if (md_append_input(context, &size, piece, piece_size) != 0)
+                goto out_of_memory;
+            is_gathering = TRUE;
+        }
+        piece = text;
+        piece_size = text_size;
+    }
+
+    if (is_gathering) {
+        if (md_append_input(context, &size, piece, piece_size) != 0)
+            goto out_of_memory;
+        ret = md_parse_impl(context, context->input, size, parser, userdata);
+    } else {
+        ret = md_parse_impl(context, piece, piece_size, parser, userdata);
+    }
+
+    if (context == &tmp_context)
+        md_parse_context_reset(context);
     return ret;
+
+out_of_memory:
+    if (parser->debug_log != NULL)
+        parser->debug_log("realloc() failed.", userdata);
+    if (context == &tmp_context)
+        md_parse_context_reset(context);
+    return -1;
+}
+
+int
+md_parse_context_set_threads(MD_PARSE_CONTEXT* context, int n_threads)
+{
+#ifdef MD_USE_THREADS
+    if (n_threads != context->n_threads  &&  context->pool != NULL) {
+        md_worker_pool_destroy(context->pool);
+        context->pool = NULL;
+    }
+    context->n_threads = n_threads;
+    return 0;
+#else
+    MD_UNUSED(context);
+    return (n_threads > 1 ? -1 : 0);
+#endif
+}
+
+void
+md_parse_context_reset(MD_PARSE_CONTEXT* context)
+{
+    int n_threads = context->n_threads;
+
+#ifdef MD_USE_THREADS
+    if (context->pool != NULL)
+        md_worker_pool_destroy(context->pool);
+#endif
+    free(context->buffer);
+    md_arena_free(&context->arena);
+    free(context->ref_defs);
+    md_ref_def_index_free(&context->ref_def_index);
+    free(context->marks);
+    free(context->block_bytes);
+    free(context->containers);
+    free(context->input);
+    memset(context, 0, sizeof(MD_PARSE_CONTEXT));
+    context->n_threads = n_threads;
+}
+
+void
+md_parse_context_destroy(MD_PARSE_CONTEXT* context)
+{
+    if (context == NULL)
+        return;
+
+    md_parse_context_reset(context);
+    free(context);
 }
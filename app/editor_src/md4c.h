@@ -334,10 +334,50 @@ extern "C" {
 #define MD_DIALECT_COMMONMARK               0
 #define MD_DIALECT_GITHUB                   (MD_FLAG_PERMISSIVEAUTOLINKS | MD_FLAG_TABLES | MD_FLAG_STRIKETHROUGH | MD_FLAG_TASKLISTS)
 
+      /* Optional resource limits of md_parse(), so that a huge or malicious
+       * input cannot stall the application. Zero means no limit.
+       */
+    typedef struct MD_PARSE_LIMITS {
+        /* Max. count of inline marks (potential emphasis delimiters, brackets,
+         * backticks, ...) in a single leaf block or table row. Blocks needing
+         * more are rendered as plain text (no emphasis, links, etc.).
+         */
+        unsigned max_marks;
+
+        /* Max. size (in bytes) of the internal buffer which holds a small
+         * record for every block and every line of the document. If the
+         * document needs more, the rest of it is ignored and md_parse() returns
+         * MD_PARSE_LIMIT_EXCEEDED after rendering what it has seen. (The
+         * limit is checked after every line, so it may be exceeded by the
+         * records of a single line.)
+         */
+        unsigned max_block_bytes;
+
+        /* Max. nesting depth of container blocks (block quotes and lists).
+         * This also bounds the internal stack of the containers. Any deeper
+         * block quote or list item mark is treated as an ordinary text.
+         */
+        unsigned max_nesting;
+
+        /* Max. time of the parsing, in milliseconds. It is checked at block
+         * boundaries: When it is over, no more blocks are rendered (the open
+         * container blocks are still closed) and md_parse() returns
+         * MD_PARSE_LIMIT_EXCEEDED.
+         */
+        unsigned max_time_ms;
+    } MD_PARSE_LIMITS;
+
+      /* Current version of the MD_PARSER layout. Version 1 has added the
+       * member 'limits'.
+       */
+#define MD_PARSER_ABI_VERSION               1
+
       /* Parser structure.
        */
     typedef struct MD_PARSER {
-        /* Reserved. Set to zero.
+        /* Set to MD_PARSER_ABI_VERSION. Zero is also accepted for callers
+         * built against the original layout, which ends with the member
+         * 'syntax': The later members are then neither read nor used.
          */
         unsigned abi_version;
 
@@ -380,6 +420,11 @@ extern "C" {
         /* Reserved. Set to NULL.
          */
         void (*syntax)(void);
+
+        /* Resource limits. Optional (may be NULL). Only used if abi_version
+         * is at least 1.
+         */
+        const MD_PARSE_LIMITS* limits;
     } MD_PARSER;
 
 
@@ -396,10 +441,90 @@ extern "C" {
      * Zero is returned on success. If a runtime error occurs (e.g. a memory
      * fails), -1 is returned. If the processing is aborted due any callback
      * returning non-zero, the return value of the callback is returned.
+     * If the parsing is cut short by MD_PARSER::limits, MD_PARSE_LIMIT_EXCEEDED
+     * is returned (the callbacks should not use this value).
      */
+#define MD_PARSE_LIMIT_EXCEEDED             (-2)
+
     int md_parse(const MD_CHAR* text, MD_SIZE size, const MD_PARSER* parser, void* userdata);
 
 
+    /* Opaque parser context for applications which parse repeatedly (e.g. an
+     * editor re-parsing the document on every change).
+     *
+     * md_parse() allocates all its internal buffers from scratch and frees
+     * them when it returns. md_parse_with_context() instead keeps them in the
+     * context, so subsequent parses of documents of similar size need (almost)
+     * no memory allocation at all.
+     *
+     * A context may be used only by one md_parse_with_context() call at a
+     * time (and so also not from within its callbacks).
+     */
+    typedef struct MD_PARSE_CONTEXT_tag MD_PARSE_CONTEXT;
+
+    /* Create a new parser context. Returns NULL on memory allocation failure.
+     */
+    MD_PARSE_CONTEXT* md_parse_context_create(void);
+
+    /* Same as md_parse() but reuses the buffers kept in the 'context'.
+     */
+    int md_parse_with_context(MD_PARSE_CONTEXT* context, const MD_CHAR* text, MD_SIZE size,
+                              const MD_PARSER* parser, void* userdata);
+
+    /* Iterator over the pieces of a document which is not stored in one
+     * contiguous buffer (e.g. the pieces of a piece table or the leaves of
+     * a rope).
+     *
+     * Callback next_chunk() shall set *p_text and *p_size to the next piece
+     * and return non-zero, or return zero when there are no more pieces.
+     * Empty pieces are allowed. The pieces have to remain valid (and
+     * unchanged) until md_parse_chunks() returns.
+     */
+    typedef struct MD_CHUNK_ITERATOR {
+        int (*next_chunk)(const MD_CHAR** /*p_text*/, MD_SIZE* /*p_size*/, void* /*iter_data*/);
+        void* iter_data;
+    } MD_CHUNK_ITERATOR;
+
+    /* Same as md_parse_with_context() but the document is read through the
+     * 'iter'. Pieces adjacent in memory are joined; if that leaves a single
+     * piece, it is parsed in place. Otherwise the document is still
+     * flattened on each call: the pieces are copied into a buffer kept in
+     * the 'context', which is reused by the next calls (so it is allocated
+     * only once for documents of similar size). The parser itself always
+     * works on contiguous text. The strings passed to the callbacks then
+     * point into that buffer, so they are contiguous even where they span
+     * more pieces.
+     *
+     * The 'context' may be NULL; then all the memory is released before the
+     * function returns.
+     */
+    int md_parse_chunks(MD_PARSE_CONTEXT* context, const MD_CHUNK_ITERATOR* iter,
+                        const MD_PARSER* parser, void* userdata);
+
+    /* Analyze inline contents of large documents on 'n_threads' worker
+     * threads. The calling thread meanwhile processes the blocks in the
+     * document order so all the callbacks are still called from it, in the
+     * same order and with the same arguments as without the workers. Zero
+     * or one (the default) means no workers.
+     *
+     * The threads are started on the first md_parse_with_context() call which
+     * needs them, and they are kept until the context is reset or destroyed.
+     *
+     * Returns -1 if md4c has been built without support for threads.
+     */
+    int md_parse_context_set_threads(MD_PARSE_CONTEXT* context, int n_threads);
+
+    /* Release all the memory kept by the 'context', e.g. after parsing an
+     * unusually large document, and stop its worker threads. The context
+     * remains usable (with the same count of threads).
+     */
+    void md_parse_context_reset(MD_PARSE_CONTEXT* context);
+
+    /* Destroy the 'context'. NULL is allowed.
+     */
+    void md_parse_context_destroy(MD_PARSE_CONTEXT* context);
+
+
 #ifdef __cplusplus
 }  /* extern "C" { */
 #endif
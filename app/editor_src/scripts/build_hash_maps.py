@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# Generates the perfect hash tables used by entity_lookup() in entity.c and by
+# md_is_html_block_start_condition() in md4c.c.
+#
+# Usage: python3 scripts/build_hash_maps.py entity.c
+#
+# The tables use the "hash and displace" scheme: A FNV-1a hash of the key
+# selects a bucket, the bucket's displacement is mixed into the hash and the
+# result is scaled into the slot range. Displacements are chosen so that no two
+# keys share a slot. The lookup functions in C must compute exactly the same
+# slot as slot_of() below.
+
+import re
+import sys
+
+FNV1A_BASE = 2166136261
+FNV1A_PRIME = 16777619
+MASK32 = 0xffffffff
+
+
+def fnv1a(data):
+    h = FNV1A_BASE
+    for b in data:
+        h ^= b
+        h = (h * FNV1A_PRIME) & MASK32
+    return h
+
+
+def mix32(x):
+    x ^= x >> 16
+    x = (x * 0x85ebca6b) & MASK32
+    x ^= x >> 13
+    x = (x * 0xc2b2ae35) & MASK32
+    x ^= x >> 16
+    return x
+
+
+def slot_of(h, disp, n_slots):
+    return (mix32(h ^ disp) * n_slots) >> 32
+
+
+def build(keys, n_buckets, n_slots):
+    hashes = [fnv1a(k) for k in keys]
+    buckets = [[] for _ in range(n_buckets)]
+    for i, h in enumerate(hashes):
+        buckets[h & (n_buckets - 1)].append(i)
+
+    disp = [0] * n_buckets
+    slots = [None] * n_slots
+    for b in sorted(range(n_buckets), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for d in range(65536):
+            taken = [slot_of(hashes[i], d, n_slots) for i in buckets[b]]
+            if len(set(taken)) == len(taken) and all(slots[s] is None for s in taken):
+                break
+        else:
+            sys.exit("No displacement found for bucket %d." % b)
+        disp[b] = d
+        for i, s in zip(buckets[b], taken):
+            slots[s] = i
+    return disp, slots
+
+
+def emit(name, ctype, values, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    lines[-1] = lines[-1][:-1]
+    print("static const %s %s[%d] = {" % (ctype, name, len(values)))
+    print("\n".join(lines))
+    print("};")
+    print("")
+
+
+def main():
+    # Entities: keys are the names in ENTITY_MAP[], including '&' and ';'.
+    src = open(sys.argv[1], encoding="latin-1").read()
+    names = re.findall(r'\{ "(&[A-Za-z0-9]+;)", \{', src)
+    disp, slots = build([n.encode() for n in names], 512, 2560)
+    print("/* Generated by scripts/build_hash_maps.py. */")
+    print("#define ENTITY_HASH_BUCKETS     %d" % len(disp))
+    print("#define ENTITY_HASH_SLOTS       %d" % len(slots))
+    print("")
+    emit("ENTITY_HASH_DISP", "unsigned short", disp, 16)
+    # Slot value is (index into ENTITY_MAP[] + 1); zero marks an empty slot.
+    emit("ENTITY_HASH_INDEX", "unsigned short", [0 if s is None else s + 1 for s in slots], 16)
+    emit("ENTITY_HASH_NAME_SIZE", "unsigned char", [0 if s is None else len(names[s]) for s in slots], 24)
+
+    # HTML block (type 6) tag names, lowercase.
+    tags = ("address article aside base basefont blockquote body caption center "
+            "col colgroup dd details dialog dir div dl dt fieldset figcaption "
+            "figure footer form frame frameset h1 h2 h3 h4 h5 h6 head header hr "
+            "html iframe legend li link main menu menuitem nav noframes ol "
+            "optgroup option p param search section summary table tbody td "
+            "tfoot th thead title tr track ul").split()
+    disp, slots = build([t.encode() for t in tags], 16, 96)
+    print("/* Generated by scripts/build_hash_maps.py. */")
+    print("#define TAG6_HASH_BUCKETS       %d" % len(disp))
+    print("#define TAG6_HASH_SLOTS         %d" % len(slots))
+    print("")
+    emit("TAG6_HASH_DISP", "unsigned short", disp, 16)
+    print("static const TAG TAG6_HASH_MAP[%d] = {" % len(slots))
+    row = []
+    for s in slots:
+        row.append("Xend" if s is None else 'X("%s")' % tags[s])
+    for i in range(0, len(row), 6):
+        print("    " + ", ".join(row[i:i + 6]) + ("," if i + 6 < len(row) else ""))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+#
+# Generates the two-stage Unicode property tables used by
+# md_is_unicode_whitespace__(), md_is_unicode_punct__() and
+# md_get_unicode_fold_info() in md4c.c.
+#
+# Usage: python3 scripts/build_unicode_tables.py UnicodeData.txt CaseFolding.txt
+#
+# Both input files come from the Unicode Character Database
+# (https://www.unicode.org/Public/UCD/latest/ucd/).
+#
+# Every table is split into pages of (1 << shift) codepoints. Identical pages
+# are stored only once and a page index maps (codepoint >> shift) to the page.
+# Whitespace and punctuation pages are bitmaps; folding pages hold an index
+# into FOLD_RECORDS[], where record 0 maps a codepoint to itself.
+
+import sys
+
+
+def parse_unicode_data(path):
+    whitespace = set()
+    punct = set()
+    range_first = None
+    for line in open(path, encoding="utf-8"):
+        fields = line.split(";")
+        if len(fields) < 3:
+            continue
+        cp = int(fields[0], 16)
+        name = fields[1]
+        category = fields[2]
+        if name.endswith(", First>"):
+            range_first = cp
+            continue
+        if name.endswith(", Last>"):
+            cps = range(range_first, cp + 1)
+        else:
+            cps = (cp,)
+        if category == "Zs":
+            whitespace.update(cps)
+        # CommonMark treats all "P*" and "S*" characters as punctuation.
+        if category[0] in "PS":
+            punct.update(cps)
+    return whitespace, punct
+
+
+def parse_case_folding(path):
+    folds = {}
+    for line in open(path, encoding="utf-8"):
+        line = line.split("#")[0].strip()
+        if not line:
+            continue
+        fields = [f.strip() for f in line.split(";")]
+        # Full case folding: statuses "C" (common) and "F" (full).
+        if fields[1] not in ("C", "F"):
+            continue
+        folds[int(fields[0], 16)] = [int(x, 16) for x in fields[2].split()]
+    return folds
+
+
+def paginate(values, shift):
+    page_size = 1 << shift
+    pages = []
+    page_map = {}
+    index = []
+    for i in range(0, len(values), page_size):
+        page = tuple(values[i:i + page_size])
+        if page not in page_map:
+            page_map[page] = len(pages)
+            pages.append(page)
+        index.append(page_map[page])
+    return index, pages
+
+
+def ctype_for(max_value):
+    return "unsigned char" if max_value < 256 else "unsigned short"
+
+
+def emit(name, ctype, values, per_line, width):
+    print("static const %s %s[%d] = {" % (ctype, name, len(values)))
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ",".join(("%" + str(width) + "s") % v for v in values[i:i + per_line]) + ",")
+    lines[-1] = lines[-1][:-1]
+    print("\n".join(lines))
+    print("};")
+
+
+def emit_bitmap(prefix, cps, limit):
+    # Pick the page size giving the smallest tables.
+    best = None
+    for shift in range(5, 10):
+        bits = [1 if cp in cps else 0 for cp in range(limit)]
+        index, pages = paginate(bits, shift)
+        size = len(index) * (1 if len(pages) < 256 else 2) + len(pages) * (1 << shift) // 8
+        if best is None or size < best[0]:
+            best = (size, shift, index, pages)
+    size, shift, index, pages = best
+
+    page_bytes = []
+    for page in pages:
+        for i in range(0, len(page), 8):
+            page_bytes.append("0x%02x" % sum(b << j for j, b in enumerate(page[i:i + 8])))
+
+    print("#define %-24s%d" % (prefix + "_PAGE_SHIFT", shift))
+    print("#define %-24s%d" % (prefix + "_PAGE_BYTES", (1 << shift) // 8))
+    emit(prefix + "_PAGE_INDEX", ctype_for(len(pages) - 1), index, 32, 3)
+    emit(prefix + "_PAGES", "unsigned char", page_bytes, 16, 5)
+
+
+def emit_folding(folds, limit):
+    # Record: number of codepoints, first codepoint relative to the folded one,
+    # then the remaining codepoints. Storing the first codepoint as a delta lets
+    # runs like 'A' -> 'a' share one record and whole pages deduplicate.
+    records = [(1, 0, 0, 0)]
+    record_map = {records[0]: 0}
+    values = []
+    for cp in range(limit):
+        fold = folds.get(cp, [cp])
+        rec = (len(fold), fold[0] - cp, fold[1] if len(fold) > 1 else 0, fold[2] if len(fold) > 2 else 0)
+        if rec not in record_map:
+            record_map[rec] = len(records)
+            records.append(rec)
+        values.append(record_map[rec])
+
+    best = None
+    for shift in range(4, 10):
+        index, pages = paginate(values, shift)
+        size = len(index) * (1 if len(pages) < 256 else 2) + len(pages) * (1 << shift) * (1 if len(records) < 256 else 2)
+        if best is None or size < best[0]:
+            best = (size, shift, index, pages)
+    size, shift, index, pages = best
+
+    print("#define %-24s%d" % ("FOLD_PAGE_SHIFT", shift))
+    emit("FOLD_PAGE_INDEX", ctype_for(len(pages) - 1), index, 32, 3)
+    emit("FOLD_PAGES", ctype_for(len(records) - 1), [v for page in pages for v in page], 32, 3)
+    print("static const int FOLD_RECORDS[%d][4] = {" % len(records))
+    lines = ["    { %d, %d, 0x%04x, 0x%04x }," % r for r in records]
+    lines[-1] = lines[-1][:-1]
+    print("\n".join(lines))
+    print("};")
+
+
+def main():
+    whitespace, punct = parse_unicode_data(sys.argv[1])
+    folds = parse_case_folding(sys.argv[2])
+
+    # The ASCII range is handled by the callers; the tables only cover the
+    # codepoints up to the last one with any property, rounded up to a page.
+    top = max(max(whitespace), max(punct), max(folds)) + 1
+    limit = (top + 1023) & ~1023
+
+    print("/* Generated by scripts/build_unicode_tables.py. */")
+    print("#define %-24s0x%x" % ("UNICODE_TABLE_LIMIT", limit))
+    print("")
+    emit_bitmap("WHITESPACE", whitespace, limit)
+    print("")
+    emit_bitmap("PUNCT", punct, limit)
+    print("")
+    emit_folding(folds, limit)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,849 @@
+// Headless benchmark of the Dear ImGui text editing widgets on large documents.
+//
+// Build (from app/editor_src):
+//   c++ -O2 -I../.. -o inputtext_bench scripts/inputtext_bench.cpp ../../imgui.cpp ../../imgui_draw.cpp ../../imgui_widgets.cpp ../../imgui_tables.cpp
+//   cl /O2 /EHsc /I..\.. scripts\inputtext_bench.cpp ..\..\imgui.cpp ..\..\imgui_draw.cpp ..\..\imgui_widgets.cpp ..\..\imgui_tables.cpp
+//
+// Usage:
+//   inputtext_bench [OPTION]...
+//
+// Options:
+//   --case NAME        Run only the given case.
+//   --list             List the cases.
+//   --frames N         Number of timed frames per measurement. (Default 200.)
+//
+// No window or renderer is created: every frame runs NewFrame(), the widget
+// and Render() on a context with a built font atlas, and the draw data is
+// simply dropped. Documents are made of lines of 20 to 100 characters,
+// or of paragraphs of 200 to 4000 characters for the word-wrapping cases.
+// The "focus" case also edits a gap buffer in place through ImGuiInputTextStorage.
+// The "replace" case searches for a 57 characters string, found on about two lines out of five.
+// The "textwrapped" case shows a static text with TextWrapped() and TextWrappedIndexed() instead of an editor.
+// Times are averages over the timed frames, in microseconds per frame.
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static double Now()
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, t;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Documents
+//-----------------------------------------------------------------------------
+
+// Resizable zero-terminated buffer passed to InputTextMultiline() with ImGuiInputTextFlags_CallbackResize.
+struct Doc
+{
+    ImVector<char>  Buf;
+    int             MoveCursorTo = -1;     // When >= 0, the next frame of an active editor moves the cursor there.
+    ImGuiInputTextStorage* Storage = NULL; // When set, the editor edits this storage in place instead of Buf.
+    const char*     Find = NULL;           // When set, matches of this text are highlighted.
+    const char*     ReplaceAll = NULL;     // When set, the next frame replaces all matches of Find with this text.
+
+    int     Len() const                 { return Buf.Size > 0 ? (int)strlen(Buf.Data) : 0; }
+    void    Clear()                     { Buf.resize(1); Buf[0] = 0; }
+};
+
+static int DocResizeCallback(ImGuiInputTextCallbackData* data)
+{
+    if (data->EventFlag == ImGuiInputTextFlags_CallbackResize)
+    {
+        Doc* doc = (Doc*)data->UserData;
+        doc->Buf.resize(data->BufSize);
+        data->Buf = doc->Buf.Data;
+    }
+    else if (data->EventFlag == ImGuiInputTextFlags_CallbackAlways)
+    {
+        Doc* doc = (Doc*)data->UserData;
+        data->CursorPos = data->SelectionStart = data->SelectionEnd = doc->MoveCursorTo;
+        doc->MoveCursorTo = -1;
+    }
+    return 0;
+}
+
+static unsigned int g_Rand = 1;
+static unsigned int Rand() { g_Rand = g_Rand * 1103515245 + 12345; return g_Rand >> 16; }
+
+// Fill doc with about 'size' bytes of text, or with 'line_count' lines if not 0.
+static void GenLines(Doc* doc, size_t size, int line_count = 0)
+{
+    static const char words[] = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor ";
+    g_Rand = 1;
+    if (line_count > 0)
+        size = (size_t)line_count * 100;
+    doc->Buf.resize((int)size + 128);
+    char* p = doc->Buf.Data;
+    char* p_end = p + size;
+    for (int n = 0; line_count > 0 ? n < line_count : p < p_end; n++)
+    {
+        int len = 20 + (int)(Rand() % 81);
+        int start = (int)(Rand() % 16);
+        for (int i = 0; i < len; i++)
+            *p++ = words[(start + i) % (sizeof(words) - 1)];
+        *p++ = '\n';
+    }
+    *p = 0;
+    doc->Buf.resize((int)(p - doc->Buf.Data) + 1);
+}
+
+// Fill doc with 'line_count' lines of 'line_len' characters.
+static void GenLongLines(Doc* doc, int line_count, int line_len)
+{
+    static const char words[] = "{\"lorem\":[1,2,3],\"ipsum\":\"dolor sit amet\",\"consectetur\":{\"adipiscing\":true}},";
+    doc->Buf.resize(line_count * (line_len + 1) + 1);
+    char* p = doc->Buf.Data;
+    for (int n = 0; n < line_count; n++)
+    {
+        for (int i = 0; i < line_len; i++)
+            *p++ = words[(n + i) % (sizeof(words) - 1)];
+        *p++ = '\n';
+    }
+    *p = 0;
+}
+
+// Fill doc with 'line_count' lines of about 'line_size' bytes, made of the space separated words of 'words'.
+static void GenWords(Doc* doc, const char* const* words, int words_count, int line_count, int line_size)
+{
+    g_Rand = 1;
+    doc->Buf.resize(line_count * (line_size + 64) + 1);
+    char* p = doc->Buf.Data;
+    for (int n = 0; n < line_count; n++)
+    {
+        for (char* line_end = p + line_size; p < line_end; )
+        {
+            const char* word = words[Rand() % words_count];
+            const size_t len = strlen(word);
+            memcpy(p, word, len);
+            p += len;
+            *p++ = ' ';
+        }
+        p[-1] = '\n';
+    }
+    *p = 0;
+    doc->Buf.resize((int)(p - doc->Buf.Data) + 1);
+}
+
+// Fill doc with about 'size' bytes of paragraphs of prose, separated by empty lines.
+static void GenParagraphs(Doc* doc, size_t size)
+{
+    static const char* words[] = { "lorem", "ipsum", "dolor", "sit", "amet,", "consectetur", "adipiscing", "elit.", "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore", "et", "magna" };
+    g_Rand = 1;
+    doc->Buf.resize((int)size + 4096);
+    char* p = doc->Buf.Data;
+    char* p_end = p + size;
+    while (p < p_end)
+    {
+        char* paragraph_end = p + 200 + (int)(Rand() % 3801);
+        while (p < paragraph_end)
+        {
+            const char* word = words[Rand() % IM_ARRAYSIZE(words)];
+            size_t len = strlen(word);
+            memcpy(p, word, len);
+            p += len;
+            *p++ = ' ';
+        }
+        p[-1] = '\n';
+        *p++ = '\n';
+    }
+    *p = 0;
+    doc->Buf.resize((int)(p - doc->Buf.Data) + 1);
+}
+
+// Gap buffer edited in place through ImGuiInputTextStorage. Reading the whole text moves the gap to the end.
+struct GapBuffer
+{
+    ImVector<char>          Data;
+    int                     GapPos = 0;
+    int                     GapLen = 0;
+    ImGuiInputTextStorage   Storage;
+
+    GapBuffer()
+    {
+        Storage.UserData = this;
+        Storage.GetLengthFn = [](ImGuiInputTextStorage* st) { return ((GapBuffer*)st->UserData)->Len(); };
+        Storage.GetSpanFn = [](ImGuiInputTextStorage* st, int pos, int len) { GapBuffer* gb = (GapBuffer*)st->UserData; IM_ASSERT(pos + len <= gb->Len()); gb->MoveGap(gb->Len()); gb->Data[gb->GapPos] = 0; return (const char*)gb->Data.Data + pos; };
+        Storage.InsertCharsFn = [](ImGuiInputTextStorage* st, int pos, const char* text, int text_len) { ((GapBuffer*)st->UserData)->Insert(pos, text, text_len); };
+        Storage.DeleteCharsFn = [](ImGuiInputTextStorage* st, int pos, int len) { GapBuffer* gb = (GapBuffer*)st->UserData; gb->MoveGap(pos); gb->GapLen += len; };
+    }
+    int     Len() const     { return Data.Size - GapLen; }
+    void    Set(const char* text, int len)
+    {
+        Data.resize(len + len / 2 + 64);
+        memcpy(Data.Data, text, (size_t)len);
+        GapPos = len;
+        GapLen = Data.Size - len;
+    }
+    void    MoveGap(int pos)
+    {
+        if (pos < GapPos)
+            memmove(Data.Data + pos + GapLen, Data.Data + pos, (size_t)(GapPos - pos));
+        else if (pos > GapPos)
+            memmove(Data.Data + GapPos, Data.Data + GapPos + GapLen, (size_t)(pos - GapPos));
+        GapPos = pos;
+    }
+    void    Insert(int pos, const char* text, int text_len)
+    {
+        if (GapLen < text_len + 1) // Keep room for the zero-terminator
+        {
+            MoveGap(Len());
+            Data.resize(Data.Size + text_len + Data.Size / 2 + 64);
+            GapLen = Data.Size - GapPos;
+        }
+        MoveGap(pos);
+        memcpy(Data.Data + pos, text, (size_t)text_len);
+        GapPos += text_len;
+        GapLen -= text_len;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Frame driver
+//-----------------------------------------------------------------------------
+
+static int g_Frames = 200;
+static ImGuiID g_EditorId = 0;
+
+static void BeginContext()
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2(1280.0f, 800.0f);
+    io.DeltaTime = 1.0f / 60.0f;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+}
+
+static void EndContext()
+{
+    ImGui::DestroyContext();
+}
+
+enum EditorFlags_
+{
+    EditorFlags_None        = 0,
+    EditorFlags_Focus       = 1 << 0,   // Request keyboard focus for the editor this frame.
+    EditorFlags_Generation  = 1 << 1,   // Call SetNextItemTextGeneration() before the editor.
+    EditorFlags_Unfocus     = 1 << 2,   // Remove focus from the window (deactivating the editor) this frame.
+};
+
+// Run one frame showing a full-window multiline editor over the document.
+static void EditorFrame(Doc* doc, ImGuiInputTextFlags flags, int editor_flags)
+{
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Bench", NULL, ImGuiWindowFlags_NoDecoration);
+    if (editor_flags & EditorFlags_Unfocus)
+        ImGui::SetWindowFocus(NULL);
+    if (editor_flags & EditorFlags_Focus)
+        ImGui::SetKeyboardFocusHere();
+    if (editor_flags & EditorFlags_Generation)
+        ImGui::SetNextItemTextGeneration(1);
+    if (doc->MoveCursorTo >= 0)
+        flags |= ImGuiInputTextFlags_CallbackAlways;
+    if (doc->Find != NULL)
+        ImGui::SetNextItemTextFind(doc->Find);
+    if (doc->ReplaceAll != NULL)
+        ImGui::SetNextItemTextReplaceAll(doc->ReplaceAll);
+    doc->ReplaceAll = NULL;
+    if (doc->Storage != NULL)
+        ImGui::InputTextMultiline("##doc", doc->Storage, ImVec2(-FLT_MIN, -FLT_MIN), flags);
+    else
+        ImGui::InputTextMultiline("##doc", doc->Buf.Data, (size_t)doc->Buf.Size, ImVec2(-FLT_MIN, -FLT_MIN), flags | ImGuiInputTextFlags_CallbackResize, DocResizeCallback, doc);
+    g_EditorId = ImGui::GetItemID();
+    ImGui::End();
+    ImGui::Render();
+}
+
+static void PressKey(ImGuiKey key, ImGuiKeyChord mods)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    if (mods & ImGuiMod_Ctrl)
+        io.AddKeyEvent(ImGuiMod_Ctrl, true);
+    if (mods & ImGuiMod_Shift)
+        io.AddKeyEvent(ImGuiMod_Shift, true);
+    io.AddKeyEvent(key, true);
+}
+
+static void ReleaseKeys()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.ClearInputKeys();
+}
+
+// Focus the editor and move the cursor to the end of the document.
+static void ActivateAtEnd(Doc* doc, ImGuiInputTextFlags flags)
+{
+    EditorFrame(doc, flags, EditorFlags_Focus);
+    EditorFrame(doc, flags, EditorFlags_None);
+    PressKey(ImGuiKey_End, ImGuiMod_Ctrl);
+    EditorFrame(doc, flags, EditorFlags_None);
+    ReleaseKeys();
+    EditorFrame(doc, flags, EditorFlags_None);
+}
+
+//-----------------------------------------------------------------------------
+// Cases
+//-----------------------------------------------------------------------------
+
+static const size_t g_Sizes[] = { 1 << 20, 4 << 20, 16 << 20 };
+
+// Frame time of an active editor, idle and while typing at the end of the document.
+static void CaseActive()
+{
+    printf("%-10s %12s %12s %12s\n", "size", "lines", "idle us", "typing us");
+    for (size_t size : g_Sizes)
+    {
+        Doc doc;
+        GenLines(&doc, size);
+        int lines = 0;
+        for (const char* p = doc.Buf.Data; *p; p++)
+            lines += (*p == '\n');
+
+        BeginContext();
+        ActivateAtEnd(&doc, 0);
+
+        double t_idle = Now();
+        for (int i = 0; i < g_Frames; i++)
+            EditorFrame(&doc, 0, EditorFlags_None);
+        t_idle = Now() - t_idle;
+
+        double t_typing = Now();
+        for (int i = 0; i < g_Frames; i++)
+        {
+            ImGui::GetIO().AddInputCharacter((i % 40) == 39 ? '\n' : 'a' + (i % 26));
+            EditorFrame(&doc, 0, EditorFlags_None);
+        }
+        t_typing = Now() - t_typing;
+        EndContext();
+
+        printf("%7.1f MB %12d %12.1f %12.1f\n", size / (1024.0 * 1024.0), lines, t_idle * 1e6 / g_Frames, t_typing * 1e6 / g_Frames);
+    }
+}
+
+// Frame time of an inactive read-only field scrolled to the end, with and without a text generation.
+static void CaseLog()
+{
+    static const int line_counts[] = { 10000, 100000, 1000000 };
+    printf("%-10s %12s %12s %12s\n", "size", "lines", "plain us", "generation us");
+    for (int line_count : line_counts)
+    {
+        Doc doc;
+        GenLines(&doc, 0, line_count);
+        double t[2];
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const int editor_flags = pass ? EditorFlags_Generation : EditorFlags_None;
+            BeginContext();
+            ImGui::GetIO().AddMousePosEvent(100.0f, 100.0f);
+            for (int i = 0; i < 3; i++)
+            {
+                ImGui::GetIO().AddMouseWheelEvent(0.0f, -1e6f);
+                EditorFrame(&doc, ImGuiInputTextFlags_ReadOnly, editor_flags);
+            }
+            t[pass] = Now();
+            for (int i = 0; i < g_Frames; i++)
+                EditorFrame(&doc, ImGuiInputTextFlags_ReadOnly, editor_flags);
+            t[pass] = Now() - t[pass];
+            EndContext();
+        }
+        printf("%7.1f MB %12d %12.1f %12.1f\n", doc.Len() / (1024.0 * 1024.0), line_count, t[0] * 1e6 / g_Frames, t[1] * 1e6 / g_Frames);
+    }
+}
+
+// Run one frame with a key chord pressed, then one frame with it released. Returns the time of the first frame.
+static double KeyFrame(Doc* doc, ImGuiKey key, ImGuiKeyChord mods, ImGuiInputTextFlags flags = 0)
+{
+    PressKey(key, mods);
+    double t = Now();
+    EditorFrame(doc, flags, EditorFlags_None);
+    t = Now() - t;
+    ReleaseKeys();
+    EditorFrame(doc, flags, EditorFlags_None);
+    return t;
+}
+
+// Undo and redo of a 10 MB paste, then memory used by the undo history over a long typing session.
+static void CaseUndo()
+{
+    Doc paste;
+    GenLines(&paste, 10 << 20);
+    Doc doc;
+    GenLines(&doc, 1 << 20);
+    ImVector<char> doc_before;
+    doc_before.resize(doc.Buf.Size);
+    memcpy(doc_before.Data, doc.Buf.Data, (size_t)doc.Buf.Size);
+
+    BeginContext();
+    ActivateAtEnd(&doc, 0);
+    ImGuiInputTextUndoStack* undo_stack = &ImGui::GetInputTextState(g_EditorId)->UndoStack;
+    ImGui::SetClipboardText(paste.Buf.Data);
+    printf("%-10s %10s %12s\n", "10 MB", "ms", "history KB");
+    const double t_paste = KeyFrame(&doc, ImGuiKey_V, ImGuiMod_Ctrl);
+    printf("%-10s %10.1f %12d\n", "paste", t_paste * 1e3, undo_stack->GetMemoryUsage() / 1024);
+    const double t_undo = KeyFrame(&doc, ImGuiKey_Z, ImGuiMod_Ctrl);
+    printf("%-10s %10.1f %12d %s\n", "undo", t_undo * 1e3, undo_stack->GetMemoryUsage() / 1024, strcmp(doc.Buf.Data, doc_before.Data) == 0 ? "(restored)" : "(NOT restored)");
+    const double t_redo = KeyFrame(&doc, ImGuiKey_Y, ImGuiMod_Ctrl);
+    printf("%-10s %10.1f %12d %s\n", "redo", t_redo * 1e3, undo_stack->GetMemoryUsage() / 1024, doc.Len() == (int)(doc_before.Size + paste.Buf.Size - 2) ? "(restored)" : "(NOT restored)");
+    EndContext();
+
+    // Typing session: lines of 60 characters, with a word erased with backspaces every 200 characters
+    static const int budgets[] = { 16 << 20, 64 << 10 };
+    static const int chars_total = 200000;
+    for (int budget : budgets)
+    {
+        GenLines(&doc, 1 << 20);
+        BeginContext();
+        ImGui::GetIO().ConfigInputTextUndoMemory = budget;
+        ActivateAtEnd(&doc, 0);
+        undo_stack = &ImGui::GetInputTextState(g_EditorId)->UndoStack;
+        printf("\nbudget %d KB\n%-10s %10s %12s %12s\n", budget / 1024, "typed", "records", "history KB", "us/frame");
+        double t = Now();
+        int frames = 0;
+        for (int n = 0; n < chars_total; frames++)
+        {
+            if (n % 200 == 199)
+            {
+                for (int i = 0; i < 5; i++)
+                    KeyFrame(&doc, ImGuiKey_Backspace, ImGuiMod_None);
+                frames += 9;
+            }
+            for (int i = 0; i < 4; i++, n++)
+                ImGui::GetIO().AddInputCharacter((n % 60) == 59 ? '\n' : (n % 7) == 6 ? ' ' : 'a' + (n % 26));
+            EditorFrame(&doc, 0, EditorFlags_None);
+            if (n % (chars_total / 4) == 0)
+                printf("%-10d %10d %12d %12.1f\n", n, undo_stack->GetUndoCount(), undo_stack->GetMemoryUsage() / 1024, (Now() - t) * 1e6 / frames);
+        }
+        EndContext();
+    }
+}
+
+// Frame time of pasting a large clipboard at the end of an active 1 MB document, then of typing a character.
+static void CasePaste()
+{
+    static const size_t paste_sizes[] = { 1 << 20, 10 << 20, 50 << 20 };
+    printf("%-10s %12s %12s\n", "paste", "paste ms", "typing ms");
+    for (size_t paste_size : paste_sizes)
+    {
+        Doc paste;
+        GenLines(&paste, paste_size);
+        Doc doc;
+        GenLines(&doc, 1 << 20);
+        const int len_before = doc.Len();
+
+        BeginContext();
+        ActivateAtEnd(&doc, 0);
+        ImGui::SetClipboardText(paste.Buf.Data);
+        PressKey(ImGuiKey_V, ImGuiMod_Ctrl);
+        double t_paste = Now();
+        EditorFrame(&doc, 0, EditorFlags_None);
+        t_paste = Now() - t_paste;
+        ReleaseKeys();
+        const bool ok = doc.Len() == len_before + paste.Len() && memcmp(doc.Buf.Data + len_before, paste.Buf.Data, (size_t)paste.Len()) == 0;
+        ImGui::GetIO().AddInputCharacter('a');
+        double t_typing = Now();
+        EditorFrame(&doc, 0, EditorFlags_None);
+        t_typing = Now() - t_typing;
+        EndContext();
+
+        printf("%7.1f MB %12.1f %12.1f%s\n", paste_size / (1024.0 * 1024.0), t_paste * 1e3, t_typing * 1e3, ok ? "" : " (MISMATCH)");
+    }
+}
+
+// Run frames until the background reflow of a word-wrapped editor is done. Returns the number of frames, and their average time in 'out_time'.
+static int WrapReflowFrames(Doc* doc, ImGuiInputTextFlags flags, double* out_time)
+{
+    ImGuiInputTextState* state = ImGui::GetInputTextState(g_EditorId);
+    int frames = 0;
+    double t = Now();
+    while (state->WrapStaleCount > 0 && frames < 100000)
+    {
+        EditorFrame(doc, flags, EditorFlags_None);
+        frames++;
+    }
+    *out_time = frames > 0 ? (Now() - t) / frames : 0.0;
+    return frames;
+}
+
+// Word-wrapped editor over 5 MB of paragraphs: activation and width change (lazy reflow), then keystroke latency in the middle of the document.
+static void CaseWrap()
+{
+    const ImGuiInputTextFlags flags = ImGuiInputTextFlags_WordWrap;
+    Doc doc;
+    GenParagraphs(&doc, 5 << 20);
+    BeginContext();
+    printf("%-10s %12s %12s\n", "5 MB", "us/frame", "frames");
+
+    double t = Now();
+    EditorFrame(&doc, flags, EditorFlags_Focus);
+    EditorFrame(&doc, flags, EditorFlags_None);
+    printf("%-10s %12.1f %12d\n", "activate", (Now() - t) * 1e6 / 2, 2);
+    double t_reflow;
+    int frames = WrapReflowFrames(&doc, flags, &t_reflow);
+    ImGuiInputTextState* state = ImGui::GetInputTextState(g_EditorId);
+    printf("%-10s %12.1f %12d (%d lines, %d rows)\n", "reflow", t_reflow * 1e6, frames, state->GetLineCount(), state->GetRowCount());
+
+    // Move to the middle of the document
+    doc.MoveCursorTo = state->GetLineStart(state->GetLineCount() / 2) + 100;
+    EditorFrame(&doc, flags, EditorFlags_None);
+
+    t = Now();
+    for (int i = 0; i < g_Frames; i++)
+    {
+        ImGui::GetIO().AddInputCharacter((i % 7) == 6 ? ' ' : 'a' + (i % 26));
+        EditorFrame(&doc, flags, EditorFlags_None);
+    }
+    printf("%-10s %12.1f %12d\n", "typing", (Now() - t) * 1e6 / g_Frames, g_Frames);
+
+    static const struct { const char* Name; ImGuiKey Key; } keys[] = { { "down", ImGuiKey_DownArrow }, { "up", ImGuiKey_UpArrow }, { "pagedown", ImGuiKey_PageDown }, { "pageup", ImGuiKey_PageUp }, { "end", ImGuiKey_End } };
+    for (const auto& key : keys)
+    {
+        t = 0.0;
+        for (int i = 0; i < g_Frames / 2; i++)
+            t += KeyFrame(&doc, key.Key, ImGuiMod_None, flags);
+        printf("%-10s %12.1f %12d\n", key.Name, t * 1e6 / (g_Frames / 2), g_Frames / 2);
+    }
+
+    // Narrower window: visible lines are reflowed in the first frame, the others over the next ones
+    ImGui::GetIO().DisplaySize.x *= 0.6f;
+    t = Now();
+    EditorFrame(&doc, flags, EditorFlags_None);
+    printf("%-10s %12.1f %12d\n", "resize", (Now() - t) * 1e6, 1);
+    frames = WrapReflowFrames(&doc, flags, &t_reflow);
+    printf("%-10s %12.1f %12d (%d rows)\n", "reflow", t_reflow * 1e6, frames, state->GetRowCount());
+
+    // Read-only: the rows are kept while the text doesn't change, instead of being laid out again every frame
+    const ImGuiInputTextFlags readonly_flags = flags | ImGuiInputTextFlags_ReadOnly;
+    EditorFrame(&doc, readonly_flags, EditorFlags_None);
+    frames = WrapReflowFrames(&doc, readonly_flags, &t_reflow);
+    t = Now();
+    for (int i = 0; i < g_Frames; i++)
+        EditorFrame(&doc, readonly_flags, EditorFlags_None);
+    printf("%-10s %12.1f %12d (reflowed in %d frames)\n", "read-only", (Now() - t) * 1e6 / g_Frames, g_Frames, frames);
+
+    // Inactive, without a text generation: the rows are kept while the text is the same as the copy kept with them
+    EditorFrame(&doc, flags, EditorFlags_Unfocus);
+    EditorFrame(&doc, flags, EditorFlags_None);
+    t = Now();
+    for (int i = 0; i < g_Frames; i++)
+        EditorFrame(&doc, flags, EditorFlags_None);
+    printf("%-10s %12.1f %12d\n", "inactive", (Now() - t) * 1e6 / g_Frames, g_Frames);
+    EndContext();
+}
+
+// Focus and unfocus of a 50 MB document, editing a copy of a plain buffer vs editing a gap buffer in place.
+static void CaseFocus()
+{
+    const int rounds = 10;
+    Doc src;
+    GenLines(&src, 50 << 20);
+    printf("%-10s %12s %12s %12s %12s\n", "50 MB", "focus us", "idle us", "typing us", "unfocus us");
+    for (int pass = 0; pass < 2; pass++)
+    {
+        Doc doc;
+        GapBuffer gap_buffer;
+        if (pass == 0)
+        {
+            doc.Buf.resize(src.Buf.Size);
+            memcpy(doc.Buf.Data, src.Buf.Data, (size_t)src.Buf.Size);
+        }
+        else
+        {
+            gap_buffer.Set(src.Buf.Data, src.Len());
+            doc.Storage = &gap_buffer.Storage;
+        }
+
+        // Each round focuses the editor (over two frames, activation happens on the second one), types a character at the end then unfocuses it.
+        // The cursor is moved to the end in the first round, and kept by the next ones because the text generation doesn't change.
+        BeginContext();
+        EditorFrame(&doc, 0, EditorFlags_Generation);
+        double t_focus = 0.0, t_idle = 0.0, t_typing = 0.0, t_unfocus = 0.0;
+        for (int round = 0; round < rounds; round++)
+        {
+            double t = Now();
+            EditorFrame(&doc, 0, EditorFlags_Focus | EditorFlags_Generation);
+            EditorFrame(&doc, 0, EditorFlags_Generation);
+            t_focus += Now() - t;
+            if (round == 0)
+            {
+                PressKey(ImGuiKey_End, ImGuiMod_Ctrl);
+                EditorFrame(&doc, 0, EditorFlags_Generation);
+                ReleaseKeys();
+            }
+            t = Now();
+            EditorFrame(&doc, 0, EditorFlags_Generation);
+            t_idle += Now() - t;
+            ImGui::GetIO().AddInputCharacter('a' + round);
+            t = Now();
+            EditorFrame(&doc, 0, EditorFlags_Generation);
+            t_typing += Now() - t;
+            t = Now();
+            EditorFrame(&doc, 0, EditorFlags_Unfocus | EditorFlags_Generation);
+            EditorFrame(&doc, 0, EditorFlags_Generation);
+            t_unfocus += Now() - t;
+        }
+        EndContext();
+        IM_ASSERT((pass == 0 ? doc.Len() : gap_buffer.Len()) == src.Len() + rounds);
+        printf("%-10s %12.1f %12.1f %12.1f %12.1f\n", pass == 0 ? "buffer" : "storage", t_focus * 1e6 / rounds, t_idle * 1e6 / rounds, t_typing * 1e6 / rounds, t_unfocus * 1e6 / rounds);
+    }
+}
+
+// Cursor moves on lines of 100 KB (e.g. minified JSON), with the cursor in the middle of a line.
+static void CaseLongLines()
+{
+    Doc doc;
+    GenLongLines(&doc, 4, 100 * 1024);
+    BeginContext();
+    printf("%-10s %12s %12s\n", "100 KB", "us/frame", "frames");
+    EditorFrame(&doc, 0, EditorFlags_Focus);
+    EditorFrame(&doc, 0, EditorFlags_None);
+    doc.MoveCursorTo = 2 * (100 * 1024 + 1) + 50 * 1024;
+    EditorFrame(&doc, 0, EditorFlags_None);
+
+    static const struct { const char* Name; ImGuiKey Key1; ImGuiKey Key2; } moves[] = { { "up/down", ImGuiKey_DownArrow, ImGuiKey_UpArrow }, { "pgup/pgdn", ImGuiKey_PageDown, ImGuiKey_PageUp }, { "home/end", ImGuiKey_Home, ImGuiKey_End } };
+    for (const auto& move : moves)
+    {
+        double t = 0.0;
+        for (int i = 0; i < g_Frames / 2; i++)
+            t += KeyFrame(&doc, (i & 1) ? move.Key2 : move.Key1, ImGuiMod_None);
+        printf("%-10s %12.1f %12d\n", move.Name, t * 1e6 / (g_Frames / 2), g_Frames / 2);
+    }
+
+    // Clicks on the long lines, as the view is scrolled horizontally to the cursor
+    ImGuiIO& io = ImGui::GetIO();
+    double t = 0.0;
+    for (int i = 0; i < g_Frames / 2; i++)
+    {
+        io.AddMousePosEvent(100.0f + (i * 37) % 1000, 10.0f + ImGui::GetFontSize() * ((i % 4) + 0.5f));
+        EditorFrame(&doc, 0, EditorFlags_None);
+        io.AddMouseButtonEvent(0, true);
+        double t_click = Now();
+        EditorFrame(&doc, 0, EditorFlags_None);
+        t += Now() - t_click;
+        io.AddMouseButtonEvent(0, false);
+        EditorFrame(&doc, 0, EditorFlags_None);
+    }
+    printf("%-10s %12.1f %12d\n", "click", t * 1e6 / (g_Frames / 2), g_Frames / 2);
+    EndContext();
+}
+
+// Text measurement throughput on 4 MB of ASCII, Latin-1 and CJK text: ImGui::CalcTextSize() over the whole text,
+// then frames of an active editor with everything selected (the selection is measured line by line).
+static void CaseMeasure()
+{
+    static const char* ascii[] = { "lorem", "ipsum", "dolor", "sit", "amet,", "consectetur", "adipiscing", "elit.", "{\"key\":", "[1,2,3]}" };
+    static const char* latin1[] = { "caf\xC3\xA9", "d\xC3\xA9j\xC3\xA0", "\xC3\xA0", "la", "fran\xC3\xA7" "aise", "\xC3\xA9l\xC3\xA8ve", "o\xC3\xB9", "na\xC3\xAFve", "gro\xC3\x9F", "stra\xC3\x9F" "e" };
+    static const char* cjk[] = { "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", "\xE3\x81\xAE", "\xE3\x83\x86\xE3\x82\xAD\xE3\x82\xB9\xE3\x83\x88", "\xE6\xBC\xA2\xE5\xAD\x97", "\xE3\x81\xA8", "\xE3\x81\x8B\xE3\x81\xAA\xE3\x80\x82" };
+    static const struct { const char* Name; const char* const* Words; int WordsCount; } texts[] = { { "ascii", ascii, IM_ARRAYSIZE(ascii) }, { "latin1", latin1, IM_ARRAYSIZE(latin1) }, { "cjk", cjk, IM_ARRAYSIZE(cjk) } };
+    printf("%-10s %12s %12s %12s\n", "4 MB", "size MB/s", "select us", "width");
+    for (const auto& text : texts)
+    {
+        Doc doc;
+        GenWords(&doc, text.Words, text.WordsCount, 40, 100 * 1024);
+        BeginContext();
+        EditorFrame(&doc, 0, EditorFlags_None);
+        const int rounds = ImMax(g_Frames / 10, 1);
+        ImVec2 size;
+        double t_size = Now();
+        for (int i = 0; i < rounds; i++)
+            size = ImGui::CalcTextSize(doc.Buf.Data, doc.Buf.Data + doc.Len());
+        t_size = Now() - t_size;
+
+        // Select everything with the cursor at the start, so that the view is not scrolled horizontally
+        ActivateAtEnd(&doc, 0);
+        PressKey(ImGuiKey_Home, ImGuiMod_Ctrl | ImGuiMod_Shift);
+        EditorFrame(&doc, 0, EditorFlags_None);
+        ReleaseKeys();
+        double t_select = Now();
+        for (int i = 0; i < rounds; i++)
+            EditorFrame(&doc, 0, EditorFlags_None);
+        t_select = Now() - t_select;
+        EndContext();
+        printf("%-10s %12.1f %12.1f %12.1f\n", text.Name, doc.Len() * rounds / (t_size * 1024.0 * 1024.0), t_select * 1e6 / rounds, size.x);
+    }
+}
+
+// Run one frame showing the document with TextWrapped(), or TextWrappedIndexed() when 'index' is not NULL, scrolled to 'scroll_ratio' of its height.
+static void WrappedTextFrame(Doc* doc, ImGuiTextWrapIndex* index, float scroll_ratio)
+{
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f));
+    ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize);
+    ImGui::Begin("Bench", NULL, ImGuiWindowFlags_NoDecoration);
+    ImGui::SetScrollY(ImGui::GetScrollMaxY() * scroll_ratio);
+    if (index)
+        ImGui::TextWrappedIndexed(index, doc->Buf.Data, doc->Buf.Data + doc->Len());
+    else
+        ImGui::TextWrapped("%s", doc->Buf.Data);
+    ImGui::End();
+    ImGui::Render();
+}
+
+// Read-only TextWrapped() over 2 MB of paragraphs, with and without a wrap index: scrolled to the top, to the middle, and resized every frame.
+static void CaseTextWrapped()
+{
+    Doc doc;
+    GenParagraphs(&doc, 2 << 20);
+    printf("%-10s %12s %12s\n", "2 MB", "plain us", "indexed us");
+    static const struct { const char* Name; float ScrollRatio; bool Resize; } runs[] = { { "top", 0.0f, false }, { "middle", 0.5f, false }, { "end", 1.0f, false }, { "resize", 0.5f, true } };
+    for (const auto& run : runs)
+    {
+        double t[2];
+        for (int pass = 0; pass < 2; pass++)
+        {
+            ImGuiTextWrapIndex index;
+            ImGuiTextWrapIndex* p_index = pass ? &index : NULL;
+            BeginContext();
+            for (int i = 0; i < 3; i++)
+                WrappedTextFrame(&doc, p_index, run.ScrollRatio);
+            t[pass] = Now();
+            for (int i = 0; i < g_Frames; i++)
+            {
+                if (run.Resize)
+                    ImGui::GetIO().DisplaySize.x = 1280.0f - (float)(i % 2) * 7.0f;
+                WrappedTextFrame(&doc, p_index, run.ScrollRatio);
+            }
+            t[pass] = Now() - t[pass];
+            EndContext();
+        }
+        printf("%-10s %12.1f %12.1f\n", run.Name, t[0] * 1e6 / g_Frames, t[1] * 1e6 / g_Frames);
+    }
+}
+
+// Count the non-overlapping matches of 'find' in the document.
+static int CountMatches(const Doc& doc, const char* find)
+{
+    int count = 0;
+    const size_t find_len = strlen(find);
+    for (const char* p = strstr(doc.Buf.Data, find); p != NULL; p = strstr(p + find_len, find))
+        count++;
+    return count;
+}
+
+// Find highlighting and replace-all over 20 MB, with the editor inactive then active, followed by undo and redo.
+static void CaseReplace()
+{
+    const char* find = "sit amet consectetur adipiscing elit sed do eiusmod tempor";
+    const char* replace = "SIT AMET";
+    Doc doc;
+    GenLines(&doc, 20 << 20);
+    const int len_before = doc.Len();
+    const int matches = CountMatches(doc, find);
+    const int len_after = len_before - matches * (int)(strlen(find) - strlen(replace));
+    printf("%-10s %12s %12s (%d matches)\n", "20 MB", "ms", "length", matches);
+
+    BeginContext();
+    EditorFrame(&doc, 0, EditorFlags_None);
+    doc.Find = find;
+    double t = Now();
+    for (int i = 0; i < g_Frames; i++)
+        EditorFrame(&doc, 0, EditorFlags_None);
+    printf("%-10s %12.3f %12d\n", "highlight", (Now() - t) * 1e3 / g_Frames, doc.Len());
+    doc.ReplaceAll = replace;
+    t = Now();
+    EditorFrame(&doc, 0, EditorFlags_None);
+    printf("%-10s %12.1f %12d%s\n", "inactive", (Now() - t) * 1e3, doc.Len(), doc.Len() == len_after ? "" : " (MISMATCH)");
+    EndContext();
+
+    GenLines(&doc, 20 << 20);
+    BeginContext();
+    ActivateAtEnd(&doc, 0);
+    t = Now();
+    for (int i = 0; i < g_Frames; i++)
+        EditorFrame(&doc, 0, EditorFlags_None);
+    printf("%-10s %12.3f %12d\n", "highlight", (Now() - t) * 1e3 / g_Frames, doc.Len());
+    doc.ReplaceAll = replace;
+    t = Now();
+    EditorFrame(&doc, 0, EditorFlags_None);
+    printf("%-10s %12.1f %12d%s\n", "active", (Now() - t) * 1e3, doc.Len(), doc.Len() == len_after ? "" : " (MISMATCH)");
+    ImGuiInputTextUndoStack* undo_stack = &ImGui::GetInputTextState(g_EditorId)->UndoStack;
+    const double t_undo = KeyFrame(&doc, ImGuiKey_Z, ImGuiMod_Ctrl);
+    printf("%-10s %12.1f %12d%s\n", "undo", t_undo * 1e3, doc.Len(), doc.Len() == len_before && CountMatches(doc, find) == matches ? "" : " (MISMATCH)");
+    const double t_redo = KeyFrame(&doc, ImGuiKey_Y, ImGuiMod_Ctrl);
+    printf("%-10s %12.1f %12d%s (history %d KB)\n", "redo", t_redo * 1e3, doc.Len(), doc.Len() == len_after ? "" : " (MISMATCH)", undo_stack->GetMemoryUsage() / 1024);
+    EndContext();
+}
+
+struct Case
+{
+    const char* Name;
+    const char* Desc;
+    void        (*Run)();
+};
+
+static const Case g_Cases[] =
+{
+    { "active",  "Active multiline editor, idle and typing at the end", CaseActive },
+    { "log",     "Inactive read-only field scrolled to the end", CaseLog },
+    { "undo",    "Undo/redo of a 10 MB paste, undo history memory while typing", CaseUndo },
+    { "paste",   "Paste of 1, 10 and 50 MB at the end of an active document", CasePaste },
+    { "wrap",    "Word-wrapped editor over 5 MB: reflow, typing and moving in the middle", CaseWrap },
+    { "focus",   "Focus, typing and unfocus on 50 MB: plain buffer vs in-place storage", CaseFocus },
+    { "replace", "Find highlighting and replace-all of a string found 138k times in 20 MB", CaseReplace },
+    { "longline", "Cursor moves and clicks on 4 lines of 100 KB", CaseLongLines },
+    { "measure", "Text measurement of 4 MB of ASCII, Latin-1 and CJK text", CaseMeasure },
+    { "textwrapped", "Read-only TextWrapped() over 2 MB, with and without a wrap index", CaseTextWrapped },
+};
+
+int main(int argc, char** argv)
+{
+    const char* case_name = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--case") == 0 && i + 1 < argc)
+            case_name = argv[++i];
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            g_Frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--list") == 0)
+        {
+            for (const Case& c : g_Cases)
+                printf("%-12s %s\n", c.Name, c.Desc);
+            return 0;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (g_Frames <= 0)
+        g_Frames = 1;
+
+    int ran = 0;
+    for (const Case& c : g_Cases)
+    {
+        if (case_name != NULL && strcmp(case_name, c.Name) != 0)
+            continue;
+        printf("== %s: %s\n", c.Name, c.Desc);
+        c.Run();
+        ran++;
+    }
+    if (ran == 0)
+    {
+        fprintf(stderr, "Unknown case: %s\n", case_name);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,1672 @@
+/*
+ * Benchmark of md_parse() on pathological and realistic inputs.
+ *
+ * Build (from app/editor_src):
+ *   cc -O2 -I. -o md4c_bench scripts/md4c_bench.c md4c.c md4c-text.c md4c-stream.c entity.c -lpthread -lm
+ *   cl /O2 /I. scripts\md4c_bench.c md4c.c md4c-text.c md4c-stream.c entity.c
+ *
+ * (md4c-html.c is not listed: It is compiled as a part of this file.)
+ *
+ * Usage:
+ *   md4c_bench [OPTION]...                 Run all the pathological cases.
+ *   md4c_bench [OPTION]... FILE...         Measure throughput on the files.
+ *   md4c_bench [OPTION]... --tiny COUNT    Measure rendering of many tiny
+ *                                          documents.
+ *   md4c_bench [OPTION]... --limits        Check each of MD_PARSE_LIMITS.
+ *   md4c_bench --verify                    Check the SIMD escaping against
+ *                                          the scalar one.
+ *   md4c_bench [OPTION]... --ref-defs      Measure re-parsing of documents
+ *                                          with many ref. defs after edits.
+ *   md4c_bench --stream                    Check malformed event streams are
+ *                                          rejected.
+ *
+ * Options:
+ *   --case NAME            Run only the given pathological case.
+ *   --list                 List the pathological cases.
+ *   --max-exponent X       Fail if the time grows faster than size^X.
+ *                          (Default 1.3.)
+ *   --commonmark           Use MD_DIALECT_COMMONMARK. (Default is
+ *                          MD_DIALECT_GITHUB.)
+ *   --pieces SIZE          For files, also compare md_parse_chunks() with
+ *                          flattening and md_parse() on the file split into
+ *                          non-adjacent pieces of about SIZE bytes.
+ *
+ * Every pathological case generates a document from a repeated pattern.
+ * The pattern count is first doubled until md_parse() takes a few
+ * milliseconds, then the document is timed at four more doublings. The
+ * growth exponent is the least-squares slope of log(time) over log(size).
+ * Linear algorithms come out close to 1.0, quadratic ones close to 2.0.
+ *
+ * For files, the throughput of md_parse() (with no-op callbacks), of repeated
+ * md_parse_with_context() (of the unchanged file, and of the file with its
+ * middle line removed after parsing the original) and of md_html_buffer() is
+ * reported in MB/s. Plain
+ * text extraction by md_text() is compared with md_html_buffer() followed by
+ * stripping the tags and unescaping the HTML output. With
+ * --pieces, the file is also stored as a piece table would store it and
+ * parsed both ways an editor could do it: By copying the pieces into a fresh
+ * buffer for md_parse(), and by md_parse_chunks() with a reused context
+ * (which copies them too, but into the buffer kept in the context).
+ *
+ * With --tiny, COUNT documents of 50 to about 500 bytes are rendered one by
+ * one with md_html_buffer() and with a single reused MD_HTML_RENDERER, to
+ * show the per-call setup cost.
+ *
+ * With --ref-defs, documents with 10k and 100k ref. defs (ASCII, mixed case
+ * and non-ASCII labels) are parsed, re-parsed unchanged, and re-parsed after
+ * several edits with the context of the previous parse, in milliseconds. The
+ * HTML of each edited document rendered with the reused context is also
+ * compared with the one rendered from scratch.
+ *
+ * With --verify, render_html_escaped() and render_url_escaped() are run on
+ * random buffers of up to 160 bytes at each of 64 alignments, once with the
+ * scalar loops only and once with each SIMD skip function the CPU supports.
+ * The outputs must be the same, and each skip function must stop exactly
+ * where its contract says.
+ *
+ * With --limits, documents exceeding each member of MD_PARSE_LIMITS are
+ * rendered through the HTML entry points, and the return values and the
+ * (partial) output are checked.
+ *
+ * With --stream, a recorded document is checked and replayed into the HTML
+ * renderer, and then hand-built streams with missing details, values out of
+ * range and unbalanced or misnested records are fed to md_stream_check() and
+ * md_stream_replay(). Both must report them as malformed.
+ *
+ * The exit code is 0 if all the cases are within the bound (or all the
+ * checks pass), 1 if any is not, and 2 on usage or I/O errors.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "md4c.h"
+#include "md4c-text.h"
+#include "md4c-stream.h"
+
+/* Compiled in rather than linked, so --verify can reach the static escaping
+ * functions. */
+#include "md4c-html.c"
+
+
+/* Time limits for the calibration: The smallest measured document should
+ * take at least MIN_TIME, and we give up doubling it at MAX_TIME or MAX_SIZE. */
+#define MIN_TIME        0.005
+#define MAX_TIME        2.0
+#define MAX_SIZE        ((size_t)256 * 1024 * 1024)
+#define N_STEPS         5
+#define N_REPEATS       5
+
+
+static double
+now(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, t;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+
+/*************************
+ ***  Document buffer  ***
+ *************************/
+
+typedef struct DOC_tag DOC;
+struct DOC_tag {
+    char* data;
+    size_t size;
+    size_t alloc;
+};
+
+static void
+doc_append(DOC* doc, const char* str, size_t n)
+{
+    if (doc->size + n > doc->alloc) {
+        size_t alloc = (doc->alloc > 0 ? doc->alloc * 2 : 4096);
+
+        while (alloc < doc->size + n)
+            alloc *= 2;
+        doc->data = (char*)realloc(doc->data, alloc);
+        if (doc->data == NULL) {
+            fprintf(stderr, "Out of memory.\n");
+            exit(2);
+        }
+        doc->alloc = alloc;
+    }
+    memcpy(doc->data + doc->size, str, n);
+    doc->size += n;
+}
+
+static void
+doc_puts(DOC* doc, const char* str)
+{
+    doc_append(doc, str, strlen(str));
+}
+
+static void
+doc_repeat(DOC* doc, const char* str, int n)
+{
+    int i;
+    for (i = 0; i < n; i++)
+        doc_puts(doc, str);
+}
+
+/* Makes dst a copy of src with the bytes [beg, end) replaced by str, as an
+ * edit in the editor would do it. */
+static void
+doc_edit(DOC* dst, const DOC* src, size_t beg, size_t end, const char* str)
+{
+    dst->size = 0;
+    doc_append(dst, src->data, beg);
+    doc_puts(dst, str);
+    doc_append(dst, src->data + end, src->size - end);
+}
+
+/* Offset of the start of the line 'line' (counted from zero). */
+static size_t
+doc_line_offset(const DOC* doc, int line)
+{
+    size_t off = 0;
+
+    while (line > 0  &&  off < doc->size) {
+        if (doc->data[off++] == '\n')
+            line--;
+    }
+    return off;
+}
+
+
+/****************************
+ ***  Pathological cases  ***
+ ****************************/
+
+/* Each generator appends a document built from 'n' repetitions of its
+ * pattern. */
+
+static void
+gen_nested_emph(DOC* doc, int n)
+{
+    doc_repeat(doc, "*a ", n);
+    doc_puts(doc, "b");
+    doc_repeat(doc, " a*", n);
+}
+
+static void
+gen_unclosed_emph(DOC* doc, int n)
+{
+    doc_repeat(doc, "*a **b _c __d ", n);
+}
+
+static void
+gen_emph_mod3(DOC* doc, int n)
+{
+    doc_repeat(doc, "a***b**", n);
+}
+
+static void
+gen_unclosed_brackets(DOC* doc, int n)
+{
+    doc_repeat(doc, "[a ", n);
+}
+
+static void
+gen_unclosed_links(DOC* doc, int n)
+{
+    doc_repeat(doc, "[a](b ", n);
+}
+
+static void
+gen_nested_brackets(DOC* doc, int n)
+{
+    doc_repeat(doc, "[", n);
+    doc_puts(doc, "a");
+    doc_repeat(doc, "](b)", n);
+}
+
+static void
+gen_closing_brackets(DOC* doc, int n)
+{
+    doc_repeat(doc, "a] ", n);
+}
+
+static void
+gen_ref_defs(DOC* doc, int n)
+{
+    char buf[64];
+    int i;
+
+    for (i = 0; i < n; i++) {
+        sprintf(buf, "[label %d]: /url/%d \"title\"\n", i, i);
+        doc_puts(doc, buf);
+    }
+    doc_puts(doc, "\n");
+    for (i = 0; i < n; i++) {
+        sprintf(buf, "[label %d] ", (i * 7919) % n);
+        doc_puts(doc, buf);
+    }
+}
+
+/* Same with labels which only match after the case folding. */
+static void
+gen_ref_defs_mixed(DOC* doc, int n)
+{
+    char buf[64];
+    int i;
+
+    for (i = 0; i < n; i++) {
+        sprintf(buf, "[Mixed Case Label %d]: /url/%d \"title\"\n", i, i);
+        doc_puts(doc, buf);
+    }
+    doc_puts(doc, "\n");
+    for (i = 0; i < n; i++) {
+        sprintf(buf, "[mIXED cASE lABEL %d] ", (i * 7919) % n);
+        doc_puts(doc, buf);
+    }
+}
+
+/* Same with non-ASCII labels: The references use the other case, and their
+ * "STRASSE" matches the sharp s of the labels only by the full case folding. */
+static void
+gen_ref_defs_unicode(DOC* doc, int n)
+{
+    char buf[64];
+    int i;
+
+    for (i = 0; i < n; i++) {
+        sprintf(buf, "[\xc3\x84rger Stra\xc3\x9f" "e \xce\xa9mega %d]: /url/%d\n", i, i);
+        doc_puts(doc, buf);
+    }
+    doc_puts(doc, "\n");
+    for (i = 0; i < n; i++) {
+        sprintf(buf, "[\xc3\xa4RGER STRASSE \xcf\x89MEGA %d] ", (i * 7919) % n);
+        doc_puts(doc, buf);
+    }
+}
+
+static void
+gen_backtick_runs(DOC* doc, int n)
+{
+    int i;
+
+    /* Openers of growing length, none of them closed. */
+    for (i = 0; i < n; i++) {
+        doc_repeat(doc, "`", 1 + i % 64);
+        doc_puts(doc, "a ");
+    }
+}
+
+static void
+gen_long_backtick_run(DOC* doc, int n)
+{
+    doc_puts(doc, "a ");
+    doc_repeat(doc, "`", n);
+    doc_puts(doc, " b");
+}
+
+static void
+gen_unclosed_html(DOC* doc, int n)
+{
+    doc_repeat(doc, "a <!-- b <? c <![CDATA[ d <!X ", n);
+}
+
+static void
+gen_unclosed_autolinks(DOC* doc, int n)
+{
+    doc_repeat(doc, "<http://a ", n);
+}
+
+static void
+gen_permissive_autolinks(DOC* doc, int n)
+{
+    doc_repeat(doc, "www.a.b@c.d:e ", n);
+}
+
+static void
+gen_nested_quotes(DOC* doc, int n)
+{
+    doc_repeat(doc, ">", n);
+    doc_puts(doc, " a\n");
+}
+
+static void
+gen_nested_lists(DOC* doc, int n)
+{
+    /* "- - - a" nests the lists without the quadratic indentation. */
+    doc_repeat(doc, "- ", n);
+    doc_puts(doc, "a\n");
+}
+
+static void
+gen_wide_table(DOC* doc, int n)
+{
+    int i;
+
+    doc_puts(doc, "|a|b|\n|-|-|\n");
+    for (i = 0; i < n; i++)
+        doc_puts(doc, "|x\n");
+}
+
+static void
+gen_table_pipes(DOC* doc, int n)
+{
+    doc_puts(doc, "|a|b|\n|-|-|\n");
+    doc_repeat(doc, "|`x", n);
+    doc_puts(doc, "\n");
+}
+
+static void
+gen_entities(DOC* doc, int n)
+{
+    doc_repeat(doc, "&amp &#x12 &#1234567 &a; ", n);
+}
+
+static void
+gen_many_lines(DOC* doc, int n)
+{
+    doc_repeat(doc, "a\n", n);
+}
+
+typedef struct CASE_tag CASE;
+struct CASE_tag {
+    const char* name;
+    void (*generate)(DOC* doc, int n);
+};
+
+static const CASE cases[] = {
+    { "nested-emph",            gen_nested_emph },
+    { "unclosed-emph",          gen_unclosed_emph },
+    { "emph-mod3",              gen_emph_mod3 },
+    { "unclosed-brackets",      gen_unclosed_brackets },
+    { "unclosed-links",         gen_unclosed_links },
+    { "nested-brackets",        gen_nested_brackets },
+    { "closing-brackets",       gen_closing_brackets },
+    { "ref-defs",               gen_ref_defs },
+    { "ref-defs-mixed",         gen_ref_defs_mixed },
+    { "ref-defs-unicode",       gen_ref_defs_unicode },
+    { "backtick-runs",          gen_backtick_runs },
+    { "long-backtick-run",      gen_long_backtick_run },
+    { "unclosed-html",          gen_unclosed_html },
+    { "unclosed-autolinks",     gen_unclosed_autolinks },
+    { "permissive-autolinks",   gen_permissive_autolinks },
+    { "nested-quotes",          gen_nested_quotes },
+    { "nested-lists",           gen_nested_lists },
+    { "wide-table",             gen_wide_table },
+    { "table-pipes",            gen_table_pipes },
+    { "entities",               gen_entities },
+    { "many-lines",             gen_many_lines }
+};
+
+
+/*******************
+ ***  Measuring  ***
+ *******************/
+
+static unsigned parser_flags = MD_DIALECT_GITHUB;
+
+static int
+noop_block(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    (void)type; (void)detail; (void)userdata;
+    return 0;
+}
+
+static int
+noop_span(MD_SPANTYPE type, void* detail, void* userdata)
+{
+    (void)type; (void)detail; (void)userdata;
+    return 0;
+}
+
+static int
+noop_text(MD_TEXTTYPE type, const MD_CHAR* text, MD_SIZE size, void* userdata)
+{
+    (void)type; (void)text; (void)size; (void)userdata;
+    return 0;
+}
+
+static void
+init_noop_parser(MD_PARSER* parser)
+{
+    memset(parser, 0, sizeof(MD_PARSER));
+    parser->flags = parser_flags;
+    parser->enter_block = noop_block;
+    parser->leave_block = noop_block;
+    parser->enter_span = noop_span;
+    parser->leave_span = noop_span;
+    parser->text = noop_text;
+}
+
+/* Best of N_REPEATS runs of md_parse(), in seconds. */
+static double
+time_parse(const DOC* doc)
+{
+    MD_PARSER parser;
+    double best = -1.0;
+    int i;
+
+    init_noop_parser(&parser);
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t = now();
+        md_parse(doc->data, (MD_SIZE)doc->size, &parser, NULL);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+/* Same for md_parse_with_context() with a context kept between the runs, as
+ * an editor re-parsing the document would do it. */
+static double
+time_reparse(const DOC* doc)
+{
+    MD_PARSE_CONTEXT* context = md_parse_context_create();
+    MD_PARSER parser;
+    double best = -1.0;
+    int i;
+
+    init_noop_parser(&parser);
+    md_parse_with_context(context, doc->data, (MD_SIZE)doc->size, &parser, NULL);
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t = now();
+        md_parse_with_context(context, doc->data, (MD_SIZE)doc->size, &parser, NULL);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    md_parse_context_destroy(context);
+    return best;
+}
+
+/* Same, but the context has last parsed 'doc' and the edited document is
+ * timed, as after every keystroke in an editor. */
+static double
+time_edit_reparse(const DOC* doc, const DOC* edited)
+{
+    MD_PARSE_CONTEXT* context = md_parse_context_create();
+    MD_PARSER parser;
+    double best = -1.0;
+    int i;
+
+    init_noop_parser(&parser);
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t;
+
+        md_parse_with_context(context, doc->data, (MD_SIZE)doc->size, &parser, NULL);
+        t = now();
+        md_parse_with_context(context, edited->data, (MD_SIZE)edited->size, &parser, NULL);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    md_parse_context_destroy(context);
+    return best;
+}
+
+static double
+time_html(const DOC* doc)
+{
+    MD_HTML_BUFFER out = { NULL, 0, 0 };
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t = now();
+        out.size = 0;
+        md_html_buffer(doc->data, (MD_SIZE)doc->size, &out, parser_flags, 0, NULL);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    free(out.data);
+    return best;
+}
+
+static double
+time_text(const DOC* doc)
+{
+    MD_PARSE_CONTEXT* context = md_parse_context_create();
+    MD_TEXT_BUFFER out = { NULL, 0, 0 };
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t = now();
+        out.size = 0;
+        md_text(context, doc->data, (MD_SIZE)doc->size, &out, NULL, parser_flags, 0);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    free(out.data);
+    md_parse_context_destroy(context);
+    return best;
+}
+
+/* What a caller without md_text() would do: Render HTML, then drop the tags
+ * and unescape what md_html_buffer() has escaped. */
+static MD_SIZE
+strip_html(const MD_CHAR* html, MD_SIZE size, MD_CHAR* out)
+{
+    MD_SIZE off = 0;
+    MD_SIZE n = 0;
+
+    while (off < size) {
+        if (html[off] == '<') {
+            while (off < size && html[off] != '>')
+                off++;
+            off++;
+        } else if (html[off] == '&') {
+            if (strncmp(html + off, "&amp;", 5) == 0) {
+                out[n++] = '&';
+                off += 5;
+            } else if (strncmp(html + off, "&lt;", 4) == 0) {
+                out[n++] = '<';
+                off += 4;
+            } else if (strncmp(html + off, "&gt;", 4) == 0) {
+                out[n++] = '>';
+                off += 4;
+            } else if (strncmp(html + off, "&quot;", 6) == 0) {
+                out[n++] = '"';
+                off += 6;
+            } else {
+                out[n++] = html[off++];
+            }
+        } else {
+            out[n++] = html[off++];
+        }
+    }
+    return n;
+}
+
+static double
+time_html_strip(const DOC* doc)
+{
+    MD_HTML_BUFFER html = { NULL, 0, 0 };
+    MD_CHAR* out = NULL;
+    MD_SIZE out_capacity = 0;
+    double best = -1.0;
+    int i;
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t = now();
+        html.size = 0;
+        md_html_buffer(doc->data, (MD_SIZE)doc->size, &html, parser_flags, 0, NULL);
+        if (html.size > out_capacity) {
+            free(out);
+            out_capacity = html.size;
+            out = (MD_CHAR*)malloc(out_capacity);
+            if (out == NULL) {
+                fprintf(stderr, "Out of memory.\n");
+                exit(2);
+            }
+        }
+        strip_html(html.data, html.size, out);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    free(html.data);
+    free(out);
+    return best;
+}
+
+/* The document split into pieces which are not adjacent in memory. */
+typedef struct PIECES_tag PIECES;
+struct PIECES_tag {
+    char* storage;
+    const char** text;
+    size_t* size;
+    size_t n;
+    size_t total;
+    size_t iter;        /* For next_piece(). */
+};
+
+static void
+pieces_init(PIECES* pieces, const DOC* doc, size_t piece_size)
+{
+    size_t off = 0;
+    size_t pos = 0;
+    unsigned rnd = 1;
+
+    pieces->n = 0;
+    pieces->total = doc->size;
+    pieces->storage = (char*)malloc(doc->size + doc->size / piece_size * 2 + 2);
+    pieces->text = (const char**)malloc((doc->size / piece_size * 2 + 2) * sizeof(const char*));
+    pieces->size = (size_t*)malloc((doc->size / piece_size * 2 + 2) * sizeof(size_t));
+    if (pieces->storage == NULL || pieces->text == NULL || pieces->size == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        exit(2);
+    }
+
+    while (off < doc->size) {
+        /* Sizes between 1/2 and 3/2 of piece_size. */
+        size_t n = piece_size / 2 + 1 + (rnd = rnd * 1103515245 + 12345) % piece_size;
+
+        if (n > doc->size - off)
+            n = doc->size - off;
+        memcpy(pieces->storage + pos, doc->data + off, n);
+        pieces->text[pieces->n] = pieces->storage + pos;
+        pieces->size[pieces->n] = n;
+        pieces->n++;
+        off += n;
+        pos += n + 1;   /* Leave a gap so md_parse_chunks() cannot join them. */
+    }
+}
+
+static void
+pieces_fini(PIECES* pieces)
+{
+    free(pieces->storage);
+    free((void*)pieces->text);
+    free(pieces->size);
+}
+
+static int
+next_piece(const MD_CHAR** p_text, MD_SIZE* p_size, void* iter_data)
+{
+    PIECES* pieces = (PIECES*)iter_data;
+
+    if (pieces->iter >= pieces->n)
+        return 0;
+    *p_text = pieces->text[pieces->iter];
+    *p_size = (MD_SIZE)pieces->size[pieces->iter];
+    pieces->iter++;
+    return 1;
+}
+
+static double
+time_flatten_parse(const PIECES* pieces)
+{
+    MD_PARSER parser;
+    double best = -1.0;
+    size_t i;
+    int j;
+
+    init_noop_parser(&parser);
+
+    for (j = 0; j < N_REPEATS; j++) {
+        double t = now();
+        char* flat = (char*)malloc(pieces->total);
+        char* ptr = flat;
+
+        if (flat == NULL) {
+            fprintf(stderr, "Out of memory.\n");
+            exit(2);
+        }
+        for (i = 0; i < pieces->n; i++) {
+            memcpy(ptr, pieces->text[i], pieces->size[i]);
+            ptr += pieces->size[i];
+        }
+        md_parse(flat, (MD_SIZE)pieces->total, &parser, NULL);
+        free(flat);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    return best;
+}
+
+static double
+time_chunks(PIECES* pieces)
+{
+    MD_PARSE_CONTEXT* context = md_parse_context_create();
+    MD_CHUNK_ITERATOR iter = { next_piece, NULL };
+    MD_PARSER parser;
+    double best = -1.0;
+    int i;
+
+    init_noop_parser(&parser);
+    iter.iter_data = (void*)pieces;
+
+    for (i = 0; i < N_REPEATS; i++) {
+        double t = now();
+        pieces->iter = 0;
+        md_parse_chunks(context, &iter, &parser, NULL);
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    md_parse_context_destroy(context);
+    return best;
+}
+
+/* Snippets the tiny documents are assembled from. */
+static const char* tiny_snippets[] = {
+    "Short *note* with a [link](http://example.com).\n\n",
+    "# Heading\n\n",
+    "- item **one**\n- item `two`\n\n",
+    "> Quoted text &amp; more.\n\n",
+    "Plain sentence without any markup at all.\n\n",
+    "| a | b |\n|---|---|\n| 1 | 2 |\n\n",
+    "```\ncode\n```\n\n",
+    "Some _emphasis_ and ~~strike~~ text.\n\n"
+};
+
+/* Generates n documents into doc; document i spans from offsets[i] to
+ * offsets[i+1]. */
+static void
+gen_tiny_docs(DOC* doc, size_t* offsets, int n)
+{
+    unsigned rnd = 1;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        size_t target = 50 + (rnd = rnd * 1103515245 + 12345) % 451;
+
+        offsets[i] = doc->size;
+        while (doc->size - offsets[i] < target) {
+            rnd = rnd * 1103515245 + 12345;
+            doc_puts(doc, tiny_snippets[(rnd >> 16) % (sizeof(tiny_snippets) / sizeof(tiny_snippets[0]))]);
+        }
+    }
+    offsets[n] = doc->size;
+}
+
+static double
+time_tiny(const DOC* doc, const size_t* offsets, int n, MD_HTML_RENDERER* renderer)
+{
+    MD_HTML_BUFFER out = { NULL, 0, 0 };
+    double best = -1.0;
+    int i, j;
+
+    for (j = 0; j < N_REPEATS; j++) {
+        double t = now();
+        for (i = 0; i < n; i++) {
+            const char* text = doc->data + offsets[i];
+            MD_SIZE size = (MD_SIZE)(offsets[i + 1] - offsets[i]);
+
+            out.size = 0;
+            if (renderer != NULL)
+                md_html_renderer_render_buffer(renderer, text, size, &out);
+            else
+                md_html_buffer(text, size, &out, parser_flags, 0, NULL);
+        }
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    free(out.data);
+    return best;
+}
+
+static int
+run_tiny(int n)
+{
+    DOC doc = { NULL, 0, 0 };
+    size_t* offsets;
+    MD_HTML_RENDERER* renderer;
+    double t_html, t_renderer;
+
+    offsets = (size_t*)malloc((n + 1) * sizeof(size_t));
+    renderer = md_html_renderer_create(parser_flags, 0, NULL);
+    if (offsets == NULL || renderer == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        exit(2);
+    }
+    gen_tiny_docs(&doc, offsets, n);
+
+    t_html = time_tiny(&doc, offsets, n, NULL);
+    t_renderer = time_tiny(&doc, offsets, n, renderer);
+    printf("%d tiny documents, %lu B on average\n", n, (unsigned long)(doc.size / n));
+    printf("  md_html_buffer()      %8.3f us/doc  %8.1f MB/s\n",
+           t_html * 1e6 / n, (double)doc.size / t_html / (1024.0 * 1024.0));
+    printf("  MD_HTML_RENDERER      %8.3f us/doc  %8.1f MB/s\n",
+           t_renderer * 1e6 / n, (double)doc.size / t_renderer / (1024.0 * 1024.0));
+
+    md_html_renderer_destroy(renderer);
+    free(offsets);
+    free(doc.data);
+    return 0;
+}
+
+/* Returns 0 if the case is within the bound, 1 otherwise. */
+static int
+run_case(const CASE* c, double max_exponent)
+{
+    DOC doc = { NULL, 0, 0 };
+    double log_size[N_STEPS];
+    double log_time[N_STEPS];
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    double exponent;
+    double t;
+    int n = 16;
+    int i;
+
+    /* Calibrate. */
+    while (1) {
+        doc.size = 0;
+        c->generate(&doc, n);
+        t = time_parse(&doc);
+        if (t >= MIN_TIME || n >= (1 << 24))
+            break;
+        n *= 2;
+    }
+
+    printf("%-22s", c->name);
+    for (i = 0; i < N_STEPS; i++) {
+        if (i > 0) {
+            n *= 2;
+            doc.size = 0;
+            c->generate(&doc, n);
+            t = time_parse(&doc);
+        }
+        log_size[i] = log((double)doc.size);
+        log_time[i] = log(t > 1e-9 ? t : 1e-9);
+        printf(" %8.2f", t * 1e3);
+        fflush(stdout);
+
+        if ((t > MAX_TIME || doc.size > MAX_SIZE) && i < N_STEPS - 1) {
+            /* Too slow or too big to go on; use what we have. */
+            i++;
+            break;
+        }
+    }
+
+    for (n = 0; n < i; n++) {
+        sx += log_size[n];
+        sy += log_time[n];
+        sxx += log_size[n] * log_size[n];
+        sxy += log_size[n] * log_time[n];
+    }
+    if (i < 2)
+        exponent = 99.0;
+    else
+        exponent = (i * sxy - sx * sy) / (i * sxx - sx * sx);
+
+    printf("%*s  %5.2f  %s\n", 9 * (N_STEPS - i), "", exponent,
+           (exponent <= max_exponent ? "ok" : "SUPERLINEAR"));
+
+    free(doc.data);
+    return (exponent <= max_exponent ? 0 : 1);
+}
+
+static int
+run_file(const char* path, size_t piece_size)
+{
+    DOC doc = { NULL, 0, 0 };
+    DOC edited = { NULL, 0, 0 };
+    FILE* f;
+    char buf[65536];
+    size_t n, beg, end;
+    double t_parse, t_reparse, t_edit_reparse, t_html, t_text, t_html_strip;
+
+    f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "Cannot open %s.\n", path);
+        return 2;
+    }
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        doc_append(&doc, buf, n);
+    fclose(f);
+
+    t_parse = time_parse(&doc);
+    t_reparse = time_reparse(&doc);
+    t_html = time_html(&doc);
+    printf("%-40s %10lu B  parse %8.1f MB/s  reparse %8.1f MB/s  parse+html %8.1f MB/s\n", path,
+           (unsigned long)doc.size,
+           (double)doc.size / t_parse / (1024.0 * 1024.0),
+           (double)doc.size / t_reparse / (1024.0 * 1024.0),
+           (double)doc.size / t_html / (1024.0 * 1024.0));
+
+    /* The edit removes the line in the middle of the file. */
+    for (beg = doc.size / 2; beg > 0  &&  doc.data[beg - 1] != '\n'; beg--);
+    for (end = doc.size / 2; end < doc.size  &&  doc.data[end++] != '\n'; );
+    doc_edit(&edited, &doc, beg, end, "");
+
+    t_edit_reparse = time_edit_reparse(&doc, &edited);
+    t_text = time_text(&doc);
+    t_html_strip = time_html_strip(&doc);
+    printf("%-40s %10s    text %8.1f MB/s  html+strip %8.1f MB/s  edit+reparse %8.1f MB/s\n", "", "",
+           (double)doc.size / t_text / (1024.0 * 1024.0),
+           (double)doc.size / t_html_strip / (1024.0 * 1024.0),
+           (double)edited.size / t_edit_reparse / (1024.0 * 1024.0));
+
+    if (piece_size > 0  &&  doc.size > 0) {
+        PIECES pieces;
+        double t_flatten, t_chunks;
+
+        pieces_init(&pieces, &doc, piece_size);
+        t_flatten = time_flatten_parse(&pieces);
+        t_chunks = time_chunks(&pieces);
+        printf("%-40s %10lu pieces  flatten+parse %8.1f MB/s  chunks %8.1f MB/s\n", "",
+               (unsigned long)pieces.n,
+               (double)doc.size / t_flatten / (1024.0 * 1024.0),
+               (double)doc.size / t_chunks / (1024.0 * 1024.0));
+        pieces_fini(&pieces);
+    }
+
+    free(edited.data);
+    free(doc.data);
+    return 0;
+}
+
+
+/*******************************
+ ***  Ref. def. edit timing  ***
+ *******************************/
+
+/* Documents and edits for --ref-defs. Each edit is applied to a document of
+ * 'n' ref. defs (one per line, followed by the references). */
+static const CASE ref_def_docs[] = {
+    { "ascii",                  gen_ref_defs },
+    { "mixed-case",             gen_ref_defs_mixed },
+    { "unicode",                gen_ref_defs_unicode }
+};
+
+static void
+edit_text_before(DOC* dst, const DOC* src, int n)
+{
+    (void)n;
+    doc_edit(dst, src, 0, 0, "Intro.\n\n");
+}
+
+static void
+edit_remove_one(DOC* dst, const DOC* src, int n)
+{
+    doc_edit(dst, src, doc_line_offset(src, n / 2), doc_line_offset(src, n / 2 + 1), "");
+}
+
+static void
+edit_remove_block(DOC* dst, const DOC* src, int n)
+{
+    doc_edit(dst, src, doc_line_offset(src, n / 2), doc_line_offset(src, n / 2 + 100), "");
+}
+
+static void
+edit_add_one(DOC* dst, const DOC* src, int n)
+{
+    size_t off = doc_line_offset(src, n / 2);
+    doc_edit(dst, src, off, off, "[New Label]: /new\n");
+}
+
+typedef struct EDIT_tag EDIT;
+struct EDIT_tag {
+    const char* name;
+    void (*apply)(DOC* dst, const DOC* src, int n);
+};
+
+static const EDIT ref_def_edits[] = {
+    { "text-before",            edit_text_before },
+    { "1-removed",              edit_remove_one },
+    { "100-removed",            edit_remove_block },
+    { "1-added",                edit_add_one }
+};
+
+/* Returns 1 if rendering 'edited' with the context which has last seen 'doc'
+ * differs from rendering it from scratch. */
+static int
+check_edit_render(MD_HTML_RENDERER* renderer, const DOC* doc, const DOC* edited)
+{
+    MD_HTML_BUFFER reused = { NULL, 0, 0 };
+    MD_HTML_BUFFER fresh = { NULL, 0, 0 };
+    int differs;
+
+    md_html_renderer_render_buffer(renderer, doc->data, (MD_SIZE)doc->size, &reused);
+    reused.size = 0;
+    md_html_renderer_render_buffer(renderer, edited->data, (MD_SIZE)edited->size, &reused);
+    md_html_buffer(edited->data, (MD_SIZE)edited->size, &fresh, parser_flags, 0, NULL);
+    differs = (reused.size != fresh.size  ||  memcmp(reused.data, fresh.data, fresh.size) != 0);
+
+    free(reused.data);
+    free(fresh.data);
+    return differs;
+}
+
+static int
+run_ref_defs(void)
+{
+    static const int counts[] = { 10000, 100000 };
+    DOC doc = { NULL, 0, 0 };
+    DOC edited = { NULL, 0, 0 };
+    MD_HTML_RENDERER* renderer;
+    int ret = 0;
+    int i, j, k;
+
+    renderer = md_html_renderer_create(parser_flags, 0, NULL);
+    if (renderer == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        exit(2);
+    }
+
+    printf("%-12s %7s  %8s %8s", "ref-defs", "count", "parse", "reparse");
+    for (k = 0; k < (int)(sizeof(ref_def_edits) / sizeof(ref_def_edits[0])); k++)
+        printf(" %12s", ref_def_edits[k].name);
+    printf("  (ms)\n");
+
+    for (i = 0; i < (int)(sizeof(counts) / sizeof(counts[0])); i++) {
+        for (j = 0; j < (int)(sizeof(ref_def_docs) / sizeof(ref_def_docs[0])); j++) {
+            doc.size = 0;
+            ref_def_docs[j].generate(&doc, counts[i]);
+
+            printf("%-12s %7d  %8.2f %8.2f", ref_def_docs[j].name, counts[i],
+                   time_parse(&doc) * 1e3, time_reparse(&doc) * 1e3);
+            fflush(stdout);
+
+            for (k = 0; k < (int)(sizeof(ref_def_edits) / sizeof(ref_def_edits[0])); k++) {
+                ref_def_edits[k].apply(&edited, &doc, counts[i]);
+                printf(" %12.2f", time_edit_reparse(&doc, &edited) * 1e3);
+                if (check_edit_render(renderer, &doc, &edited) != 0) {
+                    printf(" MISMATCH");
+                    ret = 1;
+                }
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+    }
+
+    md_html_renderer_destroy(renderer);
+    free(edited.data);
+    free(doc.data);
+    return ret;
+}
+
+/**********************
+ ***  Limit checks  ***
+ **********************/
+
+/* Each check renders a document built to exceed one of MD_PARSE_LIMITS and
+ * verifies both the return value and what has made it into the output. */
+
+static int n_failed;
+
+static void
+check(int ok, const char* what)
+{
+    printf("  %-60s %s\n", what, (ok ? "ok" : "FAILED"));
+    if (!ok)
+        n_failed++;
+}
+
+/* Count of the occurrences of str in the buffer. */
+static int
+count_str(const MD_HTML_BUFFER* buf, const char* str)
+{
+    size_t len = strlen(str);
+    int n = 0;
+    MD_SIZE i;
+
+    for (i = 0; i + len <= buf->size; i++) {
+        if (memcmp(buf->data + i, str, len) == 0)
+            n++;
+    }
+    return n;
+}
+
+static int
+ends_with(const MD_HTML_BUFFER* buf, const char* str)
+{
+    size_t len = strlen(str);
+    return (buf->size >= len  &&  memcmp(buf->data + buf->size - len, str, len) == 0);
+}
+
+static int
+render_limited(const DOC* doc, const MD_PARSE_LIMITS* limits, MD_HTML_BUFFER* out)
+{
+    out->size = 0;
+    return md_html_buffer(doc->data, (MD_SIZE)doc->size, out, parser_flags, 0, limits);
+}
+
+static void
+collect_output(const MD_CHAR* text, MD_SIZE size, void* userdata)
+{
+    doc_append((DOC*)userdata, text, size);
+}
+
+static int
+run_limits(void)
+{
+    DOC doc = { NULL, 0, 0 };
+    DOC out_doc = { NULL, 0, 0 };
+    MD_HTML_BUFFER full = { NULL, 0, 0 };
+    MD_HTML_BUFFER out = { NULL, 0, 0 };
+    MD_PARSE_LIMITS limits;
+    MD_HTML_RENDERER* renderer;
+    int ret;
+
+    n_failed = 0;
+
+    printf("max_marks\n");
+    doc_repeat(&doc, "*a* ", 1000);
+    doc_puts(&doc, "\n\n*b*\n");
+    memset(&limits, 0, sizeof(limits));
+    limits.max_marks = 100;
+    ret = render_limited(&doc, &limits, &out);
+    check(ret == 0, "returns 0");
+    check(count_str(&out, "<em>") == 1, "only the small block has emphasis");
+    check(count_str(&out, "*a*") == 1000, "the big block is plain text");
+
+    printf("max_block_bytes\n");
+    doc.size = 0;
+    doc_repeat(&doc, "para\n\n", 10000);
+    render_limited(&doc, NULL, &full);
+    limits.max_marks = 0;
+    limits.max_block_bytes = 4096;
+    ret = render_limited(&doc, &limits, &out);
+    check(ret == MD_PARSE_LIMIT_EXCEEDED, "returns MD_PARSE_LIMIT_EXCEEDED");
+    check(out.size > 0  &&  out.size < full.size / 10, "renders only a part");
+    check(memcmp(out.data, full.data, out.size) == 0, "the part is a prefix of the full output");
+
+    printf("max_nesting\n");
+    doc.size = 0;
+    doc_repeat(&doc, "> ", 100);
+    doc_puts(&doc, "x\n");
+    limits.max_block_bytes = 0;
+    limits.max_nesting = 8;
+    ret = render_limited(&doc, &limits, &out);
+    check(ret == 0, "returns 0");
+    check(count_str(&out, "<blockquote>") == 8, "nests 8 block quotes");
+    check(count_str(&out, "</blockquote>") == 8, "closes all of them");
+
+    printf("max_time_ms\n");
+    doc.size = 0;
+    doc_repeat(&doc, "Some *text* with [a link](http://example.com).\n\n", 400000);
+    limits.max_nesting = 0;
+    limits.max_time_ms = 1;
+    ret = render_limited(&doc, &limits, &out);
+    check(ret == MD_PARSE_LIMIT_EXCEEDED, "returns MD_PARSE_LIMIT_EXCEEDED");
+    check(out.size < (MD_SIZE)doc.size, "renders only a part");
+    check(out.size == 0  ||  ends_with(&out, "</p>\n"), "ends with a whole block");
+
+    /* The limits reach md_parse() through every HTML entry point. */
+    printf("entry points\n");
+    doc.size = 0;
+    doc_repeat(&doc, "para\n\n", 10000);
+    memset(&limits, 0, sizeof(limits));
+    limits.max_block_bytes = 4096;
+    ret = md_html_ex(doc.data, (MD_SIZE)doc.size, collect_output, &out_doc, parser_flags, 0, &limits);
+    check(ret == MD_PARSE_LIMIT_EXCEEDED, "md_html_ex()");
+    ret = md_html(doc.data, (MD_SIZE)doc.size, collect_output, &out_doc, parser_flags, 0);
+    check(ret == 0, "md_html() has no limits");
+    ret = md_html_chunked(doc.data, (MD_SIZE)doc.size, collect_output, &out_doc, parser_flags, 0, &limits);
+    check(ret == MD_PARSE_LIMIT_EXCEEDED, "md_html_chunked()");
+    renderer = md_html_renderer_create(parser_flags, 0, &limits);
+    if (renderer == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        exit(2);
+    }
+    limits.max_block_bytes = 0;     /* The renderer has its own copy. */
+    out.size = 0;
+    ret = md_html_renderer_render_buffer(renderer, doc.data, (MD_SIZE)doc.size, &out);
+    check(ret == MD_PARSE_LIMIT_EXCEEDED, "md_html_renderer_render_buffer()");
+    md_html_renderer_destroy(renderer);
+
+    /* MD_PARSER::limits is only read with a non-zero abi_version. */
+    printf("abi_version\n");
+    {
+        MD_PARSER parser;
+
+        limits.max_block_bytes = 4096;
+        init_noop_parser(&parser);
+        parser.limits = &limits;
+        check(md_parse(doc.data, (MD_SIZE)doc.size, &parser, NULL) == 0, "0 ignores the limits");
+        parser.abi_version = MD_PARSER_ABI_VERSION;
+        check(md_parse(doc.data, (MD_SIZE)doc.size, &parser, NULL) == MD_PARSE_LIMIT_EXCEEDED,
+              "MD_PARSER_ABI_VERSION applies them");
+        parser.abi_version = MD_PARSER_ABI_VERSION + 1;
+        check(md_parse(doc.data, (MD_SIZE)doc.size, &parser, NULL) == -1, "a newer version is rejected");
+    }
+
+    free(full.data);
+    free(out.data);
+    free(out_doc.data);
+    free(doc.data);
+    printf("%d check(s) failed\n", n_failed);
+    return (n_failed == 0 ? 0 : 1);
+}
+
+/***************************
+ ***  SIMD verification  ***
+ **************************/
+
+#ifdef MD_HTML_USE_SSE2
+
+/* The scalar reference: Skips nothing, so the scalar loops do all the work. */
+static MD_OFFSET
+verify_skip_none(const MD_CHAR* data, MD_OFFSET off, MD_SIZE size)
+{
+    (void)data; (void)size;
+    return off;
+}
+
+typedef struct SKIP_VARIANT_tag SKIP_VARIANT;
+struct SKIP_VARIANT_tag {
+    const char* name;
+    MD_OFFSET (*skip_html_safe)(const MD_CHAR*, MD_OFFSET, MD_SIZE);
+    MD_OFFSET (*skip_url_safe)(const MD_CHAR*, MD_OFFSET, MD_SIZE);
+};
+
+/* Renders the data with the given escaping function and skip variant into
+ * out (from its start). */
+static void
+verify_render(void (*render)(MD_HTML*, const MD_CHAR*, MD_SIZE), const SKIP_VARIANT* variant,
+    const MD_CHAR* data, MD_SIZE size, MD_HTML_BUFFER* out)
+{
+    MD_HTML r;
+
+    memset(&r, 0, sizeof(MD_HTML));
+    r.skip_html_safe = variant->skip_html_safe;
+    r.skip_url_safe = variant->skip_url_safe;
+    r.out = out->data;
+    r.out_size = 0;
+    r.out_capacity = out->capacity;
+    r.out_buffer = out;
+    render(&r, data, size);
+    out->size = r.out_size;
+}
+
+/* Checks the contract of a skip function from every start offset: It may
+ * only skip chars which need no escaping, and it must stop either at the
+ * first one which does, or where less than 16 chars remain. */
+static int
+verify_skip(MD_OFFSET (*skip)(const MD_CHAR*, MD_OFFSET, MD_SIZE), int esc_flag,
+    const MD_CHAR* data, MD_SIZE size)
+{
+    MD_OFFSET off, end, i;
+
+    for (off = 0; off <= size; off++) {
+        end = skip(data, off, size);
+        if (end < off  ||  end > size)
+            return 1;
+        for (i = off; i < end; i++) {
+            if (escape_map[(unsigned char)data[i]] & esc_flag)
+                return 1;
+        }
+        if (size - end >= 16  &&  !(escape_map[(unsigned char)data[end]] & esc_flag))
+            return 1;
+    }
+    return 0;
+}
+
+#define VERIFY_MAX_SIZE     160
+#define VERIFY_ALIGNMENTS   64
+#define VERIFY_ROUNDS       20
+
+static int
+run_verify(void)
+{
+    SKIP_VARIANT variants[3];
+    int n_variants = 0;
+    /* The buffer is aligned to VERIFY_ALIGNMENTS by hand, so each alignment
+     * below is relative to any vector size. */
+    static MD_CHAR storage[2 * VERIFY_ALIGNMENTS + VERIFY_MAX_SIZE];
+    MD_CHAR* base = storage + (VERIFY_ALIGNMENTS - (size_t)storage % VERIFY_ALIGNMENTS);
+    MD_HTML_BUFFER expected = { NULL, 0, 0 };
+    MD_HTML_BUFFER got = { NULL, 0, 0 };
+    unsigned rnd = 1;
+    unsigned long n_checked = 0;
+    int n_failures = 0;
+    int size, align, round, density, v, fn;
+
+    variants[n_variants].name = "scalar";
+    variants[n_variants].skip_html_safe = verify_skip_none;
+    variants[n_variants].skip_url_safe = verify_skip_none;
+    n_variants++;
+    variants[n_variants].name = "sse2";
+    variants[n_variants].skip_html_safe = skip_html_safe_sse2;
+    variants[n_variants].skip_url_safe = skip_url_safe_sse2;
+    n_variants++;
+#ifdef MD_HTML_USE_AVX2
+    if (md_html_cpu_has_avx2()) {
+        variants[n_variants].name = "avx2";
+        variants[n_variants].skip_html_safe = skip_html_safe_avx2;
+        variants[n_variants].skip_url_safe = skip_url_safe_avx2;
+        n_variants++;
+    }
+#endif
+
+    printf("Variants:");
+    for (v = 0; v < n_variants; v++)
+        printf(" %s", variants[v].name);
+    printf("\n");
+
+    for (size = 0; size <= VERIFY_MAX_SIZE; size++) {
+        for (align = 0; align < VERIFY_ALIGNMENTS; align++) {
+            for (round = 0; round < VERIFY_ROUNDS; round++) {
+                MD_CHAR* data = base + align;
+                int i;
+
+                /* Vary the density of the chars to escape: None at all, a
+                 * few, or most of them. */
+                density = (round % 4 == 0 ? 0 : 1 << (2 * (round % 4)));
+                for (i = 0; i < size; i++) {
+                    rnd = rnd * 1103515245 + 12345;
+                    if (density > 0  &&  (rnd >> 16) % (unsigned)density == 0) {
+                        rnd = rnd * 1103515245 + 12345;
+                        /* A char special in HTML (including the terminating
+                         * '\0' of the literal), or any byte at all. */
+                        data[i] = (rnd & 0x100) ? "\"&<>"[(rnd >> 16) % 5] : (MD_CHAR)(rnd >> 16);
+                    } else {
+                        rnd = rnd * 1103515245 + 12345;
+                        data[i] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"[(rnd >> 16) % 62];
+                    }
+                }
+
+                for (fn = 0; fn < 2; fn++) {
+                    void (*render)(MD_HTML*, const MD_CHAR*, MD_SIZE) =
+                            (fn == 0 ? render_html_escaped : render_url_escaped);
+
+                    verify_render(render, &variants[0], data, (MD_SIZE)size, &expected);
+                    for (v = 1; v < n_variants; v++) {
+                        int failed;
+
+                        verify_render(render, &variants[v], data, (MD_SIZE)size, &got);
+                        failed = (got.size != expected.size  ||
+                                  memcmp(got.data, expected.data, expected.size) != 0);
+                        failed |= verify_skip((fn == 0 ? variants[v].skip_html_safe : variants[v].skip_url_safe),
+                                              (fn == 0 ? NEED_HTML_ESC_FLAG : NEED_URL_ESC_FLAG),
+                                              data, (MD_SIZE)size);
+                        if (failed) {
+                            if (n_failures++ < 10) {
+                                printf("  %s %s differs from scalar: size %d, alignment %d, round %d\n",
+                                       variants[v].name, (fn == 0 ? "render_html_escaped()" : "render_url_escaped()"),
+                                       size, align, round);
+                            }
+                        }
+                        n_checked++;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%lu buffers checked, %d failure(s)\n", n_checked, n_failures);
+    free(expected.data);
+    free(got.data);
+    return (n_failures == 0 ? 0 : 1);
+}
+
+#else
+
+static int
+run_verify(void)
+{
+    printf("Built without the SIMD escaping (MD4C_HTML_NO_SIMD); nothing to verify.\n");
+    return 0;
+}
+
+#endif  /* MD_HTML_USE_SSE2 */
+
+/****************************
+ ***  Event stream checks  ***
+ ****************************/
+
+/* Record layout, as described in md4c-stream.c. */
+#define STREAM_HEADER_SIZE      6
+#define STREAM_REC_DETAIL       0x00000020
+#define STREAM_REC(event_type, type, flags)  ((unsigned)(event_type) | (unsigned)(flags) | ((unsigned)(type) << 8))
+
+#define ENTER_BLOCK(type)       STREAM_REC(MD_STREAM_ENTER_BLOCK, type, 0)
+#define LEAVE_BLOCK(type)       STREAM_REC(MD_STREAM_LEAVE_BLOCK, type, 0)
+#define ENTER_DETAIL(type)      STREAM_REC(MD_STREAM_ENTER_BLOCK, type, STREAM_REC_DETAIL)
+#define LEAVE_DETAIL(type)      STREAM_REC(MD_STREAM_LEAVE_BLOCK, type, STREAM_REC_DETAIL)
+#define ENTER_SPAN(type)        STREAM_REC(MD_STREAM_ENTER_SPAN, type, 0)
+#define LEAVE_SPAN(type)        STREAM_REC(MD_STREAM_LEAVE_SPAN, type, 0)
+#define TEXT_X                  STREAM_REC(MD_STREAM_TEXT, MD_TEXT_NORMAL, 0), 1, 0
+
+/* Records of the hand-built streams, terminated by STREAM_END. */
+#define STREAM_END              0xffffffffU
+
+typedef struct STREAM_CASE {
+    const char* name;
+    int is_valid;
+    unsigned records[16];
+} STREAM_CASE;
+
+static const STREAM_CASE stream_cases[] = {
+    { "well-formed paragraph", 1,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_P), TEXT_X,
+        LEAVE_BLOCK(MD_BLOCK_P), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "well-formed heading", 1,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_DETAIL(MD_BLOCK_H), 6, TEXT_X,
+        LEAVE_DETAIL(MD_BLOCK_H), 6, LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "OL without detail", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_OL),
+        LEAVE_BLOCK(MD_BLOCK_OL), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "H without detail", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_H), TEXT_X,
+        LEAVE_BLOCK(MD_BLOCK_H), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "IMG without detail", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_P), ENTER_SPAN(MD_SPAN_IMG),
+        LEAVE_SPAN(MD_SPAN_IMG), LEAVE_BLOCK(MD_BLOCK_P), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "H level 1000", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_DETAIL(MD_BLOCK_H), 1000, TEXT_X,
+        LEAVE_DETAIL(MD_BLOCK_H), 1000, LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "H level 0", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_DETAIL(MD_BLOCK_H), 0, TEXT_X,
+        LEAVE_DETAIL(MD_BLOCK_H), 0, LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "TD align 99", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_DETAIL(MD_BLOCK_TD), 99,
+        LEAVE_DETAIL(MD_BLOCK_TD), 99, LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "block type out of range", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(200),
+        LEAVE_BLOCK(200), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "leave without enter", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), LEAVE_BLOCK(MD_BLOCK_P),
+        LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "leave of another type", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_P), TEXT_X,
+        LEAVE_BLOCK(MD_BLOCK_QUOTE), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "span left as block", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_P), ENTER_SPAN(MD_SPAN_EM),
+        LEAVE_BLOCK(MD_SPAN_EM), LEAVE_BLOCK(MD_BLOCK_P), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "missing leave of DOC", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_P), TEXT_X,
+        LEAVE_BLOCK(MD_BLOCK_P), STREAM_END } },
+    { "block inside span", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_P), ENTER_SPAN(MD_SPAN_EM),
+        ENTER_BLOCK(MD_BLOCK_QUOTE), LEAVE_BLOCK(MD_BLOCK_QUOTE), LEAVE_SPAN(MD_SPAN_EM),
+        LEAVE_BLOCK(MD_BLOCK_P), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "text outside DOC", 0,
+      { TEXT_X, ENTER_BLOCK(MD_BLOCK_DOC), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "records after DOC", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), LEAVE_BLOCK(MD_BLOCK_DOC),
+        ENTER_BLOCK(MD_BLOCK_DOC), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } },
+    { "nested DOC", 0,
+      { ENTER_BLOCK(MD_BLOCK_DOC), ENTER_BLOCK(MD_BLOCK_DOC),
+        LEAVE_BLOCK(MD_BLOCK_DOC), LEAVE_BLOCK(MD_BLOCK_DOC), STREAM_END } }
+};
+
+/* Replay the stream into the HTML renderer, as an editor would do with a
+ * cached parse. */
+static int
+replay_html(const MD_STREAM* stream, const MD_CHAR* text, MD_HTML_BUFFER* out)
+{
+    MD_HTML render;
+    MD_PARSER parser;
+    int ret;
+
+    out->size = 0;
+    memset(&render, 0, sizeof(MD_HTML));
+    render.out = out->data;
+    render.out_size = out->size;
+    render.out_capacity = out->capacity;
+    render.out_buffer = out;
+
+    md_html_init(&render);
+    md_html_init_parser(&parser, md_stream_parser_flags(stream), NULL);
+    parser.debug_log = NULL;
+    ret = md_stream_replay(stream, text, &parser, &render);
+
+    out->size = render.out_size;
+    return ret;
+}
+
+static int
+run_stream(void)
+{
+    static const char doc_text[] =
+        "# Head\n\n"
+        "1. one\n"
+        "2. [x] two\n\n"
+        "| a | b |\n"
+        "|---|:-:|\n"
+        "| c | *d* |\n\n"
+        "[link](http://x \"t\") ![i](y) `code`\n\n"
+        "```c\nint x;\n```\n";
+    MD_STREAM recorded = { NULL, 0, 0 };
+    MD_STREAM stream = { NULL, 0, 0 };
+    MD_HTML_BUFFER out = { NULL, 0, 0 };
+    MD_HTML_BUFFER expected = { NULL, 0, 0 };
+    MD_SIZE doc_size = (MD_SIZE)strlen(doc_text);
+    char what[128];
+    size_t i, n;
+
+    n_failed = 0;
+
+    printf("recorded document:\n");
+    if (md_stream_record(NULL, doc_text, doc_size, parser_flags | MD_FLAG_TASKLISTS, &recorded) != 0) {
+        fprintf(stderr, "md_stream_record() failed.\n");
+        return 2;
+    }
+    check(md_stream_check(&recorded, doc_text, doc_size) == 0, "md_stream_check() accepts it");
+    check(md_stream_check(&recorded, doc_text, doc_size - 1) == -1, "md_stream_check() rejects other text");
+    md_html_buffer(doc_text, doc_size, &expected, parser_flags | MD_FLAG_TASKLISTS, 0, NULL);
+    check(replay_html(&recorded, doc_text, &out) == 0  &&  out.size == expected.size  &&
+          memcmp(out.data, expected.data, out.size) == 0, "replay renders the same HTML as md_html_buffer()");
+
+    printf("hand-built streams:\n");
+    stream.capacity = STREAM_HEADER_SIZE + 16;
+    stream.data = (unsigned*)malloc(stream.capacity * sizeof(unsigned));
+    if (stream.data == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        return 2;
+    }
+    for (i = 0; i < sizeof(stream_cases) / sizeof(stream_cases[0]); i++) {
+        const STREAM_CASE* c = &stream_cases[i];
+        int expected_ret = (c->is_valid ? 0 : -1);
+
+        /* The header of the recording matches the text; only the records
+         * are replaced. TEXT_X refers to the first character of the text. */
+        memcpy(stream.data, recorded.data, STREAM_HEADER_SIZE * sizeof(unsigned));
+        for (n = 0; c->records[n] != STREAM_END; n++)
+            stream.data[STREAM_HEADER_SIZE + n] = c->records[n];
+        stream.size = STREAM_HEADER_SIZE + (MD_SIZE)n;
+
+        snprintf(what, sizeof(what), "%s: md_stream_check()", c->name);
+        check(md_stream_check(&stream, doc_text, doc_size) == expected_ret, what);
+        snprintf(what, sizeof(what), "%s: md_stream_replay()", c->name);
+        check(replay_html(&stream, doc_text, &out) == expected_ret, what);
+    }
+
+    printf("%d failure(s)\n", n_failed);
+    free(recorded.data);
+    free(stream.data);
+    free(out.data);
+    free(expected.data);
+    return (n_failed == 0 ? 0 : 1);
+}
+
+
+/**********************
+ ***  Main program  ***
+ **********************/
+
+static void
+usage(void)
+{
+    printf("Usage: md4c_bench [--case NAME] [--list] [--max-exponent X] [--commonmark] [--pieces SIZE] [--tiny COUNT] [--ref-defs] [--limits] [--verify] [--stream] [FILE]...\n");
+}
+
+int
+main(int argc, char** argv)
+{
+    const char* case_name = NULL;
+    double max_exponent = 1.3;
+    size_t piece_size = 0;
+    int tiny_count = 0;
+    int limits = 0;
+    int ref_defs = 0;
+    int verify = 0;
+    int stream = 0;
+    int n_files = 0;
+    int ret = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--case") == 0 && i + 1 < argc) {
+            case_name = argv[++i];
+        } else if (strcmp(argv[i], "--max-exponent") == 0 && i + 1 < argc) {
+            max_exponent = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--pieces") == 0 && i + 1 < argc) {
+            piece_size = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "--tiny") == 0 && i + 1 < argc) {
+            tiny_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--commonmark") == 0) {
+            parser_flags = MD_DIALECT_COMMONMARK;
+        } else if (strcmp(argv[i], "--limits") == 0) {
+            limits = 1;
+        } else if (strcmp(argv[i], "--ref-defs") == 0) {
+            ref_defs = 1;
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = 1;
+        } else if (strcmp(argv[i], "--list") == 0) {
+            for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++)
+                printf("%s\n", cases[i].name);
+            return 0;
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            n_files++;
+        }
+    }
+
+    if (tiny_count > 0)
+        return run_tiny(tiny_count);
+    if (limits)
+        return run_limits();
+    if (ref_defs)
+        return run_ref_defs();
+    if (verify)
+        return run_verify();
+    if (stream)
+        return run_stream();
+
+    if (n_files > 0) {
+        for (i = 1; i < argc; i++) {
+            if (argv[i][0] == '-') {
+                if (strcmp(argv[i], "--commonmark") != 0)
+                    i++;
+                continue;
+            }
+            if (run_file(argv[i], piece_size) != 0)
+                ret = 2;
+        }
+        return ret;
+    }
+
+    printf("%-22s", "case");
+    for (i = 0; i < N_STEPS; i++)
+        printf("   ms(%dx)", 1 << i);
+    printf("  slope\n");
+
+    for (i = 0; i < (int)(sizeof(cases) / sizeof(cases[0])); i++) {
+        if (case_name != NULL && strcmp(case_name, cases[i].name) != 0)
+            continue;
+        if (run_case(&cases[i], max_exponent) != 0)
+            ret = 1;
+    }
+    return ret;
+}
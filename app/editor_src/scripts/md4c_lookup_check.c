@@ -0,0 +1,578 @@
+/*
+ * Equivalence checks and a microbenchmark of the perfect hash lookups: Of the
+ * entities in entity_lookup() and of the tags which start an HTML block of
+ * type 6 in md4c.c.
+ *
+ * Build (from app/editor_src):
+ *   cc -O2 -I. -o md4c_lookup_check scripts/md4c_lookup_check.c md4c.c -lpthread
+ *   cl /O2 /I. scripts\md4c_lookup_check.c md4c.c
+ *
+ * (entity.c is not listed: It is compiled as a part of this file, so the
+ * checks can reach ENTITY_MAP[].)
+ *
+ * Usage:
+ *   md4c_lookup_check
+ *
+ * The reference for entity_lookup() is the bsearch() over ENTITY_MAP[] it has
+ * replaced. Both must return the same record for every entity name, for
+ * variants of the names (case flipped, truncated, altered) and for 1M random
+ * ';'-terminated keys. Both are then timed on the names and on the random
+ * keys.
+ *
+ * The tags are checked through md_parse(): A line starting with "<tag" right
+ * after a paragraph line starts an HTML block only if the tag is of type 6
+ * (type 7 cannot interrupt a paragraph). For every listed tag name, its case
+ * variants, prefixes and extensions, opening and closing, and followed by
+ * every kind of char which may end the name, this must agree with the
+ * CommonMark rule: An exact case-insensitive match of a listed name. The
+ * former walk of per-letter lists is run as well. It stopped at the first
+ * listed prefix of the name, so it must differ exactly for the tags shadowed
+ * by such a prefix.
+ *
+ * The exit code is 0 if all the checks pass, 1 otherwise.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "md4c.h"
+
+/* Compiled in rather than linked, so the checks can reach ENTITY_MAP[]. */
+#include "entity.c"
+
+
+#define N_RANDOM_KEYS       (1024 * 1024)
+#define N_BENCH_ROUNDS      50
+
+static int n_failed;
+
+static double
+now(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, t;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static unsigned rnd_state = 1;
+
+static unsigned
+rnd(void)
+{
+    rnd_state = rnd_state * 1103515245 + 12345;
+    return rnd_state >> 16;
+}
+
+
+/******************
+ ***  Entities  ***
+ ******************/
+
+/* The former entity_lookup(). */
+typedef struct OLD_ENTITY_KEY_tag OLD_ENTITY_KEY;
+struct OLD_ENTITY_KEY_tag {
+    const char* name;
+    size_t name_size;
+};
+
+static int
+old_entity_cmp(const void* p_key, const void* p_entity)
+{
+    OLD_ENTITY_KEY* key = (OLD_ENTITY_KEY*)p_key;
+    ENTITY* ent = (ENTITY*)p_entity;
+
+    return strncmp(key->name, ent->name, key->name_size);
+}
+
+static const ENTITY*
+old_entity_lookup(const char* name, size_t name_size)
+{
+    OLD_ENTITY_KEY key = { name, name_size };
+
+    return bsearch(&key,
+        ENTITY_MAP,
+        sizeof(ENTITY_MAP) / sizeof(ENTITY_MAP[0]),
+        sizeof(ENTITY),
+        old_entity_cmp);
+}
+
+#define N_ENTITIES      ((int)(sizeof(ENTITY_MAP) / sizeof(ENTITY_MAP[0])))
+
+/* A key in the form of "&name;" as md4c passes it. */
+typedef struct KEY_tag KEY;
+struct KEY_tag {
+    char name[40];
+    size_t size;
+};
+
+static int n_entity_keys;
+static int n_entity_mismatches;
+
+static void
+check_entity_key(const char* name, size_t size)
+{
+    const ENTITY* expected = old_entity_lookup(name, size);
+    const ENTITY* got = entity_lookup(name, size);
+
+    n_entity_keys++;
+    if (got != expected) {
+        if (n_entity_mismatches++ < 10) {
+            printf("  %.*s: %s instead of %s\n", (int)size, name,
+                   (got != NULL ? got->name : "NULL"),
+                   (expected != NULL ? expected->name : "NULL"));
+        }
+    }
+}
+
+static void
+check_entities(KEY* random_keys)
+{
+    KEY key;
+    size_t len;
+    int i, j;
+
+    printf("entity_lookup() vs. bsearch() of ENTITY_MAP[]\n");
+
+    for (i = 0; i < N_ENTITIES; i++) {
+        const char* name = ENTITY_MAP[i].name;
+
+        len = strlen(name);
+        check_entity_key(name, len);
+
+        /* Variants: Each inner char case-flipped or altered, and the name
+         * truncated (still ';'-terminated). */
+        for (j = 1; j + 1 < (int)len; j++) {
+            memcpy(key.name, name, len);
+            if (isalpha((unsigned char)name[j])) {
+                key.name[j] = (char)(islower((unsigned char)name[j]) ? toupper((unsigned char)name[j])
+                                                                    : tolower((unsigned char)name[j]));
+                check_entity_key(key.name, len);
+            }
+            key.name[j] = (char)(name[j] + 1);
+            check_entity_key(key.name, len);
+
+            memcpy(key.name, name, j);
+            key.name[j] = ';';
+            check_entity_key(key.name, j + 1);
+        }
+    }
+
+    for (i = 0; i < N_RANDOM_KEYS; i++)
+        check_entity_key(random_keys[i].name, random_keys[i].size);
+
+    printf("  %d keys, %d mismatch(es)\n", n_entity_keys, n_entity_mismatches);
+    if (n_entity_mismatches > 0)
+        n_failed++;
+}
+
+static void
+gen_random_keys(KEY* keys, int n)
+{
+    static const char chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    int i, j;
+
+    for (i = 0; i < n; i++) {
+        int len = 1 + rnd() % 12;
+
+        keys[i].name[0] = '&';
+        for (j = 1; j <= len; j++)
+            keys[i].name[j] = chars[rnd() % (sizeof(chars) - 1)];
+        keys[i].name[len + 1] = ';';
+        keys[i].size = len + 2;
+    }
+}
+
+static double
+time_entity_lookups(const ENTITY* (*lookup)(const char*, size_t), const KEY* keys, int n, int* p_n_found)
+{
+    double best = -1.0;
+    int n_found = 0;
+    int round, i;
+
+    for (round = 0; round < 5; round++) {
+        double t = now();
+
+        n_found = 0;
+        for (i = 0; i < n; i++) {
+            if (lookup(keys[i].name, keys[i].size) != NULL)
+                n_found++;
+        }
+        t = now() - t;
+        if (best < 0.0 || t < best)
+            best = t;
+    }
+    *p_n_found = n_found;
+    return best;
+}
+
+static void
+bench_entities(const KEY* random_keys)
+{
+    KEY* names;
+    int n = N_ENTITIES * N_BENCH_ROUNDS;
+    int n_found;
+    int i;
+    double t;
+
+    /* The names in a shuffled order, as a document would use them. */
+    names = (KEY*)malloc(n * sizeof(KEY));
+    if (names == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        exit(2);
+    }
+    for (i = 0; i < n; i++) {
+        const char* name = ENTITY_MAP[rnd() % N_ENTITIES].name;
+
+        names[i].size = strlen(name);
+        memcpy(names[i].name, name, names[i].size);
+    }
+
+    printf("entity lookup timing (ns per lookup)\n");
+    printf("  %-24s %10s %10s\n", "", "bsearch()", "hash");
+    t = time_entity_lookups(old_entity_lookup, names, n, &n_found);
+    printf("  %-24s %10.1f", "names (all found)", t * 1e9 / n);
+    t = time_entity_lookups(entity_lookup, names, n, &n_found);
+    printf(" %10.1f\n", t * 1e9 / n);
+    t = time_entity_lookups(old_entity_lookup, random_keys, N_RANDOM_KEYS, &n_found);
+    printf("  %-24s %10.1f", "random keys", t * 1e9 / N_RANDOM_KEYS);
+    t = time_entity_lookups(entity_lookup, random_keys, N_RANDOM_KEYS, &n_found);
+    printf(" %10.1f  (%d found)\n", t * 1e9 / N_RANDOM_KEYS, n_found);
+
+    free(names);
+}
+
+
+/**************
+ ***  Tags  ***
+ **************/
+
+/* The former per-letter lists of the tags starting HTML block of type 6. */
+typedef struct OLD_TAG_tag OLD_TAG;
+struct OLD_TAG_tag {
+    const char* name;
+    unsigned len;
+};
+
+#define X(name)     { name, sizeof(name) - 1 }
+#define Xend        { NULL, 0 }
+
+static const OLD_TAG a6[] = { X("address"), X("article"), X("aside"), Xend };
+static const OLD_TAG b6[] = { X("base"), X("basefont"), X("blockquote"), X("body"), Xend };
+static const OLD_TAG c6[] = { X("caption"), X("center"), X("col"), X("colgroup"), Xend };
+static const OLD_TAG d6[] = { X("dd"), X("details"), X("dialog"), X("dir"),
+                              X("div"), X("dl"), X("dt"), Xend };
+static const OLD_TAG f6[] = { X("fieldset"), X("figcaption"), X("figure"), X("footer"),
+                              X("form"), X("frame"), X("frameset"), Xend };
+static const OLD_TAG h6[] = { X("h1"), X("h2"), X("h3"), X("h4"), X("h5"), X("h6"),
+                              X("head"), X("header"), X("hr"), X("html"), Xend };
+static const OLD_TAG i6[] = { X("iframe"), Xend };
+static const OLD_TAG l6[] = { X("legend"), X("li"), X("link"), Xend };
+static const OLD_TAG m6[] = { X("main"), X("menu"), X("menuitem"), Xend };
+static const OLD_TAG n6[] = { X("nav"), X("noframes"), Xend };
+static const OLD_TAG o6[] = { X("ol"), X("optgroup"), X("option"), Xend };
+static const OLD_TAG p6[] = { X("p"), X("param"), Xend };
+static const OLD_TAG s6[] = { X("search"), X("section"), X("summary"), Xend };
+static const OLD_TAG t6[] = { X("table"), X("tbody"), X("td"), X("tfoot"), X("th"),
+                              X("thead"), X("title"), X("tr"), X("track"), Xend };
+static const OLD_TAG u6[] = { X("ul"), Xend };
+static const OLD_TAG xx[] = { Xend };
+
+static const OLD_TAG* map6[26] = {
+    a6, b6, c6, d6, xx, f6, xx, h6, i6, xx, xx, l6, m6,
+    n6, o6, p6, xx, xx, s6, t6, u6, xx, xx, xx, xx, xx
+};
+
+#undef X
+#undef Xend
+
+/* Type 1 tags take precedence; they are left out of the checks. */
+static const char* t1_names[] = { "pre", "script", "style", "textarea" };
+
+/* The tags shadowed by a listed prefix in the former walk. */
+static const char* shadowed_names[] = {
+    "basefont", "colgroup", "frameset", "header", "link",
+    "menuitem", "param", "thead", "track"
+};
+
+/* What may follow the tag name (the empty string is the end of document). */
+static const char* tag_contexts[] = { "", " ", "\t", "\n", ">", "/>", "/", "-", "=" };
+
+static int
+is_tag_delimited(const char* s, size_t size)
+{
+    if (size == 0)
+        return 1;
+    if (s[0] == ' ' || s[0] == '\t' || s[0] == '\n' || s[0] == '\r' || s[0] == '>')
+        return 1;
+    return (size >= 2 && s[0] == '/' && s[1] == '>');
+}
+
+static int
+case_eq(const char* a, const char* b, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i]))
+            return 0;
+    }
+    return 1;
+}
+
+/* The former check of the type 6 start, on s[] following the '<'. */
+static int
+old_is_type6(const char* s, size_t size)
+{
+    const OLD_TAG* tags;
+    size_t off = 0;
+    int i;
+
+    if (!(off + 1 < size && (isalpha((unsigned char)s[off]) ||
+                             (s[off] == '/' && isalpha((unsigned char)s[off + 1])))))
+        return 0;
+    if (s[off] == '/')
+        off++;
+
+    tags = map6[tolower((unsigned char)s[off]) - 'a'];
+    for (i = 0; tags[i].name != NULL; i++) {
+        if (off + tags[i].len <= size  &&  case_eq(s + off, tags[i].name, tags[i].len))
+            return is_tag_delimited(s + off + tags[i].len, size - off - tags[i].len);
+    }
+    return 0;
+}
+
+/* The CommonMark rule: The whole tag name is one of the listed names. */
+static int
+ref_is_type6(const char* s, size_t size)
+{
+    size_t off = 0;
+    size_t len = 0;
+    int i, j;
+
+    if (!(off + 1 < size && (isalpha((unsigned char)s[off]) ||
+                             (s[off] == '/' && isalpha((unsigned char)s[off + 1])))))
+        return 0;
+    if (s[off] == '/')
+        off++;
+
+    while (off + len < size && isalnum((unsigned char)s[off + len]))
+        len++;
+
+    for (i = 0; i < 26; i++) {
+        for (j = 0; map6[i][j].name != NULL; j++) {
+            if (map6[i][j].len == len  &&  case_eq(s + off, map6[i][j].name, len))
+                return is_tag_delimited(s + off + len, size - off - len);
+        }
+    }
+    return 0;
+}
+
+static int html_block_seen;
+
+static int
+tag_enter_block(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    (void)detail; (void)userdata;
+    if (type == MD_BLOCK_HTML)
+        html_block_seen = 1;
+    return 0;
+}
+
+static int
+tag_leave_block(MD_BLOCKTYPE type, void* detail, void* userdata)
+{
+    (void)type; (void)detail; (void)userdata;
+    return 0;
+}
+
+static int
+tag_span(MD_SPANTYPE type, void* detail, void* userdata)
+{
+    (void)type; (void)detail; (void)userdata;
+    return 0;
+}
+
+static int
+tag_text(MD_TEXTTYPE type, const MD_CHAR* text, MD_SIZE size, void* userdata)
+{
+    (void)type; (void)text; (void)size; (void)userdata;
+    return 0;
+}
+
+/* Whether md4c lets the tag (the document text after '<') interrupt a
+ * paragraph, i.e. whether it starts an HTML block of type 6. */
+static int
+md4c_is_type6(const char* s, size_t size)
+{
+    MD_PARSER parser;
+    char doc[64];
+
+    memset(&parser, 0, sizeof(MD_PARSER));
+    parser.flags = MD_DIALECT_GITHUB;
+    parser.enter_block = tag_enter_block;
+    parser.leave_block = tag_leave_block;
+    parser.enter_span = tag_span;
+    parser.leave_span = tag_span;
+    parser.text = tag_text;
+
+    memcpy(doc, "para\n<", 6);
+    memcpy(doc + 6, s, size);
+    html_block_seen = 0;
+    md_parse(doc, (MD_SIZE)(6 + size), &parser, NULL);
+    return html_block_seen;
+}
+
+static int n_tag_inputs;
+static int n_tag_mismatches;
+static char shadowed_seen[sizeof(shadowed_names) / sizeof(shadowed_names[0])];
+static int n_unexpected_shadowed;
+
+static void
+check_tag(const char* name, size_t len, int closing)
+{
+    char s[40];
+    size_t i, size;
+    int c;
+
+    for (i = 0; i < sizeof(t1_names) / sizeof(t1_names[0]); i++) {
+        if (strlen(t1_names[i]) == len  &&  case_eq(name, t1_names[i], len))
+            return;
+    }
+
+    for (c = 0; c < (int)(sizeof(tag_contexts) / sizeof(tag_contexts[0])); c++) {
+        int ref, got, old;
+
+        size = 0;
+        if (closing)
+            s[size++] = '/';
+        memcpy(s + size, name, len);
+        size += len;
+        memcpy(s + size, tag_contexts[c], strlen(tag_contexts[c]));
+        size += strlen(tag_contexts[c]);
+
+        ref = ref_is_type6(s, size);
+        got = md4c_is_type6(s, size);
+        old = old_is_type6(s, size);
+        n_tag_inputs++;
+
+        if (got != ref) {
+            if (n_tag_mismatches++ < 10)
+                printf("  <%.*s: md4c %d, CommonMark %d\n", (int)size, s, got, ref);
+        }
+        if (old != ref) {
+            int known = 0;
+
+            for (i = 0; i < sizeof(shadowed_names) / sizeof(shadowed_names[0]); i++) {
+                if (strlen(shadowed_names[i]) == len  &&  case_eq(name, shadowed_names[i], len)) {
+                    shadowed_seen[i] = 1;
+                    known = 1;
+                }
+            }
+            if (!known) {
+                if (n_unexpected_shadowed++ < 10)
+                    printf("  <%.*s: the former walk differs unexpectedly\n", (int)size, s);
+            }
+        }
+    }
+}
+
+static void
+check_tags(void)
+{
+    char name[40];
+    size_t len, k;
+    int i, j, closing;
+
+    printf("type 6 tags vs. CommonMark (and the former walk)\n");
+
+    for (i = 0; i < 26; i++) {
+        for (j = 0; map6[i][j].name != NULL; j++) {
+            const OLD_TAG* tag = &map6[i][j];
+
+            len = tag->len;
+            for (closing = 0; closing < 2; closing++) {
+                /* As listed, upper case, and capitalized. */
+                memcpy(name, tag->name, len);
+                check_tag(name, len, closing);
+                for (k = 0; k < len; k++)
+                    name[k] = (char)toupper((unsigned char)name[k]);
+                check_tag(name, len, closing);
+                memcpy(name, tag->name, len);
+                name[0] = (char)toupper((unsigned char)name[0]);
+                check_tag(name, len, closing);
+
+                /* Prefixes, and extensions by a letter or a digit. */
+                for (k = 1; k < len; k++)
+                    check_tag(tag->name, k, closing);
+                memcpy(name, tag->name, len);
+                name[len] = 'x';
+                check_tag(name, len + 1, closing);
+                name[len] = '1';
+                check_tag(name, len + 1, closing);
+            }
+        }
+    }
+
+    printf("  %d inputs, %d mismatch(es) with CommonMark\n", n_tag_inputs, n_tag_mismatches);
+    if (n_tag_mismatches > 0)
+        n_failed++;
+
+    printf("  the former walk missed:");
+    for (i = 0; i < (int)(sizeof(shadowed_names) / sizeof(shadowed_names[0])); i++) {
+        printf(" %s", shadowed_names[i]);
+        if (!shadowed_seen[i]) {
+            printf(" (NOT SEEN)");
+            n_failed++;
+        }
+    }
+    printf("\n");
+    if (n_unexpected_shadowed > 0)
+        n_failed++;
+}
+
+
+/**********************
+ ***  Main program  ***
+ **********************/
+
+int
+main(int argc, char** argv)
+{
+    KEY* random_keys;
+
+    (void)argv;
+    if (argc > 1) {
+        printf("Usage: md4c_lookup_check\n");
+        return 2;
+    }
+
+    random_keys = (KEY*)malloc(N_RANDOM_KEYS * sizeof(KEY));
+    if (random_keys == NULL) {
+        fprintf(stderr, "Out of memory.\n");
+        return 2;
+    }
+    gen_random_keys(random_keys, N_RANDOM_KEYS);
+
+    check_entities(random_keys);
+    check_tags();
+    bench_entities(random_keys);
+
+    free(random_keys);
+    printf("%d check(s) failed\n", n_failed);
+    return (n_failed == 0 ? 0 : 1);
+}
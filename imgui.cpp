@@ -1445,6 +1445,7 @@ ImGuiIO::ImGuiIO()
     ConfigWindowsCopyContentsWithCtrlC = false;
     ConfigScrollbarScrollByPage = true;
     ConfigMemoryCompactTimer = 60.0f;
+    ConfigInputTextUndoMemory = 16 * 1024 * 1024;
     ConfigDebugIsDebuggerPresent = false;
     ConfigDebugHighlightIdConflicts = true;
     ConfigDebugBeginReturnValueOnce = false;
@@ -2013,28 +2014,66 @@ const char* ImStrbol(const char* buf_mid_line, const char* buf_begin) // find be
     return buf_mid_line;
 }
 
-const char* ImStristr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end)
+// Find the first occurrence of [needle, needle_end) in [haystack, haystack_end). With 'ignore_case', ASCII letters are compared case-insensitively.
+// Candidate positions are those where both the first and the last character of the needle match: with SSE they are tested 16 positions at a time.
+static const char* ImStrFindRange(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end, bool ignore_case)
 {
-    if (!needle_end)
-        needle_end = needle + strlen(needle);
-
-    const char un0 = (char)ImToUpper(*needle);
-    while ((!haystack_end && *haystack) || (haystack_end && haystack < haystack_end))
+    const int needle_len = (int)(needle_end - needle);
+    if (needle_len == 0)
+        return haystack;
+    if (haystack_end - haystack < needle_len)
+        return NULL;
+    const char* last = haystack_end - needle_len; // Last candidate position
+    const char first_u = ignore_case ? ImToUpper(needle[0]) : needle[0];
+    const char last_u = ignore_case ? ImToUpper(needle[needle_len - 1]) : needle[needle_len - 1];
+    const char* p = haystack;
+#ifdef IMGUI_ENABLE_SSE
+    const char first_l = (first_u >= 'A' && first_u <= 'Z' && ignore_case) ? (char)(first_u | 32) : first_u;
+    const char last_l = (last_u >= 'A' && last_u <= 'Z' && ignore_case) ? (char)(last_u | 32) : last_u;
+    const __m128i v_first_u = _mm_set1_epi8(first_u);
+    const __m128i v_first_l = _mm_set1_epi8(first_l);
+    const __m128i v_last_u = _mm_set1_epi8(last_u);
+    const __m128i v_last_l = _mm_set1_epi8(last_l);
+    for (; last - p >= 15; p += 16)
+    {
+        const __m128i v_first = _mm_loadu_si128((const __m128i*)(const void*)p);
+        const __m128i v_last = _mm_loadu_si128((const __m128i*)(const void*)(p + needle_len - 1));
+        const __m128i v_eq_first = _mm_or_si128(_mm_cmpeq_epi8(v_first, v_first_u), _mm_cmpeq_epi8(v_first, v_first_l));
+        const __m128i v_eq_last = _mm_or_si128(_mm_cmpeq_epi8(v_last, v_last_u), _mm_cmpeq_epi8(v_last, v_last_l));
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(v_eq_first, v_eq_last));
+        for (const char* candidate = p; mask != 0; candidate++, mask >>= 1)
+            if ((mask & 1) && (ignore_case ? ImStrnicmp(candidate, needle, (size_t)needle_len) : memcmp(candidate, needle, (size_t)needle_len)) == 0)
+                return candidate;
+    }
+#endif
+    for (; p <= last; p++)
     {
-        if (ImToUpper(*haystack) == un0)
-        {
-            const char* b = needle + 1;
-            for (const char* a = haystack + 1; b < needle_end; a++, b++)
-                if (ImToUpper(*a) != ImToUpper(*b))
-                    break;
-            if (b == needle_end)
-                return haystack;
-        }
-        haystack++;
+        const char c = ignore_case ? ImToUpper(*p) : *p;
+        if (c == first_u && (ignore_case ? ImToUpper(p[needle_len - 1]) : p[needle_len - 1]) == last_u)
+            if ((ignore_case ? ImStrnicmp(p, needle, (size_t)needle_len) : memcmp(p, needle, (size_t)needle_len)) == 0)
+                return p;
     }
     return NULL;
 }
 
+const char* ImStrstr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end)
+{
+    if (!haystack_end)
+        haystack_end = haystack + strlen(haystack);
+    if (!needle_end)
+        needle_end = needle + strlen(needle);
+    return ImStrFindRange(haystack, haystack_end, needle, needle_end, false);
+}
+
+const char* ImStristr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end)
+{
+    if (!haystack_end)
+        haystack_end = haystack + strlen(haystack);
+    if (!needle_end)
+        needle_end = needle + strlen(needle);
+    return ImStrFindRange(haystack, haystack_end, needle, needle_end, true);
+}
+
 // Trim str by offsetting contents when there's leading data + writing a \0 at the trailing position. We use this in situation where the cost is negligible.
 void ImStrTrimBlanks(char* buf)
 {
@@ -4205,6 +4244,8 @@ void ImGui::Shutdown()
     g.MenusIdSubmittedThisFrame.clear();
     g.InputTextState.ClearFreeMemory();
     g.InputTextDeactivatedState.ClearFreeMemory();
+    g.InputTextLineCaches.Clear();
+    g.InputTextVisibleRowStarts.clear();
 
     g.SettingsWindows.clear();
     g.SettingsHandlers.clear();
@@ -5314,6 +5355,13 @@ void ImGui::NewFrame()
     for (ImGuiTableTempData& table_temp_data : g.TablesTempData)
         if (table_temp_data.LastTimeActive >= 0.0f && table_temp_data.LastTimeActive < memory_compact_start_time)
             TableGcCompactTransientBuffers(&table_temp_data);
+
+    // Garbage collect line index of recently unused multi-line InputText()
+    if (g.IO.ConfigMemoryCompactTimer >= 0.0f || g.GcCompactAll)
+        for (int n = 0; n < g.InputTextLineCaches.GetMapSize(); n++)
+            if (ImGuiInputTextLineCache* line_cache = g.InputTextLineCaches.TryGetMapData(n))
+                if (line_cache->LastTimeActive < memory_compact_start_time)
+                    g.InputTextLineCaches.Remove(g.InputTextLineCaches.Map.Data[n].key, line_cache);
     if (g.GcCompactAll)
         GcCompactTransientMiscBuffers();
     g.GcCompactAll = false;
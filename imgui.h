@@ -43,8 +43,8 @@ Index of this file:
 // [SECTION] Helpers: Debug log, Memory allocations macros, ImVector<>
 // [SECTION] ImGuiStyle
 // [SECTION] ImGuiIO
-// [SECTION] Misc data structures (ImGuiInputTextCallbackData, ImGuiSizeCallbackData, ImGuiPayload)
-// [SECTION] Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiStorage, ImGuiListClipper, Math Operators, ImColor)
+// [SECTION] Misc data structures (ImGuiInputTextCallbackData, ImGuiInputTextStorage, ImGuiSizeCallbackData, ImGuiPayload)
+// [SECTION] Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiTextWrapIndex, ImGuiStorage, ImGuiListClipper, Math Operators, ImColor)
 // [SECTION] Multi-Select API flags and structures (ImGuiMultiSelectFlags, ImGuiMultiSelectIO, ImGuiSelectionRequest, ImGuiSelectionBasicStorage, ImGuiSelectionExternalStorage)
 // [SECTION] Drawing API (ImDrawCallback, ImDrawCmd, ImDrawIdx, ImDrawVert, ImDrawChannel, ImDrawListSplitter, ImDrawFlags, ImDrawListFlags, ImDrawList, ImDrawData)
 // [SECTION] Font API (ImFontConfig, ImFontGlyph, ImFontGlyphRangesBuilder, ImFontAtlasFlags, ImFontAtlas, ImFont)
@@ -178,6 +178,7 @@ struct ImColor;                     // Helper functions to create a color that c
 struct ImGuiContext;                // Dear ImGui context (opaque structure, unless including imgui_internal.h)
 struct ImGuiIO;                     // Main configuration and I/O between your application and ImGui (also see: ImGuiPlatformIO)
 struct ImGuiInputTextCallbackData;  // Shared state of InputText() when using custom ImGuiInputTextCallback (rare/advanced use)
+struct ImGuiInputTextStorage;       // Caller-owned text edited in place by InputTextMultiline() (rare/advanced use)
 struct ImGuiKeyData;                // Storage for ImGuiIO and IsKeyDown(), IsKeyPressed() etc functions.
 struct ImGuiListClipper;            // Helper to manually clip large list of items
 struct ImGuiMultiSelectIO;          // Structure to interact with a BeginMultiSelect()/EndMultiSelect() block
@@ -196,6 +197,7 @@ struct ImGuiTableSortSpecs;         // Sorting specifications for a table (often
 struct ImGuiTableColumnSortSpecs;   // Sorting specification for one column of a table
 struct ImGuiTextBuffer;             // Helper to hold and append into a text buffer (~string builder)
 struct ImGuiTextFilter;             // Helper to parse and apply text filters (e.g. "aaaaa[,bbbbb][,ccccc]")
+struct ImGuiTextWrapIndex;          // Helper to cache the word-wrapped rows of a large static text, for TextWrappedIndexed()
 struct ImGuiViewport;               // A Platform Window (always only one in 'master' branch), in the future may represent Platform Monitor
 
 // Enumerations
@@ -540,6 +542,7 @@ namespace ImGui
     IMGUI_API void          TextDisabledV(const char* fmt, va_list args)                    IM_FMTLIST(1);
     IMGUI_API void          TextWrapped(const char* fmt, ...)                               IM_FMTARGS(1); // shortcut for PushTextWrapPos(0.0f); Text(fmt, ...); PopTextWrapPos();. Note that this won't work on an auto-resizing window if there's no other widgets to extend the window width, yoy may need to set a size using SetNextWindowSize().
     IMGUI_API void          TextWrappedV(const char* fmt, va_list args)                     IM_FMTLIST(1);
+    IMGUI_API void          TextWrappedIndexed(ImGuiTextWrapIndex* index, const char* text, const char* text_end = NULL); // raw text wrapped as with TextWrapped(), for large static texts: wrap positions are kept in 'index' and only recomputed when the width changes, so each frame only processes the visible rows.
     IMGUI_API void          LabelText(const char* label, const char* fmt, ...)              IM_FMTARGS(2); // display text+label aligned the same way as value+label widgets
     IMGUI_API void          LabelTextV(const char* label, const char* fmt, va_list args)    IM_FMTLIST(2);
     IMGUI_API void          BulletText(const char* fmt, ...)                                IM_FMTARGS(1); // shortcut for Bullet()+Text()
@@ -631,7 +634,11 @@ namespace ImGui
     // - Most of the ImGuiInputTextFlags flags are only useful for InputText() and not for InputFloatX, InputIntX, InputDouble etc.
     IMGUI_API bool          InputText(const char* label, char* buf, size_t buf_size, ImGuiInputTextFlags flags = 0, ImGuiInputTextCallback callback = NULL, void* user_data = NULL);
     IMGUI_API bool          InputTextMultiline(const char* label, char* buf, size_t buf_size, const ImVec2& size = ImVec2(0, 0), ImGuiInputTextFlags flags = 0, ImGuiInputTextCallback callback = NULL, void* user_data = NULL);
+    IMGUI_API bool          InputTextMultiline(const char* label, ImGuiInputTextStorage* storage, const ImVec2& size = ImVec2(0, 0), ImGuiInputTextFlags flags = 0); // edit text held in your own data structure, without the widget keeping a copy of it. See ImGuiInputTextStorage.
     IMGUI_API bool          InputTextWithHint(const char* label, const char* hint, char* buf, size_t buf_size, ImGuiInputTextFlags flags = 0, ImGuiInputTextCallback callback = NULL, void* user_data = NULL);
+    IMGUI_API void          SetNextItemTextGeneration(ImU32 generation);                        // set generation of the text of the next InputTextMultiline(), which you must change whenever you modify the text outside of the widget. Lets the inactive widget keep a line index instead of scanning the whole text every frame (useful for large texts).
+    IMGUI_API void          SetNextItemTextFind(const char* find, bool ignore_case = false);    // highlight the matches of 'find' in the visible lines of the next InputTextMultiline(). 'ignore_case' only applies to ASCII letters.
+    IMGUI_API void          SetNextItemTextReplaceAll(const char* replace);                     // replace all the matches of the SetNextItemTextFind() text in the next InputTextMultiline(), which then returns true. While the widget is active, this is a single undo step.
     IMGUI_API bool          InputFloat(const char* label, float* v, float step = 0.0f, float step_fast = 0.0f, const char* format = "%.3f", ImGuiInputTextFlags flags = 0);
     IMGUI_API bool          InputFloat2(const char* label, float v[2], const char* format = "%.3f", ImGuiInputTextFlags flags = 0);
     IMGUI_API bool          InputFloat3(const char* label, float v[3], const char* format = "%.3f", ImGuiInputTextFlags flags = 0);
@@ -1186,6 +1193,9 @@ enum ImGuiInputTextFlags_
     ImGuiInputTextFlags_CallbackResize      = 1 << 22,  // Callback on buffer capacity changes request (beyond 'buf_size' parameter value), allowing the string to grow. Notify when the string wants to be resized (for string types which hold a cache of their Size). You will be provided a new BufSize in the callback and NEED to honor it. (see misc/cpp/imgui_stdlib.h for an example of using this)
     ImGuiInputTextFlags_CallbackEdit        = 1 << 23,  // Callback on any edit. Note that InputText() already returns true on edit + you can always use IsItemEdited(). The callback is useful to manipulate the underlying buffer while focus is active.
 
+    // Multi-line Word-Wrapping
+    ImGuiInputTextFlags_WordWrap            = 1 << 24,  // InputTextMultiline(): wrap lines at the width of the field instead of scrolling horizontally. Always displays the vertical scrollbar.
+
     // Obsolete names
     //ImGuiInputTextFlags_AlwaysInsertMode  = ImGuiInputTextFlags_AlwaysOverwrite   // [renamed in 1.82] name was not matching behavior
 };
@@ -2257,6 +2267,7 @@ struct ImGuiIO
     bool        ConfigWindowsCopyContentsWithCtrlC; // = false      // [EXPERIMENTAL] CTRL+C copy the contents of focused window into the clipboard. Experimental because: (1) has known issues with nested Begin/End pairs (2) text output quality varies (3) text output is in submission order rather than spatial order.
     bool        ConfigScrollbarScrollByPage;    // = true           // Enable scrolling page by page when clicking outside the scrollbar grab. When disabled, always scroll to clicked location. When enabled, Shift+Click scrolls to clicked location.
     float       ConfigMemoryCompactTimer;       // = 60.0f          // Timer (in seconds) to free transient windows/tables memory buffers when unused. Set to -1.0f to disable.
+    int         ConfigInputTextUndoMemory;      // = 16 MB          // Memory budget (in bytes) of the undo/redo history of the active InputText(). The oldest edits are forgotten first. Set to 0 to disable undo.
 
     // Inputs Behaviors
     // (other variables, ones which are expected to be tweaked within UI code, are exposed in ImGuiStyle)
@@ -2440,7 +2451,7 @@ struct ImGuiIO
 };
 
 //-----------------------------------------------------------------------------
-// [SECTION] Misc data structures (ImGuiInputTextCallbackData, ImGuiSizeCallbackData, ImGuiPayload)
+// [SECTION] Misc data structures (ImGuiInputTextCallbackData, ImGuiInputTextStorage, ImGuiSizeCallbackData, ImGuiPayload)
 //-----------------------------------------------------------------------------
 
 // Shared state of InputText(), passed as an argument to your callback when a ImGuiInputTextFlags_Callback* flag is used.
@@ -2484,6 +2495,30 @@ struct ImGuiInputTextCallbackData
     bool                HasSelection() const    { return SelectionStart != SelectionEnd; }
 };
 
+// Caller-owned text storage, edited in place by InputTextMultiline(label, storage, ...).
+// - The widget reads and modifies the text through those functions and never holds its own copy of it, so there is no copy
+//   of the text when the widget is focused or unfocused, and no comparison with your buffer on every frame.
+//   This lets you edit large texts held in your own data structure, as long as it can cheaply return the whole text as one span (e.g. a gap buffer).
+// - GetSpanFn() returns 'len' contiguous bytes of text starting at 'pos', followed by a zero-terminator when pos + len == length.
+//   The returned pointer only needs to stay valid until the next call to any of the functions.
+//   The current implementation reads the whole text as a single span on every frame the widget is active (again after each edit),
+//   is being activated, replaces text or logs, and on every frame without a text generation. A piece table or a rope would have to be
+//   flattened then. An inactive widget with a text generation (see SetNextItemTextGeneration()) only requests the span of its visible lines.
+// - Edits made by the widget are applied immediately and InputTextMultiline() returns true on the frame they happen.
+//   If you modify the text while the widget is active, call ReloadUserBufAndKeepSelection() on its ImGuiInputTextState.
+//   Use SetNextItemTextGeneration() to let the widget keep its cursor and undo history when it is focused again.
+// - Callbacks (ImGuiInputTextFlags_CallbackXXX) are not supported, and pressing Escape doesn't revert the edits.
+struct ImGuiInputTextStorage
+{
+    void*       UserData;                                                                                   // Any data you need to retrieve your storage from the callbacks
+    int         (*GetLengthFn)(ImGuiInputTextStorage* storage);                                             // Return the length of the text (in bytes)
+    const char* (*GetSpanFn)(ImGuiInputTextStorage* storage, int pos, int len);                             // Return 'len' contiguous bytes of text starting at 'pos'
+    void        (*InsertCharsFn)(ImGuiInputTextStorage* storage, int pos, const char* text, int text_len);  // Insert 'text_len' bytes at 'pos'. 'text' never points into the storage
+    void        (*DeleteCharsFn)(ImGuiInputTextStorage* storage, int pos, int len);                         // Delete 'len' bytes starting at 'pos'
+
+    ImGuiInputTextStorage()     { memset(this, 0, sizeof(*this)); }
+};
+
 // Resizing callback data to apply custom constraint. As enabled by SetNextWindowSizeConstraints(). Callback is called during the next Begin().
 // NB: For basic min/max size constraint on each axis you don't need to use the callback! The SetNextWindowSizeConstraints() parameters are enough.
 struct ImGuiSizeCallbackData
@@ -2517,7 +2552,7 @@ struct ImGuiPayload
 };
 
 //-----------------------------------------------------------------------------
-// [SECTION] Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiStorage, ImGuiListClipper, Math Operators, ImColor)
+// [SECTION] Helpers (ImGuiOnceUponAFrame, ImGuiTextFilter, ImGuiTextBuffer, ImGuiTextWrapIndex, ImGuiStorage, ImGuiListClipper, Math Operators, ImColor)
 //-----------------------------------------------------------------------------
 
 // Helper: Unicode defines
@@ -2584,6 +2619,25 @@ struct ImGuiTextBuffer
     IMGUI_API void      appendfv(const char* fmt, va_list args) IM_FMTLIST(2);
 };
 
+// Helper: Rows of a large static word-wrapped text, used by TextWrappedIndexed() to only lay out and render the visible rows.
+// - Rows are computed on first use, and again whenever the text pointer or length, the wrap width, the font or the font size change.
+// - Call Clear() after modifying the text in place without changing its length, or after rebuilding the font atlas.
+// - TextSize is the same as CalcTextSize(text, text_end, false, wrap_width) before rounding, without measuring the text again.
+struct ImGuiTextWrapIndex
+{
+    ImVector<int>       RowStarts;      // Offset of the first byte of each row (after a '\n' or a wrap)
+    const char*         Text;           // Text, font, font size and wrap width the rows were computed for
+    int                 TextLen;
+    ImFont*             Font;
+    float               FontSize;
+    float               WrapWidth;
+    ImVec2              TextSize;
+
+    ImGuiTextWrapIndex()    { Clear(); }
+    void                Clear()                 { RowStarts.clear(); Text = NULL; TextLen = 0; Font = NULL; FontSize = WrapWidth = 0.0f; TextSize = ImVec2(0.0f, 0.0f); }
+    IMGUI_API void      Build(ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end = NULL); // Called by TextWrappedIndexed() when needed
+};
+
 // [Internal] Key+Value for ImGuiStorage
 struct ImGuiStoragePair
 {
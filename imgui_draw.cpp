@@ -3928,6 +3928,106 @@ static inline const char* CalcWordWrapNextLineStartA(const char* text, const cha
 
 #define ImFontGetCharAdvanceX(_FONT, _CH)  ((int)(_CH) < (_FONT)->IndexAdvanceX.Size ? (_FONT)->IndexAdvanceX.Data[_CH] : (_FONT)->FallbackAdvanceX)
 
+#ifdef IMGUI_ENABLE_SSE
+// Find the smallest k such as all scaled ASCII advances are multiples of 1/2^k: sums staying below 2^(24-k) are then exact in any order.
+static void ImFontAsciiMeasureSetup(ImFontAsciiMeasure* measure)
+{
+    ImFont* font = measure->Font;
+    bool valid = true;
+    measure->AdvanceMax = 0.0f;
+    for (int c = 0; c < 128; c++)
+    {
+        const float advance = ImFontGetCharAdvanceX(font, c) * measure->Scale;
+        measure->Advances[c] = advance;
+        measure->AdvanceMax = ImMax(measure->AdvanceMax, advance);
+        if (!(advance >= 0.0f && advance < 65536.0f))
+            valid = false;
+    }
+    measure->ExactLimit = 0.0f;
+    if (!valid || measure->AdvanceMax <= 0.0f)
+        return;
+    for (int k = 0; k <= 8; k++)
+    {
+        const float grid_scale = (float)(1 << k);
+        int c = 0;
+        while (c < 128 && measure->Advances[c] * grid_scale == ImFloor(measure->Advances[c] * grid_scale))
+            c++;
+        if (c < 128)
+            continue;
+        measure->GridScale = grid_scale;
+        measure->ExactLimit = (float)(1 << (24 - k));
+        return;
+    }
+}
+#endif
+
+bool ImFontMeasureAsciiRun(ImFontAsciiMeasure* measure, const char** p_text, const char* text_end, float* p_line_width, float max_width)
+{
+    ImFont* font = measure->Font;
+    const float scale = measure->Scale;
+    const char* s = *p_text;
+    float line_width = *p_line_width;
+
+#ifdef IMGUI_ENABLE_SSE
+    // Whole blocks of 16 characters, classified with vector compares and summed in parallel when this is exact.
+    // The number of blocks is bounded so that every partial sum stays exact and below max_width, leaving one block of margin for the rounding of the estimate.
+    const __m128i v_lf = _mm_set1_epi8('\n');
+    const __m128i v_cr = _mm_set1_epi8('\r');
+    #define IM_ASCII_BLOCK_IS_PLAIN(_V) (_mm_movemask_epi8(_mm_or_si128(_V, _mm_or_si128(_mm_cmpeq_epi8(_V, v_lf), _mm_cmpeq_epi8(_V, v_cr)))) == 0)
+    if (text_end - s >= 256 && IM_ASCII_BLOCK_IS_PLAIN(_mm_loadu_si128((const __m128i*)(const void*)s)))
+    {
+        if (measure->ExactLimit < 0.0f)
+            ImFontAsciiMeasureSetup(measure);
+        const float limit = ImMin(measure->ExactLimit, max_width);
+        const float block_max = measure->AdvanceMax * 16;
+        if (measure->ExactLimit > 0.0f && line_width >= 0.0f && line_width + block_max * 2 < limit && line_width * measure->GridScale == ImFloor(line_width * measure->GridScale))
+        {
+            const int blocks_max = (int)((limit - line_width) / block_max) - 1;
+            const float* advances = measure->Advances;
+            __m128 v_sum = _mm_setzero_ps();
+            int blocks = 0;
+            for (; blocks < blocks_max && text_end - s >= 16; blocks++, s += 16)
+            {
+                const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)s);
+                if (!IM_ASCII_BLOCK_IS_PLAIN(v))
+                    break;
+                const unsigned char* b = (const unsigned char*)s;
+                const __m128 v_sum01 = _mm_add_ps(_mm_set_ps(advances[b[3]], advances[b[2]], advances[b[1]], advances[b[0]]), _mm_set_ps(advances[b[7]], advances[b[6]], advances[b[5]], advances[b[4]]));
+                const __m128 v_sum23 = _mm_add_ps(_mm_set_ps(advances[b[11]], advances[b[10]], advances[b[9]], advances[b[8]]), _mm_set_ps(advances[b[15]], advances[b[14]], advances[b[13]], advances[b[12]]));
+                v_sum = _mm_add_ps(v_sum, _mm_add_ps(v_sum01, v_sum23));
+            }
+            if (blocks > 0)
+            {
+                v_sum = _mm_add_ps(v_sum, _mm_movehl_ps(v_sum, v_sum));
+                v_sum = _mm_add_ss(v_sum, _mm_shuffle_ps(v_sum, v_sum, 0x55));
+                line_width += _mm_cvtss_f32(v_sum);
+            }
+        }
+    }
+    #undef IM_ASCII_BLOCK_IS_PLAIN
+#endif
+
+    // Remaining characters, one at a time
+    bool ret = true;
+    while (s < text_end)
+    {
+        const unsigned int c = (unsigned int)*s;
+        if (c >= 0x80 || c == '\n' || c == '\r')
+            break;
+        const float char_width = ImFontGetCharAdvanceX(font, c) * scale;
+        if (line_width + char_width >= max_width)
+        {
+            ret = false;
+            break;
+        }
+        line_width += char_width;
+        s++;
+    }
+    *p_text = s;
+    *p_line_width = line_width;
+    return ret;
+}
+
 // Simple word-wrapping for English, not full-featured. Please submit failing cases!
 // This will return the next location to wrap from. If no wrapping if necessary, this will fast-forward to e.g. text_end.
 // FIXME: Much possible improvements (don't cut things like "word !", "word!!!" but cut within "word,,,,", more sensible support for punctuations, support for Unicode punctuations, etc.)
@@ -4042,6 +4142,7 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
 
     const bool word_wrap_enabled = (wrap_width > 0.0f);
     const char* word_wrap_eol = NULL;
+    ImFontAsciiMeasure ascii_measure(this, scale);
 
     const char* s = text_begin;
     while (s < text_end)
@@ -4064,6 +4165,14 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
             }
         }
 
+        // Fast path for long runs of ASCII characters
+        if (ImFontIsAsciiRunAhead(s, word_wrap_enabled ? word_wrap_eol : text_end))
+        {
+            if (!ImFontMeasureAsciiRun(&ascii_measure, &s, word_wrap_enabled ? word_wrap_eol : text_end, &line_width, max_width))
+                break;
+            continue;
+        }
+
         // Decode and advance source
         const char* prev_s = s;
         unsigned int c = (unsigned int)*s;
@@ -4107,6 +4216,88 @@ ImVec2 ImFont::CalcTextSizeA(float size, float max_width, float wrap_width, cons
     return text_size;
 }
 
+// Same loop as ImFont::CalcTextSizeA() without max_width, recording where each row starts.
+void ImGuiTextWrapIndex::Build(ImFont* font, float font_size, float wrap_width, const char* text, const char* text_end)
+{
+    if (!text_end)
+        text_end = text + strlen(text);
+    Text = text;
+    TextLen = (int)(text_end - text);
+    Font = font;
+    FontSize = font_size;
+    WrapWidth = wrap_width;
+    RowStarts.resize(0);
+    RowStarts.push_back(0);
+
+    const float line_height = font_size;
+    const float scale = font_size / font->FontSize;
+
+    ImVec2 text_size = ImVec2(0, 0);
+    float line_width = 0.0f;
+
+    const bool word_wrap_enabled = (wrap_width > 0.0f);
+    const char* word_wrap_eol = NULL;
+    ImFontAsciiMeasure ascii_measure(font, scale);
+
+    const char* s = text;
+    while (s < text_end)
+    {
+        if (word_wrap_enabled)
+        {
+            if (!word_wrap_eol)
+                word_wrap_eol = font->CalcWordWrapPositionA(scale, s, text_end, wrap_width - line_width);
+
+            if (s >= word_wrap_eol)
+            {
+                if (text_size.x < line_width)
+                    text_size.x = line_width;
+                text_size.y += line_height;
+                line_width = 0.0f;
+                word_wrap_eol = NULL;
+                s = CalcWordWrapNextLineStartA(s, text_end); // Wrapping skips upcoming blanks
+                RowStarts.push_back((int)(s - text));
+                continue;
+            }
+        }
+
+        if (ImFontIsAsciiRunAhead(s, word_wrap_enabled ? word_wrap_eol : text_end))
+        {
+            ImFontMeasureAsciiRun(&ascii_measure, &s, word_wrap_enabled ? word_wrap_eol : text_end, &line_width, FLT_MAX);
+            continue;
+        }
+
+        unsigned int c = (unsigned int)*s;
+        if (c < 0x80)
+            s += 1;
+        else
+            s += ImTextCharFromUtf8(&c, s, text_end);
+
+        if (c < 32)
+        {
+            if (c == '\n')
+            {
+                text_size.x = ImMax(text_size.x, line_width);
+                text_size.y += line_height;
+                line_width = 0.0f;
+                RowStarts.push_back((int)(s - text));
+                continue;
+            }
+            if (c == '\r')
+                continue;
+        }
+
+        line_width += ImFontGetCharAdvanceX(font, c) * scale;
+    }
+
+    if (text_size.x < line_width)
+        text_size.x = line_width;
+
+    if (line_width > 0 || text_size.y == 0.0f)
+        text_size.y += line_height;
+
+    TextSize = text_size;
+}
+
 // Note: as with every ImDrawList drawing function, this expects that the font atlas texture is bound.
 void ImFont::RenderChar(ImDrawList* draw_list, float size, const ImVec2& pos, ImU32 col, ImWchar c)
 {
@@ -4208,6 +4399,14 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, const ImVec2& pos, Im
                 continue;
             }
         }
+        else if (x > clip_rect.z + line_height)
+        {
+            // Skip the rest of a line going past the right of the clip rectangle (with a margin for glyphs extending to the left of their position)
+            const char* line_end = (const char*)memchr(s, '\n', text_end - s);
+            s = line_end ? line_end : text_end;
+            if (s == text_end)
+                break;
+        }
 
         // Decode and advance source
         unsigned int c = (unsigned int)*s;
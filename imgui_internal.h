@@ -378,7 +378,8 @@ IMGUI_API char*         ImStrdup(const char* str);
 IMGUI_API char*         ImStrdupcpy(char* dst, size_t* p_dst_size, const char* str);        // Copy in provided buffer, recreate buffer if needed.
 IMGUI_API const char*   ImStrchrRange(const char* str_begin, const char* str_end, char c);  // Find first occurrence of 'c' in string range.
 IMGUI_API const char*   ImStreolRange(const char* str, const char* str_end);                // End end-of-line
-IMGUI_API const char*   ImStristr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end);  // Find a substring in a string range.
+IMGUI_API const char*   ImStrstr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end);   // Find a substring in a string range.
+IMGUI_API const char*   ImStristr(const char* haystack, const char* haystack_end, const char* needle, const char* needle_end);  // Find a substring in a string range, ignoring the case of ASCII letters.
 IMGUI_API void          ImStrTrimBlanks(char* str);                                         // Remove leading and trailing blanks from a buffer.
 IMGUI_API const char*   ImStrSkipBlank(const char* str);                                    // Find first non-blank character.
 IMGUI_API int           ImStrlenW(const ImWchar* str);                                      // Computer string length (ImWchar string)
@@ -1113,14 +1114,96 @@ struct IMGUI_API ImGuiInputTextDeactivatedState
     void    ClearFreeMemory()           { ID = 0; TextA.clear(); }
 };
 
+// Line index of an inactive multi-line InputText(), kept between frames when SetNextItemTextGeneration() is used.
+// Valid as long as the buffer pointer (or the storage, see ImGuiInputTextStorage) and the generation are the same as when it was built.
+// Word-wrapped fields without a text generation keep one too, with a copy of the text: valid as long as the text is the same as the copy.
+struct IMGUI_API ImGuiInputTextLineCache
+{
+    const char*        Buf;             // buffer the index was built for (NULL if invalid)
+    ImGuiInputTextStorage* Storage;     // storage the index was built for, if any. Buf is then the last span read of the whole text, and isn't compared.
+    ImU32              Generation;      // generation the index was built for
+    int                TextLen;         // UTF-8 length of the text in Buf (in bytes)
+    float              LastTimeActive;  // last used, for garbage collection
+    ImVector<int>      LineStarts;      // offset of the first character of each line
+    ImVector<int>      WrapRowStarts;   // offset of the first character of each visual row, with ImGuiInputTextFlags_WordWrap (valid if WrapWidth > 0.0f)
+    ImVector<char>     TextCopy;        // without a text generation: copy of the text the index was built for (empty otherwise)
+    float              WrapWidth;       // wrap width, font and font size the rows were laid out for
+    ImFont*            WrapFont;
+    float              WrapFontSize;
+
+    ImGuiInputTextLineCache()           { Buf = NULL; Storage = NULL; Generation = 0; TextLen = 0; LastTimeActive = -1.0f; WrapWidth = 0.0f; WrapFont = NULL; WrapFontSize = 0.0f; }
+};
+
+// Block of text storage for ImGuiInputTextUndoStack. Small texts are appended to a shared chunk, large ones get a chunk of their own.
+// Allocated with IM_ALLOC(), followed by Capacity bytes of text.
+struct ImGuiInputTextUndoChunk
+{
+    int                 Size;               // bytes used
+    int                 Capacity;           // bytes allocated after the header
+    int                 RefCount;           // number of texts stored in this chunk by live records
+
+    char*               Data()              { return (char*)(this + 1); }
+};
+
+// An edit recorded by ImGuiInputTextUndoStack: DeletedLen characters at Where were replaced by InsertedLen characters.
+struct ImGuiInputTextUndoRecord
+{
+    int                 Where;
+    int                 DeletedLen;
+    int                 InsertedLen;
+    int                 DeletedOffset;      // offset of the deleted text in DeletedChunk
+    int                 InsertedOffset;     // offset of the inserted text in InsertedChunk
+    ImGuiInputTextUndoChunk* DeletedChunk;  // deleted text (NULL when DeletedLen == 0)
+    ImGuiInputTextUndoChunk* InsertedChunk; // inserted text, only stored once the edit is undone (until then it is part of the edited text)
+    bool                Typed;              // created by typing, may be extended by the following typed characters
+    int                 ReplaceCount;       // > 0 for a replace-all: DeletedChunk holds the replaced matches instead of the deleted text (see InputTextReplaceAll())
+};
+
+// Undo/redo history of ImGuiInputTextState, used instead of the fixed size buffers of imstb_textedit.h.
+// Memory is bounded by io.ConfigInputTextUndoMemory: the oldest records are discarded first.
+struct IMGUI_API ImGuiInputTextUndoStack
+{
+    ImVector<ImGuiInputTextUndoRecord> Records; // records [RecordsHead, UndoPoint) can be undone, records [UndoPoint, Records.Size) can be redone
+    int                 RecordsHead;        // records before this index were discarded (compacted lazily)
+    int                 UndoPoint;
+    ImGuiInputTextUndoChunk* CurrentChunk;  // chunk small texts are appended to
+    int                 ChunksMemory;       // bytes allocated for chunks (records are counted separately)
+    bool                Typing;             // set while recording the edits of a typed character
+    bool                MergeTyping;        // last record may be extended by the next typed characters (cleared by any key press)
+
+    void                Clear();
+    int                 GetUndoCount() const    { return UndoPoint - RecordsHead; }
+    int                 GetRedoCount() const    { return Records.Size - UndoPoint; }
+    int                 GetMemoryUsage() const  { return ChunksMemory + (Records.Size - RecordsHead) * (int)sizeof(ImGuiInputTextUndoRecord); }
+};
+
+// Layout of a row of ImGuiInputTextState (a line, or a visual row with ImGuiInputTextFlags_WordWrap): x position of each character from the start of the row.
+// Kept for a few rows so that moving up/down and clicking on long lines are binary searches instead of measuring the row again for every lookup.
+struct IMGUI_API ImGuiInputTextRowLayout
+{
+    int                 RowStart;
+    int                 RowEnd;             // end of the row, including its new line character
+    int                 VisibleEnd;         // end of the characters having a width (excludes the new line character, or the last character of a wrapped row)
+    ImFont*             Font;               // font and font size the row was measured with. NULL when unused.
+    float               FontSize;
+    int                 LastUse;
+    ImVector<int>       CharOffsets;        // offset of each character from RowStart, followed by VisibleEnd - RowStart. Empty when all characters are single bytes (offset == index).
+    ImVector<float>     CharX;              // x position of each character, followed by the width of the visible part
+
+    int                 GetCharOffset(int n) const { return CharOffsets.Size > 0 ? CharOffsets.Data[n] : n; }
+    float               GetCharX(int pos) const;
+    int                 FindCharAtX(float x) const;     // Last character whose x position is <= x
+    int                 LocateCharAtX(float x) const;   // Character boundary nearest to x
+};
+
 // Forward declare imstb_textedit.h structure + make its main configuration define accessible
 #undef IMSTB_TEXTEDIT_STRING
 #undef IMSTB_TEXTEDIT_CHARTYPE
 #define IMSTB_TEXTEDIT_STRING             ImGuiInputTextState
 #define IMSTB_TEXTEDIT_CHARTYPE           char
 #define IMSTB_TEXTEDIT_GETWIDTH_NEWLINE   (-1.0f)
-#define IMSTB_TEXTEDIT_UNDOSTATECOUNT     99
-#define IMSTB_TEXTEDIT_UNDOCHARCOUNT      999
+#define IMSTB_TEXTEDIT_UNDOSTATECOUNT     1     // Unused: undo is handled by ImGuiInputTextUndoStack
+#define IMSTB_TEXTEDIT_UNDOCHARCOUNT      1
 namespace ImStb { struct STB_TexteditState; }
 typedef ImStb::STB_TexteditState ImStbTexteditState;
 
@@ -1133,10 +1216,12 @@ struct IMGUI_API ImGuiInputTextState
     ImGuiInputTextFlags     Flags;                  // copy of InputText() flags. may be used to check if e.g. ImGuiInputTextFlags_Password is set.
     ImGuiID                 ID;                     // widget id owning the text state
     int                     TextLen;                // UTF-8 length of the string in TextA (in bytes)
-    const char*             TextSrc;                // == TextA.Data unless read-only, in which case == buf passed to InputText(). Field only set and valid _inside_ the call InputText() call.
+    const char*             TextSrc;                // == TextA.Data unless read-only or editing a storage, in which case == buf passed to InputText() / span of the storage. Field only set and valid _inside_ the call InputText() call.
+    ImGuiInputTextStorage*  Storage;                // caller-owned storage edited in place (TextA is then unused). Field only valid _inside_ the InputText() call, only tested against NULL outside of it.
     ImVector<char>          TextA;                  // main UTF8 buffer. TextA.Size is a buffer size! Should always be >= buf_size passed by user (and of course >= CurLenA + 1).
     ImVector<char>          TextToRevertTo;         // value to revert to when pressing Escape = backup of end-user buffer at the time of focus (in UTF-8, unaltered)
     ImVector<char>          CallbackTextBackup;     // temporary storage for callback to support automatic reconcile of undo-stack
+    ImGuiInputTextUndoStack UndoStack;              // undo/redo history
     int                     BufCapacity;            // end-user buffer capacity (include zero terminator)
     ImVec2                  Scroll;                 // horizontal offset (managed manually) + vertical scrolling (pulled from child window's own Scroll.y)
     float                   CursorAnim;             // timer for cursor blink, reset on every user action so the cursor reappears immediately
@@ -1144,13 +1229,34 @@ struct IMGUI_API ImGuiInputTextState
     bool                    SelectedAllMouseLock;   // after a double-click to select all, we ignore further mouse drags to update selection
     bool                    Edited;                 // edited this frame
     bool                    WantReloadUserBuf;      // force a reload of user buf so it may be modified externally. may be automatic in future version.
+    bool                    TextGenerationValid;    // TextGeneration was set by SetNextItemTextGeneration() on activation
+    ImU32                   TextGeneration;         // text generation on activation: when the widget is activated again with the same generation, the text is known to be unchanged
+    const char*             ReadOnlySrc;            // read-only: buffer, length and text generation the line index was built for (without a generation, the text is copied to TextA). The index and rows are kept while the text is unchanged.
+    int                     ReadOnlySrcLen;
+    bool                    ReadOnlySrcHasGeneration;
+    ImU32                   ReadOnlySrcGeneration;
     int                     ReloadSelectionStart;
     int                     ReloadSelectionEnd;
+    ImVector<int>           LineStarts;             // offset of the first character of each line of TextSrc, updated by STB_TEXTEDIT_INSERTCHARS()/STB_TEXTEDIT_DELETECHARS(). Use GetLineStart().
+    int                     LineStartsDeltaLine;    // LineStarts[] entries from this index onward are stored without LineStartsDelta, so edits on a same line don't shift the whole index.
+    int                     LineStartsDelta;
+    bool                    LineStartsValid;        // false when the text was replaced as a whole. The index is rebuilt on next use.
+    ImVector<int>           WrapRowStarts;          // with ImGuiInputTextFlags_WordWrap: offset of the first character of each visual row. Same delta scheme as LineStarts. Use GetRowStart().
+    int                     WrapRowStartsDeltaRow;
+    int                     WrapRowStartsDelta;
+    ImVector<bool>          WrapLineStale;          // per line: rows were laid out for another width/font and are waiting to be reflowed (a stale line is kept as a single row)
+    int                     WrapStaleCount;         // number of stale lines
+    int                     WrapReflowLine;         // next line looked at by the background reflow
+    float                   WrapWidth;              // wrap width, font and font size of the rows. WrapWidth is 0.0f when not wrapping (rows are not maintained).
+    ImFont*                 WrapFont;
+    float                   WrapFontSize;
+    ImGuiInputTextRowLayout RowLayouts[4];          // cached row layouts, cleared by any change of the text. Use GetRowLayout().
+    int                     RowLayoutsUseCounter;
 
     ImGuiInputTextState();
     ~ImGuiInputTextState();
-    void        ClearText()                 { TextLen = 0; TextA[0] = 0; CursorClamp(); }
-    void        ClearFreeMemory()           { TextA.clear(); TextToRevertTo.clear(); }
+    void        ClearText()                 { TextLen = 0; TextA[0] = 0; LineStartsValid = false; CursorClamp(); }
+    void        ClearFreeMemory()           { TextA.clear(); TextToRevertTo.clear(); LineStarts.clear(); LineStartsValid = false; WrapRowStarts.clear(); WrapLineStale.clear(); WrapWidth = 0.0f; UndoStack.Clear(); UndoStack.Records.clear(); RowLayoutsClear(true); }
     void        OnKeyPressed(int key);      // Cannot be inline because we call in code in stb_textedit.h implementation
     void        OnCharPressed(unsigned int c);
 
@@ -1164,6 +1270,29 @@ struct IMGUI_API ImGuiInputTextState
     int         GetSelectionEnd() const;
     void        SelectAll();
 
+    // Line index (lookups are O(log n) in the number of lines)
+    int         GetLineCount();
+    int         GetLineFromPos(int pos);
+    int         GetLineStart(int line_no) const { return LineStarts.Data[line_no] + (line_no >= LineStartsDeltaLine ? LineStartsDelta : 0); }
+    void        LineIndexRebuild();
+    void        LineIndexSet(const ImVector<int>& line_starts);
+    void        LineIndexOnInsert(int pos, const char* new_text, int new_text_len);
+    void        LineIndexOnDelete(int pos, int n);
+
+    // Visual rows with ImGuiInputTextFlags_WordWrap (lookups are O(log n) in the number of rows). Every line starts a row.
+    int         GetRowCount()                   { GetLineCount(); return WrapRowStarts.Size; }
+    int         GetRowFromPos(int pos);
+    int         GetRowStart(int row_no) const   { return WrapRowStarts.Data[row_no] + (row_no >= WrapRowStartsDeltaRow ? WrapRowStartsDelta : 0); }
+    int         GetRowEnd(int row_no) const     { return (row_no + 1 < WrapRowStarts.Size) ? GetRowStart(row_no + 1) : TextLen; }
+    void        WrapIndexReset();
+    void        WrapIndexReflowLines(int line_begin, int line_end);
+    void        WrapIndexOnEdit(int pos, int old_len, int new_len, int old_line_count);
+
+    // Row layouts (lookups are O(log n) in the number of characters of the row once the row is laid out)
+    ImGuiInputTextRowLayout* GetRowLayout(int row_start);
+    ImGuiInputTextRowLayout* FindRowLayout(int row_start);  // Return NULL instead of laying out the row if it isn't cached
+    void        RowLayoutsClear(bool free_memory = false);
+
     // Reload user buf (WIP #2890)
     // If you modify underlying user-passed const char* while active you need to call this (InputText V2 may lift this)
     //   strcpy(my_buf, "hello");
@@ -1231,6 +1360,9 @@ enum ImGuiNextItemDataFlags_
     ImGuiNextItemDataFlags_HasShortcut  = 1 << 2,
     ImGuiNextItemDataFlags_HasRefVal    = 1 << 3,
     ImGuiNextItemDataFlags_HasStorageID = 1 << 4,
+    ImGuiNextItemDataFlags_HasTextGeneration = 1 << 5,
+    ImGuiNextItemDataFlags_HasTextFind  = 1 << 6,
+    ImGuiNextItemDataFlags_HasTextReplaceAll = 1 << 7,
 };
 
 struct ImGuiNextItemData
@@ -1247,6 +1379,10 @@ struct ImGuiNextItemData
     ImU8                        OpenCond;           // Set by SetNextItemOpen()
     ImGuiDataTypeStorage        RefVal;             // Not exposed yet, for ImGuiInputTextFlags_ParseEmptyAsRefVal
     ImGuiID                     StorageId;          // Set by SetNextItemStorageID()
+    ImU32                       TextGeneration;     // Set by SetNextItemTextGeneration()
+    const char*                 TextFind;           // Set by SetNextItemTextFind(), only valid during the next item call
+    bool                        TextFindIgnoreCase; // Set by SetNextItemTextFind()
+    const char*                 TextReplace;        // Set by SetNextItemTextReplaceAll(), only valid during the next item call
 
     ImGuiNextItemData()         { memset(this, 0, sizeof(*this)); SelectionUserData = -1; }
     inline void ClearFlags()    { HasFlags = ImGuiNextItemDataFlags_None; ItemFlags = ImGuiItemFlags_None; } // Also cleared manually by ItemAdd()!
@@ -2302,6 +2438,8 @@ struct ImGuiContext
     // Widget state
     ImGuiInputTextState     InputTextState;
     ImGuiInputTextDeactivatedState InputTextDeactivatedState;
+    ImPool<ImGuiInputTextLineCache> InputTextLineCaches;        // Line index of inactive multi-line InputText() which have a text generation (see SetNextItemTextGeneration()) or are word-wrapped
+    ImVector<int>           InputTextVisibleRowStarts;          // Temporary: starts of the visible rows of a multi-line InputText(), followed by the end of the last one
     ImFont                  InputTextPasswordFont;
     ImGuiID                 TempInputId;                        // Temporary text input when CTRL+clicking on a slider, etc.
     ImGuiDataTypeStorage    DataTypeZeroValue;                  // 0 for all data types
@@ -3460,7 +3598,7 @@ namespace ImGui
     IMGUI_API bool          DataTypeIsZero(ImGuiDataType data_type, const void* p_data);
 
     // InputText
-    IMGUI_API bool          InputTextEx(const char* label, const char* hint, char* buf, int buf_size, const ImVec2& size_arg, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback = NULL, void* user_data = NULL);
+    IMGUI_API bool          InputTextEx(const char* label, const char* hint, char* buf, int buf_size, const ImVec2& size_arg, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback = NULL, void* user_data = NULL, ImGuiInputTextStorage* storage = NULL);
     IMGUI_API void          InputTextDeactivateHook(ImGuiID id);
     IMGUI_API bool          TempInputText(const ImRect& bb, ImGuiID id, const char* label, char* buf, int buf_size, ImGuiInputTextFlags flags);
     IMGUI_API bool          TempInputScalar(const ImRect& bb, ImGuiID id, const char* label, ImGuiDataType data_type, void* p_data, const char* format, const void* p_clamp_min = NULL, const void* p_clamp_max = NULL);
@@ -3572,6 +3710,36 @@ IMGUI_API void      ImFontAtlasBuildRender32bppRectFromString(ImFontAtlas* atlas
 IMGUI_API void      ImFontAtlasBuildMultiplyCalcLookupTable(unsigned char out_table[256], float in_multiply_factor);
 IMGUI_API void      ImFontAtlasBuildMultiplyRectAlpha8(const unsigned char table[256], unsigned char* pixels, int x, int y, int w, int h, int stride);
 
+// Helper for text measurement: fast path over runs of ASCII characters (other than '\n' and '\r'), used by ImFont::CalcTextSizeA() and InputText().
+// Widths are accumulated in the same order as the one character at a time loop, so results are identical.
+// Blocks of 16 characters are summed in parallel only when this is provably exact: every advance is a multiple of 1/2^k and the total stays below 2^(24-k).
+// This is the case for pixel-snapped fonts such as the default font, drawn at their native size.
+struct ImFontAsciiMeasure
+{
+    ImFont*     Font;
+    float       Scale;
+    float       ExactLimit;         // -1.0f: not set up yet, 0.0f: parallel sums are not exact for this font/scale.
+    float       GridScale;          // 2^k
+    float       AdvanceMax;
+    float       Advances[128];      // Scaled advances, set up lazily on the first long run.
+
+    ImFontAsciiMeasure(ImFont* font, float scale) { Font = font; Scale = scale; ExactLimit = -1.0f; GridScale = AdvanceMax = 0.0f; }
+};
+IMGUI_API bool      ImFontMeasureAsciiRun(ImFontAsciiMeasure* measure, const char** p_text, const char* text_end, float* p_line_width, float max_width); // Return false when stopping before a character which would reach max_width.
+static inline bool  ImFontIsAsciiRunAhead(const char* text, const char* text_end)   // Are the next 16 bytes ASCII characters other than '\n' and '\r'? Shorter runs are not worth leaving the one character at a time loop.
+{
+#ifdef IMGUI_ENABLE_SSE
+    if (text_end - text < 16)
+        return false;
+    const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)text);
+    return _mm_movemask_epi8(_mm_or_si128(v, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))))) == 0;
+#else
+    IM_UNUSED(text);
+    IM_UNUSED(text_end);
+    return false;
+#endif
+}
+
 //-----------------------------------------------------------------------------
 // [SECTION] Test Engine specific hooks (imgui_test_engine)
 //-----------------------------------------------------------------------------
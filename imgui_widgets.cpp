@@ -149,6 +149,7 @@ static ImVec2   InputTextCalcTextSize(ImGuiContext* ctx, const char* text_begin,
 // - TextDisabledV()
 // - TextWrapped()
 // - TextWrappedV()
+// - TextWrappedIndexed()
 // - LabelText()
 // - LabelTextV()
 // - BulletText()
@@ -337,6 +338,50 @@ void ImGui::TextWrappedV(const char* fmt, va_list args)
         PopTextWrapPos();
 }
 
+void ImGui::TextWrappedIndexed(ImGuiTextWrapIndex* index, const char* text, const char* text_end)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems)
+        return;
+    ImGuiContext& g = *GImGui;
+
+    if (text_end == NULL)
+        text_end = text + strlen(text);
+
+    // Same wrap width as TextWrapped(), keeping existing wrap position if one is already set
+    const float wrap_pos_x = (window->DC.TextWrapPos >= 0.0f) ? window->DC.TextWrapPos : 0.0f;
+    const float wrap_width = CalcWrapWidthForPos(window->DC.CursorPos, wrap_pos_x);
+    if (index->Text != text || index->TextLen != (int)(text_end - text) || index->WrapWidth != wrap_width || index->Font != g.Font || index->FontSize != g.FontSize)
+        index->Build(g.Font, g.FontSize, wrap_width, text, text_end);
+
+    const ImVec2 text_pos(window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset);
+    const ImVec2 text_size(IM_TRUNC(index->TextSize.x + 0.99999f), index->TextSize.y); // Rounded as in CalcTextSize()
+    ImRect bb(text_pos, text_pos + text_size);
+    ItemSize(text_size, 0.0f);
+    if (!ItemAdd(bb, 0))
+        return;
+
+    // Render the visible rows only (logging needs the whole text)
+    // Each row is rendered without wrapping: a wrapped render of a range of rows could break them differently, as a break position depends on the text following the row.
+    // The blanks and '\n' skipped at the end of a row are invisible.
+    if (g.LogEnabled)
+    {
+        RenderTextWrapped(bb.Min, text, text_end, wrap_width);
+        return;
+    }
+    const float line_height = g.FontSize;
+    const int row_count = index->RowStarts.Size;
+    const int row_begin = ImClamp((int)((window->ClipRect.Min.y - text_pos.y) / line_height), 0, row_count);
+    const int row_end = ImClamp((int)((window->ClipRect.Max.y - text_pos.y) / line_height) + 1, row_begin, row_count);
+    const ImU32 col = GetColorU32(ImGuiCol_Text);
+    for (int row = row_begin; row < row_end; row++)
+    {
+        const char* row_text_begin = text + index->RowStarts[row];
+        const char* row_text_end = (row + 1 < row_count) ? text + index->RowStarts[row + 1] : text_end;
+        window->DrawList->AddText(g.Font, g.FontSize, ImVec2(text_pos.x, text_pos.y + row * line_height), col, row_text_begin, row_text_end);
+    }
+}
+
 void ImGui::LabelText(const char* label, const char* fmt, ...)
 {
     va_list args;
@@ -3836,6 +3881,9 @@ bool ImGui::InputDouble(const char* label, double* v, double step, double step_f
 // - InputText()
 // - InputTextWithHint()
 // - InputTextMultiline()
+// - SetNextItemTextGeneration()
+// - SetNextItemTextFind()
+// - SetNextItemTextReplaceAll()
 // - InputTextGetCharInfo() [Internal]
 // - InputTextReindexLines() [Internal]
 // - InputTextReindexLinesRange() [Internal]
@@ -3859,12 +3907,252 @@ bool ImGui::InputTextMultiline(const char* label, char* buf, size_t buf_size, co
     return InputTextEx(label, NULL, buf, (int)buf_size, size, flags | ImGuiInputTextFlags_Multiline, callback, user_data);
 }
 
+bool ImGui::InputTextMultiline(const char* label, ImGuiInputTextStorage* storage, const ImVec2& size, ImGuiInputTextFlags flags)
+{
+    IM_ASSERT(storage != NULL && storage->GetLengthFn != NULL && storage->GetSpanFn != NULL && storage->InsertCharsFn != NULL && storage->DeleteCharsFn != NULL);
+    const int len = storage->GetLengthFn(storage);
+    return InputTextEx(label, NULL, NULL, len + 1, size, flags | ImGuiInputTextFlags_Multiline, NULL, NULL, storage); // Spans of the text are requested by InputTextEx()
+}
+
 bool ImGui::InputTextWithHint(const char* label, const char* hint, char* buf, size_t buf_size, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* user_data)
 {
     IM_ASSERT(!(flags & ImGuiInputTextFlags_Multiline)); // call InputTextMultiline() or  InputTextEx() manually if you need multi-line + hint.
     return InputTextEx(label, hint, buf, (int)buf_size, ImVec2(0, 0), flags, callback, user_data);
 }
 
+// Let the next InputTextMultiline() cache its line index while inactive, rebuilding it only when 'generation' or the buffer pointer change.
+void ImGui::SetNextItemTextGeneration(ImU32 generation)
+{
+    ImGuiContext& g = *GImGui;
+    if (g.CurrentWindow->SkipItems)
+        return;
+    g.NextItemData.HasFlags |= ImGuiNextItemDataFlags_HasTextGeneration;
+    g.NextItemData.TextGeneration = generation;
+}
+
+// Highlight the matches of 'find' in the next InputTextMultiline(). The string is only read during the next item call.
+void ImGui::SetNextItemTextFind(const char* find, bool ignore_case)
+{
+    ImGuiContext& g = *GImGui;
+    if (g.CurrentWindow->SkipItems)
+        return;
+    IM_ASSERT(find != NULL);
+    g.NextItemData.HasFlags |= ImGuiNextItemDataFlags_HasTextFind;
+    g.NextItemData.TextFind = find;
+    g.NextItemData.TextFindIgnoreCase = ignore_case;
+}
+
+// Replace the matches of the SetNextItemTextFind() text in the next InputTextMultiline(). The string is only read during the next item call.
+void ImGui::SetNextItemTextReplaceAll(const char* replace)
+{
+    ImGuiContext& g = *GImGui;
+    if (g.CurrentWindow->SkipItems)
+        return;
+    IM_ASSERT(replace != NULL);
+    IM_ASSERT((g.NextItemData.HasFlags & ImGuiNextItemDataFlags_HasTextFind) && "Call SetNextItemTextFind() first!");
+    g.NextItemData.HasFlags |= ImGuiNextItemDataFlags_HasTextReplaceAll;
+    g.NextItemData.TextReplace = replace;
+}
+
+// Word-wrapping for InputTextMultiline() with ImGuiInputTextFlags_WordWrap. Lines are broken with ImFont::CalcWordWrapPositionA().
+// Rows partition the text: the blanks a row was broken at belong to it, and so does the new line character when nothing but blanks follows.
+// Return the start of the row following the one starting at 'row_start', or 'line_end' (its new line character or end of text) if it is the last row of its line.
+static const char* InputTextWrapNextRow(ImFont* font, float scale, const char* row_start, const char* line_end, float wrap_width)
+{
+    const char* s = font->CalcWordWrapPositionA(scale, row_start, line_end, wrap_width);
+    if (s >= line_end)
+        return line_end;
+    if (s == row_start + 1) // Not even one character fits: don't break inside a multi-byte character
+    {
+        unsigned int c;
+        s = row_start + ImTextCharFromUtf8(&c, row_start, line_end);
+    }
+    while (s < line_end && ImCharIsBlankA(*s))
+        s++;
+    return s;
+}
+
+// Append the offsets (from 'text') of the rows of the line [line, line_end).
+static void InputTextWrapLine(ImFont* font, float scale, const char* text, const char* line, const char* line_end, float wrap_width, ImVector<int>* out_rows)
+{
+    const char* row = line;
+    do
+    {
+        out_rows->push_back((int)(row - text));
+        row = InputTextWrapNextRow(font, scale, row, line_end, wrap_width);
+    }
+    while (row < line_end);
+}
+
+// Index the lines of [buf, buf_end).
+static void InputTextLineCacheIndex(ImGuiInputTextLineCache* line_cache, const char* buf, const char* buf_end)
+{
+    line_cache->LineStarts.resize(0);
+    line_cache->LineStarts.push_back(0);
+    for (const char* s = buf; (s = (const char*)memchr(s, '\n', (size_t)(buf_end - s))) != NULL; s++)
+        line_cache->LineStarts.push_back((int)(s + 1 - buf));
+    line_cache->Buf = buf;
+    line_cache->TextLen = (int)(buf_end - buf);
+    line_cache->WrapWidth = 0.0f;
+}
+
+// Line index of an inactive multiline widget with a text generation. Rebuilt when the buffer pointer or the generation change.
+// 'state' is the edit state of the widget if it still owns it: after the widget was deactivated, its line index (and rows) are taken over
+// instead of scanning the text again, unless the text was modified outside of the widget since its activation.
+// With a storage, the index is kept as long as the storage and the generation are the same: only the span pointer is updated.
+static ImGuiInputTextLineCache* InputTextGetLineCache(ImGuiContext* ctx, ImGuiID id, const char* buf, int buf_size, ImU32 generation, ImGuiInputTextState* state, ImGuiInputTextStorage* storage)
+{
+    ImGuiContext& g = *ctx;
+    ImGuiInputTextLineCache* line_cache = g.InputTextLineCaches.GetOrAddByKey(id);
+    line_cache->LastTimeActive = (float)g.Time;
+    if (line_cache->Generation == generation && line_cache->TextCopy.Size == 0)
+    {
+        if (storage == NULL && line_cache->Buf == buf && line_cache->TextLen < buf_size)
+            return line_cache;
+        if (storage != NULL && line_cache->Storage == storage && line_cache->TextLen == buf_size - 1)
+        {
+            line_cache->Buf = buf;
+            return line_cache;
+        }
+    }
+    line_cache->TextCopy.clear();
+    line_cache->Storage = storage;
+
+    if (state != NULL && state->LineStartsValid && state->TextGenerationValid && state->TextGeneration == generation && state->TextLen < buf_size && buf[state->TextLen] == 0)
+    {
+        line_cache->LineStarts.resize(state->LineStarts.Size);
+        for (int line_no = 0; line_no < state->LineStarts.Size; line_no++)
+            line_cache->LineStarts.Data[line_no] = state->GetLineStart(line_no);
+        line_cache->WrapWidth = 0.0f;
+        if (state->WrapWidth > 0.0f && state->WrapStaleCount == 0)
+        {
+            line_cache->WrapRowStarts.resize(state->WrapRowStarts.Size);
+            for (int row_no = 0; row_no < state->WrapRowStarts.Size; row_no++)
+                line_cache->WrapRowStarts.Data[row_no] = state->GetRowStart(row_no);
+            line_cache->WrapWidth = state->WrapWidth;
+            line_cache->WrapFont = state->WrapFont;
+            line_cache->WrapFontSize = state->WrapFontSize;
+        }
+        line_cache->Buf = buf;
+        line_cache->Generation = generation;
+        line_cache->TextLen = state->TextLen;
+        return line_cache;
+    }
+
+    InputTextLineCacheIndex(line_cache, buf, buf + strlen(buf));
+    line_cache->Generation = generation;
+    return line_cache;
+}
+
+// Line index of an inactive word-wrapped widget without a text generation. Rebuilt when the buffer pointer or the text change,
+// which is found by comparing the text with a copy: much cheaper than laying out its rows again every frame.
+static ImGuiInputTextLineCache* InputTextGetLineCacheByText(ImGuiContext* ctx, ImGuiID id, const char* buf)
+{
+    ImGuiContext& g = *ctx;
+    ImGuiInputTextLineCache* line_cache = g.InputTextLineCaches.GetOrAddByKey(id);
+    line_cache->LastTimeActive = (float)g.Time;
+    const int text_len = (int)strlen(buf);
+    if (line_cache->Buf == buf && line_cache->TextLen == text_len && line_cache->TextCopy.Size == text_len + 1 && memcmp(line_cache->TextCopy.Data, buf, (size_t)text_len) == 0)
+        return line_cache;
+
+    line_cache->TextCopy.resize(text_len + 1);
+    memcpy(line_cache->TextCopy.Data, buf, (size_t)text_len + 1);
+    line_cache->Storage = NULL;
+    InputTextLineCacheIndex(line_cache, buf, buf + text_len);
+    line_cache->Generation = 0;
+    return line_cache;
+}
+
+// Request the span [begin, end) of the text of a storage, widened by 'margin' bytes on each side. Return it, its offset in the text and its end.
+static const char* InputTextGetStorageSpan(ImGuiInputTextStorage* storage, int text_len, int begin, int end, int margin, int* out_offset, const char** out_end)
+{
+    begin = ImMax(begin - margin, 0);
+    end = ImMin(end + margin, text_len);
+    const char* span = storage->GetSpanFn(storage, begin, end - begin);
+    *out_offset = begin;
+    *out_end = span + (end - begin);
+    return span;
+}
+
+// Lay out the rows of a cached text, unless they are already for the same width and font.
+static void InputTextLineCacheWrapRows(ImGuiContext* ctx, ImGuiInputTextLineCache* line_cache, float wrap_width)
+{
+    ImGuiContext& g = *ctx;
+    if (line_cache->WrapWidth == wrap_width && line_cache->WrapFont == g.Font && line_cache->WrapFontSize == g.FontSize)
+        return;
+    const char* text = line_cache->Buf;
+    const float scale = g.FontSize / g.Font->FontSize;
+    const int line_count = line_cache->LineStarts.Size;
+    line_cache->WrapRowStarts.resize(0);
+    for (int line_no = 0; line_no < line_count; line_no++)
+    {
+        const char* line_end = text + ((line_no + 1 < line_count) ? line_cache->LineStarts[line_no + 1] - 1 : line_cache->TextLen);
+        InputTextWrapLine(g.Font, scale, text, text + line_cache->LineStarts[line_no], line_end, wrap_width, &line_cache->WrapRowStarts);
+    }
+    line_cache->WrapWidth = wrap_width;
+    line_cache->WrapFont = g.Font;
+    line_cache->WrapFontSize = g.FontSize;
+}
+
+// Highlight the matches of 'find' in the rows 'first_row_no', 'first_row_no + 1'... starting at 'row_starts' offsets of 'text', followed by the end of the last one.
+// Searching starts a little before the first row, so that a match continuing from the row above is highlighted too.
+static void InputTextRenderFindMatches(ImGuiContext* ctx, ImDrawList* draw_list, const char* text, const char* text_end, const ImVector<int>& row_starts, int first_row_no, const ImVec2& text_pos, const ImVec4& clip_rect, const char* find, bool ignore_case)
+{
+    ImGuiContext& g = *ctx;
+    const int find_len = (int)strlen(find);
+    const char* rows_begin = text + row_starts[0];
+    const char* rows_end = text + row_starts.back();
+    const char* search_end = ImMin(rows_end + find_len - 1, text_end);
+    const ImU32 bg_color = ImGui::GetColorU32(ImGuiCol_TextSelectedBg, 0.5f);
+
+    // Matches are measured from the previous one on the same row, so that long lines with many matches are not measured again from their start
+    int measured_row_n = -1;
+    const char* measured_end = NULL;
+    float measured_x = 0.0f;
+    int row_n = 0;
+    const char* p = ImMax(rows_begin - (find_len - 1), text);
+    while (p < rows_end)
+    {
+        const char* match = ignore_case ? ImStristr(p, search_end, find, find + find_len) : ImStrstr(p, search_end, find, find + find_len);
+        if (match == NULL || match >= rows_end)
+            break;
+        const char* match_end = match + find_len;
+        p = match_end;
+        for (int n = row_n; n + 1 < row_starts.Size && text + row_starts[n] < match_end; n++)
+        {
+            const char* row_begin = text + row_starts[n];
+            const char* row_end = text + row_starts[n + 1];
+            if (row_end <= match)
+                continue;
+            row_n = n;
+            if (measured_row_n != n)
+            {
+                measured_row_n = n;
+                measured_end = row_begin;
+                measured_x = 0.0f;
+            }
+            const char* segment_begin = ImMax(match, row_begin);
+            const char* segment_end = ImMin(match_end, row_end);
+            const float x0 = measured_x + InputTextCalcTextSize(ctx, measured_end, segment_begin, NULL, NULL, true).x;
+            if (text_pos.x + x0 > clip_rect.z)
+            {
+                p = ImMax(p, row_end); // The rest of the row is not visible
+                break;
+            }
+            float width = InputTextCalcTextSize(ctx, segment_begin, segment_end, NULL, NULL, true).x;
+            measured_end = segment_end;
+            measured_x = x0 + width;
+            if (width <= 0.0f)
+                width = IM_TRUNC(g.Font->GetCharAdvance((ImWchar)' ') * 0.50f); // So we can see matched new lines
+            const ImVec2 row_pos(text_pos.x, text_pos.y + (first_row_no + n) * g.FontSize);
+            ImRect rect(row_pos + ImVec2(x0, 0.0f), row_pos + ImVec2(x0 + width, g.FontSize));
+            rect.ClipWith(clip_rect);
+            if (rect.Overlaps(clip_rect))
+                draw_list->AddRectFilled(rect.Min, rect.Max, bg_color);
+        }
+    }
+}
+
 // This is only used in the path where the multiline widget is inactivate.
 static int InputTextCalcTextLenAndLineCount(const char* text_begin, const char** out_text_end)
 {
@@ -3892,6 +4180,7 @@ static ImVec2 InputTextCalcTextSize(ImGuiContext* ctx, const char* text_begin, c
     ImFont* font = g.Font;
     const float line_height = g.FontSize;
     const float scale = line_height / font->FontSize;
+    ImFontAsciiMeasure ascii_measure(font, scale);
 
     ImVec2 text_size = ImVec2(0, 0);
     float line_width = 0.0f;
@@ -3899,6 +4188,11 @@ static ImVec2 InputTextCalcTextSize(ImGuiContext* ctx, const char* text_begin, c
     const char* s = text_begin;
     while (s < text_end)
     {
+        if (ImFontIsAsciiRunAhead(s, text_end))
+        {
+            ImFontMeasureAsciiRun(&ascii_measure, &s, text_end, &line_width, FLT_MAX);
+            continue;
+        }
         unsigned int c = (unsigned int)*s;
         if (c < 0x80)
             s += 1;
@@ -3945,19 +4239,35 @@ namespace ImStb
 {
 static int     STB_TEXTEDIT_STRINGLEN(const ImGuiInputTextState* obj)                             { return obj->TextLen; }
 static char    STB_TEXTEDIT_GETCHAR(const ImGuiInputTextState* obj, int idx)                      { IM_ASSERT(idx <= obj->TextLen); return obj->TextSrc[idx]; }
-static float   STB_TEXTEDIT_GETWIDTH(ImGuiInputTextState* obj, int line_start_idx, int char_idx)  { unsigned int c; ImTextCharFromUtf8(&c, obj->TextSrc + line_start_idx + char_idx, obj->TextSrc + obj->TextLen); if ((ImWchar)c == '\n') return IMSTB_TEXTEDIT_GETWIDTH_NEWLINE; ImGuiContext& g = *obj->Ctx; return g.Font->GetCharAdvance((ImWchar)c) * g.FontScale; }
 static char    STB_TEXTEDIT_NEWLINE = '\n';
+static float   STB_TEXTEDIT_GETWIDTH(ImGuiInputTextState* obj, int line_start_idx, int char_idx)
+{
+    unsigned int c;
+    const int pos = line_start_idx + char_idx;
+    const int char_len = ImTextCharFromUtf8(&c, obj->TextSrc + pos, obj->TextSrc + obj->TextLen);
+    if ((ImWchar)c == '\n')
+        return IMSTB_TEXTEDIT_GETWIDTH_NEWLINE;
+
+    // The last character of a wrapped row is reported like a new line, so that moving up/down stops before it: after it is the start of the next row.
+    if (obj->WrapWidth > 0.0f)
+    {
+        const int row_no = obj->GetRowFromPos(line_start_idx);
+        if (row_no + 1 < obj->WrapRowStarts.Size && obj->GetRowStart(row_no + 1) == pos + char_len)
+            return IMSTB_TEXTEDIT_GETWIDTH_NEWLINE;
+    }
+    ImGuiContext& g = *obj->Ctx;
+    return g.Font->GetCharAdvance((ImWchar)c) * g.FontScale;
+}
+// Rows are lines, or come from the row index with word-wrapping. The last character of a wrapped row is not part of its width (see STB_TEXTEDIT_GETWIDTH).
 static void    STB_TEXTEDIT_LAYOUTROW(StbTexteditRow* r, ImGuiInputTextState* obj, int line_start_idx)
 {
-    const char* text = obj->TextSrc;
-    const char* text_remaining = NULL;
-    const ImVec2 size = InputTextCalcTextSize(obj->Ctx, text + line_start_idx, text + obj->TextLen, &text_remaining, NULL, true);
+    const ImGuiInputTextRowLayout* layout = obj->GetRowLayout(line_start_idx);
     r->x0 = 0.0f;
-    r->x1 = size.x;
-    r->baseline_y_delta = size.y;
+    r->x1 = layout->CharX.back();
+    r->baseline_y_delta = obj->Ctx->FontSize;
     r->ymin = 0.0f;
-    r->ymax = size.y;
-    r->num_chars = (int)(text_remaining - (text + line_start_idx));
+    r->ymax = obj->Ctx->FontSize;
+    r->num_chars = layout->RowEnd - line_start_idx;
 }
 
 #define IMSTB_TEXTEDIT_GETNEXTCHARINDEX  IMSTB_TEXTEDIT_GETNEXTCHARINDEX_IMPL
@@ -4053,15 +4363,70 @@ static int  STB_TEXTEDIT_MOVEWORDRIGHT_IMPL(ImGuiInputTextState* obj, int idx)
 #define STB_TEXTEDIT_MOVEWORDLEFT       STB_TEXTEDIT_MOVEWORDLEFT_IMPL  // They need to be #define for stb_textedit.h
 #define STB_TEXTEDIT_MOVEWORDRIGHT      STB_TEXTEDIT_MOVEWORDRIGHT_IMPL
 
+// Let stb_textedit.h start its row searches one row before the target instead of laying out every row from the start of the text.
+// Rows are lines here (one LAYOUTROW call per line, each line being g.FontSize high), or visual rows with ImGuiInputTextFlags_WordWrap.
+static void STB_TEXTEDIT_SEEKROW_CHAR_IMPL(ImGuiInputTextState* obj, int n, int* out_row_start, int* out_prev_row_start, float* out_row_y)
+{
+    if (obj->WrapWidth > 0.0f)
+    {
+        const int row_no = ImMax(obj->GetRowFromPos(n) - 1, 0);
+        *out_row_start = obj->GetRowStart(row_no);
+        *out_prev_row_start = (row_no > 0) ? obj->GetRowStart(row_no - 1) : 0;
+        *out_row_y = row_no * obj->Ctx->FontSize;
+        return;
+    }
+    const int line_no = ImMax(obj->GetLineFromPos(n) - 1, 0);
+    *out_row_start = obj->GetLineStart(line_no);
+    *out_prev_row_start = (line_no > 0) ? obj->GetLineStart(line_no - 1) : 0;
+    *out_row_y = line_no * obj->Ctx->FontSize;
+}
+static void STB_TEXTEDIT_SEEKROW_Y_IMPL(ImGuiInputTextState* obj, float y, int* out_row_start, float* out_row_y)
+{
+    const float line_height = obj->Ctx->FontSize;
+    if (obj->WrapWidth > 0.0f)
+    {
+        const int row_no = (int)ImClamp(y / line_height - 1.0f, 0.0f, (float)(obj->GetRowCount() - 1));
+        *out_row_start = obj->GetRowStart(row_no);
+        *out_row_y = row_no * line_height;
+        return;
+    }
+    const int line_no = (int)ImClamp(y / line_height - 1.0f, 0.0f, (float)(obj->GetLineCount() - 1));
+    *out_row_start = obj->GetLineStart(line_no);
+    *out_row_y = line_no * line_height;
+}
+#define STB_TEXTEDIT_SEEKROW_CHAR       STB_TEXTEDIT_SEEKROW_CHAR_IMPL
+#define STB_TEXTEDIT_SEEKROW_Y          STB_TEXTEDIT_SEEKROW_Y_IMPL
+
+// Position characters in a row with its cached layout (see ImGuiInputTextState::GetRowLayout()) rather than summing STB_TEXTEDIT_GETWIDTH() from the row start.
+static float STB_TEXTEDIT_GETROWX_IMPL(ImGuiInputTextState* obj, int row_start, int n)     { return (n > row_start) ? obj->GetRowLayout(row_start)->GetCharX(n) : 0.0f; }
+static int   STB_TEXTEDIT_FINDROWX_IMPL(ImGuiInputTextState* obj, int row_start, float x)   { return obj->GetRowLayout(row_start)->FindCharAtX(x); }
+static int   STB_TEXTEDIT_LOCATEROWX_IMPL(ImGuiInputTextState* obj, int row_start, float x) { return obj->GetRowLayout(row_start)->LocateCharAtX(x); }
+#define STB_TEXTEDIT_GETROWX            STB_TEXTEDIT_GETROWX_IMPL
+#define STB_TEXTEDIT_FINDROWX           STB_TEXTEDIT_FINDROWX_IMPL
+#define STB_TEXTEDIT_LOCATEROWX         STB_TEXTEDIT_LOCATEROWX_IMPL
+
 static void STB_TEXTEDIT_DELETECHARS(ImGuiInputTextState* obj, int pos, int n)
 {
-    // Offset remaining text (+ copy zero terminator)
-    IM_ASSERT(obj->TextSrc == obj->TextA.Data);
-    char* dst = obj->TextA.Data + pos;
-    char* src = obj->TextA.Data + pos + n;
-    memmove(dst, src, obj->TextLen - n - pos + 1);
+    const int old_line_count = obj->LineStarts.Size;
+    if (obj->LineStartsValid)
+        obj->LineIndexOnDelete(pos, n);
+    if (ImGuiInputTextStorage* storage = obj->Storage)
+    {
+        storage->DeleteCharsFn(storage, pos, n);
+        obj->TextSrc = storage->GetSpanFn(storage, 0, obj->TextLen - n);
+    }
+    else
+    {
+        // Offset remaining text (+ copy zero terminator)
+        IM_ASSERT(obj->TextSrc == obj->TextA.Data);
+        char* dst = obj->TextA.Data + pos;
+        char* src = obj->TextA.Data + pos + n;
+        memmove(dst, src, obj->TextLen - n - pos + 1);
+    }
     obj->Edited = true;
     obj->TextLen -= n;
+    if (obj->LineStartsValid && obj->WrapWidth > 0.0f)
+        obj->WrapIndexOnEdit(pos, n, 0, old_line_count);
 }
 
 static bool STB_TEXTEDIT_INSERTCHARS(ImGuiInputTextState* obj, int pos, const char* new_text, int new_text_len)
@@ -4070,31 +4435,369 @@ static bool STB_TEXTEDIT_INSERTCHARS(ImGuiInputTextState* obj, int pos, const ch
     const int text_len = obj->TextLen;
     IM_ASSERT(pos <= text_len);
 
-    if (!is_resizable && (new_text_len + obj->TextLen + 1 > obj->BufCapacity))
-        return false;
-
-    // Grow internal buffer if needed
-    IM_ASSERT(obj->TextSrc == obj->TextA.Data);
-    if (new_text_len + text_len + 1 > obj->TextA.Size)
+    if (ImGuiInputTextStorage* storage = obj->Storage)
     {
-        if (!is_resizable)
+        // Caller-owned storage has no capacity limit
+        storage->InsertCharsFn(storage, pos, new_text, new_text_len);
+        obj->TextSrc = storage->GetSpanFn(storage, 0, text_len + new_text_len);
+    }
+    else
+    {
+        if (!is_resizable && (new_text_len + obj->TextLen + 1 > obj->BufCapacity))
             return false;
-        obj->TextA.resize(text_len + ImClamp(new_text_len, 32, ImMax(256, new_text_len)) + 1);
-        obj->TextSrc = obj->TextA.Data;
+
+        // Grow internal buffer if needed
+        IM_ASSERT(obj->TextSrc == obj->TextA.Data);
+        if (new_text_len + text_len + 1 > obj->TextA.Size)
+        {
+            if (!is_resizable)
+                return false;
+            // Grow from the new size rather than from the old capacity, so that typing after a large paste doesn't reallocate again
+            const int new_size = text_len + new_text_len + 1;
+            if (new_size > obj->TextA.Capacity)
+                obj->TextA.reserve(new_size + new_size / 2);
+            obj->TextA.resize(text_len + ImClamp(new_text_len, 32, ImMax(256, new_text_len)) + 1);
+            obj->TextSrc = obj->TextA.Data;
+        }
+
+        char* text = obj->TextA.Data;
+        if (pos != text_len)
+            memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos));
+        memcpy(text + pos, new_text, (size_t)new_text_len);
+        text[text_len + new_text_len] = '\0';
     }
 
-    char* text = obj->TextA.Data;
-    if (pos != text_len)
-        memmove(text + pos + new_text_len, text + pos, (size_t)(text_len - pos));
-    memcpy(text + pos, new_text, (size_t)new_text_len);
+    const int old_line_count = obj->LineStarts.Size;
+    if (obj->LineStartsValid)
+        obj->LineIndexOnInsert(pos, new_text, new_text_len);
 
     obj->Edited = true;
     obj->TextLen += new_text_len;
-    obj->TextA[obj->TextLen] = '\0';
+    if (obj->LineStartsValid && obj->WrapWidth > 0.0f)
+        obj->WrapIndexOnEdit(pos, 0, new_text_len, old_line_count);
+
+    return true;
+}
+
+// Undo history, replacing the fixed size buffers of stb_textedit.h (see ImGuiInputTextUndoStack).
+// Deleted text is copied into chunks when an edit is recorded. Inserted text is only referenced by position and length,
+// and only copied when the edit is undone (to be able to redo it). Consecutive typed characters extend the same record.
+static const int UNDO_CHUNK_MIN_SIZE = 256;
+static const int UNDO_CHUNK_MAX_SIZE = 64 * 1024;
+
+static ImGuiInputTextUndoChunk* InputTextUndoStoreText(ImGuiInputTextUndoStack* stack, const char* text, int len, int budget, int* out_offset)
+{
+    ImGuiInputTextUndoChunk* chunk = stack->CurrentChunk;
+    if (chunk == NULL || chunk->Size + len > chunk->Capacity)
+    {
+        // Large texts get a chunk of their own, small ones are appended to a shared chunk (growing up to 1/8th of the budget)
+        const int shared_capacity_max = ImClamp(budget / 8, 16, UNDO_CHUNK_MAX_SIZE);
+        const bool is_shared = (len <= shared_capacity_max / 4);
+        const int capacity = is_shared ? ImMax(ImMin(ImMax(chunk ? chunk->Capacity * 2 : 0, UNDO_CHUNK_MIN_SIZE), shared_capacity_max), len) : len;
+        chunk = (ImGuiInputTextUndoChunk*)IM_ALLOC(sizeof(ImGuiInputTextUndoChunk) + (size_t)capacity);
+        chunk->Size = 0;
+        chunk->Capacity = capacity;
+        chunk->RefCount = 0;
+        stack->ChunksMemory += (int)sizeof(ImGuiInputTextUndoChunk) + capacity;
+        if (is_shared)
+        {
+            if (ImGuiInputTextUndoChunk* prev_chunk = stack->CurrentChunk)
+                if (prev_chunk->RefCount == 0)
+                {
+                    stack->ChunksMemory -= (int)sizeof(ImGuiInputTextUndoChunk) + prev_chunk->Capacity;
+                    IM_FREE(prev_chunk);
+                }
+            stack->CurrentChunk = chunk;
+        }
+    }
+    *out_offset = chunk->Size;
+    memcpy(chunk->Data() + chunk->Size, text, (size_t)len);
+    chunk->Size += len;
+    chunk->RefCount++;
+    return chunk;
+}
+
+static void InputTextUndoReleaseText(ImGuiInputTextUndoStack* stack, ImGuiInputTextUndoChunk* chunk)
+{
+    if (chunk == NULL || --chunk->RefCount > 0)
+        return;
+    if (chunk == stack->CurrentChunk)
+    {
+        chunk->Size = 0; // Keep for reuse
+        return;
+    }
+    stack->ChunksMemory -= (int)sizeof(ImGuiInputTextUndoChunk) + chunk->Capacity;
+    IM_FREE(chunk);
+}
+
+static void InputTextUndoReleaseRecord(ImGuiInputTextUndoStack* stack, ImGuiInputTextUndoRecord* rec)
+{
+    InputTextUndoReleaseText(stack, rec->DeletedChunk);
+    InputTextUndoReleaseText(stack, rec->InsertedChunk);
+}
+
+static void InputTextUndoDiscardRedo(ImGuiInputTextUndoStack* stack)
+{
+    while (stack->Records.Size > stack->UndoPoint)
+    {
+        InputTextUndoReleaseRecord(stack, &stack->Records.back());
+        stack->Records.pop_back();
+    }
+}
 
+// Discard the oldest records, then the last redo records, until 'extra_bytes' fit in the budget. Record 'keep_n' is never discarded.
+static bool InputTextUndoMakeRoom(ImGuiInputTextUndoStack* stack, int extra_bytes, int budget, int keep_n)
+{
+    while (stack->GetMemoryUsage() + extra_bytes > budget)
+    {
+        if (stack->RecordsHead < stack->UndoPoint && stack->RecordsHead != keep_n)
+        {
+            InputTextUndoReleaseRecord(stack, &stack->Records[stack->RecordsHead]);
+            stack->RecordsHead++;
+        }
+        else if (stack->Records.Size > stack->UndoPoint && stack->Records.Size - 1 != keep_n)
+        {
+            InputTextUndoReleaseRecord(stack, &stack->Records.back());
+            stack->Records.pop_back();
+        }
+        else
+        {
+            return false;
+        }
+    }
     return true;
 }
 
+// Record that 'deleted_len' characters at 'where' are replaced by 'inserted_len' characters. 'data' is a copy of the deleted text,
+// or with 'replace_count' > 0 the replaced matches of a replace-all (see InputTextReplaceAll()).
+static void InputTextUndoPush(ImGuiInputTextState* obj, int where, int deleted_len, int inserted_len, const char* data, int data_len, int replace_count)
+{
+    ImGuiInputTextUndoStack* stack = &obj->UndoStack;
+    InputTextUndoDiscardRedo(stack);
+
+    // Extend the last record when typing, until the cursor moves, a key is pressed or a new line starts
+    if (stack->Typing && stack->MergeTyping && deleted_len == 0 && replace_count == 0 && stack->UndoPoint > stack->RecordsHead)
+    {
+        ImGuiInputTextUndoRecord* last_rec = &stack->Records.back();
+        if (last_rec->Typed && last_rec->InsertedChunk == NULL && last_rec->Where + last_rec->InsertedLen == where && (where == 0 || obj->TextSrc[where - 1] != '\n'))
+        {
+            last_rec->InsertedLen += inserted_len;
+            return;
+        }
+    }
+
+    // Drop the discarded records from the front of the array once they make up half of it
+    if (stack->RecordsHead >= 32 && stack->RecordsHead * 2 >= stack->Records.Size)
+    {
+        stack->Records.erase(stack->Records.Data, stack->Records.Data + stack->RecordsHead);
+        stack->UndoPoint -= stack->RecordsHead;
+        stack->RecordsHead = 0;
+    }
+
+    // The new record may not fit even alone, in which case we lose the whole history (older records refer to positions in the text before this edit)
+    const int budget = obj->Ctx->IO.ConfigInputTextUndoMemory;
+    if (!InputTextUndoMakeRoom(stack, (int)sizeof(ImGuiInputTextUndoRecord) + data_len, budget, -1))
+    {
+        stack->Clear();
+        return;
+    }
+    ImGuiInputTextUndoRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.Where = where;
+    rec.DeletedLen = deleted_len;
+    rec.InsertedLen = inserted_len;
+    rec.Typed = stack->Typing;
+    rec.ReplaceCount = replace_count;
+    if (data_len > 0)
+        rec.DeletedChunk = InputTextUndoStoreText(stack, data, data_len, budget, &rec.DeletedOffset);
+    stack->Records.push_back(rec);
+    stack->UndoPoint = stack->Records.Size;
+    stack->MergeTyping = stack->Typing;
+    if (!InputTextUndoMakeRoom(stack, 0, budget, stack->Records.Size - 1)) // Allocating a chunk may have gone over budget
+        stack->Clear();
+}
+
+static void STB_TEXTEDIT_UNDO_RECORD_IMPL(ImGuiInputTextState* obj, int where, int old_len, int new_len)
+{
+    if (obj->Flags & ImGuiInputTextFlags_NoUndoRedo)
+        return;
+    InputTextUndoPush(obj, where, old_len, new_len, obj->TextSrc + where, old_len, 0);
+}
+
+// Replace-all. The text from the first match to the end of the last one is rebuilt in a single pass, then replaced with a single edit.
+// Instead of a copy of that whole span, the undo record keeps the offsets of the matches and their text (their case may differ from the searched
+// text), followed by the replacement: undoing or redoing rebuilds the span again from the current text.
+static void InputTextFindAll(const char* text, int text_len, const char* find, int find_len, bool ignore_case, ImVector<int>* out_offsets)
+{
+    IM_ASSERT(find_len > 0);
+    const char* text_end = text + text_len;
+    for (const char* p = text; (p = ignore_case ? ImStristr(p, text_end, find, find + find_len) : ImStrstr(p, text_end, find, find + find_len)) != NULL; p += find_len)
+        out_offsets->push_back((int)(p - text));
+}
+
+// Write the text from offsets[0] to offsets[count - 1] + old_len, with the 'old_len' characters at each offset replaced by 'new_len' characters
+// read from 'new_texts' (advancing by 'new_texts_stride' for each match, 0 when they are all replaced by the same text). Return the end of the written text.
+static char* InputTextWriteReplacedSpan(char* dst, const char* text, const int* offsets, int count, int old_len, const char* new_texts, int new_texts_stride, int new_len)
+{
+    int pos = offsets[0];
+    for (int n = 0; n < count; n++)
+    {
+        memcpy(dst, text + pos, (size_t)(offsets[n] - pos));
+        dst += offsets[n] - pos;
+        memcpy(dst, new_texts + n * new_texts_stride, (size_t)new_len);
+        dst += new_len;
+        pos = offsets[n] + old_len;
+    }
+    return dst;
+}
+
+// Position of 'pos' once the matches were replaced. A position inside a match moves to the start of its replacement.
+static int InputTextReplaceAllMapPos(const ImVector<int>& offsets, int find_len, int replace_len, int pos)
+{
+    int lo = 0, hi = offsets.Size; // Find the number of matches starting before 'pos'
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) >> 1;
+        if (offsets[mid] < pos)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo > 0 && pos < offsets[lo - 1] + find_len)
+        return offsets[lo - 1] + (lo - 1) * (replace_len - find_len);
+    return pos + lo * (replace_len - find_len);
+}
+
+// Return the number of replaced matches (0 if the result doesn't fit in a non-resizable buffer)
+static int InputTextReplaceAll(ImGuiInputTextState* obj, const char* find, int find_len, bool ignore_case, const char* replace, int replace_len)
+{
+    ImVector<int> offsets;
+    InputTextFindAll(obj->TextSrc, obj->TextLen, find, find_len, ignore_case, &offsets);
+    if (offsets.Size == 0)
+        return 0;
+    const int count = offsets.Size;
+    const int where = offsets[0];
+    const int deleted_len = offsets.back() + find_len - where;
+    const int inserted_len = deleted_len + count * (replace_len - find_len);
+    if (obj->Storage == NULL && (obj->Flags & ImGuiInputTextFlags_CallbackResize) == 0 && obj->TextLen - deleted_len + inserted_len + 1 > obj->BufCapacity)
+        return 0;
+
+    ImVector<char> span;
+    span.resize(inserted_len + 1);
+    InputTextWriteReplacedSpan(span.Data, obj->TextSrc, offsets.Data, count, find_len, replace, 0, replace_len);
+    if ((obj->Flags & ImGuiInputTextFlags_NoUndoRedo) == 0)
+    {
+        ImVector<char> data;
+        data.resize((int)sizeof(int) * (2 + count) + replace_len + count * find_len);
+        char* p = data.Data;
+        memcpy(p, &find_len, sizeof(int));
+        memcpy(p + sizeof(int), &replace_len, sizeof(int));
+        p += sizeof(int) * 2;
+        memcpy(p, replace, (size_t)replace_len);
+        p += replace_len;
+        memcpy(p, offsets.Data, sizeof(int) * count);
+        p += sizeof(int) * count;
+        for (int n = 0; n < count; n++, p += find_len)
+            memcpy(p, obj->TextSrc + offsets[n], (size_t)find_len);
+        InputTextUndoPush(obj, where, deleted_len, inserted_len, data.Data, data.Size, count);
+    }
+
+    STB_TexteditState* stb = obj->Stb;
+    stb->cursor = InputTextReplaceAllMapPos(offsets, find_len, replace_len, stb->cursor);
+    stb->select_start = InputTextReplaceAllMapPos(offsets, find_len, replace_len, stb->select_start);
+    stb->select_end = InputTextReplaceAllMapPos(offsets, find_len, replace_len, stb->select_end);
+    stb->has_preferred_x = 0;
+    STB_TEXTEDIT_DELETECHARS(obj, where, deleted_len);
+    if (inserted_len > 0)
+        STB_TEXTEDIT_INSERTCHARS(obj, where, span.Data, inserted_len);
+    return count;
+}
+
+static int InputTextUndoApplyReplaceAll(ImGuiInputTextState* obj, const ImGuiInputTextUndoRecord* rec, bool redo)
+{
+    const char* data = rec->DeletedChunk->Data() + rec->DeletedOffset;
+    int find_len, replace_len;
+    memcpy(&find_len, data, sizeof(int));
+    memcpy(&replace_len, data + sizeof(int), sizeof(int));
+    const char* replace = data + sizeof(int) * 2;
+    const int count = rec->ReplaceCount;
+    ImVector<int> offsets;
+    offsets.resize(count);
+    memcpy(offsets.Data, replace + replace_len, sizeof(int) * count);
+    const char* matches = replace + replace_len + sizeof(int) * count;
+
+    const int old_len = redo ? rec->DeletedLen : rec->InsertedLen;
+    const int new_len = redo ? rec->InsertedLen : rec->DeletedLen;
+    ImVector<char> span;
+    span.resize(new_len + 1);
+    if (redo)
+    {
+        InputTextWriteReplacedSpan(span.Data, obj->TextSrc, offsets.Data, count, find_len, replace, 0, replace_len);
+    }
+    else
+    {
+        // The replacements are at the offsets of the matches, shifted by the difference of length of the previous ones
+        for (int n = 0; n < count; n++)
+            offsets[n] += n * (replace_len - find_len);
+        InputTextWriteReplacedSpan(span.Data, obj->TextSrc, offsets.Data, count, replace_len, matches, find_len, find_len);
+    }
+    STB_TEXTEDIT_DELETECHARS(obj, rec->Where, old_len);
+    if (new_len > 0)
+        STB_TEXTEDIT_INSERTCHARS(obj, rec->Where, span.Data, new_len);
+    return rec->Where + new_len;
+}
+
+static int STB_TEXTEDIT_UNDO_APPLY_IMPL(ImGuiInputTextState* obj, int redo)
+{
+    ImGuiInputTextUndoStack* stack = &obj->UndoStack;
+    stack->MergeTyping = false;
+    if (!redo)
+    {
+        if (stack->UndoPoint == stack->RecordsHead)
+            return -1;
+        const int rec_n = --stack->UndoPoint;
+        ImGuiInputTextUndoRecord* rec = &stack->Records[rec_n];
+        if (rec->ReplaceCount > 0)
+            return InputTextUndoApplyReplaceAll(obj, rec, false);
+
+        // Save the inserted text before deleting it, so we can redo. Without room for it, we lose the ability to redo.
+        bool can_redo = true;
+        if (rec->InsertedLen > 0 && rec->InsertedChunk == NULL)
+        {
+            const int budget = obj->Ctx->IO.ConfigInputTextUndoMemory;
+            can_redo = InputTextUndoMakeRoom(stack, rec->InsertedLen, budget, rec_n);
+            if (can_redo)
+            {
+                rec->InsertedChunk = InputTextUndoStoreText(stack, obj->TextSrc + rec->Where, rec->InsertedLen, budget, &rec->InsertedOffset);
+                can_redo = InputTextUndoMakeRoom(stack, 0, budget, rec_n);
+            }
+        }
+        if (rec->InsertedLen > 0)
+            STB_TEXTEDIT_DELETECHARS(obj, rec->Where, rec->InsertedLen);
+        if (rec->DeletedLen > 0)
+            STB_TEXTEDIT_INSERTCHARS(obj, rec->Where, rec->DeletedChunk->Data() + rec->DeletedOffset, rec->DeletedLen);
+        const int cursor = rec->Where + rec->DeletedLen;
+        if (!can_redo)
+            InputTextUndoDiscardRedo(stack);
+        return cursor;
+    }
+    else
+    {
+        if (stack->UndoPoint == stack->Records.Size)
+            return -1;
+        ImGuiInputTextUndoRecord* rec = &stack->Records[stack->UndoPoint++];
+        if (rec->ReplaceCount > 0)
+            return InputTextUndoApplyReplaceAll(obj, rec, true);
+        if (rec->DeletedLen > 0)
+            STB_TEXTEDIT_DELETECHARS(obj, rec->Where, rec->DeletedLen);
+        if (rec->InsertedLen > 0)
+            STB_TEXTEDIT_INSERTCHARS(obj, rec->Where, rec->InsertedChunk->Data() + rec->InsertedOffset, rec->InsertedLen);
+        return rec->Where + rec->InsertedLen;
+    }
+}
+#define STB_TEXTEDIT_UNDO_RECORD        STB_TEXTEDIT_UNDO_RECORD_IMPL
+#define STB_TEXTEDIT_UNDO_APPLY         STB_TEXTEDIT_UNDO_APPLY_IMPL
+
 // We don't use an enum so we can build even with conflicting symbols (if another user of stb_textedit.h leak their STB_TEXTEDIT_K_* symbols)
 #define STB_TEXTEDIT_K_LEFT         0x200000 // keyboard input to move cursor left
 #define STB_TEXTEDIT_K_RIGHT        0x200001 // keyboard input to move cursor right
@@ -4148,11 +4851,13 @@ ImGuiInputTextState::ImGuiInputTextState()
 
 ImGuiInputTextState::~ImGuiInputTextState()
 {
+    UndoStack.Clear();
     IM_DELETE(Stb);
 }
 
 void ImGuiInputTextState::OnKeyPressed(int key)
 {
+    UndoStack.MergeTyping = false;
     stb_textedit_key(this, Stb, key);
     CursorFollow = true;
     CursorAnimReset();
@@ -4164,7 +4869,9 @@ void ImGuiInputTextState::OnCharPressed(unsigned int c)
     // The changes we had to make to stb_textedit_key made it very much UTF-8 specific which is not too great.
     char utf8[5];
     ImTextCharToUtf8(utf8, c);
+    UndoStack.Typing = true;
     stb_textedit_text(this, Stb, utf8, (int)strlen(utf8));
+    UndoStack.Typing = false;
     CursorFollow = true;
     CursorAnimReset();
 }
@@ -4182,6 +4889,509 @@ void ImGuiInputTextState::ReloadUserBufAndSelectAll()       { WantReloadUserBuf
 void ImGuiInputTextState::ReloadUserBufAndKeepSelection()   { WantReloadUserBuf = true; ReloadSelectionStart = Stb->select_start; ReloadSelectionEnd = Stb->select_end; }
 void ImGuiInputTextState::ReloadUserBufAndMoveToEnd()       { WantReloadUserBuf = true; ReloadSelectionStart = ReloadSelectionEnd = INT_MAX; }
 
+void ImGuiInputTextUndoStack::Clear()
+{
+    for (int n = RecordsHead; n < Records.Size; n++)
+        ImStb::InputTextUndoReleaseRecord(this, &Records[n]);
+    if (CurrentChunk)
+    {
+        IM_ASSERT(CurrentChunk->RefCount == 0);
+        ChunksMemory -= (int)sizeof(ImGuiInputTextUndoChunk) + CurrentChunk->Capacity;
+        IM_FREE(CurrentChunk);
+        CurrentChunk = NULL;
+    }
+    IM_ASSERT(ChunksMemory == 0);
+    Records.resize(0);
+    RecordsHead = UndoPoint = 0;
+    MergeTyping = false;
+}
+
+// Line index of TextSrc. LineStarts[n] is the offset of the first character of line n, minus LineStartsDelta if n >= LineStartsDeltaLine.
+// Inserting or deleting text only moves that boundary to the edited line and adjusts LineStartsDelta, so that typing at the same place
+// doesn't touch the entries of all following lines. Entries are only added or removed when the edit contains new lines.
+void ImGuiInputTextState::LineIndexRebuild()
+{
+    const char* text = TextSrc;
+    const char* text_end = TextSrc + TextLen;
+    LineStarts.resize(0);
+    LineStarts.push_back(0);
+    for (const char* s = text; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++)
+        LineStarts.push_back((int)(s + 1 - text));
+    LineStartsDeltaLine = LineStarts.Size;
+    LineStartsDelta = 0;
+    LineStartsValid = true;
+    RowLayoutsClear();
+    if (WrapWidth > 0.0f)
+        WrapIndexReset();
+}
+
+void ImGuiInputTextState::LineIndexSet(const ImVector<int>& line_starts)
+{
+    LineStarts = line_starts;
+    LineStartsDeltaLine = LineStarts.Size;
+    LineStartsDelta = 0;
+    LineStartsValid = true;
+    RowLayoutsClear();
+    if (WrapWidth > 0.0f)
+        WrapIndexReset();
+}
+
+int ImGuiInputTextState::GetLineCount()
+{
+    if (!LineStartsValid)
+        LineIndexRebuild();
+    return LineStarts.Size;
+}
+
+// Return the line containing the character at 'pos' (a new line character belongs to the line it ends).
+int ImGuiInputTextState::GetLineFromPos(int pos)
+{
+    if (!LineStartsValid)
+        LineIndexRebuild();
+    int lo = 0, hi = LineStarts.Size - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) >> 1;
+        if (GetLineStart(mid) <= pos)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+// Make '*p_delta' apply to the entries of 'starts' from 'n' onward (instead of from '*p_delta_from' onward).
+static void InputTextIndexMoveDelta(ImVector<int>* starts, int* p_delta_from, int* p_delta, int n)
+{
+    int* data = starts->Data;
+    const int delta = *p_delta;
+    if (delta != 0)
+    {
+        for (int i = *p_delta_from; i < n; i++)
+            data[i] += delta;
+        for (int i = n; i < *p_delta_from; i++)
+            data[i] -= delta;
+    }
+    *p_delta_from = n;
+    if (n >= starts->Size)
+        *p_delta = 0;
+}
+
+// Called after the text was inserted.
+void ImGuiInputTextState::LineIndexOnInsert(int pos, const char* new_text, int new_text_len)
+{
+    RowLayoutsClear();
+    const int line_no = GetLineFromPos(pos);
+    InputTextIndexMoveDelta(&LineStarts, &LineStartsDeltaLine, &LineStartsDelta, line_no + 1);
+    LineStartsDelta += new_text_len;
+
+    const char* new_text_end = new_text + new_text_len;
+    int new_lines = 0;
+    for (const char* s = new_text; (s = (const char*)memchr(s, '\n', (size_t)(new_text_end - s))) != NULL; s++)
+        new_lines++;
+    if (new_lines == 0)
+        return;
+
+    // New entries land after the boundary, so they are stored without the delta as well
+    const int insert_at = line_no + 1;
+    const int old_size = LineStarts.Size;
+    LineStarts.resize(old_size + new_lines);
+    memmove(LineStarts.Data + insert_at + new_lines, LineStarts.Data + insert_at, (size_t)(old_size - insert_at) * sizeof(int));
+    int* out = LineStarts.Data + insert_at;
+    for (const char* s = new_text; (s = (const char*)memchr(s, '\n', (size_t)(new_text_end - s))) != NULL; s++)
+        *out++ = pos + (int)(s + 1 - new_text) - LineStartsDelta;
+}
+
+// Called before the text is deleted. Lines starting inside (pos, pos + n] lose their new line character.
+void ImGuiInputTextState::LineIndexOnDelete(int pos, int n)
+{
+    RowLayoutsClear();
+    const int line_first = GetLineFromPos(pos);
+    const int line_last = GetLineFromPos(pos + n);
+    InputTextIndexMoveDelta(&LineStarts, &LineStartsDeltaLine, &LineStartsDelta, line_last + 1);
+    if (line_last > line_first)
+        LineStarts.erase(LineStarts.Data + line_first + 1, LineStarts.Data + line_last + 1);
+    LineStartsDeltaLine = line_first + 1;
+    LineStartsDelta -= n;
+}
+
+// Visual rows for ImGuiInputTextFlags_WordWrap, stored like LineStarts (WrapRowStarts[n] is the row start minus WrapRowStartsDelta if n >= WrapRowStartsDeltaRow).
+// Edits lay out the rows of the edited lines again. When the wrap width or the font changes, lines are marked stale and keep their current rows
+// (which still partition the text) until they are reflowed: visible lines first, then the others a chunk at a time (see InputTextWrapReflowVisible()).
+static const int WRAP_REFLOW_BUDGET = 256 * 1024; // Bytes of text reflowed per frame in the background, or laid out at once by an edit
+
+int ImGuiInputTextState::GetRowFromPos(int pos)
+{
+    IM_ASSERT(WrapWidth > 0.0f);
+    if (!LineStartsValid)
+        LineIndexRebuild();
+    int lo = 0, hi = WrapRowStarts.Size - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) >> 1;
+        if (GetRowStart(mid) <= pos)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+// Start over from one stale row per line.
+void ImGuiInputTextState::WrapIndexReset()
+{
+    IM_ASSERT(LineStartsValid);
+    WrapRowStarts.resize(LineStarts.Size);
+    for (int n = 0; n < LineStarts.Size; n++)
+        WrapRowStarts.Data[n] = GetLineStart(n);
+    WrapRowStartsDeltaRow = WrapRowStarts.Size;
+    WrapRowStartsDelta = 0;
+    WrapLineStale.resize(LineStarts.Size);
+    for (int n = 0; n < WrapLineStale.Size; n++)
+        WrapLineStale.Data[n] = true;
+    WrapStaleCount = WrapLineStale.Size;
+    WrapReflowLine = 0;
+}
+
+// Replace rows [row_begin, row_end) with the rows of lines [line_begin, line_end), laid out for the current width or one row per line if 'stale'.
+static void InputTextWrapReplaceRows(ImGuiInputTextState* state, int line_begin, int line_end, int row_begin, int row_end, bool stale)
+{
+    ImGuiContext& g = *state->Ctx;
+    const char* text = state->TextSrc;
+    const float scale = g.FontSize / g.Font->FontSize;
+    ImVector<int> rows;
+    for (int line_no = line_begin; line_no < line_end; line_no++)
+    {
+        const char* line = text + state->GetLineStart(line_no);
+        if (stale)
+        {
+            rows.push_back((int)(line - text));
+            continue;
+        }
+        const char* line_end_p = (line_no + 1 < state->LineStarts.Size) ? text + state->GetLineStart(line_no + 1) - 1 : text + state->TextLen;
+        InputTextWrapLine(g.Font, scale, text, line, line_end_p, state->WrapWidth, &rows);
+    }
+
+    // Entries before the delta boundary are stored as is: move it past the replaced rows before splicing
+    ImVector<int>& starts = state->WrapRowStarts;
+    InputTextIndexMoveDelta(&starts, &state->WrapRowStartsDeltaRow, &state->WrapRowStartsDelta, row_end);
+    const int old_size = starts.Size;
+    const int size_diff = rows.Size - (row_end - row_begin);
+    if (size_diff > 0)
+        starts.resize(old_size + size_diff);
+    if (size_diff != 0)
+        memmove(starts.Data + row_end + size_diff, starts.Data + row_end, (size_t)(old_size - row_end) * sizeof(int));
+    if (size_diff < 0)
+        starts.resize(old_size + size_diff);
+    memcpy(starts.Data + row_begin, rows.Data, (size_t)rows.Size * sizeof(int));
+    state->WrapRowStartsDeltaRow = row_begin + rows.Size;
+}
+
+// Lay out lines [line_begin, line_end) again for the current width.
+void ImGuiInputTextState::WrapIndexReflowLines(int line_begin, int line_end)
+{
+    const int row_begin = GetRowFromPos(GetLineStart(line_begin));
+    const int row_end = (line_end < LineStarts.Size) ? GetRowFromPos(GetLineStart(line_end)) : WrapRowStarts.Size;
+    InputTextWrapReplaceRows(this, line_begin, line_end, row_begin, row_end, false);
+    for (int line_no = line_begin; line_no < line_end; line_no++)
+        if (WrapLineStale.Data[line_no])
+        {
+            WrapLineStale.Data[line_no] = false;
+            WrapStaleCount--;
+        }
+}
+
+// Called after 'old_len' bytes at 'pos' were replaced with 'new_len' bytes, once the text and LineStarts are up to date.
+// Rows of the lines touched by the edit are laid out again (or left to the background reflow if there is a lot of them), the following ones are shifted.
+void ImGuiInputTextState::WrapIndexOnEdit(int pos, int old_len, int new_len, int old_line_count)
+{
+    const int lines_added = LineStarts.Size - old_line_count;
+    const int line_first = GetLineFromPos(pos);
+    const int line_last = GetLineFromPos(pos + new_len);
+    const int line_last_old = line_last - lines_added;
+
+    // Rows are still in the old coordinates here: find the first row of the line following the edit
+    const int row_begin = GetRowFromPos(GetLineStart(line_first));
+    int row_end = WrapRowStarts.Size;
+    if (line_last + 1 < LineStarts.Size)
+    {
+        const int next_line_start_old = GetLineStart(line_last + 1) - new_len + old_len;
+        int lo = row_begin, hi = WrapRowStarts.Size - 1;
+        while (lo < hi)
+        {
+            const int mid = (lo + hi) >> 1;
+            if (GetRowStart(mid) < next_line_start_old)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        row_end = lo;
+    }
+    InputTextIndexMoveDelta(&WrapRowStarts, &WrapRowStartsDeltaRow, &WrapRowStartsDelta, row_end);
+    WrapRowStartsDelta += new_len - old_len;
+
+    // Lines [line_first, line_last_old] were replaced with lines [line_first, line_last]
+    const bool stale = (new_len > WRAP_REFLOW_BUDGET);
+    for (int line_no = line_first; line_no <= line_last_old; line_no++)
+        if (WrapLineStale.Data[line_no])
+            WrapStaleCount--;
+    if (lines_added > 0)
+    {
+        const int old_size = WrapLineStale.Size;
+        WrapLineStale.resize(old_size + lines_added);
+        memmove(WrapLineStale.Data + line_first + lines_added, WrapLineStale.Data + line_first, (size_t)(old_size - line_first) * sizeof(bool));
+    }
+    else if (lines_added < 0)
+        WrapLineStale.erase(WrapLineStale.Data + line_first, WrapLineStale.Data + line_first - lines_added);
+    for (int line_no = line_first; line_no <= line_last; line_no++)
+        WrapLineStale.Data[line_no] = stale;
+    if (stale)
+        WrapStaleCount += line_last - line_first + 1;
+    if (WrapReflowLine > line_last_old)
+        WrapReflowLine += lines_added;
+    else if (WrapReflowLine > line_first)
+        WrapReflowLine = line_first;
+
+    InputTextWrapReplaceRows(this, line_first, line_last + 1, row_begin, row_end, stale);
+}
+
+// Follow the current wrap width and font. When they change, every line becomes stale but keeps its rows until reflowed.
+static void InputTextWrapSetLayout(ImGuiInputTextState* state, float wrap_width)
+{
+    ImGuiContext& g = *state->Ctx;
+    state->GetLineCount(); // Rebuild the index first if needed
+    const bool was_wrapping = (state->WrapWidth > 0.0f);
+    if (was_wrapping && state->WrapWidth == wrap_width && state->WrapFont == g.Font && state->WrapFontSize == g.FontSize)
+        return;
+    state->WrapWidth = wrap_width;
+    state->WrapFont = g.Font;
+    state->WrapFontSize = g.FontSize;
+    if (!was_wrapping)
+    {
+        state->WrapIndexReset();
+        return;
+    }
+    for (int n = 0; n < state->WrapLineStale.Size; n++)
+        state->WrapLineStale.Data[n] = true;
+    state->WrapStaleCount = state->WrapLineStale.Size;
+}
+
+// Reflow the stale lines of the rows displayed between 'y_min' and 'y_max' (relative to the top of the text).
+static void InputTextWrapReflowVisible(ImGuiInputTextState* state, float y_min, float y_max)
+{
+    const float line_height = state->Ctx->FontSize;
+    while (state->WrapStaleCount > 0)
+    {
+        // Reflowing lines changes their number of rows: find the visible lines again after each run of stale lines
+        const int row_count = state->WrapRowStarts.Size;
+        const int row_min = ImClamp((int)(y_min / line_height) - 1, 0, row_count - 1);
+        const int row_max = ImClamp((int)(y_max / line_height) + 1, row_min, row_count - 1);
+        const int line_max = state->GetLineFromPos(state->GetRowStart(row_max));
+        int line_no = state->GetLineFromPos(state->GetRowStart(row_min));
+        while (line_no <= line_max && !state->WrapLineStale.Data[line_no])
+            line_no++;
+        if (line_no > line_max)
+            break;
+        int line_end = line_no + 1;
+        while (line_end <= line_max && state->WrapLineStale.Data[line_end])
+            line_end++;
+        state->WrapIndexReflowLines(line_no, line_end);
+    }
+}
+
+// Reflow stale lines from WrapReflowLine onward (wrapping around), about 'budget' bytes of text at most.
+// Returns the number of rows added before 'anchor_line', so that the caller may keep it in place.
+static int InputTextWrapReflowBackground(ImGuiInputTextState* state, int budget, int anchor_line)
+{
+    const int line_count = state->LineStarts.Size;
+    const int anchor_row = state->GetRowFromPos(state->GetLineStart(anchor_line));
+    int line_no = state->WrapReflowLine;
+    while (state->WrapStaleCount > 0 && budget > 0)
+    {
+        if (line_no >= line_count)
+            line_no = 0;
+        if (!state->WrapLineStale.Data[line_no])
+        {
+            line_no++;
+            continue;
+        }
+        int line_end = line_no;
+        while (line_end < line_count && state->WrapLineStale.Data[line_end] && budget > 0)
+        {
+            const int line_len = ((line_end + 1 < line_count) ? state->GetLineStart(line_end + 1) : state->TextLen) - state->GetLineStart(line_end);
+            budget -= line_len + 1;
+            line_end++;
+        }
+        state->WrapIndexReflowLines(line_no, line_end);
+        line_no = line_end;
+    }
+    state->WrapReflowLine = line_no;
+    return state->GetRowFromPos(state->GetLineStart(anchor_line)) - anchor_row;
+}
+
+// Row layouts: x positions are summed in the same order as InputTextCalcTextSize() so that they match the measured and rendered text.
+// Moving up/down looks at the row of the cursor, the one before it and the target row, so a few of them are kept until the text changes.
+static void InputTextCalcRowEnd(ImGuiInputTextState* state, int row_start, int* out_row_end, int* out_visible_end)
+{
+    const char* text = state->TextSrc;
+    int row_end;
+    bool is_wrapped = false;
+    if (state->WrapWidth > 0.0f)
+    {
+        const int row_no = state->GetRowFromPos(row_start);
+        row_end = state->GetRowEnd(row_no);
+        is_wrapped = (row_no + 1 < state->WrapRowStarts.Size && text[row_end - 1] != '\n');
+    }
+    else
+    {
+        const int line_no = state->GetLineFromPos(row_start);
+        row_end = (line_no + 1 < state->LineStarts.Size) ? state->GetLineStart(line_no + 1) : state->TextLen;
+    }
+    *out_row_end = row_end;
+    if (is_wrapped)
+        *out_visible_end = (int)(ImTextFindPreviousUtf8Codepoint(text, text + row_end) - text);
+    else
+        *out_visible_end = (row_end > row_start && text[row_end - 1] == '\n') ? row_end - 1 : row_end;
+}
+
+static ImGuiInputTextRowLayout* InputTextFindRowLayout(ImGuiInputTextState* state, int row_start, int row_end, int visible_end)
+{
+    ImGuiContext& g = *state->Ctx;
+    for (ImGuiInputTextRowLayout& layout : state->RowLayouts)
+        if (layout.Font == g.Font && layout.FontSize == g.FontSize && layout.RowStart == row_start && layout.RowEnd == row_end && layout.VisibleEnd == visible_end)
+        {
+            layout.LastUse = ++state->RowLayoutsUseCounter;
+            return &layout;
+        }
+    return NULL;
+}
+
+ImGuiInputTextRowLayout* ImGuiInputTextState::FindRowLayout(int row_start)
+{
+    int row_end, visible_end;
+    InputTextCalcRowEnd(this, row_start, &row_end, &visible_end);
+    return InputTextFindRowLayout(this, row_start, row_end, visible_end);
+}
+
+ImGuiInputTextRowLayout* ImGuiInputTextState::GetRowLayout(int row_start)
+{
+    int row_end, visible_end;
+    InputTextCalcRowEnd(this, row_start, &row_end, &visible_end);
+    if (ImGuiInputTextRowLayout* layout = InputTextFindRowLayout(this, row_start, row_end, visible_end))
+        return layout;
+
+    // Lay out the row in place of the least recently used one
+    ImGuiInputTextRowLayout* layout = &RowLayouts[0];
+    for (ImGuiInputTextRowLayout& candidate : RowLayouts)
+        if (candidate.LastUse < layout->LastUse)
+            layout = &candidate;
+    ImGuiContext& g = *Ctx;
+    ImFont* font = g.Font;
+    const float scale = g.FontSize / font->FontSize;
+    layout->RowStart = row_start;
+    layout->RowEnd = row_end;
+    layout->VisibleEnd = visible_end;
+    layout->Font = font;
+    layout->FontSize = g.FontSize;
+    layout->LastUse = ++RowLayoutsUseCounter;
+    layout->CharOffsets.resize(0);
+    layout->CharX.resize(0);
+    layout->CharX.reserve(visible_end - row_start + 1);
+
+    const char* text = TextSrc + row_start;
+    const char* text_end = TextSrc + visible_end;
+    float line_width = 0.0f;
+    bool has_offsets = false;
+    for (const char* s = text; s < text_end; )
+    {
+        unsigned int c = (unsigned int)*s;
+        const int char_len = (c < 0x80) ? 1 : ImTextCharFromUtf8(&c, s, text_end);
+        if (char_len > 1 && !has_offsets)
+        {
+            // First multi-byte character: offsets stop being character indices
+            has_offsets = true;
+            layout->CharOffsets.reserve(layout->CharX.capacity());
+            for (int n = 0; n < layout->CharX.Size; n++)
+                layout->CharOffsets.push_back(n);
+        }
+        if (has_offsets)
+            layout->CharOffsets.push_back((int)(s - text));
+        layout->CharX.push_back(line_width);
+        s += char_len;
+        if (c == '\r')
+            continue;
+        line_width += ((int)c < font->IndexAdvanceX.Size ? font->IndexAdvanceX.Data[c] : font->FallbackAdvanceX) * scale;
+    }
+    if (has_offsets)
+        layout->CharOffsets.push_back(visible_end - row_start);
+    layout->CharX.push_back(line_width);
+    return layout;
+}
+
+void ImGuiInputTextState::RowLayoutsClear(bool free_memory)
+{
+    for (ImGuiInputTextRowLayout& layout : RowLayouts)
+    {
+        layout.Font = NULL;
+        if (free_memory)
+        {
+            layout.CharOffsets.clear();
+            layout.CharX.clear();
+        }
+    }
+}
+
+// Return the x position of the character at 'pos' (positions past the visible end of the row are at its end).
+float ImGuiInputTextRowLayout::GetCharX(int pos) const
+{
+    const int offset = ImClamp(pos - RowStart, 0, VisibleEnd - RowStart);
+    if (CharOffsets.Size == 0)
+        return CharX.Data[offset];
+    int lo = 0, hi = CharOffsets.Size - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) >> 1;
+        if (CharOffsets.Data[mid] < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return CharX.Data[lo];
+}
+
+int ImGuiInputTextRowLayout::FindCharAtX(float x) const
+{
+    int lo = 0, hi = CharX.Size - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) >> 1;
+        if (CharX.Data[mid] <= x)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return RowStart + GetCharOffset(lo);
+}
+
+// Find the character straddling 'x' and return the boundary on the nearest side of it.
+int ImGuiInputTextRowLayout::LocateCharAtX(float x) const
+{
+    if (CharX.Size < 2)
+        return RowStart;
+    int lo = 1, hi = CharX.Size - 1;
+    while (lo < hi)
+    {
+        const int mid = (lo + hi) >> 1;
+        if (CharX.Data[mid] > x)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    const float char_x = CharX.Data[lo - 1];
+    const float char_w = CharX.Data[lo] - char_x;
+    return RowStart + GetCharOffset((x < char_x + char_w / 2) ? lo - 1 : lo);
+}
+
 ImGuiInputTextCallbackData::ImGuiInputTextCallbackData()
 {
     memset(this, 0, sizeof(*this));
@@ -4345,6 +5555,35 @@ static bool InputTextFilterCharacter(ImGuiContext* ctx, unsigned int* p_char, Im
     return true;
 }
 
+// Return the end of the run of ASCII characters at the start of 'text' which InputTextFilterCharacter() lets through unchanged
+// when no named filter nor ImGuiInputTextFlags_CallbackCharFilter is set: printable characters, plus new lines and tabs if allowed.
+static const char* InputTextSkipUnfilteredAscii(const char* text, const char* text_end, ImGuiInputTextFlags flags)
+{
+    const char allowed_a = (flags & ImGuiInputTextFlags_Multiline) ? '\n' : ' ';
+    const char allowed_b = (flags & ImGuiInputTextFlags_AllowTabInput) ? '\t' : ' ';
+    const char* p = text;
+#ifdef IMGUI_ENABLE_SSE
+    // Test 16 bytes at a time. A signed comparison with ' ' catches both control characters and non-ASCII bytes.
+    const __m128i v_space = _mm_set1_epi8(' ');
+    const __m128i v_allowed_a = _mm_set1_epi8(allowed_a);
+    const __m128i v_allowed_b = _mm_set1_epi8(allowed_b);
+    for (; text_end - p >= 16; p += 16)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(const void*)p);
+        const __m128i v_allowed = _mm_or_si128(_mm_cmpeq_epi8(v, v_allowed_a), _mm_cmpeq_epi8(v, v_allowed_b));
+        if (_mm_movemask_epi8(_mm_andnot_si128(v_allowed, _mm_cmplt_epi8(v, v_space))) != 0)
+            break;
+    }
+#endif
+    for (; p < text_end; p++)
+    {
+        const unsigned char c = (unsigned char)*p;
+        if ((c < ' ' || c >= 0x80) && c != (unsigned char)allowed_a && c != (unsigned char)allowed_b)
+            break;
+    }
+    return p;
+}
+
 // Find the shortest single replacement we can make to get from old_buf to new_buf
 // Note that this doesn't directly alter state->TextA, state->TextLen. They are expected to be made valid separately.
 // FIXME: Ideally we should transition toward (1) making InsertChars()/DeleteChars() update undo-stack (2) discourage (and keep reconcile) or obsolete (and remove reconcile) accessing buffer directly.
@@ -4366,10 +5605,8 @@ static void InputTextReconcileUndoState(ImGuiInputTextState* state, const char*
 
     const int insert_len = new_last_diff - first_diff + 1;
     const int delete_len = old_last_diff - first_diff + 1;
-    if (insert_len > 0 || delete_len > 0)
-        if (IMSTB_TEXTEDIT_CHARTYPE* p = stb_text_createundo(&state->Stb->undostate, first_diff, delete_len, insert_len))
-            for (int i = 0; i < delete_len; i++)
-                p[i] = old_buf[first_diff + i];
+    if ((insert_len > 0 || delete_len > 0) && (state->Flags & ImGuiInputTextFlags_NoUndoRedo) == 0)
+        ImStb::InputTextUndoPush(state, first_diff, delete_len, insert_len, old_buf + first_diff, delete_len, 0);
 }
 
 // As InputText() retain textual data and we currently provide a path for user to not retain it (via local variables)
@@ -4383,7 +5620,7 @@ void ImGui::InputTextDeactivateHook(ImGuiID id)
     if (id == 0 || state->ID != id)
         return;
     g.InputTextDeactivatedState.ID = state->ID;
-    if (state->Flags & ImGuiInputTextFlags_ReadOnly)
+    if ((state->Flags & ImGuiInputTextFlags_ReadOnly) || state->Storage != NULL) // A storage is edited in place
     {
         g.InputTextDeactivatedState.TextA.resize(0); // In theory this data won't be used, but clear to be neat.
     }
@@ -4404,16 +5641,18 @@ void ImGui::InputTextDeactivateHook(ImGuiID id)
 // - If you want to use ImGui::InputText() with std::string, see misc/cpp/imgui_stdlib.h
 // (FIXME: Rather confusing and messy function, among the worse part of our codebase, expecting to rewrite a V2 at some point.. Partly because we are
 //  doing UTF8 > U16 > UTF8 conversions on the go to easily interface with stb_textedit. Ideally should stay in UTF-8 all the time. See https://github.com/nothings/stb/issues/188)
-bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_size, const ImVec2& size_arg, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* callback_user_data)
+bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_size, const ImVec2& size_arg, ImGuiInputTextFlags flags, ImGuiInputTextCallback callback, void* callback_user_data, ImGuiInputTextStorage* storage)
 {
     ImGuiWindow* window = GetCurrentWindow();
     if (window->SkipItems)
         return false;
 
-    IM_ASSERT(buf != NULL && buf_size >= 0);
+    IM_ASSERT((buf != NULL || storage != NULL) && buf_size >= 0);
     IM_ASSERT(!((flags & ImGuiInputTextFlags_CallbackHistory) && (flags & ImGuiInputTextFlags_Multiline)));        // Can't use both together (they both use up/down keys)
     IM_ASSERT(!((flags & ImGuiInputTextFlags_CallbackCompletion) && (flags & ImGuiInputTextFlags_AllowTabInput))); // Can't use both together (they both use tab key)
     IM_ASSERT(!((flags & ImGuiInputTextFlags_ElideLeft) && (flags & ImGuiInputTextFlags_Multiline)));               // Multiline will not work with left-trimming
+    IM_ASSERT(!((flags & ImGuiInputTextFlags_WordWrap) && !(flags & ImGuiInputTextFlags_Multiline)));               // Word-wrapping is only supported by InputTextMultiline()
+    IM_ASSERT(storage == NULL || (callback == NULL && (flags & ImGuiInputTextFlags_CallbackResize) == 0));           // Callbacks are not supported when editing a storage
 
     ImGuiContext& g = *GImGui;
     ImGuiIO& io = g.IO;
@@ -4421,6 +5660,12 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
 
     const bool RENDER_SELECTION_WHEN_INACTIVE = false;
     const bool is_multiline = (flags & ImGuiInputTextFlags_Multiline) != 0;
+    const bool is_wordwrap = (flags & ImGuiInputTextFlags_WordWrap) != 0;
+    const bool has_text_generation = is_multiline && (g.NextItemData.HasFlags & ImGuiNextItemDataFlags_HasTextGeneration) != 0; // Cleared by ItemAdd()
+    const ImU32 text_generation = g.NextItemData.TextGeneration;
+    const char* text_find = (is_multiline && (g.NextItemData.HasFlags & ImGuiNextItemDataFlags_HasTextFind) && g.NextItemData.TextFind[0] != 0) ? g.NextItemData.TextFind : NULL;
+    const bool text_find_ignore_case = g.NextItemData.TextFindIgnoreCase;
+    const char* text_replace = (text_find != NULL && (g.NextItemData.HasFlags & ImGuiNextItemDataFlags_HasTextReplaceAll)) ? g.NextItemData.TextReplace : NULL;
 
     if (is_multiline) // Open group before calling GetID() because groups tracks id created within their scope (including the scrollbar)
         BeginGroup();
@@ -4461,7 +5706,8 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         PushStyleVar(ImGuiStyleVar_ChildRounding, style.FrameRounding);
         PushStyleVar(ImGuiStyleVar_ChildBorderSize, style.FrameBorderSize);
         PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0, 0)); // Ensure no clip rect so mouse hover can reach FramePadding edges
-        bool child_visible = BeginChildEx(label, id, frame_bb.GetSize(), ImGuiChildFlags_Borders, ImGuiWindowFlags_NoMove);
+        // Word-wrapping always displays the vertical scrollbar, so that the wrap width doesn't depend on the height of the wrapped text.
+        bool child_visible = BeginChildEx(label, id, frame_bb.GetSize(), ImGuiChildFlags_Borders, ImGuiWindowFlags_NoMove | (is_wordwrap ? ImGuiWindowFlags_AlwaysVerticalScrollbar : 0));
         g.NavActivateId = backup_activate_id;
         PopStyleVar(3);
         PopStyleColor();
@@ -4484,6 +5730,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             if (!ItemAdd(total_bb, id, &frame_bb, ImGuiItemFlags_Inputable))
                 return false;
     }
+    const float wrap_width = is_wordwrap ? ImMax(inner_size.x - style.FramePadding.x * 2.0f, 1.0f) : 0.0f;
 
     // Ensure mouse cursor is set even after switching to keyboard/gamepad mode. May generalize further? (#6417)
     bool hovered = ItemHoverable(frame_bb, id, g.LastItemData.ItemFlags | ImGuiItemFlags_NoNavDisableMouseHover);
@@ -4518,15 +5765,38 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
     const bool init_changed_specs = (state != NULL && state->Stb->single_line != !is_multiline); // state != NULL means its our state.
     const bool init_make_active = (user_clicked || user_scroll_finish || input_requested_by_nav);
     const bool init_state = (init_make_active || user_scroll_active);
+
+    // A storage is read as a single span whenever the widget works on the whole text. An inactive widget with a text generation and an up to date
+    // line index (and rows) only requests the span of its visible lines, when rendering them.
+    ImGuiInputTextLineCache* storage_line_cache = NULL;
+    if (storage != NULL)
+    {
+        if (has_text_generation && g.ActiveId != id && !init_state && !init_reload_from_user_buf && text_replace == NULL && !g.LogEnabled)
+            if (ImGuiInputTextLineCache* line_cache = g.InputTextLineCaches.GetByKey(id))
+                if (line_cache->Storage == storage && line_cache->Generation == text_generation && line_cache->TextLen == buf_size - 1 && line_cache->TextCopy.Size == 0)
+                    if (!is_wordwrap || (line_cache->WrapWidth == wrap_width && line_cache->WrapFont == g.Font && line_cache->WrapFontSize == g.FontSize))
+                        storage_line_cache = line_cache;
+        if (storage_line_cache == NULL)
+            buf = (char*)storage->GetSpanFn(storage, 0, buf_size - 1); // Never written to: edits go through the storage
+    }
+
     if (init_reload_from_user_buf)
     {
-        int new_len = (int)strlen(buf);
+        int new_len = storage ? buf_size - 1 : (int)strlen(buf);
         IM_ASSERT(new_len + 1 <= buf_size && "Is your input buffer properly zero-terminated?");
         state->WantReloadUserBuf = false;
-        InputTextReconcileUndoState(state, state->TextA.Data, state->TextLen, buf, new_len);
-        state->TextA.resize(buf_size + 1); // we use +1 to make sure that .Data is always pointing to at least an empty string.
+        if (storage != NULL)
+        {
+            state->UndoStack.Clear(); // We have no copy of the previous text to reconcile the undo stack with
+        }
+        else
+        {
+            InputTextReconcileUndoState(state, state->TextA.Data, state->TextLen, buf, new_len);
+            state->TextA.resize(buf_size + 1); // we use +1 to make sure that .Data is always pointing to at least an empty string.
+            memcpy(state->TextA.Data, buf, new_len + 1);
+        }
         state->TextLen = new_len;
-        memcpy(state->TextA.Data, buf, state->TextLen + 1);
+        state->LineStartsValid = false;
         state->Stb->select_start = state->ReloadSelectionStart;
         state->Stb->cursor = state->Stb->select_end = state->ReloadSelectionEnd;
         state->CursorClamp();
@@ -4541,22 +5811,35 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         InputTextDeactivateHook(state->ID);
 
         // Take a copy of the initial buffer value.
-        // From the moment we focused we are normally ignoring the content of 'buf' (unless we are in read-only mode)
-        const int buf_len = (int)strlen(buf);
+        // From the moment we focused we are normally ignoring the content of 'buf' (unless we are in read-only mode or editing a storage in place)
+        const int buf_len = storage ? buf_size - 1 : (int)strlen(buf);
         IM_ASSERT(buf_len + 1 <= buf_size && "Is your input buffer properly zero-terminated?");
-        state->TextToRevertTo.resize(buf_len + 1);    // UTF-8. we use +1 to make sure that .Data is always pointing to at least an empty string.
-        memcpy(state->TextToRevertTo.Data, buf, buf_len + 1);
+        if (storage == NULL)
+        {
+            state->TextToRevertTo.resize(buf_len + 1);    // UTF-8. we use +1 to make sure that .Data is always pointing to at least an empty string.
+            memcpy(state->TextToRevertTo.Data, buf, buf_len + 1);
+        }
 
         // Preserve cursor position and undo/redo stack if we come back to same widget
         // FIXME: Since we reworked this on 2022/06, may want to differentiate recycle_cursor vs recycle_undostate?
-        bool recycle_state = (state->ID == id && !init_changed_specs);
-        if (recycle_state && (state->TextLen != buf_len || (state->TextA.Data == NULL || strncmp(state->TextA.Data, buf, buf_len) != 0)))
+        // An unchanged text generation tells us the text is the one we left, without comparing it. A storage has no copy to compare with.
+        bool recycle_state = (state->ID == id && !init_changed_specs && state->TextLen == buf_len);
+        if (recycle_state && has_text_generation && state->TextGenerationValid)
+            recycle_state = (state->TextGeneration == text_generation);
+        else if (recycle_state && (storage != NULL || state->TextA.Data == NULL || strncmp(state->TextA.Data, buf, buf_len) != 0))
             recycle_state = false;
 
         // Start edition
         state->ID = id;
         state->TextLen = buf_len;
-        if (!is_readonly)
+        state->TextGenerationValid = has_text_generation;
+        state->TextGeneration = text_generation;
+        state->LineStartsValid = false;
+        if (has_text_generation && !is_readonly)
+            if (ImGuiInputTextLineCache* line_cache = g.InputTextLineCaches.GetByKey(id))
+                if ((storage ? line_cache->Storage == storage : line_cache->Buf == buf) && line_cache->Generation == text_generation && line_cache->TextLen == buf_len && line_cache->TextCopy.Size == 0)
+                    state->LineIndexSet(line_cache->LineStarts); // Take over the line index of the inactive widget instead of scanning the text again
+        if (!is_readonly && storage == NULL)
         {
             state->TextA.resize(buf_size + 1); // we use +1 to make sure that .Data is always pointing to at least an empty string.
             memcpy(state->TextA.Data, buf, state->TextLen + 1);
@@ -4572,7 +5855,10 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         if (recycle_state)
             state->CursorClamp();
         else
+        {
             stb_textedit_initialize_state(state->Stb, !is_multiline);
+            state->UndoStack.Clear();
+        }
 
         if (!is_multiline)
         {
@@ -4627,12 +5913,44 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
 
         // Read-only mode always ever read from source buffer. Refresh TextLen when active.
         if (is_readonly && state != NULL)
-            state->TextLen = (int)strlen(buf);
+            state->TextLen = storage ? buf_size - 1 : (int)strlen(buf);
         //if (is_readonly && state != NULL)
         //    state->TextA.clear(); // Uncomment to facilitate debugging, but we otherwise prefer to keep/amortize th allocation.
     }
     if (state != NULL)
-        state->TextSrc = is_readonly ? buf : state->TextA.Data;
+    {
+        state->TextSrc = (is_readonly || storage) ? buf : state->TextA.Data;
+        state->Storage = storage;
+        if (is_readonly && g.ActiveId == id)
+        {
+            // Source buffer may have been modified by the user: keep the line index (and rows) only while the text is known to be unchanged,
+            // from its text generation or else by comparing it with a copy in TextA (unused when read-only). Much cheaper than indexing and wrapping it again.
+            const int text_len = state->TextLen;
+            bool text_unchanged = state->LineStartsValid && state->ReadOnlySrc == buf && state->ReadOnlySrcLen == text_len && state->ReadOnlySrcHasGeneration == has_text_generation;
+            if (text_unchanged && has_text_generation)
+                text_unchanged = (state->ReadOnlySrcGeneration == text_generation);
+            else if (text_unchanged)
+                text_unchanged = (memcmp(state->TextA.Data, buf, (size_t)text_len) == 0);
+            if (!text_unchanged)
+            {
+                state->LineStartsValid = false;
+                state->ReadOnlySrc = buf;
+                state->ReadOnlySrcLen = text_len;
+                state->ReadOnlySrcHasGeneration = has_text_generation;
+                state->ReadOnlySrcGeneration = text_generation;
+                if (!has_text_generation)
+                {
+                    state->TextA.resize(text_len + 1);
+                    memcpy(state->TextA.Data, buf, (size_t)text_len);
+                    state->TextA.Data[text_len] = 0;
+                }
+            }
+        }
+        else if (is_readonly)
+        {
+            state->LineStartsValid = false; // Source buffer may have been modified by the user
+        }
+    }
 
     // We have an edge case if ActiveId was set through another widget (e.g. widget being swapped), clear id immediately (don't wait until the end of the function)
     if (g.ActiveId == id && state == NULL)
@@ -4650,7 +5968,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
 
     // Select the buffer to render.
     const bool buf_display_from_state = (render_cursor || render_selection || g.ActiveId == id) && !is_readonly && state;
-    const bool is_displaying_hint = (hint != NULL && (buf_display_from_state ? state->TextA.Data : buf)[0] == 0);
+    const bool is_displaying_hint = (hint != NULL && (buf_display_from_state ? state->TextSrc : buf)[0] == 0);
 
     // Password pushes a temporary font with only a fallback glyph
     if (is_password && !is_displaying_hint)
@@ -4668,6 +5986,21 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         PushFont(password_font);
     }
 
+    // Word-wrapping: follow the current width, and reflow the visible lines before mouse and keyboard inputs use the rows
+    if (state != NULL && render_cursor)
+    {
+        if (is_wordwrap)
+        {
+            InputTextWrapSetLayout(state, wrap_width);
+            InputTextWrapReflowVisible(state, scroll_y - style.FramePadding.y, scroll_y - style.FramePadding.y + inner_size.y);
+            state->Scroll.x = 0.0f;
+        }
+        else
+        {
+            state->WrapWidth = 0.0f;
+        }
+    }
+
     // Process mouse inputs and character inputs
     if (g.ActiveId == id)
     {
@@ -4866,7 +6199,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         {
             if (flags & ImGuiInputTextFlags_EscapeClearsAll)
             {
-                if (buf[0] != 0)
+                if ((storage ? state->TextSrc : buf)[0] != 0)
                 {
                     revert_edit = true;
                 }
@@ -4918,26 +6251,52 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             if (const char* clipboard = GetClipboardText())
             {
                 // Filter pasted buffer
+                // Characters which pass the filter unchanged are only copied once a character gets altered or discarded:
+                // when nothing is filtered out, which is the common case for large pastes, we insert directly from the clipboard.
                 const int clipboard_len = (int)strlen(clipboard);
+                const char* clipboard_end = clipboard + clipboard_len;
+                const bool skip_ascii = (flags & (ImGuiInputTextFlags_CharsDecimal | ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CharsUppercase | ImGuiInputTextFlags_CharsNoBlank | ImGuiInputTextFlags_CharsScientific | (ImGuiInputTextFlags)ImGuiInputTextFlags_LocalizeDecimalPoint | ImGuiInputTextFlags_CallbackCharFilter)) == 0;
                 ImVector<char> clipboard_filtered;
-                clipboard_filtered.reserve(clipboard_len + 1);
-                for (const char* s = clipboard; *s != 0; )
+                bool clipboard_altered = false;
+                const char* s_unaltered = clipboard; // Start of the characters passed unchanged since the last altered one
+                for (const char* s = clipboard; s < clipboard_end; )
                 {
+                    if (skip_ascii && (s = InputTextSkipUnfilteredAscii(s, clipboard_end, flags)) == clipboard_end)
+                        break;
+                    const char* s_char = s;
                     unsigned int c;
-                    int in_len = ImTextCharFromUtf8(&c, s, NULL);
+                    int in_len = ImTextCharFromUtf8(&c, s, clipboard_end);
                     s += in_len;
-                    if (!InputTextFilterCharacter(&g, &c, flags, callback, callback_user_data, true))
-                        continue;
                     char c_utf8[5];
-                    ImTextCharToUtf8(c_utf8, c);
-                    int out_len = (int)strlen(c_utf8);
-                    clipboard_filtered.resize(clipboard_filtered.Size + out_len);
-                    memcpy(clipboard_filtered.Data + clipboard_filtered.Size - out_len, c_utf8, out_len);
+                    int out_len = 0;
+                    if (InputTextFilterCharacter(&g, &c, flags, callback, callback_user_data, true))
+                    {
+                        ImTextCharToUtf8(c_utf8, c);
+                        out_len = (int)strlen(c_utf8);
+                        if (out_len == in_len && memcmp(c_utf8, s_char, (size_t)in_len) == 0)
+                            continue;
+                    }
+                    if (!clipboard_altered)
+                        clipboard_filtered.reserve(clipboard_len + 1);
+                    clipboard_altered = true;
+                    clipboard_filtered.resize(clipboard_filtered.Size + (int)(s_char - s_unaltered) + out_len);
+                    char* out = clipboard_filtered.Data + clipboard_filtered.Size - out_len - (int)(s_char - s_unaltered);
+                    memcpy(out, s_unaltered, (size_t)(s_char - s_unaltered));
+                    memcpy(out + (s_char - s_unaltered), c_utf8, (size_t)out_len);
+                    s_unaltered = s;
+                }
+                const char* paste_text = clipboard;
+                int paste_len = clipboard_len;
+                if (clipboard_altered)
+                {
+                    clipboard_filtered.resize(clipboard_filtered.Size + (int)(clipboard_end - s_unaltered));
+                    memcpy(clipboard_filtered.Data + clipboard_filtered.Size - (int)(clipboard_end - s_unaltered), s_unaltered, (size_t)(clipboard_end - s_unaltered));
+                    paste_text = clipboard_filtered.Data;
+                    paste_len = clipboard_filtered.Size;
                 }
-                if (clipboard_filtered.Size > 0) // If everything was filtered, ignore the pasting operation
+                if (paste_len > 0) // If everything was filtered, ignore the pasting operation
                 {
-                    clipboard_filtered.push_back(0);
-                    stb_textedit_paste(state, state->Stb, clipboard_filtered.Data, clipboard_filtered.Size - 1);
+                    stb_textedit_paste(state, state->Stb, paste_text, paste_len);
                     state->CursorFollow = true;
                 }
             }
@@ -4947,6 +6306,17 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         render_selection |= state->HasSelection() && (RENDER_SELECTION_WHEN_INACTIVE || render_cursor);
     }
 
+    // Replace all the matches of the SetNextItemTextFind() text, as a single edit
+    if (text_replace != NULL && g.ActiveId == id && !is_readonly)
+    {
+        IM_ASSERT(state != NULL);
+        if (ImStb::InputTextReplaceAll(state, text_find, (int)strlen(text_find), text_find_ignore_case, text_replace, (int)strlen(text_replace)) > 0)
+        {
+            state->CursorAnimReset();
+            render_selection |= state->HasSelection() && (RENDER_SELECTION_WHEN_INACTIVE || render_cursor);
+        }
+    }
+
     // Process callbacks and apply result back to user's buffer.
     const char* apply_new_text = NULL;
     int apply_new_text_length = 0;
@@ -4958,14 +6328,17 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             if (flags & ImGuiInputTextFlags_EscapeClearsAll)
             {
                 // Clear input
-                IM_ASSERT(buf[0] != 0);
-                apply_new_text = "";
-                apply_new_text_length = 0;
+                IM_ASSERT((storage ? state->TextSrc : buf)[0] != 0);
+                if (storage == NULL)
+                {
+                    apply_new_text = "";
+                    apply_new_text_length = 0;
+                }
                 value_changed = true;
                 IMSTB_TEXTEDIT_CHARTYPE empty_string;
                 stb_textedit_replace(state, state->Stb, &empty_string, 0);
             }
-            else if (strcmp(buf, state->TextToRevertTo.Data) != 0)
+            else if (storage == NULL && strcmp(buf, state->TextToRevertTo.Data) != 0)
             {
                 apply_new_text = state->TextToRevertTo.Data;
                 apply_new_text_length = state->TextToRevertTo.Size - 1;
@@ -5063,13 +6436,19 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                         IM_ASSERT(callback_data.BufTextLen == (int)strlen(callback_data.Buf)); // You need to maintain BufTextLen if you change the text!
                         InputTextReconcileUndoState(state, state->CallbackTextBackup.Data, state->CallbackTextBackup.Size - 1, callback_data.Buf, callback_data.BufTextLen);
                         state->TextLen = callback_data.BufTextLen;  // Assume correct length and valid UTF-8 from user, saves us an extra strlen()
+                        state->LineStartsValid = false;
                         state->CursorAnimReset();
                     }
                 }
             }
 
-            // Will copy result string if modified
-            if (!is_readonly && strcmp(state->TextSrc, buf) != 0)
+            // Will copy result string if modified. A storage was already modified in place.
+            if (storage != NULL)
+            {
+                if (state->Edited)
+                    value_changed = true;
+            }
+            else if (!is_readonly && strcmp(state->TextSrc, buf) != 0)
             {
                 apply_new_text = state->TextSrc;
                 apply_new_text_length = state->TextLen;
@@ -5081,7 +6460,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
     // Handle reapplying final data on deactivation (see InputTextDeactivateHook() for details)
     if (g.InputTextDeactivatedState.ID == id)
     {
-        if (g.ActiveId != id && IsItemDeactivatedAfterEdit() && !is_readonly && strcmp(g.InputTextDeactivatedState.TextA.Data, buf) != 0)
+        if (g.ActiveId != id && IsItemDeactivatedAfterEdit() && !is_readonly && storage == NULL && strcmp(g.InputTextDeactivatedState.TextA.Data, buf) != 0)
         {
             apply_new_text = g.InputTextDeactivatedState.TextA.Data;
             apply_new_text_length = g.InputTextDeactivatedState.TextA.Size - 1;
@@ -5091,6 +6470,46 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         g.InputTextDeactivatedState.ID = 0;
     }
 
+    // Replace all the matches of the SetNextItemTextFind() text in the user buffer or storage of an inactive widget
+    ImVector<char> replaced_text;
+    if (text_replace != NULL && g.ActiveId != id && !is_readonly && !user_scroll_active)
+    {
+        const char* text = apply_new_text ? apply_new_text : buf;
+        const int text_len = apply_new_text ? apply_new_text_length : storage ? buf_size - 1 : (int)strlen(buf);
+        const int find_len = (int)strlen(text_find);
+        const int replace_len = (int)strlen(text_replace);
+        ImVector<int> offsets;
+        ImStb::InputTextFindAll(text, text_len, text_find, find_len, text_find_ignore_case, &offsets);
+        const int new_text_len = text_len + offsets.Size * (replace_len - find_len);
+        if (offsets.Size > 0 && (storage != NULL || is_resizable || new_text_len + 1 <= buf_size))
+        {
+            const int where = offsets[0];
+            const int deleted_len = offsets.back() + find_len - where;
+            const int inserted_len = deleted_len + offsets.Size * (replace_len - find_len);
+            replaced_text.resize(new_text_len + 1);
+            if (storage != NULL)
+            {
+                ImStb::InputTextWriteReplacedSpan(replaced_text.Data, text, offsets.Data, offsets.Size, find_len, text_replace, 0, replace_len);
+                storage->DeleteCharsFn(storage, where, deleted_len);
+                if (inserted_len > 0)
+                    storage->InsertCharsFn(storage, where, replaced_text.Data, inserted_len);
+                buf = (char*)storage->GetSpanFn(storage, 0, new_text_len);
+                buf_size = new_text_len + 1;
+            }
+            else
+            {
+                memcpy(replaced_text.Data, text, (size_t)where);
+                char* p = ImStb::InputTextWriteReplacedSpan(replaced_text.Data + where, text, offsets.Data, offsets.Size, find_len, text_replace, 0, replace_len);
+                memcpy(p, text + where + deleted_len, (size_t)(text_len - where - deleted_len + 1));
+                apply_new_text = replaced_text.Data;
+                apply_new_text_length = new_text_len;
+            }
+            value_changed = true;
+            if (state != NULL)
+                state->TextGenerationValid = false; // Don't let the edit state or its line index be recycled on reactivation
+        }
+    }
+
     // Copy result to user buffer. This can currently only happen when (g.ActiveId == id)
     if (apply_new_text != NULL)
     {
@@ -5120,6 +6539,14 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         ImStrncpy(buf, apply_new_text, ImMin(apply_new_text_length + 1, buf_size));
     }
 
+    // We modified the text ourselves, so the line index is stale even if the generation didn't change.
+    if (value_changed)
+        if (ImGuiInputTextLineCache* line_cache = g.InputTextLineCaches.GetByKey(id))
+        {
+            line_cache->Buf = NULL;
+            line_cache->Storage = NULL;
+        }
+
     // Release active ID at the end of the function (so e.g. pressing Return still does a final application of the value)
     // Otherwise request text input ahead for next frame.
     if (g.ActiveId == id && clear_active_id)
@@ -5142,7 +6569,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
     // without any carriage return, which would makes ImFont::RenderText() reserve too many vertices and probably crash. Avoid it altogether.
     // Note that we only use this limit on single-line InputText(), so a pathologically large line on a InputTextMultiline() would still crash.
     const int buf_display_max_length = 2 * 1024 * 1024;
-    const char* buf_display = buf_display_from_state ? state->TextA.Data : buf; //-V595
+    const char* buf_display = buf_display_from_state ? state->TextSrc : buf; //-V595
     const char* buf_display_end = NULL; // We have specialized paths below for setting the length
     if (is_displaying_hint)
     {
@@ -5166,25 +6593,49 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         // We are attempting to do most of that in **one main pass** to minimize the computation cost (non-negligible for large amount of text) + 2nd pass for selection rendering (we could merge them by an extra refactoring effort)
         // FIXME: This should occur on buf_display but we'd need to maintain cursor/select_start/select_end for UTF-8.
         const char* text_begin = buf_display;
-        const char* text_end = text_begin + state->TextLen;
         ImVec2 cursor_offset, select_start_offset;
+        int line_count = 1;
+        int selmin_line_no = render_selection ? -1 : -1000;
+
+        // Word-wrapping: an edit or a callback may have replaced the rows this frame, reflow the visible lines and the one with the cursor
+        if (is_wordwrap && state->WrapStaleCount > 0)
+        {
+            InputTextWrapReflowVisible(state, scroll_y - style.FramePadding.y, scroll_y - style.FramePadding.y + inner_size.y);
+            const int cursor_line_no = state->GetLineFromPos(state->Stb->cursor);
+            if (state->WrapLineStale[cursor_line_no])
+                state->WrapIndexReflowLines(cursor_line_no, cursor_line_no + 1);
+        }
 
         {
             // Find lines numbers straddling cursor and selection min position
             int cursor_line_no = render_cursor ? -1 : -1000;
-            int selmin_line_no = render_selection ? -1 : -1000;
             const char* cursor_ptr = render_cursor ? text_begin + state->Stb->cursor : NULL;
             const char* selmin_ptr = render_selection ? text_begin + ImMin(state->Stb->select_start, state->Stb->select_end) : NULL;
+            const char* cursor_line_begin = text_begin;
+            const char* selmin_line_begin = text_begin;
 
-            // Count lines and find line number for cursor and selection ends
-            int line_count = 1;
-            if (is_multiline)
+            // Count lines and find line number for cursor and selection ends, using the line index rather than scanning the text
+            // (with word-wrapping, lines are the visual rows)
+            if (!is_multiline)
+            {
+                cursor_line_begin = ImStrbol(cursor_ptr, text_begin);
+                selmin_line_begin = ImStrbol(selmin_ptr, text_begin);
+            }
+            else
             {
-                for (const char* s = text_begin; (s = (const char*)memchr(s, '\n', (size_t)(text_end - s))) != NULL; s++)
+                line_count = is_wordwrap ? state->GetRowCount() : state->GetLineCount();
+                if (cursor_line_no == -1)
                 {
-                    if (cursor_line_no == -1 && s >= cursor_ptr) { cursor_line_no = line_count; }
-                    if (selmin_line_no == -1 && s >= selmin_ptr) { selmin_line_no = line_count; }
-                    line_count++;
+                    const int line_no = is_wordwrap ? state->GetRowFromPos(state->Stb->cursor) : state->GetLineFromPos(state->Stb->cursor);
+                    cursor_line_no = line_no + 1;
+                    cursor_line_begin = text_begin + (is_wordwrap ? state->GetRowStart(line_no) : state->GetLineStart(line_no));
+                }
+                if (selmin_line_no == -1)
+                {
+                    const int selmin_pos = (int)(selmin_ptr - text_begin);
+                    const int line_no = is_wordwrap ? state->GetRowFromPos(selmin_pos) : state->GetLineFromPos(selmin_pos);
+                    selmin_line_no = line_no + 1;
+                    selmin_line_begin = text_begin + (is_wordwrap ? state->GetRowStart(line_no) : state->GetLineStart(line_no));
                 }
             }
             if (cursor_line_no == -1)
@@ -5193,11 +6644,14 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                 selmin_line_no = line_count;
 
             // Calculate 2d position by finding the beginning of the line and measuring distance
-            cursor_offset.x = InputTextCalcTextSize(&g, ImStrbol(cursor_ptr, text_begin), cursor_ptr).x;
+            // (or by looking it up in the layout of the row, when moving the cursor around already laid it out)
+            const ImGuiInputTextRowLayout* cursor_row_layout = (render_cursor && text_begin == state->TextSrc) ? state->FindRowLayout((int)(cursor_line_begin - text_begin)) : NULL;
+            cursor_offset.x = cursor_row_layout ? cursor_row_layout->GetCharX(state->Stb->cursor) : InputTextCalcTextSize(&g, cursor_line_begin, cursor_ptr).x;
             cursor_offset.y = cursor_line_no * g.FontSize;
             if (selmin_line_no >= 0)
             {
-                select_start_offset.x = InputTextCalcTextSize(&g, ImStrbol(selmin_ptr, text_begin), selmin_ptr).x;
+                const ImGuiInputTextRowLayout* selmin_row_layout = (text_begin == state->TextSrc) ? state->FindRowLayout((int)(selmin_line_begin - text_begin)) : NULL;
+                select_start_offset.x = selmin_row_layout ? selmin_row_layout->GetCharX((int)(selmin_ptr - text_begin)) : InputTextCalcTextSize(&g, selmin_line_begin, selmin_ptr).x;
                 select_start_offset.y = selmin_line_no * g.FontSize;
             }
 
@@ -5210,7 +6664,7 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         if (render_cursor && state->CursorFollow)
         {
             // Horizontal scroll in chunks of quarter width
-            if (!(flags & ImGuiInputTextFlags_NoHorizontalScroll))
+            if (!(flags & (ImGuiInputTextFlags_NoHorizontalScroll | ImGuiInputTextFlags_WordWrap)))
             {
                 const float scroll_increment_x = inner_size.x * 0.25f;
                 const float visible_width = inner_size.x - style.FramePadding.x;
@@ -5241,8 +6695,22 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             state->CursorFollow = false;
         }
 
-        // Draw selection
+        // Draw the matches of the SetNextItemTextFind() text in the visible rows
         const ImVec2 draw_scroll = ImVec2(state->Scroll.x, 0.0f);
+        if (text_find != NULL && !is_displaying_hint)
+        {
+            const ImVec2 text_pos = draw_pos - draw_scroll;
+            const int first_row_no = ImClamp((int)((clip_rect.y - text_pos.y) / g.FontSize) - 1, 0, line_count - 1);
+            const int last_row_no = ImClamp((int)((clip_rect.w - text_pos.y) / g.FontSize) + 1, first_row_no, line_count - 1);
+            ImVector<int>& row_starts = g.InputTextVisibleRowStarts;
+            row_starts.resize(0);
+            for (int row_no = first_row_no; row_no <= last_row_no; row_no++)
+                row_starts.push_back(is_wordwrap ? state->GetRowStart(row_no) : state->GetLineStart(row_no));
+            row_starts.push_back(is_wordwrap ? state->GetRowEnd(last_row_no) : (last_row_no + 1 < line_count) ? state->GetLineStart(last_row_no + 1) : state->TextLen);
+            InputTextRenderFindMatches(&g, draw_window->DrawList, text_begin, buf_display_end, row_starts, first_row_no, text_pos, clip_rect, text_find, text_find_ignore_case);
+        }
+
+        // Draw selection
         if (render_selection)
         {
             const char* text_selected_begin = text_begin + ImMin(state->Stb->select_start, state->Stb->select_end);
@@ -5252,7 +6720,41 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
             float bg_offy_up = is_multiline ? 0.0f : -1.0f;    // FIXME: those offsets should be part of the style? they don't play so well with multi-line selection.
             float bg_offy_dn = is_multiline ? 0.0f : 2.0f;
             ImVec2 rect_pos = draw_pos + select_start_offset - draw_scroll;
-            for (const char* p = text_selected_begin; p < text_selected_end; )
+            const char* p = text_selected_begin;
+            if (is_wordwrap)
+            {
+                // One rectangle per visible row (rows don't end with a new line, so the loop below doesn't apply)
+                const int row_min = ImMax(selmin_line_no - 1, (int)((clip_rect.y - draw_pos.y) / g.FontSize) - 1);
+                const int row_max = ImMin(state->GetRowFromPos((int)(text_selected_end - text_begin)), (int)((clip_rect.w - draw_pos.y) / g.FontSize) + 1);
+                for (int row_no = row_min; row_no <= row_max; row_no++)
+                {
+                    const char* row_begin = text_begin + state->GetRowStart(row_no);
+                    const char* row_selected_begin = ImMax(row_begin, text_selected_begin);
+                    const char* row_selected_end = ImMin(text_begin + state->GetRowEnd(row_no), text_selected_end);
+                    if (row_selected_begin >= row_selected_end)
+                        continue;
+                    rect_pos = ImVec2(draw_pos.x + InputTextCalcTextSize(&g, row_begin, row_selected_begin).x, draw_pos.y + (row_no + 1) * g.FontSize);
+                    ImVec2 rect_size = InputTextCalcTextSize(&g, row_selected_begin, row_selected_end, NULL, NULL, true);
+                    if (rect_size.x <= 0.0f) rect_size.x = IM_TRUNC(g.Font->GetCharAdvance((ImWchar)' ') * 0.50f); // So we can see selected empty lines
+                    ImRect rect(rect_pos + ImVec2(0.0f, -g.FontSize), rect_pos + ImVec2(rect_size.x, 0.0f));
+                    rect.ClipWith(clip_rect);
+                    if (rect.Overlaps(clip_rect))
+                        draw_window->DrawList->AddRectFilled(rect.Min, rect.Max, bg_color);
+                }
+                p = text_selected_end;
+            }
+            else if (is_multiline && rect_pos.y < clip_rect.y)
+            {
+                // Jump close to the first visible line (the loop below skips the remaining ones)
+                const int skip_lines = (int)((clip_rect.y - rect_pos.y) / g.FontSize) - 1;
+                if (skip_lines > 0)
+                {
+                    const int line_no = selmin_line_no - 1 + skip_lines;
+                    p = (line_no < line_count) ? ImMin(text_begin + state->GetLineStart(line_no), text_selected_end) : text_selected_end;
+                    rect_pos.y += skip_lines * g.FontSize;
+                }
+            }
+            while (p < text_selected_end)
             {
                 if (rect_pos.y > clip_rect.w + g.FontSize)
                     break;
@@ -5276,11 +6778,33 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
         }
 
         // We test for 'buf_display_max_length' as a way to avoid some pathological cases (e.g. single-line 1 MB string) which would make ImDrawList crash.
-        // FIXME-OPT: Multiline could submit a smaller amount of contents to AddText() since we already iterated through it.
+        // Multiline submits text from (about) the first visible line, found with the line index.
         if (is_multiline || (buf_display_end - buf_display) < buf_display_max_length)
         {
+            const char* buf_display_visible = buf_display;
+            ImVec2 text_pos = draw_pos - draw_scroll;
             ImU32 col = GetColorU32(is_displaying_hint ? ImGuiCol_TextDisabled : ImGuiCol_Text);
-            draw_window->DrawList->AddText(g.Font, g.FontSize, draw_pos - draw_scroll, col, buf_display, buf_display_end, 0.0f, is_multiline ? NULL : &clip_rect);
+            if (is_wordwrap && !is_displaying_hint)
+            {
+                // Submit each visible row on its own
+                const int first_row_no = ImClamp((int)((clip_rect.y - text_pos.y) / g.FontSize) - 1, 0, line_count - 1);
+                const int last_row_no = ImClamp((int)((clip_rect.w - text_pos.y) / g.FontSize) + 1, first_row_no, line_count - 1);
+                for (int row_no = first_row_no; row_no <= last_row_no; row_no++)
+                    draw_window->DrawList->AddText(g.Font, g.FontSize, ImVec2(text_pos.x, text_pos.y + row_no * g.FontSize), col, text_begin + state->GetRowStart(row_no), text_begin + state->GetRowEnd(row_no));
+            }
+            else
+            {
+                if (is_multiline && !is_displaying_hint)
+                {
+                    const int first_line_no = ImMin((int)((clip_rect.y - text_pos.y) / g.FontSize) - 1, line_count - 1);
+                    if (first_line_no > 0)
+                    {
+                        buf_display_visible += state->GetLineStart(first_line_no);
+                        text_pos.y += first_line_no * g.FontSize;
+                    }
+                }
+                draw_window->DrawList->AddText(g.Font, g.FontSize, text_pos, col, buf_display_visible, buf_display_end, wrap_width, is_multiline ? NULL : &clip_rect);
+            }
         }
 
         // Draw blinking cursor
@@ -5301,11 +6825,40 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                 g.PlatformImeData.InputLineHeight = g.FontSize;
             }
         }
+
+        // Word-wrapping: reflow the lines scrolled into view, then some of the others. Rows added above the first visible line
+        // are compensated by scrolling, from next frame on.
+        if (is_wordwrap && state->WrapStaleCount > 0)
+        {
+            const float visible_y = draw_window->Scroll.y - style.FramePadding.y;
+            InputTextWrapReflowVisible(state, visible_y, visible_y + inner_size.y);
+            const int anchor_row_no = ImClamp((int)(visible_y / g.FontSize), 0, state->GetRowCount() - 1);
+            const int anchor_line_no = state->GetLineFromPos(state->GetRowStart(anchor_row_no));
+            const int rows_added_above = InputTextWrapReflowBackground(state, WRAP_REFLOW_BUDGET, anchor_line_no);
+            if (rows_added_above != 0)
+                draw_window->Scroll.y = ImMax(draw_window->Scroll.y + rows_added_above * g.FontSize, 0.0f);
+            text_size.y = state->GetRowCount() * g.FontSize;
+        }
     }
     else
     {
         // Render text only (no selection, no cursor)
-        if (is_multiline)
+        ImGuiInputTextLineCache* line_cache = storage_line_cache;
+        if (line_cache == NULL && has_text_generation && !is_displaying_hint && buf_display == buf)
+            line_cache = InputTextGetLineCache(&g, id, buf, buf_size, text_generation, state, storage);
+        else if (line_cache == NULL && is_wordwrap && !is_displaying_hint)
+            line_cache = InputTextGetLineCacheByText(&g, id, buf_display);
+        if (line_cache)
+        {
+            if (storage_line_cache == NULL)
+                buf_display_end = buf_display + line_cache->TextLen;
+            else
+                line_cache->LastTimeActive = (float)g.Time;
+            if (is_wordwrap)
+                InputTextLineCacheWrapRows(&g, line_cache, wrap_width);
+            text_size = ImVec2(inner_size.x, (is_wordwrap ? line_cache->WrapRowStarts.Size : line_cache->LineStarts.Size) * g.FontSize);
+        }
+        else if (is_multiline)
             text_size = ImVec2(inner_size.x, InputTextCalcTextLenAndLineCount(buf_display, &buf_display_end) * g.FontSize); // We don't need width
         else if (!is_displaying_hint && g.ActiveId == id)
             buf_display_end = buf_display + state->TextLen;
@@ -5319,8 +6872,87 @@ bool ImGui::InputTextEx(const char* label, const char* hint, char* buf, int buf_
                 draw_pos.x = ImMin(draw_pos.x, frame_bb.Max.x - CalcTextSize(buf_display, NULL).x - style.FramePadding.x);
 
             const ImVec2 draw_scroll = /*state ? ImVec2(state->Scroll.x, 0.0f) :*/ ImVec2(0.0f, 0.0f); // Preserve scroll when inactive?
+            const char* buf_display_visible = buf_display;
+            ImVec2 text_pos = draw_pos - draw_scroll;
             ImU32 col = GetColorU32(is_displaying_hint ? ImGuiCol_TextDisabled : ImGuiCol_Text);
-            draw_window->DrawList->AddText(g.Font, g.FontSize, draw_pos - draw_scroll, col, buf_display, buf_display_end, 0.0f, is_multiline ? NULL : &clip_rect);
+            const int first_visible_line_no = (int)((clip_rect.y - text_pos.y) / g.FontSize) - 1;
+            const int last_visible_line_no = (int)((clip_rect.w - text_pos.y) / g.FontSize) + 1;
+
+            // Matches of the SetNextItemTextFind() text are highlighted in the visible rows (collected in 'visible_row_starts', followed by the end of the last one)
+            ImVector<int>& visible_row_starts = g.InputTextVisibleRowStarts;
+            visible_row_starts.resize(0);
+            int first_row_no = 0;
+            if (is_wordwrap && line_cache)
+            {
+                // Only submit the visible rows, each on its own
+                const ImVector<int>& row_starts = line_cache->WrapRowStarts;
+                first_row_no = ImClamp(first_visible_line_no, 0, row_starts.Size - 1);
+                const int last_row_no = ImClamp(last_visible_line_no, first_row_no, row_starts.Size - 1);
+                const int rows_end = (last_row_no + 1 < row_starts.Size) ? row_starts[last_row_no + 1] : line_cache->TextLen;
+                int text_offset = 0; // Offset of buf_display in the text
+                if (storage_line_cache != NULL)
+                    buf_display = InputTextGetStorageSpan(storage, line_cache->TextLen, row_starts[first_row_no], rows_end, text_find ? (int)strlen(text_find) - 1 : 0, &text_offset, &buf_display_end);
+                if (text_find != NULL)
+                {
+                    visible_row_starts.reserve(last_row_no - first_row_no + 2);
+                    for (int row_no = first_row_no; row_no <= last_row_no; row_no++)
+                        visible_row_starts.push_back(row_starts[row_no] - text_offset);
+                    visible_row_starts.push_back(rows_end - text_offset);
+                    InputTextRenderFindMatches(&g, draw_window->DrawList, buf_display, buf_display_end, visible_row_starts, first_row_no, text_pos, clip_rect, text_find, text_find_ignore_case);
+                }
+                for (int row_no = first_row_no; row_no <= last_row_no; row_no++)
+                {
+                    const char* row_end = buf_display + ((row_no + 1 < row_starts.Size) ? row_starts[row_no + 1] : line_cache->TextLen) - text_offset;
+                    draw_window->DrawList->AddText(g.Font, g.FontSize, ImVec2(text_pos.x, text_pos.y + row_no * g.FontSize), col, buf_display + row_starts[row_no] - text_offset, row_end);
+                }
+            }
+            else
+            {
+                if (line_cache)
+                {
+                    // Only submit the visible lines (with a margin of one line)
+                    const int line_count = line_cache->LineStarts.Size;
+                    const int first_line_no = ImClamp(first_visible_line_no, 0, line_count - 1);
+                    const int last_line_no = ImClamp(last_visible_line_no, first_line_no, line_count - 1);
+                    const int lines_end = (last_line_no + 1 < line_count) ? line_cache->LineStarts[last_line_no + 1] : line_cache->TextLen;
+                    int text_offset = 0; // Offset of buf_display in the text
+                    if (storage_line_cache != NULL)
+                        buf_display = InputTextGetStorageSpan(storage, line_cache->TextLen, line_cache->LineStarts[first_line_no], lines_end, text_find ? (int)strlen(text_find) - 1 : 0, &text_offset, &buf_display_end);
+                    if (text_find != NULL)
+                    {
+                        visible_row_starts.reserve(last_line_no - first_line_no + 2);
+                        for (int line_no = first_line_no; line_no <= last_line_no; line_no++)
+                            visible_row_starts.push_back(line_cache->LineStarts[line_no] - text_offset);
+                        visible_row_starts.push_back(lines_end - text_offset);
+                        InputTextRenderFindMatches(&g, draw_window->DrawList, buf_display, buf_display_end, visible_row_starts, first_line_no, text_pos, clip_rect, text_find, text_find_ignore_case);
+                    }
+                    buf_display_visible = buf_display + line_cache->LineStarts[first_line_no] - text_offset;
+                    buf_display_end = buf_display + lines_end - text_offset;
+                    text_pos.y += first_line_no * g.FontSize;
+                }
+                else if (text_find != NULL && !is_displaying_hint)
+                {
+                    // Without a line cache, find the visible lines by scanning the text
+                    int line_no = 0;
+                    first_row_no = ImMax(first_visible_line_no, 0);
+                    for (const char* line = buf_display; line_no <= last_visible_line_no; line_no++)
+                    {
+                        const char* line_end = (const char*)memchr(line, '\n', (size_t)(buf_display_end - line));
+                        if (line_no >= first_row_no)
+                            visible_row_starts.push_back((int)(line - buf_display));
+                        if (line_end == NULL)
+                            break;
+                        line = line_end + 1;
+                    }
+                    if (visible_row_starts.Size > 0)
+                    {
+                        const char* last_line_end = (const char*)memchr(buf_display + visible_row_starts.back(), '\n', (size_t)(buf_display_end - buf_display - visible_row_starts.back()));
+                        visible_row_starts.push_back(last_line_end ? (int)(last_line_end + 1 - buf_display) : (int)(buf_display_end - buf_display));
+                        InputTextRenderFindMatches(&g, draw_window->DrawList, buf_display, buf_display_end, visible_row_starts, first_row_no, text_pos, clip_rect, text_find, text_find_ignore_case);
+                    }
+                }
+                draw_window->DrawList->AddText(g.Font, g.FontSize, text_pos, col, buf_display_visible, buf_display_end, wrap_width, is_multiline ? NULL : &clip_rect);
+            }
         }
     }
 
@@ -5373,30 +7005,38 @@ void ImGui::DebugNodeInputTextState(ImGuiInputTextState* state)
 #ifndef IMGUI_DISABLE_DEBUG_TOOLS
     ImGuiContext& g = *GImGui;
     ImStb::STB_TexteditState* stb_state = state->Stb;
-    ImStb::StbUndoState* undo_state = &stb_state->undostate;
+    ImGuiInputTextUndoStack* undo_stack = &state->UndoStack;
     Text("ID: 0x%08X, ActiveID: 0x%08X", state->ID, g.ActiveId);
     DebugLocateItemOnHover(state->ID);
     Text("CurLenA: %d, Cursor: %d, Selection: %d..%d", state->TextLen, stb_state->cursor, stb_state->select_start, stb_state->select_end);
     Text("BufCapacityA: %d", state->BufCapacity);
     Text("(Internal Buffer: TextA Size: %d, Capacity: %d)", state->TextA.Size, state->TextA.Capacity);
+    Text("LineStarts: %d lines%s, delta %+d from line %d", state->LineStarts.Size, state->LineStartsValid ? "" : " (invalid)", state->LineStartsDelta, state->LineStartsDeltaLine);
+    if (state->WrapWidth > 0.0f)
+        Text("WrapRowStarts: %d rows for width %.1f, %d stale lines, delta %+d from row %d", state->WrapRowStarts.Size, state->WrapWidth, state->WrapStaleCount, state->WrapRowStartsDelta, state->WrapRowStartsDeltaRow);
     Text("has_preferred_x: %d (%.2f)", stb_state->has_preferred_x, stb_state->preferred_x);
-    Text("undo_point: %d, redo_point: %d, undo_char_point: %d, redo_char_point: %d", undo_state->undo_point, undo_state->redo_point, undo_state->undo_char_point, undo_state->redo_char_point);
+    Text("Undo: %d records, Redo: %d records, Memory: %d/%d bytes", undo_stack->GetUndoCount(), undo_stack->GetRedoCount(), undo_stack->GetMemoryUsage(), g.IO.ConfigInputTextUndoMemory);
     if (BeginChild("undopoints", ImVec2(0.0f, GetTextLineHeight() * 10), ImGuiChildFlags_Borders | ImGuiChildFlags_ResizeY)) // Visualize undo state
     {
         PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-        for (int n = 0; n < IMSTB_TEXTEDIT_UNDOSTATECOUNT; n++)
-        {
-            ImStb::StbUndoRecord* undo_rec = &undo_state->undo_rec[n];
-            const char undo_rec_type = (n < undo_state->undo_point) ? 'u' : (n >= undo_state->redo_point) ? 'r' : ' ';
-            if (undo_rec_type == ' ')
-                BeginDisabled();
-            const int buf_preview_len = (undo_rec_type != ' ' && undo_rec->char_storage != -1) ? undo_rec->insert_length : 0;
-            const char* buf_preview_str = undo_state->undo_char + undo_rec->char_storage;
-            Text("%c [%02d] where %03d, insert %03d, delete %03d, char_storage %03d \"%.*s\"",
-                undo_rec_type, n, undo_rec->where, undo_rec->insert_length, undo_rec->delete_length, undo_rec->char_storage, buf_preview_len, buf_preview_str);
-            if (undo_rec_type == ' ')
-                EndDisabled();
-        }
+        ImGuiListClipper clipper;
+        clipper.Begin(undo_stack->Records.Size - undo_stack->RecordsHead);
+        while (clipper.Step())
+            for (int n = undo_stack->RecordsHead + clipper.DisplayStart; n < undo_stack->RecordsHead + clipper.DisplayEnd; n++)
+            {
+                ImGuiInputTextUndoRecord* undo_rec = &undo_stack->Records[n];
+                const char undo_rec_type = (n < undo_stack->UndoPoint) ? 'u' : 'r';
+                if (undo_rec->ReplaceCount > 0)
+                {
+                    Text("%c [%02d] where %03d, insert %03d, delete %03d (replace-all, %d matches)",
+                        undo_rec_type, n - undo_stack->RecordsHead, undo_rec->Where, undo_rec->InsertedLen, undo_rec->DeletedLen, undo_rec->ReplaceCount);
+                    continue;
+                }
+                const int buf_preview_len = ImMin(undo_rec->DeletedLen, 64);
+                const char* buf_preview_str = undo_rec->DeletedChunk ? undo_rec->DeletedChunk->Data() + undo_rec->DeletedOffset : "";
+                Text("%c [%02d] where %03d, insert %03d, delete %03d%s \"%.*s\"",
+                    undo_rec_type, n - undo_stack->RecordsHead, undo_rec->Where, undo_rec->InsertedLen, undo_rec->DeletedLen, undo_rec->Typed ? " (typed)" : "", buf_preview_len, buf_preview_str);
+            }
         PopStyleVar();
     }
     EndChild();
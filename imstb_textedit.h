@@ -5,6 +5,10 @@
 // - Fix in stb_textedit_find_charpos to handle last line (see https://github.com/ocornut/imgui/issues/6000 + #6783)
 // - Added name to struct or it may be forward declared in our code.
 // - Added UTF-8 support (see https://github.com/nothings/stb/issues/188 + https://github.com/ocornut/imgui/pull/7925)
+// - Added optional STB_TEXTEDIT_SEEKROW_CHAR/STB_TEXTEDIT_SEEKROW_Y to skip rows when locating a character or a coordinate.
+// - Added optional STB_TEXTEDIT_UNDO_RECORD/STB_TEXTEDIT_UNDO_APPLY to replace the fixed size undo buffer with your own storage.
+// - Support rows wrapped by the layout (not ending with a newline) in up/down/home/end and clicks, when STB_TEXTEDIT_SEEKROW_CHAR is defined.
+// - Added optional STB_TEXTEDIT_GETROWX/STB_TEXTEDIT_FINDROWX/STB_TEXTEDIT_LOCATEROWX to position characters in a row without summing STB_TEXTEDIT_GETWIDTH() calls.
 // Grep for [DEAR IMGUI] to find the changes.
 // - Also renamed macros used or defined outside of IMSTB_TEXTEDIT_IMPLEMENTATION block from STB_TEXTEDIT_* to IMSTB_TEXTEDIT_*
 
@@ -177,6 +181,28 @@
 //    STB_TEXTEDIT_K_LINEEND2            secondary keyboard input to move cursor to end of line
 //    STB_TEXTEDIT_K_TEXTSTART2          secondary keyboard input to move cursor to start of text
 //    STB_TEXTEDIT_K_TEXTEND2            secondary keyboard input to move cursor to end of text
+//    STB_TEXTEDIT_SEEKROW_CHAR(obj,n,&first,&prev_first,&y)
+//                                       [DEAR IMGUI] returns the first char and y position of a row at or before the
+//                                          row containing char n, together with the first char of the row before it
+//                                          (or 0), so that searching rows doesn't need to start from the top
+//    STB_TEXTEDIT_SEEKROW_Y(obj,y,&first,&row_y)
+//                                       [DEAR IMGUI] same for the row straddling 'y': returns a row starting at or
+//                                          before it, and that row's y position
+//    STB_TEXTEDIT_GETROWX(obj,first,n)  [DEAR IMGUI] x position of char n from the start of the row starting at char
+//                                          'first' (chars past the visible end of the row are at its end)
+//    STB_TEXTEDIT_FINDROWX(obj,first,x) [DEAR IMGUI] last char of the row starting at 'first' whose x position is
+//                                          <= x (or 'first'). Used to move up/down while keeping the x position
+//    STB_TEXTEDIT_LOCATEROWX(obj,first,x)
+//                                       [DEAR IMGUI] char of the row starting at 'first' nearest to x, x being
+//                                          inside the row. Used by clicks. Those three must be defined together
+//    STB_TEXTEDIT_UNDO_RECORD(obj,where,old_len,new_len)
+//                                       [DEAR IMGUI] if defined, undo is left to you and 'undostate' isn't used.
+//                                          Called when old_len characters at 'where' are about to be replaced by
+//                                          new_len characters, or after new_len characters were inserted at 'where'
+//                                          when old_len is 0
+//    STB_TEXTEDIT_UNDO_APPLY(obj,redo)  [DEAR IMGUI] must be defined with STB_TEXTEDIT_UNDO_RECORD: undo (redo=0)
+//                                          or redo (redo=1) an edit, returns the new cursor position or -1 if
+//                                          there was nothing to undo or redo
 //
 // Keyboard input must be encoded as a single integer value; e.g. a character code
 // and some bitflags that represent shift states. to simplify the interface, SHIFT must
@@ -418,6 +444,10 @@ static int stb_text_locate_coord(IMSTB_TEXTEDIT_STRING *str, float x, float y)
    r.ymin = r.ymax = 0;
    r.num_chars = 0;
 
+   #ifdef STB_TEXTEDIT_SEEKROW_Y
+   STB_TEXTEDIT_SEEKROW_Y(str, y, &i, &base_y); // [DEAR IMGUI]
+   #endif
+
    // search rows to find one that straddles 'y'
    while (i < n) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
@@ -444,6 +474,9 @@ static int stb_text_locate_coord(IMSTB_TEXTEDIT_STRING *str, float x, float y)
 
    // check if it's before the end of the line
    if (x < r.x1) {
+      #ifdef STB_TEXTEDIT_LOCATEROWX
+      return STB_TEXTEDIT_LOCATEROWX(str, i, x - r.x0); // [DEAR IMGUI]
+      #endif
       // search characters in row for one that straddles 'x'
       prev_x = r.x0;
       for (k=0; k < r.num_chars; k = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, i + k) - i) {
@@ -462,6 +495,8 @@ static int stb_text_locate_coord(IMSTB_TEXTEDIT_STRING *str, float x, float y)
    // if the last character is a newline, return that. otherwise return 'after' the last character
    if (STB_TEXTEDIT_GETCHAR(str, i+r.num_chars-1) == STB_TEXTEDIT_NEWLINE)
       return i+r.num_chars-1;
+   else if (i+r.num_chars < n) // [DEAR IMGUI] row wrapped by the layout: 'after' its last character is the start of the next row
+      return IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, i+r.num_chars); // [DEAR IMGUI]
    else
       return i+r.num_chars;
 }
@@ -514,7 +549,7 @@ static void stb_textedit_drag(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *sta
 static void stb_text_undo(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state);
 static void stb_text_redo(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state);
 static void stb_text_makeundo_delete(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int length);
-static void stb_text_makeundo_insert(STB_TexteditState *state, int where, int length);
+static void stb_text_makeundo_insert(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int length);
 static void stb_text_makeundo_replace(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int old_length, int new_length);
 
 typedef struct
@@ -547,6 +582,9 @@ static void stb_textedit_find_charpos(StbFindState *find, IMSTB_TEXTEDIT_STRING
 
    // search rows to find the one that straddles character n
    find->y = 0;
+   #ifdef STB_TEXTEDIT_SEEKROW_CHAR
+   STB_TEXTEDIT_SEEKROW_CHAR(str, n, &i, &prev_start, &find->y); // [DEAR IMGUI]
+   #endif
 
    for(;;) {
       STB_TEXTEDIT_LAYOUTROW(&r, str, i);
@@ -571,10 +609,36 @@ static void stb_textedit_find_charpos(StbFindState *find, IMSTB_TEXTEDIT_STRING
 
    // now scan to find xpos
    find->x = r.x0;
+   #ifdef STB_TEXTEDIT_GETROWX
+   find->x += STB_TEXTEDIT_GETROWX(str, first, n); // [DEAR IMGUI]
+   #else
    for (i=0; first+i < n; i = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, first + i) - first)
       find->x += STB_TEXTEDIT_GETWIDTH(str, first, i);
+   #endif
+}
+
+#ifdef STB_TEXTEDIT_SEEKROW_CHAR
+// [DEAR IMGUI] start and end of the row containing the cursor, for home/end. Rows may be wrapped by the layout
+// instead of ending with a newline. The end of such a row is before its last character, after it is the next row.
+static int stb_textedit_find_row_start(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state)
+{
+   StbFindState find;
+   stb_textedit_find_charpos(&find, str, state->cursor, state->single_line);
+   return find.first_char;
 }
 
+static int stb_textedit_find_row_end(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state)
+{
+   StbFindState find;
+   int end;
+   stb_textedit_find_charpos(&find, str, state->cursor, state->single_line);
+   end = find.first_char + find.length;
+   if (find.length > 0 && (end < STB_TEXTEDIT_STRINGLEN(str) || STB_TEXTEDIT_GETCHAR(str, end - 1) == STB_TEXTEDIT_NEWLINE))
+      end = IMSTB_TEXTEDIT_GETPREVCHARINDEX(str, end);
+   return end;
+}
+#endif
+
 #define STB_TEXT_HAS_SELECTION(s)   ((s)->select_start != (s)->select_end)
 
 // make the selection/cursor state valid if client altered the string
@@ -726,7 +790,7 @@ static int stb_textedit_paste_internal(IMSTB_TEXTEDIT_STRING *str, STB_TexteditS
    stb_textedit_delete_selection(str,state);
    // try to insert the characters
    if (STB_TEXTEDIT_INSERTCHARS(str, state->cursor, text, len)) {
-      stb_text_makeundo_insert(state, state->cursor, len);
+      stb_text_makeundo_insert(str, state, state->cursor, len);
       state->cursor += len;
       state->has_preferred_x = 0;
       return 1;
@@ -757,7 +821,7 @@ static void stb_textedit_text(IMSTB_TEXTEDIT_STRING* str, STB_TexteditState* sta
    else {
       stb_textedit_delete_selection(str, state); // implicitly clamps
       if (STB_TEXTEDIT_INSERTCHARS(str, state->cursor, text, text_len)) {
-         stb_text_makeundo_insert(state, state->cursor, text_len);
+         stb_text_makeundo_insert(str, state, state->cursor, text_len);
          state->cursor += text_len;
          state->has_preferred_x = 0;
       }
@@ -883,7 +947,7 @@ retry:
       case STB_TEXTEDIT_K_PGDOWN | STB_TEXTEDIT_K_SHIFT: {
          StbFindState find;
          StbTexteditRow row;
-         int i, j, sel = (key & STB_TEXTEDIT_K_SHIFT) != 0;
+         int j, sel = (key & STB_TEXTEDIT_K_SHIFT) != 0;
          int is_page = (key & ~STB_TEXTEDIT_K_SHIFT) == STB_TEXTEDIT_K_PGDOWN;
          int row_count = is_page ? state->row_count_per_page : 1;
 
@@ -903,7 +967,7 @@ retry:
          stb_textedit_find_charpos(&find, str, state->cursor, state->single_line);
 
          for (j = 0; j < row_count; ++j) {
-            float x, goal_x = state->has_preferred_x ? state->preferred_x : find.x;
+            float goal_x = state->has_preferred_x ? state->preferred_x : find.x;
             int start = find.first_char + find.length;
 
             if (find.length == 0)
@@ -911,24 +975,32 @@ retry:
 
             // [DEAR IMGUI]
             // going down while being on the last line shouldn't bring us to that line end
-            if (STB_TEXTEDIT_GETCHAR(str, find.first_char + find.length - 1) != STB_TEXTEDIT_NEWLINE)
+            // (only the last row may end without a newline, unless rows are wrapped by the layout)
+            if (start >= STB_TEXTEDIT_STRINGLEN(str) && STB_TEXTEDIT_GETCHAR(str, start - 1) != STB_TEXTEDIT_NEWLINE)
                break;
 
             // now find character position down a row
             state->cursor = start;
             STB_TEXTEDIT_LAYOUTROW(&row, str, state->cursor);
-            x = row.x0;
-            for (i=0; i < row.num_chars; ++i) {
-               float dx = STB_TEXTEDIT_GETWIDTH(str, start, i);
-               #ifdef IMSTB_TEXTEDIT_GETWIDTH_NEWLINE
-               if (dx == IMSTB_TEXTEDIT_GETWIDTH_NEWLINE)
-                  break;
-               #endif
-               x += dx;
-               if (x > goal_x)
-                  break;
-               state->cursor = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
+            #ifdef STB_TEXTEDIT_FINDROWX
+            state->cursor = STB_TEXTEDIT_FINDROWX(str, start, goal_x - row.x0); // [DEAR IMGUI]
+            #else
+            {
+               int i;
+               float x = row.x0;
+               for (i=0; i < row.num_chars; ++i) {
+                  float dx = STB_TEXTEDIT_GETWIDTH(str, start, i);
+                  #ifdef IMSTB_TEXTEDIT_GETWIDTH_NEWLINE
+                  if (dx == IMSTB_TEXTEDIT_GETWIDTH_NEWLINE)
+                     break;
+                  #endif
+                  x += dx;
+                  if (x > goal_x)
+                     break;
+                  state->cursor = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
+               }
             }
+            #endif
             stb_textedit_clamp(str, state);
 
             state->has_preferred_x = 1;
@@ -950,7 +1022,7 @@ retry:
       case STB_TEXTEDIT_K_PGUP | STB_TEXTEDIT_K_SHIFT: {
          StbFindState find;
          StbTexteditRow row;
-         int i, j, prev_scan, sel = (key & STB_TEXTEDIT_K_SHIFT) != 0;
+         int j, prev_scan, sel = (key & STB_TEXTEDIT_K_SHIFT) != 0;
          int is_page = (key & ~STB_TEXTEDIT_K_SHIFT) == STB_TEXTEDIT_K_PGUP;
          int row_count = is_page ? state->row_count_per_page : 1;
 
@@ -970,7 +1042,7 @@ retry:
          stb_textedit_find_charpos(&find, str, state->cursor, state->single_line);
 
          for (j = 0; j < row_count; ++j) {
-            float  x, goal_x = state->has_preferred_x ? state->preferred_x : find.x;
+            float  goal_x = state->has_preferred_x ? state->preferred_x : find.x;
 
             // can only go up if there's a previous row
             if (find.prev_first == find.first_char)
@@ -979,18 +1051,25 @@ retry:
             // now find character position up a row
             state->cursor = find.prev_first;
             STB_TEXTEDIT_LAYOUTROW(&row, str, state->cursor);
-            x = row.x0;
-            for (i=0; i < row.num_chars; ++i) {
-               float dx = STB_TEXTEDIT_GETWIDTH(str, find.prev_first, i);
-               #ifdef IMSTB_TEXTEDIT_GETWIDTH_NEWLINE
-               if (dx == IMSTB_TEXTEDIT_GETWIDTH_NEWLINE)
-                  break;
-               #endif
-               x += dx;
-               if (x > goal_x)
-                  break;
-               state->cursor = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
+            #ifdef STB_TEXTEDIT_FINDROWX
+            state->cursor = STB_TEXTEDIT_FINDROWX(str, find.prev_first, goal_x - row.x0); // [DEAR IMGUI]
+            #else
+            {
+               int i;
+               float x = row.x0;
+               for (i=0; i < row.num_chars; ++i) {
+                  float dx = STB_TEXTEDIT_GETWIDTH(str, find.prev_first, i);
+                  #ifdef IMSTB_TEXTEDIT_GETWIDTH_NEWLINE
+                  if (dx == IMSTB_TEXTEDIT_GETWIDTH_NEWLINE)
+                     break;
+                  #endif
+                  x += dx;
+                  if (x > goal_x)
+                     break;
+                  state->cursor = IMSTB_TEXTEDIT_GETNEXTCHARINDEX(str, state->cursor);
+               }
             }
+            #endif
             stb_textedit_clamp(str, state);
 
             state->has_preferred_x = 1;
@@ -1000,10 +1079,19 @@ retry:
                state->select_end = state->cursor;
 
             // go to previous line
+            #ifdef STB_TEXTEDIT_SEEKROW_CHAR
+            {
+               // [DEAR IMGUI] rows may be wrapped by the layout, so look the previous row up instead of scanning for a newline
+               StbFindState prev_find;
+               stb_textedit_find_charpos(&prev_find, str, find.prev_first, state->single_line);
+               prev_scan = prev_find.prev_first;
+            }
+            #else
             // (we need to scan previous line the hard way. maybe we could expose this as a new API function?)
             prev_scan = find.prev_first > 0 ? find.prev_first - 1 : 0;
             while (prev_scan > 0 && STB_TEXTEDIT_GETCHAR(str, prev_scan - 1) != STB_TEXTEDIT_NEWLINE)
                --prev_scan;
+            #endif
             find.first_char = find.prev_first;
             find.prev_first = prev_scan;
          }
@@ -1081,8 +1169,13 @@ retry:
          stb_textedit_move_to_first(state);
          if (state->single_line)
             state->cursor = 0;
+         #ifdef STB_TEXTEDIT_SEEKROW_CHAR
+         else
+            state->cursor = stb_textedit_find_row_start(str, state); // [DEAR IMGUI]
+         #else
          else while (state->cursor > 0 && STB_TEXTEDIT_GETCHAR(str, state->cursor-1) != STB_TEXTEDIT_NEWLINE)
             --state->cursor;
+         #endif
          state->has_preferred_x = 0;
          break;
 
@@ -1095,8 +1188,13 @@ retry:
          stb_textedit_move_to_first(state);
          if (state->single_line)
              state->cursor = n;
+         #ifdef STB_TEXTEDIT_SEEKROW_CHAR
+         else
+             state->cursor = stb_textedit_find_row_end(str, state); // [DEAR IMGUI]
+         #else
          else while (state->cursor < n && STB_TEXTEDIT_GETCHAR(str, state->cursor) != STB_TEXTEDIT_NEWLINE)
              ++state->cursor;
+         #endif
          state->has_preferred_x = 0;
          break;
       }
@@ -1109,8 +1207,13 @@ retry:
          stb_textedit_prep_selection_at_cursor(state);
          if (state->single_line)
             state->cursor = 0;
+         #ifdef STB_TEXTEDIT_SEEKROW_CHAR
+         else
+            state->cursor = stb_textedit_find_row_start(str, state); // [DEAR IMGUI]
+         #else
          else while (state->cursor > 0 && STB_TEXTEDIT_GETCHAR(str, state->cursor-1) != STB_TEXTEDIT_NEWLINE)
             --state->cursor;
+         #endif
          state->select_end = state->cursor;
          state->has_preferred_x = 0;
          break;
@@ -1124,8 +1227,13 @@ retry:
          stb_textedit_prep_selection_at_cursor(state);
          if (state->single_line)
              state->cursor = n;
+         #ifdef STB_TEXTEDIT_SEEKROW_CHAR
+         else
+             state->cursor = stb_textedit_find_row_end(str, state); // [DEAR IMGUI]
+         #else
          else while (state->cursor < n && STB_TEXTEDIT_GETCHAR(str, state->cursor) != STB_TEXTEDIT_NEWLINE)
             ++state->cursor;
+         #endif
          state->select_end = state->cursor;
          state->has_preferred_x = 0;
          break;
@@ -1139,6 +1247,40 @@ retry:
 //
 // @OPTIMIZE: the undo/redo buffer should be circular
 
+#ifdef STB_TEXTEDIT_UNDO_RECORD
+// [DEAR IMGUI] Undo storage provided by the user.
+static void stb_text_undo(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state)
+{
+   int cursor = STB_TEXTEDIT_UNDO_APPLY(str, 0);
+   if (cursor >= 0)
+      state->cursor = cursor;
+}
+
+static void stb_text_redo(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state)
+{
+   int cursor = STB_TEXTEDIT_UNDO_APPLY(str, 1);
+   if (cursor >= 0)
+      state->cursor = cursor;
+}
+
+static void stb_text_makeundo_insert(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int length)
+{
+   (void)state;
+   STB_TEXTEDIT_UNDO_RECORD(str, where, 0, length);
+}
+
+static void stb_text_makeundo_delete(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int length)
+{
+   (void)state;
+   STB_TEXTEDIT_UNDO_RECORD(str, where, length, 0);
+}
+
+static void stb_text_makeundo_replace(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int old_length, int new_length)
+{
+   (void)state;
+   STB_TEXTEDIT_UNDO_RECORD(str, where, old_length, new_length);
+}
+#else
 static void stb_textedit_flush_redo(StbUndoState *state)
 {
    state->redo_point = IMSTB_TEXTEDIT_UNDOSTATECOUNT;
@@ -1361,8 +1503,9 @@ static void stb_text_redo(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state)
    s->redo_point++;
 }
 
-static void stb_text_makeundo_insert(STB_TexteditState *state, int where, int length)
+static void stb_text_makeundo_insert(IMSTB_TEXTEDIT_STRING *str, STB_TexteditState *state, int where, int length)
 {
+   (void)str; // [DEAR IMGUI]
    stb_text_createundo(&state->undostate, where, 0, length);
 }
 
@@ -1385,6 +1528,7 @@ static void stb_text_makeundo_replace(IMSTB_TEXTEDIT_STRING *str, STB_TexteditSt
          p[i] = STB_TEXTEDIT_GETCHAR(str, where+i);
    }
 }
+#endif // STB_TEXTEDIT_UNDO_RECORD
 
 // reset the state to default
 static void stb_textedit_clear_state(STB_TexteditState *state, int is_single_line)